@@ -458,7 +458,7 @@ static void cxd56_geofence_sighandler(uint32_t data, FAR void *userdata)
         {
           fds->revents |= POLLIN;
           gnssinfo("Report events: %02x\n", fds->revents);
-          sem_post(fds->sem);
+          poll_notify(fds);
         }
     }
 
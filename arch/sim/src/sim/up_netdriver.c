@@ -68,6 +68,19 @@
 
 #define BUF ((struct eth_hdr_s *)g_sim_dev.d_buf)
 
+/* Poll with or without batching */
+
+#ifdef CONFIG_NETDEV_POLL_BATCH
+#  define SIM_NTXBUFS       CONFIG_NETDEV_POLL_BATCH_NPKTS
+#  define SIM_TXBUFSIZE \
+     ((MAX_NETDEV_PKTSIZE + CONFIG_NET_GUARDSIZE + 1) & ~1)
+#  define sim_devif_poll()  devif_poll_batch(&g_sim_dev, &g_txbatch)
+#  define sim_devif_timer() devif_timer_batch(&g_sim_dev, &g_txbatch)
+#else
+#  define sim_devif_poll()  devif_poll(&g_sim_dev, sim_txpoll)
+#  define sim_devif_timer() devif_timer(&g_sim_dev, sim_txpoll)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -88,6 +101,14 @@ static struct timer g_periodic_timer;
 
 static uint8_t g_pktbuf[MAX_NETDEV_PKTSIZE + CONFIG_NET_GUARDSIZE];
 
+#ifdef CONFIG_NETDEV_POLL_BATCH
+/* Transmit buffers filled by batched polling */
+
+static uint8_t g_txbuf[SIM_NTXBUFS][SIM_TXBUFSIZE];
+static struct devif_txdesc_s g_txdesc[SIM_NTXBUFS];
+static struct devif_txbatch_s g_txbatch;
+#endif
+
 /* Ethernet peripheral state */
 
 static struct net_driver_s g_sim_dev;
@@ -112,44 +133,97 @@ void timer_reset(struct timer *t)
   t->start += t->interval;
 }
 
-static int sim_txpoll(struct net_driver_s *dev)
+static int sim_send(FAR struct net_driver_s *dev)
 {
-  /* If the polling resulted in data that should be sent out on the network,
-   * the field d_len is set to a value > 0.
-   */
+  netdev_send(dev->d_buf, dev->d_len);
+  return 0;
+}
 
-  if (g_sim_dev.d_len > 0)
+static int sim_loopback_send(FAR struct net_driver_s *dev)
+{
+  if (!devif_loopback(dev))
     {
-      /* Look up the destination MAC address and add it to the Ethernet
-       * header.
-       */
+      /* Send the packet */
+
+      NETDEV_TXPACKETS(dev);
+      netdev_send(dev->d_buf, dev->d_len);
+      NETDEV_TXDONE(dev);
+    }
+
+  return 0;
+}
+
+static void sim_transmit(FAR struct net_driver_s *dev,
+                         devif_poll_callback_t txcb)
+{
+#ifdef CONFIG_NETDEV_TSO
+  /* There is no segmentation offload in the host tap interface, so split
+   * TCP payloads passed in I/O buffer chains into frames in software.
+   */
+
+  (void)devif_segment(dev, txcb);
+#else
+  (void)txcb(dev);
+#endif
+}
+
+static int sim_txprepare(FAR struct net_driver_s *dev)
+{
+  /* Look up the destination MAC address and add it to the Ethernet
+   * header.
+   */
 
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
-      if (IFF_IS_IPv4(g_sim_dev.d_flags))
+  if (IFF_IS_IPv4(dev->d_flags))
 #endif
-        {
-          arp_out(&g_sim_dev);
-        }
+    {
+      arp_out(dev);
+    }
 #endif /* CONFIG_NET_IPv4 */
 
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
-      else
+  else
 #endif
-        {
-          neighbor_out(&g_sim_dev);
-        }
+    {
+      neighbor_out(dev);
+    }
 #endif /* CONFIG_NET_IPv6 */
 
-      if (!devif_loopback(&g_sim_dev))
-        {
-          /* Send the packet */
+  return 0;
+}
 
-          NETDEV_TXPACKETS(dev);
-          netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
-          NETDEV_TXDONE(dev);
-        }
+#ifdef CONFIG_NETDEV_POLL_BATCH
+static int sim_txflush(FAR struct net_driver_s *dev,
+                       FAR struct devif_txbatch_s *batch)
+{
+  int i;
+
+  /* Send all of the packets queued by the batched poll */
+
+  for (i = 0; i < batch->tb_count; i++)
+    {
+      dev->d_buf = batch->tb_desc[i].td_buf;
+      dev->d_len = batch->tb_desc[i].td_len;
+      (void)sim_loopback_send(dev);
+    }
+
+  return 0;
+}
+#endif
+
+#ifndef CONFIG_NETDEV_POLL_BATCH
+static int sim_txpoll(struct net_driver_s *dev)
+{
+  /* If the polling resulted in data that should be sent out on the network,
+   * the field d_len is set to a value > 0.
+   */
+
+  if (g_sim_dev.d_len > 0)
+    {
+      (void)sim_txprepare(&g_sim_dev);
+      sim_transmit(&g_sim_dev, sim_loopback_send);
     }
 
   /* If zero is returned, the polling will continue until all connections have
@@ -158,6 +232,7 @@ static int sim_txpoll(struct net_driver_s *dev)
 
   return 0;
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -170,9 +245,20 @@ void netdriver_loop(void)
   /* Check for new frames.  If so, then poll the network for new XMIT data */
 
   net_lock();
-  (void)devif_poll(&g_sim_dev, sim_txpoll);
+  (void)sim_devif_poll();
   net_unlock();
 
+#ifdef CONFIG_NETDEV_IOB_RECEIVE
+  /* Receive directly into an I/O buffer if one is available so that the
+   * network can queue TCP payloads without copying them.  Otherwise keep
+   * using the static packet buffer.
+   */
+
+  net_lock();
+  (void)netdev_iob_prepare(&g_sim_dev);
+  net_unlock();
+#endif
+
   /* netdev_read will return 0 on a timeout event and >0 on a data received event */
 
   g_sim_dev.d_len = netdev_read((FAR unsigned char *)g_sim_dev.d_buf,
@@ -242,7 +328,7 @@ void netdriver_loop(void)
 
                   /* And send the packet */
 
-                  netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
+                  sim_transmit(&g_sim_dev, sim_send);
                 }
             }
           else
@@ -281,7 +367,7 @@ void netdriver_loop(void)
 
                   /* And send the packet */
 
-                  netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
+                  sim_transmit(&g_sim_dev, sim_send);
                 }
             }
           else
@@ -322,7 +408,7 @@ void netdriver_loop(void)
   else if (timer_expired(&g_periodic_timer))
     {
       timer_reset(&g_periodic_timer);
-      devif_timer(&g_sim_dev, sim_txpoll);
+      (void)sim_devif_timer();
     }
 
   sched_unlock();
@@ -342,6 +428,10 @@ int netdriver_ifdown(struct net_driver_s *dev)
 
 int netdriver_init(void)
 {
+#ifdef CONFIG_NETDEV_POLL_BATCH
+  int i;
+#endif
+
   /* Internal initialization */
 
   timer_set(&g_periodic_timer, 500);
@@ -353,6 +443,27 @@ int netdriver_init(void)
   g_sim_dev.d_ifup   = netdriver_ifup;
   g_sim_dev.d_ifdown = netdriver_ifdown;
 
+#ifdef CONFIG_NETDEV_TSO
+  /* Accept TCP payloads of any size in I/O buffer chains */
+
+  g_sim_dev.d_txcaps = NETDEV_TXCAP_SG | NETDEV_TXCAP_TSO;
+  g_sim_dev.d_tsomax = UINT16_MAX;
+#endif
+
+#ifdef CONFIG_NETDEV_POLL_BATCH
+  /* Set up the transmit buffers for batched polling */
+
+  for (i = 0; i < SIM_NTXBUFS; i++)
+    {
+      g_txdesc[i].td_buf = g_txbuf[i];
+    }
+
+  g_txbatch.tb_prepare = sim_txprepare;
+  g_txbatch.tb_flush   = sim_txflush;
+  g_txbatch.tb_desc    = g_txdesc;
+  g_txbatch.tb_ndesc   = SIM_NTXBUFS;
+#endif
+
   /* Register the device with the OS so that socket IOCTLs can be performed */
 
   (void)netdev_register(&g_sim_dev, NET_LL_ETHERNET);
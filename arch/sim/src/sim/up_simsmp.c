@@ -40,6 +40,8 @@
 #define _GNU_SOURCE 1
 
 #include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <pthread.h>
 #include <semaphore.h>
 #include <signal.h>
@@ -104,6 +106,18 @@ void nx_start(void) __attribute__ ((noreturn));
 void up_cpu_paused(int cpu);
 void sim_smp_hook(void);
 
+/****************************************************************************
+ * NuttX domain data
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_CSECTION_STATS
+/* Contention statistics of the critical section (see sched/irq/irq.h) */
+
+extern volatile uint32_t g_csection_nlocks[CONFIG_SMP_NCPUS];
+extern volatile uint32_t g_csection_ncontended[CONFIG_SMP_NCPUS];
+extern volatile uint32_t g_csection_nspins[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -217,6 +231,46 @@ static void *sim_idle_trampoline(void *arg)
   return NULL;
 }
 
+/****************************************************************************
+ * Name: sim_csection_report
+ *
+ * Description:
+ *   Print the critical section contention statistics of each CPU when the
+ *   simulation exits.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_CSECTION_STATS
+static void sim_csection_report(void)
+{
+  uint64_t nlocks = 0;
+  uint64_t ncontended = 0;
+  uint64_t nspins = 0;
+  int cpu;
+
+  fprintf(stderr, "\nCritical section contention:\n");
+  fprintf(stderr, "%4s %12s %12s %12s\n",
+          "CPU", "LOCKS", "CONTENDED", "SPINS");
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      fprintf(stderr, "%4d %12lu %12lu %12lu\n", cpu,
+              (unsigned long)g_csection_nlocks[cpu],
+              (unsigned long)g_csection_ncontended[cpu],
+              (unsigned long)g_csection_nspins[cpu]);
+
+      nlocks     += g_csection_nlocks[cpu];
+      ncontended += g_csection_ncontended[cpu];
+      nspins     += g_csection_nspins[cpu];
+    }
+
+  fprintf(stderr, "%4s %12llu %12llu %12llu (%llu%% contended)\n", "ALL",
+          (unsigned long long)nlocks, (unsigned long long)ncontended,
+          (unsigned long long)nspins,
+          nlocks > 0 ? (unsigned long long)(100 * ncontended / nlocks) : 0);
+}
+#endif
+
 /****************************************************************************
  * Name: sim_handle_signal
  *
@@ -296,6 +350,12 @@ int sim_cpu0_initialize(void)
       return -errno;
     }
 
+#ifdef CONFIG_SMP_CSECTION_STATS
+  /* Report the critical section contention when the simulation exits */
+
+  atexit(sim_csection_report);
+#endif
+
   return 0;
 }
 
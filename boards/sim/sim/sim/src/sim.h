@@ -112,6 +112,84 @@ int sim_bringup(void);
 int sim_zoneinfo(int minor);
 #endif
 
+/****************************************************************************
+ * Name: sim_bench
+ *
+ * Description:
+ *   Start a kernel thread that runs each of the selected benchmarks in
+ *   turn.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SIM_BENCH
+int sim_bench(void);
+#endif
+
+/****************************************************************************
+ * Name: sim_mmbench
+ *
+ * Description:
+ *   Run the heap latency and fragmentation benchmark on the calling thread.
+ *   The results are written to the SYSLOG.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SIM_MMBENCH
+int sim_mmbench(void);
+#endif
+
+/****************************************************************************
+ * Name: sim_strbench
+ *
+ * Description:
+ *   Run the memcpy(), memset() and memmove() benchmark on the calling
+ *   thread.  The results are written to the SYSLOG.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SIM_STRBENCH
+int sim_strbench(void);
+#endif
+
+/****************************************************************************
+ * Name: sim_spinbench
+ *
+ * Description:
+ *   Run the test-and-set, ticket lock and critical section benchmark on the
+ *   calling thread.  The results are written to the SYSLOG.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SIM_SPINBENCH
+int sim_spinbench(void);
+#endif
+
+/****************************************************************************
+ * Name: sim_pipebench
+ *
+ * Description:
+ *   Run the pipe throughput benchmark on the calling thread.  The results
+ *   are written to the SYSLOG.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SIM_PIPEBENCH
+int sim_pipebench(void);
+#endif
+
+/****************************************************************************
+ * Name: sim_uartbench
+ *
+ * Description:
+ *   Run the serial driver write benchmark on the calling thread.  The
+ *   results are written to the SYSLOG.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SIM_UARTBENCH
+int sim_uartbench(void);
+#endif
+
 /****************************************************************************
  * Name: sim_gpio_initialize
  *
@@ -0,0 +1,149 @@
+/****************************************************************************
+ * boards/sim/sim/sim/src/sim_bench.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdlib.h>
+#include <syslog.h>
+
+#include <nuttx/kthread.h>
+
+#include "sim.h"
+
+#ifdef CONFIG_SIM_BENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SIM_BENCH_NITEMS(a) (sizeof(a) / sizeof((a)[0]))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct sim_bench_s
+{
+  FAR const char *name;   /* Name used in the SYSLOG output */
+  CODE int (*run)(void);  /* Runs the benchmark on the calling thread */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The selected benchmarks, in the order in which they are run */
+
+static const struct sim_bench_s g_sim_benches[] =
+{
+#ifdef CONFIG_SIM_MMBENCH
+  { "mmbench",   sim_mmbench   },
+#endif
+#ifdef CONFIG_SIM_STRBENCH
+  { "strbench",  sim_strbench  },
+#endif
+#ifdef CONFIG_SIM_SPINBENCH
+  { "spinbench", sim_spinbench },
+#endif
+#ifdef CONFIG_SIM_PIPEBENCH
+  { "pipebench", sim_pipebench },
+#endif
+#ifdef CONFIG_SIM_UARTBENCH
+  { "uartbench", sim_uartbench },
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sim_bench_main
+ *
+ * Description:
+ *   Run the benchmarks one after the other so that they do not disturb
+ *   each other's timing.
+ *
+ ****************************************************************************/
+
+static int sim_bench_main(int argc, FAR char *argv[])
+{
+  int ret;
+  int i;
+
+  for (i = 0; i < SIM_BENCH_NITEMS(g_sim_benches); i++)
+    {
+      ret = g_sim_benches[i].run();
+      if (ret < 0)
+        {
+          syslog(LOG_ERR, "%s: failed: %d\n", g_sim_benches[i].name, ret);
+        }
+    }
+
+  return EXIT_SUCCESS;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sim_bench
+ *
+ * Description:
+ *   Start a kernel thread that runs each of the selected benchmarks in
+ *   turn.  The results are written to the SYSLOG.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sim_bench(void)
+{
+  int pid;
+
+  pid = kthread_create("simbench", CONFIG_SIM_BENCH_PRIORITY,
+                       CONFIG_SIM_BENCH_STACKSIZE,
+                       (main_t)sim_bench_main, NULL);
+  return pid < 0 ? pid : OK;
+}
+
+#endif /* CONFIG_SIM_BENCH */
@@ -323,6 +323,16 @@ int sim_bringup(void)
 
 #endif
 
+#ifdef CONFIG_SIM_BENCH
+  /* Start the benchmarks */
+
+  ret = sim_bench();
+  if (ret < 0)
+    {
+      syslog(LOG_ERR, "ERROR: sim_bench() failed: %d\n", ret);
+    }
+#endif
+
   UNUSED(ret);
   return OK;
 }
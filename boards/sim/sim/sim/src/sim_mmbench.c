@@ -0,0 +1,849 @@
+/****************************************************************************
+ * boards/sim/sim/sim/src/sim_mmbench.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <syslog.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <nuttx/mm/mm.h>
+
+#include "sim.h"
+
+#ifdef CONFIG_SIM_MMBENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Latencies are collected in a histogram with four sub-buckets per power
+ * of two nanoseconds.  That bounds the error in the reported percentiles
+ * to 25% without any allocation or sorting.
+ */
+
+#define MMBENCH_SUBSHIFT    2
+#define MMBENCH_NSUB        (1 << MMBENCH_SUBSHIFT)
+#define MMBENCH_NBUCKETS    (32 * MMBENCH_NSUB)
+
+/* The heap is sampled with mm_mallinfo() this many times per run */
+
+#define MMBENCH_NSAMPLES    64
+
+/* The recorded trace pointer map has twice as many entries as there are
+ * slots so that linear probing stays short.  Pointers are at least 4-byte
+ * aligned so 0 and 1 can be used for empty and deleted entries.
+ */
+
+#define MMBENCH_NHASH       (2 * CONFIG_SIM_MMBENCH_SLOTS)
+#define MMBENCH_EMPTY       ((uintptr_t)0)
+#define MMBENCH_DELETED     ((uintptr_t)1)
+
+#define MMBENCH_LINELEN     128
+
+#define MMBENCH_NITEMS(a)   (sizeof(a) / sizeof((a)[0]))
+
+/* Sizes representative of the network, file system and pthread users of
+ * the heap.
+ */
+
+#ifdef CONFIG_IOB_BUFSIZE
+#  define MMBENCH_IOBSIZE   CONFIG_IOB_BUFSIZE
+#else
+#  define MMBENCH_IOBSIZE   196
+#endif
+
+#ifdef CONFIG_NET_ETH_PKTSIZE
+#  define MMBENCH_PKTSIZE   CONFIG_NET_ETH_PKTSIZE
+#else
+#  define MMBENCH_PKTSIZE   1514
+#endif
+
+#ifdef CONFIG_FAT_MAXFNAME
+#  define MMBENCH_FNAMESIZE (CONFIG_FAT_MAXFNAME + 1)
+#else
+#  define MMBENCH_FNAMESIZE 33
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct mmbench_size_s
+{
+  size_t size;                  /* Base size of the allocation */
+  uint8_t weight;               /* Relative frequency of this size */
+};
+
+struct mmbench_profile_s
+{
+  FAR const char *name;         /* Profile name used in the report */
+  FAR const struct mmbench_size_s *sizes;
+  uint8_t nsizes;               /* Number of entries in sizes[] */
+  uint8_t reallocpct;           /* Percentage of releases done by realloc */
+};
+
+struct mmbench_hist_s
+{
+  uint32_t count;               /* Number of samples */
+  uint32_t max;                 /* Worst case latency (ns) */
+  uint64_t total;               /* Sum of all latencies (ns) */
+  uint32_t bucket[MMBENCH_NBUCKETS];
+};
+
+struct mmbench_slot_s
+{
+  FAR void *mem;                /* Allocated memory or NULL */
+  size_t size;                  /* Requested size of mem */
+};
+
+struct mmbench_hash_s
+{
+  uintptr_t key;                /* Pointer value from the trace */
+  int slot;                     /* Slot holding the replayed allocation */
+};
+
+struct mmbench_s
+{
+  FAR struct mm_heap_s *heap;   /* Heap under test */
+  struct mmbench_hist_s malloc; /* mm_malloc() latencies */
+  struct mmbench_hist_s free;   /* mm_free() latencies */
+  struct mmbench_hist_s realloc; /* mm_realloc() latencies */
+  uint32_t failures;            /* Number of failed allocations */
+  int baseused;                 /* uordblks before the run */
+  int peakused;                 /* Highest uordblks seen by the run */
+  int minlargest;               /* Smallest mxordblk seen by the run */
+  int maxfrag;                  /* Worst fragmentation index (per mille) */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct mmbench_size_s g_netsizes[] =
+{
+  { 16,                      20 },  /* Small control structures */
+  { 64,                      10 },
+  { MMBENCH_IOBSIZE,         30 },  /* I/O buffers */
+  { MMBENCH_PKTSIZE,         25 },  /* Packet buffers */
+  { 2048,                     5 },  /* Read-ahead and socket buffers */
+};
+
+static const struct mmbench_size_s g_fssizes[] =
+{
+  { MMBENCH_FNAMESIZE,       25 },  /* Path name segments */
+  { 96,                      20 },  /* Private file and inode structures */
+  { 512,                     30 },  /* Sector buffers */
+  { 1024,                    10 },
+  { 4096,                     5 },  /* Cluster and block caches */
+};
+
+static const struct mmbench_size_s g_pthreadsizes[] =
+{
+  { sizeof(struct pthread_tcb_s),         40 },
+  { CONFIG_PTHREAD_STACK_DEFAULT,         40 },
+  { 2 * CONFIG_PTHREAD_STACK_DEFAULT,      5 },
+  { 48,                                   15 },  /* Join and key data */
+};
+
+static const struct mmbench_size_s g_mixedsizes[] =
+{
+  { 16,                      20 },
+  { MMBENCH_FNAMESIZE,       15 },
+  { MMBENCH_IOBSIZE,         20 },
+  { 512,                     15 },
+  { MMBENCH_PKTSIZE,         15 },
+  { sizeof(struct pthread_tcb_s), 5 },
+  { CONFIG_PTHREAD_STACK_DEFAULT,  5 },
+  { 4096,                     5 },
+};
+
+static const struct mmbench_profile_s g_profiles[] =
+{
+  { "net",     g_netsizes,     MMBENCH_NITEMS(g_netsizes),     10 },
+  { "fs",      g_fssizes,      MMBENCH_NITEMS(g_fssizes),      25 },
+  { "pthread", g_pthreadsizes, MMBENCH_NITEMS(g_pthreadsizes),  0 },
+  { "mixed",   g_mixedsizes,   MMBENCH_NITEMS(g_mixedsizes),   15 },
+};
+
+static struct mmbench_s g_mmbench;
+static struct mmbench_slot_s g_mmbench_slots[CONFIG_SIM_MMBENCH_SLOTS];
+static uint32_t g_mmbench_seed;
+
+#ifdef CONFIG_SIM_MMBENCH_TRACE_ENABLE
+static struct mmbench_hash_s g_mmbench_hash[MMBENCH_NHASH];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mmbench_random
+ *
+ * Description:
+ *   A small linear congruential generator.  The C library rand() is not
+ *   used so that every run performs the same sequence of operations.
+ *
+ ****************************************************************************/
+
+static uint32_t mmbench_random(void)
+{
+  g_mmbench_seed = g_mmbench_seed * 1103515245 + 12345;
+  return g_mmbench_seed >> 8;
+}
+
+/****************************************************************************
+ * Name: mmbench_elapsed
+ *
+ * Description:
+ *   Convert the elapsed perf counter value to nanoseconds.
+ *
+ ****************************************************************************/
+
+static uint32_t mmbench_elapsed(uint32_t start)
+{
+  uint64_t elapsed = (uint32_t)(up_perf_gettime() - start);
+
+  elapsed = elapsed * 1000000000ull / up_perf_getfreq();
+  return elapsed > UINT32_MAX ? UINT32_MAX : (uint32_t)elapsed;
+}
+
+/****************************************************************************
+ * Name: mmbench_record
+ ****************************************************************************/
+
+static void mmbench_record(FAR struct mmbench_hist_s *hist, uint32_t ns)
+{
+  int ndx;
+
+  if (ns < MMBENCH_NSUB)
+    {
+      ndx = ns;
+    }
+  else
+    {
+      int msb = fls(ns) - 1;
+
+      ndx = ((msb - MMBENCH_SUBSHIFT + 1) << MMBENCH_SUBSHIFT) +
+            ((ns >> (msb - MMBENCH_SUBSHIFT)) & (MMBENCH_NSUB - 1));
+    }
+
+  hist->bucket[ndx]++;
+  hist->total += ns;
+  hist->count++;
+
+  if (ns > hist->max)
+    {
+      hist->max = ns;
+    }
+}
+
+/****************************************************************************
+ * Name: mmbench_percentile
+ *
+ * Description:
+ *   Return the upper bound (in nanoseconds) of the histogram bucket that
+ *   contains the requested percentile, limited to the worst case.
+ *
+ ****************************************************************************/
+
+static uint32_t mmbench_percentile(FAR const struct mmbench_hist_s *hist,
+                                   int pct)
+{
+  uint64_t bound;
+  uint32_t target;
+  uint32_t seen = 0;
+  int ndx;
+
+  target = (uint32_t)(((uint64_t)hist->count * pct + 99) / 100);
+  for (ndx = 0; ndx < MMBENCH_NBUCKETS; ndx++)
+    {
+      seen += hist->bucket[ndx];
+      if (seen >= target && seen > 0)
+        {
+          int oct = ndx >> MMBENCH_SUBSHIFT;
+          int sub = ndx & (MMBENCH_NSUB - 1);
+
+          if (oct == 0)
+            {
+              return sub;
+            }
+
+          oct  += MMBENCH_SUBSHIFT - 1;
+          bound = (((uint64_t)MMBENCH_NSUB + sub + 1) <<
+                   (oct - MMBENCH_SUBSHIFT)) - 1;
+          return bound < hist->max ? (uint32_t)bound : hist->max;
+        }
+    }
+
+  return hist->max;
+}
+
+/****************************************************************************
+ * Name: mmbench_sample
+ *
+ * Description:
+ *   Sample the heap state and update the peak usage, the smallest largest
+ *   free chunk and the worst fragmentation index.  The fragmentation index
+ *   is 1 - (largest free chunk / total free memory), in per mille.
+ *
+ ****************************************************************************/
+
+static void mmbench_sample(FAR struct mmbench_s *bench)
+{
+  struct mallinfo info;
+  int frag;
+
+  mm_mallinfo(bench->heap, &info);
+
+  if (info.uordblks > bench->peakused)
+    {
+      bench->peakused = info.uordblks;
+    }
+
+  if (info.mxordblk < bench->minlargest)
+    {
+      bench->minlargest = info.mxordblk;
+    }
+
+  if (info.fordblks > 0)
+    {
+      frag = 1000 - (int)((int64_t)info.mxordblk * 1000 / info.fordblks);
+      if (frag > bench->maxfrag)
+        {
+          bench->maxfrag = frag;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mmbench_malloc, mmbench_free, mmbench_realloc
+ *
+ * Description:
+ *   Perform one timed heap operation on a slot.
+ *
+ ****************************************************************************/
+
+static void mmbench_malloc(FAR struct mmbench_s *bench,
+                           FAR struct mmbench_slot_s *slot, size_t size)
+{
+  uint32_t start;
+
+  start = up_perf_gettime();
+  slot->mem = mm_malloc(bench->heap, size);
+  mmbench_record(&bench->malloc, mmbench_elapsed(start));
+
+  if (slot->mem == NULL)
+    {
+      bench->failures++;
+    }
+  else
+    {
+      /* Touch the memory like a real user would */
+
+      *(FAR uint8_t *)slot->mem = 0;
+      slot->size = size;
+    }
+}
+
+static void mmbench_free(FAR struct mmbench_s *bench,
+                         FAR struct mmbench_slot_s *slot)
+{
+  uint32_t start;
+
+  start = up_perf_gettime();
+  mm_free(bench->heap, slot->mem);
+  mmbench_record(&bench->free, mmbench_elapsed(start));
+
+  slot->mem  = NULL;
+  slot->size = 0;
+}
+
+static void mmbench_realloc(FAR struct mmbench_s *bench,
+                            FAR struct mmbench_slot_s *slot, size_t size)
+{
+  FAR void *newmem;
+  uint32_t start;
+
+  start  = up_perf_gettime();
+  newmem = mm_realloc(bench->heap, slot->mem, size);
+  mmbench_record(&bench->realloc, mmbench_elapsed(start));
+
+  if (newmem == NULL)
+    {
+      /* The old allocation is still valid */
+
+      bench->failures++;
+    }
+  else
+    {
+      slot->mem  = newmem;
+      slot->size = size;
+    }
+}
+
+/****************************************************************************
+ * Name: mmbench_start
+ ****************************************************************************/
+
+static void mmbench_start(FAR struct mmbench_s *bench,
+                          FAR struct mm_heap_s *heap)
+{
+  struct mallinfo info;
+
+  memset(bench, 0, sizeof(struct mmbench_s));
+  memset(g_mmbench_slots, 0, sizeof(g_mmbench_slots));
+
+  bench->heap = heap;
+  mm_mallinfo(heap, &info);
+
+  bench->baseused   = info.uordblks;
+  bench->peakused   = info.uordblks;
+  bench->minlargest = info.mxordblk;
+  g_mmbench_seed    = 1;
+}
+
+/****************************************************************************
+ * Name: mmbench_finish
+ *
+ * Description:
+ *   Release everything still held by the run and report the results.
+ *
+ ****************************************************************************/
+
+static void mmbench_report(FAR const char *what,
+                           FAR const struct mmbench_hist_s *hist)
+{
+  if (hist->count == 0)
+    {
+      return;
+    }
+
+  syslog(LOG_INFO,
+         "  %-8s %8lu %8lu %8lu %8lu %8lu %8lu\n", what,
+         (unsigned long)hist->count,
+         (unsigned long)(hist->total / hist->count),
+         (unsigned long)mmbench_percentile(hist, 50),
+         (unsigned long)mmbench_percentile(hist, 90),
+         (unsigned long)mmbench_percentile(hist, 99),
+         (unsigned long)hist->max);
+}
+
+static void mmbench_finish(FAR struct mmbench_s *bench,
+                           FAR const char *heapname,
+                           FAR const char *profile)
+{
+  int i;
+
+  mmbench_sample(bench);
+
+  for (i = 0; i < CONFIG_SIM_MMBENCH_SLOTS; i++)
+    {
+      if (g_mmbench_slots[i].mem != NULL)
+        {
+          mmbench_free(bench, &g_mmbench_slots[i]);
+        }
+    }
+
+  syslog(LOG_INFO, "mmbench: %s heap, %s workload\n", heapname, profile);
+  syslog(LOG_INFO, "  %-8s %8s %8s %8s %8s %8s %8s\n",
+         "op", "count", "avg ns", "p50", "p90", "p99", "max");
+
+  mmbench_report("malloc", &bench->malloc);
+  mmbench_report("free", &bench->free);
+  mmbench_report("realloc", &bench->realloc);
+
+  syslog(LOG_INFO,
+         "  peak used %d, smallest largest free %d, fragmentation %d.%d%%, "
+         "failures %lu\n",
+         bench->peakused - bench->baseused, bench->minlargest,
+         bench->maxfrag / 10, bench->maxfrag % 10,
+         (unsigned long)bench->failures);
+}
+
+/****************************************************************************
+ * Name: mmbench_synthetic
+ *
+ * Description:
+ *   Run a synthetic workload.  Each iteration picks a random slot.  Empty
+ *   slots are filled with an allocation drawn from the profile size mix;
+ *   occupied slots are either released or resized.
+ *
+ ****************************************************************************/
+
+static void mmbench_synthetic(FAR struct mmbench_s *bench,
+                              FAR const struct mmbench_profile_s *profile)
+{
+  FAR struct mmbench_slot_s *slot;
+  unsigned int totalweight = 0;
+  uint32_t interval;
+  uint32_t iter;
+  int i;
+
+  for (i = 0; i < profile->nsizes; i++)
+    {
+      totalweight += profile->sizes[i].weight;
+    }
+
+  interval = CONFIG_SIM_MMBENCH_ITERATIONS / MMBENCH_NSAMPLES;
+  if (interval == 0)
+    {
+      interval = 1;
+    }
+
+  for (iter = 0; iter < CONFIG_SIM_MMBENCH_ITERATIONS; iter++)
+    {
+      unsigned int pick;
+      size_t size;
+
+      /* Select a size from the profile and add up to 25% of jitter */
+
+      pick = mmbench_random() % totalweight;
+      for (i = 0; pick >= profile->sizes[i].weight; i++)
+        {
+          pick -= profile->sizes[i].weight;
+        }
+
+      size  = profile->sizes[i].size;
+      size += mmbench_random() % (size / 4 + 1);
+
+      slot = &g_mmbench_slots[mmbench_random() % CONFIG_SIM_MMBENCH_SLOTS];
+      if (slot->mem == NULL)
+        {
+          mmbench_malloc(bench, slot, size);
+        }
+      else if ((mmbench_random() % 100) < profile->reallocpct)
+        {
+          mmbench_realloc(bench, slot, size);
+        }
+      else
+        {
+          mmbench_free(bench, slot);
+        }
+
+      if ((iter % interval) == 0)
+        {
+          mmbench_sample(bench);
+        }
+    }
+}
+
+#ifdef CONFIG_SIM_MMBENCH_TRACE_ENABLE
+/****************************************************************************
+ * Name: mmbench_hash_*
+ *
+ * Description:
+ *   Map pointer values recorded in the trace to replay slots.
+ *
+ ****************************************************************************/
+
+static FAR struct mmbench_hash_s *mmbench_hash_find(uintptr_t key)
+{
+  int ndx = (key >> 4) % MMBENCH_NHASH;
+  int i;
+
+  for (i = 0; i < MMBENCH_NHASH; i++)
+    {
+      FAR struct mmbench_hash_s *entry = &g_mmbench_hash[ndx];
+
+      if (entry->key == key)
+        {
+          return entry;
+        }
+      else if (entry->key == MMBENCH_EMPTY)
+        {
+          break;
+        }
+
+      ndx = (ndx + 1) % MMBENCH_NHASH;
+    }
+
+  return NULL;
+}
+
+static FAR struct mmbench_hash_s *mmbench_hash_add(uintptr_t key)
+{
+  int ndx = (key >> 4) % MMBENCH_NHASH;
+  int i;
+
+  for (i = 0; i < MMBENCH_NHASH; i++)
+    {
+      FAR struct mmbench_hash_s *entry = &g_mmbench_hash[ndx];
+
+      if (entry->key == MMBENCH_EMPTY || entry->key == MMBENCH_DELETED)
+        {
+          entry->key = key;
+          return entry;
+        }
+
+      ndx = (ndx + 1) % MMBENCH_NHASH;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: mmbench_replay_line
+ *
+ * Description:
+ *   Replay one line of a trace.  The trace format is the CONFIG_DEBUG_MM
+ *   output of the heap itself:
+ *
+ *     Allocated <pointer>, size <size>
+ *     Freeing <pointer>
+ *     Cached <pointer>
+ *
+ *   Anything else on the line (such as the function name prefix) and any
+ *   other lines are ignored.
+ *
+ ****************************************************************************/
+
+static void mmbench_replay_line(FAR struct mmbench_s *bench,
+                                FAR char *line, FAR int *freeslot)
+{
+  FAR struct mmbench_hash_s *entry;
+  FAR char *ptr;
+  uintptr_t key;
+
+  if ((ptr = strstr(line, "Allocated ")) != NULL)
+    {
+      size_t size;
+
+      key = (uintptr_t)strtoul(ptr + 10, &ptr, 16);
+      ptr = strstr(ptr, "size ");
+      if (ptr == NULL || key <= MMBENCH_DELETED)
+        {
+          return;
+        }
+
+      size = (size_t)strtoul(ptr + 5, NULL, 10);
+
+      /* The recorded size includes the chunk header */
+
+      size = size > SIZEOF_MM_ALLOCNODE ? size - SIZEOF_MM_ALLOCNODE : 1;
+
+      /* Find an empty slot */
+
+      for (; *freeslot < CONFIG_SIM_MMBENCH_SLOTS &&
+             g_mmbench_slots[*freeslot].mem != NULL; (*freeslot)++);
+
+      if (*freeslot >= CONFIG_SIM_MMBENCH_SLOTS ||
+          mmbench_hash_find(key) != NULL)
+        {
+          return;
+        }
+
+      entry = mmbench_hash_add(key);
+      if (entry != NULL)
+        {
+          entry->slot = *freeslot;
+          mmbench_malloc(bench, &g_mmbench_slots[*freeslot], size);
+          if (g_mmbench_slots[*freeslot].mem == NULL)
+            {
+              entry->key = MMBENCH_DELETED;
+            }
+        }
+    }
+  else if ((ptr = strstr(line, "Freeing ")) != NULL ||
+           (ptr = strstr(line, "Cached ")) != NULL)
+    {
+      ptr = strchr(ptr, ' ');
+      key = (uintptr_t)strtoul(ptr + 1, NULL, 16);
+      entry = mmbench_hash_find(key);
+      if (entry != NULL && key > MMBENCH_DELETED)
+        {
+          mmbench_free(bench, &g_mmbench_slots[entry->slot]);
+          if (entry->slot < *freeslot)
+            {
+              *freeslot = entry->slot;
+            }
+
+          entry->key = MMBENCH_DELETED;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mmbench_replay
+ *
+ * Description:
+ *   Replay a recorded allocation trace from a file.  Traces are short
+ *   compared to the synthetic workloads so the heap is sampled after every
+ *   line to get an exact peak usage.
+ *
+ ****************************************************************************/
+
+static int mmbench_replay(FAR struct mmbench_s *bench, FAR const char *path)
+{
+  char buffer[MMBENCH_LINELEN];
+  int freeslot = 0;
+  int nbuffered = 0;
+  int fd;
+
+  fd = open(path, O_RDONLY);
+  if (fd < 0)
+    {
+      return -errno;
+    }
+
+  memset(g_mmbench_hash, 0, sizeof(g_mmbench_hash));
+
+  for (; ; )
+    {
+      FAR char *eol;
+      ssize_t nread;
+
+      nread = read(fd, &buffer[nbuffered], MMBENCH_LINELEN - 1 - nbuffered);
+      if (nread <= 0 && nbuffered == 0)
+        {
+          break;
+        }
+
+      nbuffered += nread > 0 ? nread : 0;
+      buffer[nbuffered] = '\0';
+
+      /* Replay each complete line.  Over-long lines are truncated. */
+
+      eol = strchr(buffer, '\n');
+      if (eol == NULL)
+        {
+          if (nread > 0 && nbuffered < MMBENCH_LINELEN - 1)
+            {
+              continue;
+            }
+
+          eol = &buffer[nbuffered - 1];
+        }
+
+      *eol = '\0';
+      mmbench_replay_line(bench, buffer, &freeslot);
+      mmbench_sample(bench);
+
+      nbuffered -= eol - buffer + 1;
+      memmove(buffer, eol + 1, nbuffered);
+    }
+
+  close(fd);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: mmbench_heap
+ *
+ * Description:
+ *   Run all workloads against one heap.
+ *
+ ****************************************************************************/
+
+static void mmbench_heap(FAR struct mm_heap_s *heap,
+                         FAR const char *heapname)
+{
+  FAR struct mmbench_s *bench = &g_mmbench;
+#ifdef CONFIG_SIM_MMBENCH_TRACE_ENABLE
+  int ret;
+#endif
+  int i;
+
+  for (i = 0; i < MMBENCH_NITEMS(g_profiles); i++)
+    {
+      mmbench_start(bench, heap);
+      mmbench_synthetic(bench, &g_profiles[i]);
+      mmbench_finish(bench, heapname, g_profiles[i].name);
+    }
+
+#ifdef CONFIG_SIM_MMBENCH_TRACE_ENABLE
+  mmbench_start(bench, heap);
+  ret = mmbench_replay(bench, CONFIG_SIM_MMBENCH_TRACE);
+  if (ret < 0)
+    {
+      syslog(LOG_ERR, "ERROR: Failed to replay %s: %d\n",
+             CONFIG_SIM_MMBENCH_TRACE, ret);
+    }
+
+  mmbench_finish(bench, heapname, CONFIG_SIM_MMBENCH_TRACE);
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sim_mmbench
+ *
+ * Description:
+ *   Run the heap benchmark on the calling thread.  The results are written
+ *   to the SYSLOG.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sim_mmbench(void)
+{
+  syslog(LOG_INFO, "mmbench: %d iterations over %d slots\n",
+         CONFIG_SIM_MMBENCH_ITERATIONS, CONFIG_SIM_MMBENCH_SLOTS);
+
+#ifdef CONFIG_BUILD_FLAT
+  /* The user heap is only directly accessible in the flat build */
+
+  mmbench_heap(&g_mmheap, "user");
+#endif
+
+#ifdef CONFIG_MM_KERNEL_HEAP
+  mmbench_heap(&g_kmmheap, "kernel");
+#endif
+
+  syslog(LOG_INFO, "mmbench: done\n");
+  return OK;
+}
+
+#endif /* CONFIG_SIM_MMBENCH */
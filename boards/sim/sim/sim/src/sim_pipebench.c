@@ -0,0 +1,413 @@
+/****************************************************************************
+ * boards/sim/sim/sim/src/sim_pipebench.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/ioctl.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <syslog.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/drivers/drivers.h>
+
+#include "sim.h"
+
+#ifdef CONFIG_SIM_PIPEBENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The largest write(), read() or splice measured */
+
+#define PIPEBENCH_MAXSIZE   4096
+
+#define PIPEBENCH_NITEMS(a) (sizeof(a) / sizeof((a)[0]))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The pipes used by one case.  Without a relay the producer writes the pipe
+ * that the benchmark thread reads.  With a relay, the producer writes the
+ * first pipe and the relay moves the data into the second one.
+ */
+
+struct pipebench_s
+{
+  int wrfd;            /* Written by the producer */
+  int relayrdfd;       /* Read by the relay, or -1 */
+  int relaywrfd;       /* Written by the relay, or -1 */
+  int rdfd;            /* Read by the benchmark thread */
+  size_t size;         /* Bytes per write(), read() or splice */
+  bool splice;         /* True: Relay with PIPEIOC_SPLICEOUT */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const size_t g_pipebench_sizes[] =
+{
+  16, 64, 256, 1024, PIPEBENCH_MAXSIZE
+};
+
+static uint8_t g_pipebench_wrbuf[PIPEBENCH_MAXSIZE];
+static uint8_t g_pipebench_relaybuf[PIPEBENCH_MAXSIZE];
+static uint8_t g_pipebench_rdbuf[PIPEBENCH_MAXSIZE];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pipebench_producer
+ *
+ * Description:
+ *   Write CONFIG_SIM_PIPEBENCH_BYTES into the first pipe.
+ *
+ ****************************************************************************/
+
+static FAR void *pipebench_producer(FAR void *arg)
+{
+  FAR struct pipebench_s *bench = (FAR struct pipebench_s *)arg;
+  size_t remaining = CONFIG_SIM_PIPEBENCH_BYTES;
+  ssize_t nwritten;
+
+  while (remaining > 0)
+    {
+      nwritten = write(bench->wrfd, g_pipebench_wrbuf,
+                       remaining < bench->size ? remaining : bench->size);
+      if (nwritten <= 0)
+        {
+          break;
+        }
+
+      remaining -= nwritten;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: pipebench_relay
+ *
+ * Description:
+ *   Move CONFIG_SIM_PIPEBENCH_BYTES from the first pipe to the second one,
+ *   either through a buffer with read() and write() or with
+ *   PIPEIOC_SPLICEOUT.
+ *
+ ****************************************************************************/
+
+static FAR void *pipebench_relay(FAR void *arg)
+{
+  FAR struct pipebench_s *bench = (FAR struct pipebench_s *)arg;
+  size_t remaining = CONFIG_SIM_PIPEBENCH_BYTES;
+  size_t n;
+  ssize_t nmoved;
+#ifdef CONFIG_DEV_PIPE_SPLICE
+  struct pipe_splice_s splice;
+#endif
+
+  while (remaining > 0)
+    {
+      n = remaining < bench->size ? remaining : bench->size;
+
+#ifdef CONFIG_DEV_PIPE_SPLICE
+      if (bench->splice)
+        {
+          splice.fd  = bench->relaywrfd;
+          splice.len = n;
+          nmoved = ioctl(bench->relayrdfd, PIPEIOC_SPLICEOUT,
+                         (unsigned long)((uintptr_t)&splice));
+        }
+      else
+#endif
+        {
+          nmoved = read(bench->relayrdfd, g_pipebench_relaybuf, n);
+          if (nmoved > 0)
+            {
+              nmoved = write(bench->relaywrfd, g_pipebench_relaybuf, nmoved);
+            }
+        }
+
+      if (nmoved <= 0)
+        {
+          break;
+        }
+
+      remaining -= nmoved;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: pipebench_run
+ *
+ * Description:
+ *   Move CONFIG_SIM_PIPEBENCH_BYTES through the pipes of one case and
+ *   return the throughput seen by the reader in MB/s, or a negated errno
+ *   value on failure.
+ *
+ ****************************************************************************/
+
+static int32_t pipebench_run(FAR struct pipebench_s *bench)
+{
+  pthread_t producer;
+  pthread_t relay;
+  size_t remaining = CONFIG_SIM_PIPEBENCH_BYTES;
+  uint64_t elapsed = 0;
+  uint32_t last;
+  uint32_t now;
+  ssize_t nread;
+  int ret;
+
+  /* Start the relay first: It only waits for data until the producer
+   * runs.
+   */
+
+  if (bench->relayrdfd >= 0)
+    {
+      ret = pthread_create(&relay, NULL, pipebench_relay, bench);
+      if (ret != 0)
+        {
+          return -ret;
+        }
+    }
+
+  ret = pthread_create(&producer, NULL, pipebench_producer, bench);
+  if (ret != 0)
+    {
+      if (bench->relayrdfd >= 0)
+        {
+          /* The relay sees the end of file once the write side is closed */
+
+          close(bench->wrfd);
+          bench->wrfd = -1;
+          pthread_join(relay, NULL);
+        }
+
+      return -ret;
+    }
+
+  /* Sum the time of each read() so that the 32-bit counter cannot wrap
+   * between two samples.
+   */
+
+  last = up_perf_gettime();
+  while (remaining > 0)
+    {
+      nread = read(bench->rdfd, g_pipebench_rdbuf,
+                   remaining < bench->size ? remaining : bench->size);
+      if (nread <= 0)
+        {
+          break;
+        }
+
+      now      = up_perf_gettime();
+      elapsed += (uint32_t)(now - last);
+      last     = now;
+
+      remaining -= nread;
+    }
+
+  pthread_join(producer, NULL);
+  if (bench->relayrdfd >= 0)
+    {
+      pthread_join(relay, NULL);
+    }
+
+  if (remaining > 0)
+    {
+      return -EIO;
+    }
+
+  elapsed = elapsed * 1000000000ull / up_perf_getfreq();
+  if (elapsed == 0)
+    {
+      elapsed = 1;
+    }
+
+  /* Bytes per nanosecond times 1000 is MB/s */
+
+  return (int32_t)((uint64_t)CONFIG_SIM_PIPEBENCH_BYTES * 1000 / elapsed);
+}
+
+/****************************************************************************
+ * Name: pipebench_case
+ *
+ * Description:
+ *   Create the pipes for one case, run it and report the result.
+ *
+ ****************************************************************************/
+
+static int pipebench_case(FAR const char *name, size_t size, bool relay,
+                          bool splice)
+{
+  struct pipebench_s bench;
+  int fd1[2];
+  int fd2[2];
+  int32_t rate;
+  int ret;
+
+  ret = pipe(fd1);
+  if (ret < 0)
+    {
+      return -errno;
+    }
+
+  fd2[0] = -1;
+  fd2[1] = -1;
+
+  if (relay)
+    {
+      ret = pipe(fd2);
+      if (ret < 0)
+        {
+          ret = -errno;
+          close(fd1[0]);
+          close(fd1[1]);
+          return ret;
+        }
+    }
+
+  bench.wrfd      = fd1[1];
+  bench.relayrdfd = relay ? fd1[0] : -1;
+  bench.relaywrfd = fd2[1];
+  bench.rdfd      = relay ? fd2[0] : fd1[0];
+  bench.size      = size;
+  bench.splice    = splice;
+
+  rate = pipebench_run(&bench);
+
+  close(fd1[0]);
+  if (bench.wrfd >= 0)
+    {
+      close(bench.wrfd);
+    }
+
+  if (relay)
+    {
+      close(fd2[0]);
+      close(fd2[1]);
+    }
+
+  if (rate < 0)
+    {
+      syslog(LOG_ERR, "pipebench: %-6s %5lu failed: %ld\n",
+             name, (unsigned long)size, (long)rate);
+      return (int)rate;
+    }
+
+  syslog(LOG_INFO, "pipebench: %-6s %5lu  %6lu MB/s\n",
+         name, (unsigned long)size, (unsigned long)rate);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sim_pipebench
+ *
+ * Description:
+ *   Run the pipe throughput benchmark on the calling thread.  The results
+ *   are written to the SYSLOG.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sim_pipebench(void)
+{
+  int ret;
+  int i;
+
+  for (i = 0; i < PIPEBENCH_MAXSIZE; i++)
+    {
+      g_pipebench_wrbuf[i] = (uint8_t)(i * 13 + 5);
+    }
+
+  syslog(LOG_INFO, "pipebench: %d bytes per case, "
+         "case, bytes per call, throughput\n",
+         CONFIG_SIM_PIPEBENCH_BYTES);
+
+  /* A producer writing straight to the reader, then a relay moving the
+   * data between two pipes with read()/write() and with a splice.
+   */
+
+  for (i = 0; i < PIPEBENCH_NITEMS(g_pipebench_sizes); i++)
+    {
+      ret = pipebench_case("direct", g_pipebench_sizes[i], false, false);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = pipebench_case("copy", g_pipebench_sizes[i], true, false);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+#ifdef CONFIG_DEV_PIPE_SPLICE
+      ret = pipebench_case("splice", g_pipebench_sizes[i], true, true);
+      if (ret < 0)
+        {
+          return ret;
+        }
+#endif
+    }
+
+  syslog(LOG_INFO, "pipebench: done\n");
+  return OK;
+}
+
+#endif /* CONFIG_SIM_PIPEBENCH */
@@ -0,0 +1,421 @@
+/****************************************************************************
+ * boards/sim/sim/sim/src/sim_spinbench.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <syslog.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/kthread.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/semaphore.h>
+
+#include "sim.h"
+
+#ifdef CONFIG_SIM_SPINBENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SPINBENCH_NITEMS(a)  (sizeof(a) / sizeof((a)[0]))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Each lock is taken and released through a common signature */
+
+struct spinbench_case_s
+{
+  FAR const char *name;                   /* Lock name used in the report */
+  CODE irqstate_t (*lock)(void);          /* Take the lock */
+  CODE void (*unlock)(irqstate_t flags);  /* Release the lock */
+};
+
+/* The results of one CPU.  Each entry is only written by its own worker. */
+
+struct spinbench_cpu_s
+{
+  uint32_t nlocks;                        /* Number of acquisitions */
+  uint32_t maxwait;                       /* Longest wait (perf counts) */
+  uint64_t totwait;                       /* Sum of the waits */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static irqstate_t spinbench_tslock(void);
+static void spinbench_tsunlock(irqstate_t flags);
+static irqstate_t spinbench_ticketlock(void);
+static void spinbench_ticketunlock(irqstate_t flags);
+static void spinbench_csunlock(irqstate_t flags);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct spinbench_case_s g_spinbench_cases[] =
+{
+  { "testset",  spinbench_tslock,      spinbench_tsunlock     },
+  { "ticket",   spinbench_ticketlock,  spinbench_ticketunlock },
+  { "csection", enter_critical_section, spinbench_csunlock    },
+};
+
+/* The locks under test */
+
+static volatile spinlock_t g_spinbench_tslock SP_SECTION;
+static struct spin_ticket_s g_spinbench_ticket;
+
+/* The state of the case being run */
+
+static FAR const struct spinbench_case_s *g_spinbench_case;
+static struct spinbench_cpu_s g_spinbench_cpu[CONFIG_SMP_NCPUS];
+static volatile uint32_t g_spinbench_counter;
+static volatile uint32_t g_spinbench_data[CONFIG_SIM_SPINBENCH_HOLD];
+static volatile spinlock_t g_spinbench_readylock SP_SECTION;
+static volatile int g_spinbench_nready;
+static volatile uint32_t g_spinbench_start;
+static volatile bool g_spinbench_go;
+static uint32_t g_spinbench_duration;
+static sem_t g_spinbench_startsem;
+static sem_t g_spinbench_donesem;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spinbench_tslock, spinbench_ticketlock, etc.
+ *
+ * Description:
+ *   Take and release the locks under test.
+ *
+ ****************************************************************************/
+
+static irqstate_t spinbench_tslock(void)
+{
+  return spin_lock_save(&g_spinbench_tslock);
+}
+
+static void spinbench_tsunlock(irqstate_t flags)
+{
+  spin_unlock_restore(&g_spinbench_tslock, flags);
+}
+
+static irqstate_t spinbench_ticketlock(void)
+{
+  return spin_ticket_lock_save(&g_spinbench_ticket);
+}
+
+static void spinbench_ticketunlock(irqstate_t flags)
+{
+  spin_ticket_unlock_restore(&g_spinbench_ticket, flags);
+}
+
+static void spinbench_csunlock(irqstate_t flags)
+{
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: spinbench_semwait
+ ****************************************************************************/
+
+static void spinbench_semwait(FAR sem_t *sem)
+{
+  while (nxsem_wait(sem) == -EINTR)
+    {
+    }
+}
+
+/****************************************************************************
+ * Name: spinbench_nsec
+ ****************************************************************************/
+
+static unsigned long spinbench_nsec(uint64_t elapsed)
+{
+  return (unsigned long)(elapsed * 1000000000ull / up_perf_getfreq());
+}
+
+/****************************************************************************
+ * Name: spinbench_worker
+ *
+ * Description:
+ *   The worker bound to one CPU.  Once all workers are ready, take and
+ *   release the lock under test until the duration has elapsed, doing
+ *   about the same work inside and outside of the lock.
+ *
+ ****************************************************************************/
+
+static int spinbench_worker(int argc, FAR char *argv[])
+{
+  FAR const struct spinbench_case_s *bcase;
+  FAR struct spinbench_cpu_s *result;
+  volatile int delay;
+  irqstate_t flags;
+  uint32_t waited;
+  uint32_t start;
+  int i;
+
+  for (; ; )
+    {
+      spinbench_semwait(&g_spinbench_startsem);
+
+      bcase  = g_spinbench_case;
+      result = &g_spinbench_cpu[up_cpu_index()];
+
+      /* Wait for the workers on the other CPUs.  The last one to arrive
+       * starts the clock.
+       */
+
+      flags = spin_lock_save(&g_spinbench_readylock);
+      if (++g_spinbench_nready == CONFIG_SMP_NCPUS)
+        {
+          g_spinbench_start = up_perf_gettime();
+          g_spinbench_go    = true;
+        }
+
+      spin_unlock_restore(&g_spinbench_readylock, flags);
+
+      while (!g_spinbench_go)
+        {
+        }
+
+      while (up_perf_gettime() - g_spinbench_start < g_spinbench_duration)
+        {
+          start  = up_perf_gettime();
+          flags  = bcase->lock();
+          waited = up_perf_gettime() - start;
+
+          g_spinbench_counter++;
+          for (i = 0; i < CONFIG_SIM_SPINBENCH_HOLD; i++)
+            {
+              g_spinbench_data[i]++;
+            }
+
+          bcase->unlock(flags);
+
+          result->nlocks++;
+          result->totwait += waited;
+          if (waited > result->maxwait)
+            {
+              result->maxwait = waited;
+            }
+
+          for (delay = 0; delay < CONFIG_SIM_SPINBENCH_HOLD; delay++)
+            {
+            }
+        }
+
+      nxsem_post(&g_spinbench_donesem);
+    }
+
+  return EXIT_SUCCESS;
+}
+
+/****************************************************************************
+ * Name: spinbench_run
+ ****************************************************************************/
+
+static void spinbench_run(FAR const struct spinbench_case_s *bcase)
+{
+  FAR struct spinbench_cpu_s *result;
+  uint64_t total = 0;
+  uint64_t totwait = 0;
+  uint32_t minlocks = UINT32_MAX;
+  uint32_t maxlocks = 0;
+  uint32_t maxwait = 0;
+  int cpu;
+
+  memset(g_spinbench_cpu, 0, sizeof(g_spinbench_cpu));
+  g_spinbench_counter = 0;
+  g_spinbench_nready  = 0;
+  g_spinbench_go      = false;
+  g_spinbench_case    = bcase;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      nxsem_post(&g_spinbench_startsem);
+    }
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      spinbench_semwait(&g_spinbench_donesem);
+    }
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      result   = &g_spinbench_cpu[cpu];
+      total   += result->nlocks;
+      totwait += result->totwait;
+
+      if (result->nlocks < minlocks)
+        {
+          minlocks = result->nlocks;
+        }
+
+      if (result->nlocks > maxlocks)
+        {
+          maxlocks = result->nlocks;
+        }
+
+      if (result->maxwait > maxwait)
+        {
+          maxwait = result->maxwait;
+        }
+
+      syslog(LOG_INFO,
+             "spinbench: %-8s cpu%d %10lu locks  avg wait %8lu ns  "
+             "max wait %10lu ns\n",
+             bcase->name, cpu, (unsigned long)result->nlocks,
+             spinbench_nsec(result->nlocks > 0 ?
+                            result->totwait / result->nlocks : 0),
+             spinbench_nsec(result->maxwait));
+    }
+
+  if (total != g_spinbench_counter)
+    {
+      syslog(LOG_ERR, "spinbench: %s counted %lu locks, expected %lu\n",
+             bcase->name, (unsigned long)g_spinbench_counter,
+             (unsigned long)total);
+    }
+
+  /* The fairness is the fewest acquisitions of any CPU relative to the
+   * most of any CPU, in percent.
+   */
+
+  syslog(LOG_INFO,
+         "spinbench: %-8s all  %10lu locks  avg wait %8lu ns  "
+         "max wait %10lu ns  fairness %lu%%\n",
+         bcase->name, (unsigned long)total,
+         spinbench_nsec(total > 0 ? totwait / total : 0),
+         spinbench_nsec(maxwait),
+         maxlocks > 0 ? (unsigned long)minlocks * 100 / maxlocks : 0);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sim_spinbench
+ *
+ * Description:
+ *   Run the spinlock benchmark on the calling thread.  The results are
+ *   written to the SYSLOG.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sim_spinbench(void)
+{
+  cpu_set_t cpuset;
+  pid_t pid;
+  int cpu;
+  int ret;
+  int i;
+
+  spin_initialize(&g_spinbench_tslock, SP_UNLOCKED);
+  spin_initialize(&g_spinbench_readylock, SP_UNLOCKED);
+  spin_ticket_initialize(&g_spinbench_ticket);
+  spin_ticket_register(&g_spinbench_ticket, "spinbench");
+
+  nxsem_init(&g_spinbench_startsem, 0, 0);
+  nxsem_init(&g_spinbench_donesem, 0, 0);
+  nxsem_setprotocol(&g_spinbench_startsem, SEM_PRIO_NONE);
+  nxsem_setprotocol(&g_spinbench_donesem, SEM_PRIO_NONE);
+
+  g_spinbench_duration = (uint32_t)((uint64_t)up_perf_getfreq() *
+                                    CONFIG_SIM_SPINBENCH_MSEC / 1000);
+
+  /* Start one worker bound to each CPU.  The workers have a lower priority
+   * than this thread so that they cannot keep it from starting a case.
+   */
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      pid = kthread_create("spinbench", CONFIG_SIM_BENCH_PRIORITY - 1,
+                           CONFIG_SIM_BENCH_STACKSIZE,
+                           (main_t)spinbench_worker, NULL);
+      if (pid < 0)
+        {
+          syslog(LOG_ERR, "spinbench: kthread_create failed: %d\n", pid);
+          return pid;
+        }
+
+      CPU_ZERO(&cpuset);
+      CPU_SET(cpu, &cpuset);
+
+      ret = nxsched_setaffinity(pid, sizeof(cpu_set_t), &cpuset);
+      if (ret < 0)
+        {
+          syslog(LOG_ERR, "spinbench: nxsched_setaffinity failed: %d\n",
+                 ret);
+          return ret;
+        }
+    }
+
+  syslog(LOG_INFO, "spinbench: %d CPUs, %d ms per lock, "
+         "%d words written while holding the lock\n",
+         CONFIG_SMP_NCPUS, CONFIG_SIM_SPINBENCH_MSEC,
+         CONFIG_SIM_SPINBENCH_HOLD);
+
+  for (i = 0; i < SPINBENCH_NITEMS(g_spinbench_cases); i++)
+    {
+      spinbench_run(&g_spinbench_cases[i]);
+    }
+
+  syslog(LOG_INFO, "spinbench: done\n");
+  return OK;
+}
+
+#endif /* CONFIG_SIM_SPINBENCH */
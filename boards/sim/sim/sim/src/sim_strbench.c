@@ -0,0 +1,415 @@
+/****************************************************************************
+ * boards/sim/sim/sim/src/sim_strbench.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <syslog.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+
+#include "sim.h"
+
+#ifdef CONFIG_SIM_STRBENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The largest copy measured and the room left for misaligning the source
+ * and destination.
+ */
+
+#define STRBENCH_MAXSIZE    4096
+#define STRBENCH_SLACK      16
+#define STRBENCH_BUFSIZE    (STRBENCH_MAXSIZE + 2 * STRBENCH_SLACK)
+
+#define STRBENCH_NITEMS(a)  (sizeof(a) / sizeof((a)[0]))
+
+/* Keep GCC from replacing the reference byte loops with calls to the very
+ * functions that they are compared against.
+ */
+
+#ifdef __GNUC__
+#  define STRBENCH_BYTELOOP \
+     __attribute__((noinline, optimize("no-tree-loop-distribute-patterns")))
+#else
+#  define STRBENCH_BYTELOOP
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Each operation is measured through a common signature.  For memset(),
+ * the source buffer is unused.
+ */
+
+typedef CODE void (*strbench_func_t)(FAR uint8_t *dest,
+                                     FAR const uint8_t *src, size_t n);
+
+struct strbench_op_s
+{
+  FAR const char *name;         /* Operation name used in the report */
+  strbench_func_t libc;         /* Calls the C library function */
+  strbench_func_t byte;         /* The reference byte loop */
+  bool overlap;                 /* Source and destination overlap */
+};
+
+struct strbench_align_s
+{
+  uint8_t dest;                 /* Destination offset from alignment */
+  uint8_t src;                  /* Source offset from alignment */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void strbench_memcpy(FAR uint8_t *dest, FAR const uint8_t *src,
+                            size_t n);
+static void strbench_memset(FAR uint8_t *dest, FAR const uint8_t *src,
+                            size_t n);
+static void strbench_memmove(FAR uint8_t *dest, FAR const uint8_t *src,
+                             size_t n);
+static void strbench_bytecpy(FAR uint8_t *dest, FAR const uint8_t *src,
+                             size_t n) STRBENCH_BYTELOOP;
+static void strbench_byteset(FAR uint8_t *dest, FAR const uint8_t *src,
+                             size_t n) STRBENCH_BYTELOOP;
+static void strbench_bytemove(FAR uint8_t *dest, FAR const uint8_t *src,
+                              size_t n) STRBENCH_BYTELOOP;
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct strbench_op_s g_strbench_ops[] =
+{
+  { "memcpy",  strbench_memcpy,  strbench_bytecpy,  false },
+  { "memset",  strbench_memset,  strbench_byteset,  false },
+  { "memmove", strbench_memmove, strbench_bytemove, true  },
+};
+
+static const size_t g_strbench_sizes[] =
+{
+  8, 32, 128, 512, 1500, STRBENCH_MAXSIZE
+};
+
+static const struct strbench_align_s g_strbench_aligns[] =
+{
+  {
+    0, 0
+  },
+  {
+    0, 1
+  },
+  {
+    3, 0
+  },
+  {
+    1, 7
+  }
+};
+
+/* The memmove() cases move within g_strbench_dest, towards its end, so
+ * that the backward copy is measured.  g_strbench_check receives the
+ * reference results.
+ */
+
+static uint8_t g_strbench_src[STRBENCH_BUFSIZE] aligned_data(16);
+static uint8_t g_strbench_dest[STRBENCH_BUFSIZE + STRBENCH_SLACK]
+  aligned_data(16);
+static uint8_t g_strbench_check[STRBENCH_BUFSIZE + STRBENCH_SLACK]
+  aligned_data(16);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: strbench_memcpy, strbench_memset, strbench_memmove
+ *
+ * Description:
+ *   Call the C library functions.
+ *
+ ****************************************************************************/
+
+static void strbench_memcpy(FAR uint8_t *dest, FAR const uint8_t *src,
+                            size_t n)
+{
+  memcpy(dest, src, n);
+}
+
+static void strbench_memset(FAR uint8_t *dest, FAR const uint8_t *src,
+                            size_t n)
+{
+  memset(dest, 0x5a, n);
+}
+
+static void strbench_memmove(FAR uint8_t *dest, FAR const uint8_t *src,
+                             size_t n)
+{
+  memmove(dest, src, n);
+}
+
+/****************************************************************************
+ * Name: strbench_bytecpy, strbench_byteset, strbench_bytemove
+ *
+ * Description:
+ *   The reference byte loops, as in the C library built for size.
+ *
+ ****************************************************************************/
+
+static void strbench_bytecpy(FAR uint8_t *dest, FAR const uint8_t *src,
+                             size_t n)
+{
+  while (n-- > 0)
+    {
+      *dest++ = *src++;
+    }
+}
+
+static void strbench_byteset(FAR uint8_t *dest, FAR const uint8_t *src,
+                             size_t n)
+{
+  while (n-- > 0)
+    {
+      *dest++ = 0x5a;
+    }
+}
+
+static void strbench_bytemove(FAR uint8_t *dest, FAR const uint8_t *src,
+                              size_t n)
+{
+  if (dest <= src)
+    {
+      while (n-- > 0)
+        {
+          *dest++ = *src++;
+        }
+    }
+  else
+    {
+      dest += n;
+      src  += n;
+
+      while (n-- > 0)
+        {
+          *--dest = *--src;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: strbench_time
+ *
+ * Description:
+ *   Call an operation count times and return the throughput in MB/s.
+ *
+ ****************************************************************************/
+
+static uint32_t strbench_rate(strbench_func_t func, FAR uint8_t *dest,
+                              FAR const uint8_t *src, size_t n,
+                              uint32_t count)
+{
+  uint64_t elapsed;
+  uint32_t start;
+  uint32_t i;
+
+  start = up_perf_gettime();
+  for (i = 0; i < count; i++)
+    {
+      func(dest, src, n);
+    }
+
+  elapsed = (uint32_t)(up_perf_gettime() - start);
+  elapsed = elapsed * 1000000000ull / up_perf_getfreq();
+  if (elapsed == 0)
+    {
+      elapsed = 1;
+    }
+
+  /* Bytes per nanosecond times 1000 is MB/s */
+
+  return (uint32_t)((uint64_t)n * count * 1000 / elapsed);
+}
+
+/****************************************************************************
+ * Name: strbench_verify
+ *
+ * Description:
+ *   Check that the C library function gives the same result as the byte
+ *   loop, including the bytes around the destination.
+ *
+ ****************************************************************************/
+
+static bool strbench_verify(FAR const struct strbench_op_s *op,
+                            FAR uint8_t *dest, FAR const uint8_t *src,
+                            size_t n)
+{
+  FAR uint8_t *check = g_strbench_check + (dest - g_strbench_dest);
+  FAR const uint8_t *csrc = src;
+  size_t i;
+
+  for (i = 0; i < sizeof(g_strbench_dest); i++)
+    {
+      g_strbench_dest[i]  = (uint8_t)(i * 7 + 1);
+      g_strbench_check[i] = (uint8_t)(i * 7 + 1);
+    }
+
+  if (op->overlap)
+    {
+      csrc = g_strbench_check + (src - g_strbench_dest);
+    }
+
+  op->libc(dest, src, n);
+  op->byte(check, csrc, n);
+
+  return memcmp(g_strbench_dest, g_strbench_check,
+                sizeof(g_strbench_dest)) == 0;
+}
+
+/****************************************************************************
+ * Name: strbench_run
+ ****************************************************************************/
+
+static void strbench_run(FAR const struct strbench_op_s *op, size_t n,
+                         FAR const struct strbench_align_s *align)
+{
+  FAR uint8_t *dest = g_strbench_dest + STRBENCH_SLACK + align->dest;
+  FAR const uint8_t *src;
+  uint32_t count;
+  uint32_t librate;
+  uint32_t byterate;
+
+  /* memmove() moves within the destination buffer, towards its end */
+
+  if (op->overlap)
+    {
+      src = g_strbench_dest + align->src;
+    }
+  else
+    {
+      src = g_strbench_src + align->src;
+    }
+
+  if (!strbench_verify(op, dest, src, n))
+    {
+      syslog(LOG_ERR, "strbench: %s size %lu align %u/%u MISMATCH\n",
+             op->name, (unsigned long)n, align->dest, align->src);
+      return;
+    }
+
+  /* Copy about the same number of bytes for every size */
+
+  count = CONFIG_SIM_STRBENCH_BYTES / n;
+  if (count == 0)
+    {
+      count = 1;
+    }
+
+  librate  = strbench_rate(op->libc, dest, src, n, count);
+  byterate = strbench_rate(op->byte, dest, src, n, count);
+  if (byterate == 0)
+    {
+      byterate = 1;
+    }
+
+  syslog(LOG_INFO,
+         "strbench: %-7s %5lu %u/%u  libc %6lu MB/s  byte %6lu MB/s  "
+         "x%lu.%02lu\n",
+         op->name, (unsigned long)n, align->dest, align->src,
+         (unsigned long)librate, (unsigned long)byterate,
+         (unsigned long)(librate / byterate),
+         (unsigned long)((librate % byterate) * 100 / byterate));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sim_strbench
+ *
+ * Description:
+ *   Run the string function benchmark on the calling thread.  The results
+ *   are written to the SYSLOG.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sim_strbench(void)
+{
+  int i;
+  int j;
+  int k;
+
+  for (i = 0; i < STRBENCH_BUFSIZE; i++)
+    {
+      g_strbench_src[i] = (uint8_t)(i * 13 + 5);
+    }
+
+  syslog(LOG_INFO, "strbench: %d bytes per case, "
+         "size dest/src alignment, throughput, speedup\n",
+         CONFIG_SIM_STRBENCH_BYTES);
+
+  for (i = 0; i < STRBENCH_NITEMS(g_strbench_ops); i++)
+    {
+      for (j = 0; j < STRBENCH_NITEMS(g_strbench_sizes); j++)
+        {
+          for (k = 0; k < STRBENCH_NITEMS(g_strbench_aligns); k++)
+            {
+              strbench_run(&g_strbench_ops[i], g_strbench_sizes[j],
+                           &g_strbench_aligns[k]);
+            }
+        }
+    }
+
+  syslog(LOG_INFO, "strbench: done\n");
+  return OK;
+}
+
+#endif /* CONFIG_SIM_STRBENCH */
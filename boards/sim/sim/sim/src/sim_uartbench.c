@@ -0,0 +1,414 @@
+/****************************************************************************
+ * boards/sim/sim/sim/src/sim_uartbench.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <syslog.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/serial/serial.h>
+
+#ifdef CONFIG_SERIAL_TERMIOS
+#  include <termios.h>
+#endif
+
+#include "sim.h"
+
+#ifdef CONFIG_SIM_UARTBENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define UARTBENCH_PATH      "/dev/ttyBENCH"
+#define UARTBENCH_MAXSIZE   1024
+#define UARTBENCH_LINELEN   64
+
+#define UARTBENCH_NITEMS(a) (sizeof(a) / sizeof((a)[0]))
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int  uartbench_setup(FAR struct uart_dev_s *dev);
+static void uartbench_shutdown(FAR struct uart_dev_s *dev);
+static int  uartbench_attach(FAR struct uart_dev_s *dev);
+static void uartbench_detach(FAR struct uart_dev_s *dev);
+static int  uartbench_ioctl(FAR struct file *filep, int cmd,
+                            unsigned long arg);
+static int  uartbench_receive(FAR struct uart_dev_s *dev,
+                              FAR unsigned int *status);
+static void uartbench_rxint(FAR struct uart_dev_s *dev, bool enable);
+static bool uartbench_rxavailable(FAR struct uart_dev_s *dev);
+#ifdef CONFIG_SERIAL_IFLOWCONTROL
+static bool uartbench_rxflowcontrol(FAR struct uart_dev_s *dev,
+                                    unsigned int nbuffered, bool upper);
+#endif
+#ifdef CONFIG_SERIAL_TXDMA
+static void uartbench_dmasend(FAR struct uart_dev_s *dev);
+static void uartbench_dmatxavail(FAR struct uart_dev_s *dev);
+#endif
+static void uartbench_send(FAR struct uart_dev_s *dev, int ch);
+static void uartbench_txint(FAR struct uart_dev_s *dev, bool enable);
+static bool uartbench_txready(FAR struct uart_dev_s *dev);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* A UART whose transmitter is always ready and discards what it is given.
+ * Enabling the TX interrupt drains the TX buffer at once, so the benchmark
+ * measures only the upper half of the serial driver.
+ */
+
+static const struct uart_ops_s g_uartbench_ops =
+{
+  .setup          = uartbench_setup,
+  .shutdown       = uartbench_shutdown,
+  .attach         = uartbench_attach,
+  .detach         = uartbench_detach,
+  .ioctl          = uartbench_ioctl,
+  .receive        = uartbench_receive,
+  .rxint          = uartbench_rxint,
+  .rxavailable    = uartbench_rxavailable,
+#ifdef CONFIG_SERIAL_IFLOWCONTROL
+  .rxflowcontrol  = uartbench_rxflowcontrol,
+#endif
+#ifdef CONFIG_SERIAL_TXDMA
+  .dmasend        = uartbench_dmasend,
+  .dmatxavail     = uartbench_dmatxavail,
+#endif
+  .send           = uartbench_send,
+  .txint          = uartbench_txint,
+  .txready        = uartbench_txready,
+  .txempty        = uartbench_txready,
+};
+
+static char g_uartbench_rxbuffer[16];
+static char g_uartbench_txbuffer[CONFIG_SIM_UARTBENCH_TXBUFSIZE];
+
+static uart_dev_t g_uartbench_dev =
+{
+  .recv =
+  {
+    .size   = sizeof(g_uartbench_rxbuffer),
+    .buffer = g_uartbench_rxbuffer,
+  },
+  .xmit =
+  {
+    .size   = sizeof(g_uartbench_txbuffer),
+    .buffer = g_uartbench_txbuffer,
+  },
+  .ops      = &g_uartbench_ops,
+};
+
+/* The bytes handed to the transmitter, to check the output */
+
+static size_t g_uartbench_nsent;
+
+static const size_t g_uartbench_sizes[] =
+{
+  1, 16, 64, 256, UARTBENCH_MAXSIZE
+};
+
+static char g_uartbench_raw[UARTBENCH_MAXSIZE];
+static char g_uartbench_text[UARTBENCH_MAXSIZE];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: uartbench_setup and friends
+ *
+ * Description:
+ *   The lower half of the benchmark UART.  There is no hardware, so most
+ *   methods do nothing.
+ *
+ ****************************************************************************/
+
+static int uartbench_setup(FAR struct uart_dev_s *dev)
+{
+  return OK;
+}
+
+static void uartbench_shutdown(FAR struct uart_dev_s *dev)
+{
+}
+
+static int uartbench_attach(FAR struct uart_dev_s *dev)
+{
+  return OK;
+}
+
+static void uartbench_detach(FAR struct uart_dev_s *dev)
+{
+}
+
+static int uartbench_ioctl(FAR struct file *filep, int cmd,
+                           unsigned long arg)
+{
+  return -ENOTTY;
+}
+
+static int uartbench_receive(FAR struct uart_dev_s *dev,
+                             FAR unsigned int *status)
+{
+  *status = 0;
+  return 0;
+}
+
+static void uartbench_rxint(FAR struct uart_dev_s *dev, bool enable)
+{
+}
+
+static bool uartbench_rxavailable(FAR struct uart_dev_s *dev)
+{
+  return false;
+}
+
+#ifdef CONFIG_SERIAL_IFLOWCONTROL
+static bool uartbench_rxflowcontrol(FAR struct uart_dev_s *dev,
+                                    unsigned int nbuffered, bool upper)
+{
+  return false;
+}
+#endif
+
+#ifdef CONFIG_SERIAL_TXDMA
+static void uartbench_dmasend(FAR struct uart_dev_s *dev)
+{
+  /* The transfer completes at once */
+
+  dev->dmatx.nbytes = dev->dmatx.length + dev->dmatx.nlength;
+  g_uartbench_nsent += dev->dmatx.nbytes;
+  uart_xmitchars_done(dev);
+}
+
+static void uartbench_dmatxavail(FAR struct uart_dev_s *dev)
+{
+  uart_xmitchars_dma(dev);
+}
+#endif
+
+static void uartbench_send(FAR struct uart_dev_s *dev, int ch)
+{
+  g_uartbench_nsent++;
+}
+
+static void uartbench_txint(FAR struct uart_dev_s *dev, bool enable)
+{
+  /* The transmitter is always ready:  The interrupt would fire at once */
+
+  if (enable)
+    {
+      uart_xmitchars(dev);
+    }
+}
+
+static bool uartbench_txready(FAR struct uart_dev_s *dev)
+{
+  return true;
+}
+
+/****************************************************************************
+ * Name: uartbench_run
+ *
+ * Description:
+ *   Write CONFIG_SIM_UARTBENCH_BYTES from 'data' in writes of 'size' bytes
+ *   and report the throughput.
+ *
+ ****************************************************************************/
+
+static int uartbench_run(int fd, FAR const char *name,
+                         FAR const char *data, size_t size, bool crs)
+{
+  size_t remaining = CONFIG_SIM_UARTBENCH_BYTES;
+  size_t expected = 0;
+  uint64_t elapsed = 0;
+  uint32_t start;
+  uint32_t rate;
+  ssize_t nwritten;
+
+  g_uartbench_nsent = 0;
+
+  while (remaining > 0)
+    {
+      start    = up_perf_gettime();
+      nwritten = write(fd, data, remaining < size ? remaining : size);
+      elapsed += (uint32_t)(up_perf_gettime() - start);
+
+      if (nwritten <= 0)
+        {
+          syslog(LOG_ERR, "uartbench: write failed: %d\n", errno);
+          return -errno;
+        }
+
+      /* Each write starts at the beginning of the data.  If CRs are
+       * inserted, there is one before every newline.
+       */
+
+      remaining -= nwritten;
+      expected  += nwritten;
+      if (crs)
+        {
+          expected += nwritten / UARTBENCH_LINELEN;
+        }
+    }
+
+  if (g_uartbench_nsent != expected)
+    {
+      syslog(LOG_ERR, "uartbench: %-4s %4lu sent %lu bytes, expected %lu\n",
+             name, (unsigned long)size, (unsigned long)g_uartbench_nsent,
+             (unsigned long)expected);
+      return -EIO;
+    }
+
+  elapsed = elapsed * 1000000000ull / up_perf_getfreq();
+  if (elapsed == 0)
+    {
+      elapsed = 1;
+    }
+
+  /* Bytes per nanosecond times 1000 is MB/s */
+
+  rate = (uint32_t)((uint64_t)CONFIG_SIM_UARTBENCH_BYTES * 1000 / elapsed);
+  syslog(LOG_INFO, "uartbench: %-4s %4lu  %6lu MB/s\n",
+         name, (unsigned long)size, (unsigned long)rate);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sim_uartbench
+ *
+ * Description:
+ *   Run the serial driver write benchmark on the calling thread.  The
+ *   results are written to the SYSLOG.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sim_uartbench(void)
+{
+  bool nlcr;
+  int ret;
+  int fd;
+  int i;
+
+#ifdef CONFIG_SERIAL_TERMIOS
+  /* Insert a CR before each newline, as on a console */
+
+  g_uartbench_dev.tc_oflag = OPOST | ONLCR;
+  nlcr = true;
+#else
+  /* Without termios, CRs are only inserted on the console */
+
+  nlcr = false;
+#endif
+
+  ret = uart_register(UARTBENCH_PATH, &g_uartbench_dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  fd = open(UARTBENCH_PATH, O_WRONLY);
+  if (fd < 0)
+    {
+      ret = -errno;
+      goto errout_with_driver;
+    }
+
+  /* The raw data has no newlines.  The text data has one at the end of
+   * every line.
+   */
+
+  for (i = 0; i < UARTBENCH_MAXSIZE; i++)
+    {
+      g_uartbench_raw[i]  = (char)('a' + i % 26);
+      g_uartbench_text[i] = (i % UARTBENCH_LINELEN) ==
+                            UARTBENCH_LINELEN - 1 ? '\n' : 'a' + i % 26;
+    }
+
+  syslog(LOG_INFO, "uartbench: %d bytes per case, %d byte TX buffer, "
+         "data, bytes per write, throughput\n",
+         CONFIG_SIM_UARTBENCH_BYTES, CONFIG_SIM_UARTBENCH_TXBUFSIZE);
+
+  for (i = 0; i < UARTBENCH_NITEMS(g_uartbench_sizes); i++)
+    {
+      ret = uartbench_run(fd, "raw", g_uartbench_raw,
+                          g_uartbench_sizes[i], false);
+      if (ret < 0)
+        {
+          goto errout_with_fd;
+        }
+
+      ret = uartbench_run(fd, "text", g_uartbench_text,
+                          g_uartbench_sizes[i], nlcr);
+      if (ret < 0)
+        {
+          goto errout_with_fd;
+        }
+    }
+
+  syslog(LOG_INFO, "uartbench: done\n");
+
+errout_with_fd:
+  close(fd);
+
+errout_with_driver:
+  unregister_driver(UARTBENCH_PATH);
+  return ret;
+}
+
+#endif /* CONFIG_SIM_UARTBENCH */
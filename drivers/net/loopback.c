@@ -78,6 +78,24 @@
 
 #define LO_WDDELAY   (1*CLK_TCK)
 
+/* Size of one packet buffer, rounded up to keep each buffer 16-bit
+ * aligned.
+ */
+
+#define LO_PKTBUFSIZE ((MAX_NETDEV_PKTSIZE + CONFIG_NET_GUARDSIZE + 1) & ~1)
+
+/* Poll with or without batching */
+
+#ifdef CONFIG_NETDEV_POLL_BATCH
+#  define LO_NPKTBUFS       CONFIG_NETDEV_POLL_BATCH_NPKTS
+#  define lo_devif_poll(p)  devif_poll_batch(&(p)->lo_dev, &(p)->lo_txbatch)
+#  define lo_devif_timer(p) devif_timer_batch(&(p)->lo_dev, &(p)->lo_txbatch)
+#else
+#  define LO_NPKTBUFS       1
+#  define lo_devif_poll(p)  devif_poll(&(p)->lo_dev, lo_txpoll)
+#  define lo_devif_timer(p) devif_timer(&(p)->lo_dev, lo_txpoll)
+#endif
+
 /* This is a helper pointer for accessing the contents of the Ethernet header */
 
 #define IPv4BUF ((FAR struct ipv4_hdr_s *)priv->lo_dev.d_buf)
@@ -98,6 +116,13 @@ struct lo_driver_s
   WDOG_ID lo_polldog;          /* TX poll timer */
   struct work_s lo_work;       /* For deferring poll work to the work queue */
 
+#ifdef CONFIG_NETDEV_POLL_BATCH
+  /* Transmit buffers filled by batched polling */
+
+  struct devif_txdesc_s lo_txdesc[LO_NPKTBUFS];
+  struct devif_txbatch_s lo_txbatch;
+#endif
+
   /* This holds the information visible to the NuttX network */
 
   struct net_driver_s lo_dev;  /* Interface understood by the network */
@@ -108,7 +133,7 @@ struct lo_driver_s
  ****************************************************************************/
 
 static struct lo_driver_s g_loopback;
-static uint8_t g_iobuffer[MAX_NETDEV_PKTSIZE + CONFIG_NET_GUARDSIZE];
+static uint8_t g_iobuffer[LO_NPKTBUFS][LO_PKTBUFSIZE];
 
 /****************************************************************************
  * Private Function Prototypes
@@ -117,6 +142,10 @@ static uint8_t g_iobuffer[MAX_NETDEV_PKTSIZE + CONFIG_NET_GUARDSIZE];
 /* Polling logic */
 
 static int  lo_txpoll(FAR struct net_driver_s *dev);
+#ifdef CONFIG_NETDEV_POLL_BATCH
+static int  lo_txflush(FAR struct net_driver_s *dev,
+                       FAR struct devif_txbatch_s *batch);
+#endif
 static void lo_poll_work(FAR void *arg);
 static void lo_poll_expiry(int argc, wdparm_t arg, ...);
 
@@ -209,6 +238,46 @@ static int lo_txpoll(FAR struct net_driver_s *dev)
   return 0;
 }
 
+/****************************************************************************
+ * Name: lo_txflush
+ *
+ * Description:
+ *   Loop back all of the packets queued by devif_poll_batch() or
+ *   devif_timer_batch().
+ *
+ * Input Parameters:
+ *   dev   - Reference to the NuttX driver state structure
+ *   batch - The batch of queued packets
+ *
+ * Returned Value:
+ *   Zero; polling always continues
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_POLL_BATCH
+static int lo_txflush(FAR struct net_driver_s *dev,
+                      FAR struct devif_txbatch_s *batch)
+{
+  int i;
+
+  for (i = 0; i < batch->tb_count; i++)
+    {
+      /* Each packet is received (and any response is generated) in its own
+       * transmit buffer.
+       */
+
+      dev->d_buf = batch->tb_desc[i].td_buf;
+      dev->d_len = batch->tb_desc[i].td_len;
+      (void)lo_txpoll(dev);
+    }
+
+  return 0;
+}
+#endif
+
 /****************************************************************************
  * Name: lo_poll_work
  *
@@ -234,7 +303,7 @@ static void lo_poll_work(FAR void *arg)
 
   net_lock();
   priv->lo_txdone = false;
-  (void)devif_timer(&priv->lo_dev, lo_txpoll);
+  (void)lo_devif_timer(priv);
 
   /* Was something received and looped back? */
 
@@ -243,7 +312,7 @@ static void lo_poll_work(FAR void *arg)
       /* Yes, poll again for more TX data */
 
       priv->lo_txdone = false;
-      (void)devif_poll(&priv->lo_dev, lo_txpoll);
+      (void)lo_devif_poll(priv);
     }
 
   /* Setup the watchdog poll timer again */
@@ -383,7 +452,7 @@ static void lo_txavail_work(FAR void *arg)
           /* If so, then poll the network for new XMIT data */
 
           priv->lo_txdone = false;
-          (void)devif_poll(&priv->lo_dev, lo_txpoll);
+          (void)lo_devif_poll(priv);
         }
       while (priv->lo_txdone);
     }
@@ -504,6 +573,9 @@ static int lo_rmmac(FAR struct net_driver_s *dev, FAR const uint8_t *mac)
 int localhost_initialize(void)
 {
   FAR struct lo_driver_s *priv;
+#ifdef CONFIG_NETDEV_POLL_BATCH
+  int i;
+#endif
 
   /* Get the interface structure associated with this interface number. */
 
@@ -519,9 +591,22 @@ int localhost_initialize(void)
   priv->lo_dev.d_addmac  = lo_addmac;    /* Add multicast MAC address */
   priv->lo_dev.d_rmmac   = lo_rmmac;     /* Remove multicast MAC address */
 #endif
-  priv->lo_dev.d_buf     = g_iobuffer;   /* Attach the IO buffer */
+  priv->lo_dev.d_buf     = g_iobuffer[0]; /* Attach the IO buffer */
   priv->lo_dev.d_private = (FAR void *)priv; /* Used to recover private state from dev */
 
+#ifdef CONFIG_NETDEV_POLL_BATCH
+  /* Provide all of the IO buffers for batched polling */
+
+  for (i = 0; i < LO_NPKTBUFS; i++)
+    {
+      priv->lo_txdesc[i].td_buf = g_iobuffer[i];
+    }
+
+  priv->lo_txbatch.tb_flush = lo_txflush;
+  priv->lo_txbatch.tb_desc  = priv->lo_txdesc;
+  priv->lo_txbatch.tb_ndesc = LO_NPKTBUFS;
+#endif
+
   /* Create a watchdog for timing polling for and timing of transmissions */
 
   priv->lo_polldog       = wd_create();  /* Create periodic poll timer */
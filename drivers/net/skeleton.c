@@ -218,7 +218,7 @@ static int  skel_ioctl(FAR struct net_driver_s *dev, int cmd,
  *   OK on success; a negated errno on failure
  *
  * Assumptions:
- *   The network is locked.
+ *   The device and the network are locked.
  *
  ****************************************************************************/
 
@@ -263,7 +263,7 @@ static int skel_transmit(FAR struct skel_driver_s *priv)
  *   OK on success; a negated errno on failure
  *
  * Assumptions:
- *   The network is locked.
+ *   The device and the network are locked.
  *
  ****************************************************************************/
 
@@ -338,7 +338,7 @@ static int skel_txpoll(FAR struct net_driver_s *dev)
  *   None
  *
  * Assumptions:
- *   The network is locked.
+ *   The device and the network are locked.
  *
  ****************************************************************************/
 
@@ -393,7 +393,8 @@ static void skel_reply(struct skel_driver_s *priv)
  *   None
  *
  * Assumptions:
- *   The network is locked.
+ *   The device is locked.  The network is locked here only while each
+ *   packet is given to the network.
  *
  ****************************************************************************/
 
@@ -411,6 +412,10 @@ static void skel_receive(FAR struct skel_driver_s *priv)
        * amount of data in priv->sk_dev.d_len
        */
 
+      /* Lock the network while the packet is processed */
+
+      net_lock();
+
 #ifdef CONFIG_NET_PKT
       /* When packet sockets are enabled, feed the frame into the packet tap */
 
@@ -481,6 +486,8 @@ static void skel_receive(FAR struct skel_driver_s *priv)
         {
           NETDEV_RXDROPPED(&priv->sk_dev);
         }
+
+      net_unlock();
     }
   while (); /* While there are more packets to be processed */
 }
@@ -498,7 +505,7 @@ static void skel_receive(FAR struct skel_driver_s *priv)
  *   None
  *
  * Assumptions:
- *   The network is locked.
+ *   The device is locked.
  *
  ****************************************************************************/
 
@@ -522,7 +529,9 @@ static void skel_txdone(FAR struct skel_driver_s *priv)
 
   /* In any event, poll the network for new TX data */
 
+  net_lock();
   (void)devif_poll(&priv->sk_dev, skel_txpoll);
+  net_unlock();
 }
 
 /****************************************************************************
@@ -546,13 +555,12 @@ static void skel_interrupt_work(FAR void *arg)
 {
   FAR struct skel_driver_s *priv = (FAR struct skel_driver_s *)arg;
 
-  /* Lock the network and serialize driver operations if necessary.
-   * NOTE: Serialization is only required in the case where the driver work
-   * is performed on an LP worker thread and where more than one LP worker
-   * thread has been configured.
+  /* Serialize driver operations.  The network is locked only while packets
+   * are passed to or from the network so that the work for other devices
+   * can proceed in parallel.
    */
 
-  net_lock();
+  netdev_lock(&priv->sk_dev);
 
   /* Process pending Ethernet interrupts */
 
@@ -570,7 +578,7 @@ static void skel_interrupt_work(FAR void *arg)
    */
 
   skel_txdone(priv);
-  net_unlock();
+  netdev_unlock(&priv->sk_dev);
 
   /* Re-enable Ethernet interrupts */
 
@@ -644,12 +652,11 @@ static void skel_txtimeout_work(FAR void *arg)
 {
   FAR struct skel_driver_s *priv = (FAR struct skel_driver_s *)arg;
 
-  /* Lock the network and serialize driver operations if necessary.
-   * NOTE: Serialization is only required in the case where the driver work
-   * is performed on an LP worker thread and where more than one LP worker
-   * thread has been configured.
+  /* Serialize driver operations, then lock the network.  The device lock
+   * must always be taken first.
    */
 
+  netdev_lock(&priv->sk_dev);
   net_lock();
 
   /* Increment statistics and dump debug info */
@@ -662,6 +669,7 @@ static void skel_txtimeout_work(FAR void *arg)
 
   (void)devif_poll(&priv->sk_dev, skel_txpoll);
   net_unlock();
+  netdev_unlock(&priv->sk_dev);
 }
 
 /****************************************************************************
@@ -721,12 +729,11 @@ static void skel_poll_work(FAR void *arg)
 {
   FAR struct skel_driver_s *priv = (FAR struct skel_driver_s *)arg;
 
-  /* Lock the network and serialize driver operations if necessary.
-   * NOTE: Serialization is only required in the case where the driver work
-   * is performed on an LP worker thread and where more than one LP worker
-   * thread has been configured.
+  /* Serialize driver operations, then lock the network.  The device lock
+   * must always be taken first.
    */
 
+  netdev_lock(&priv->sk_dev);
   net_lock();
 
   /* Perform the poll */
@@ -747,6 +754,7 @@ static void skel_poll_work(FAR void *arg)
   (void)wd_start(priv->sk_txpoll, skeleton_WDDELAY, skel_poll_expiry, 1,
                  (wdparm_t)priv);
   net_unlock();
+  netdev_unlock(&priv->sk_dev);
 }
 
 /****************************************************************************
@@ -898,12 +906,11 @@ static void skel_txavail_work(FAR void *arg)
 {
   FAR struct skel_driver_s *priv = (FAR struct skel_driver_s *)arg;
 
-  /* Lock the network and serialize driver operations if necessary.
-   * NOTE: Serialization is only required in the case where the driver work
-   * is performed on an LP worker thread and where more than one LP worker
-   * thread has been configured.
+  /* Serialize driver operations, then lock the network.  The device lock
+   * must always be taken first.
    */
 
+  netdev_lock(&priv->sk_dev);
   net_lock();
 
   /* Ignore the notification if the interface is not yet up */
@@ -918,6 +925,7 @@ static void skel_txavail_work(FAR void *arg)
     }
 
   net_unlock();
+  netdev_unlock(&priv->sk_dev);
 }
 
 /****************************************************************************
@@ -935,7 +943,8 @@ static void skel_txavail_work(FAR void *arg)
  *   None
  *
  * Assumptions:
- *   The network is locked.
+ *   The network is locked.  The device lock must not be taken here; that
+ *   would violate the lock ordering.
  *
  ****************************************************************************/
 
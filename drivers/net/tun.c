@@ -58,6 +58,7 @@
 #endif
 
 #include <nuttx/arch.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/irq.h>
 #include <nuttx/wdog.h>
 #include <nuttx/wqueue.h>
@@ -138,7 +139,6 @@ struct tun_device_s
   struct work_s     work;      /* For deferring poll work to the work queue */
   FAR struct file  *filep;
   FAR struct pollfd *poll_fds;
-  sem_t             waitsem;
   sem_t             read_wait_sem;
   size_t            read_d_len;
   size_t            write_d_len;
@@ -280,25 +280,18 @@ static void tundev_unlock(FAR struct tun_driver_s *tun)
 
 /****************************************************************************
  * Name: tun_lock
+ *
+ * Description:
+ *   Take the device lock.  It protects the packet buffers and the driver
+ *   state.  The network lock is taken after it, and only around the calls
+ *   into the network, so that copying packets to and from the application
+ *   does not hold up the rest of the network.
+ *
  ****************************************************************************/
 
 static void tun_lock(FAR struct tun_device_s *priv)
 {
-  int ret;
-
-  do
-    {
-      /* Take the semaphore (perhaps waiting) */
-
-      ret = nxsem_wait(&priv->waitsem);
-
-      /* The only case that an error should occur here is if the wait was
-       * awakened by a signal.
-       */
-
-      DEBUGASSERT(ret == OK || ret == -EINTR);
-    }
-  while (ret == -EINTR);
+  (void)netdev_lock(&priv->dev);
 }
 
 /****************************************************************************
@@ -307,7 +300,7 @@ static void tun_lock(FAR struct tun_device_s *priv)
 
 static void tun_unlock(FAR struct tun_device_s *priv)
 {
-  nxsem_post(&priv->waitsem);
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
@@ -329,7 +322,7 @@ static void tun_pollnotify(FAR struct tun_device_s *priv,
   if (eventset != 0)
     {
       fds->revents |= eventset;
-      nxsem_post(fds->sem);
+      poll_notify(fds);
     }
 }
 
@@ -1158,9 +1151,10 @@ static int tun_dev_init(FAR struct tun_device_s *priv, FAR struct file *filep,
 #endif
   priv->dev.d_private = (FAR void *)priv; /* Used to recover private state from dev */
 
-  /* Initialize the mutual exlcusion and wait semaphore */
+  /* Initialize the wait semaphore.  Mutual exclusion is provided by the
+   * device lock that is initialized by netdev_register().
+   */
 
-  nxsem_init(&priv->waitsem, 0, 1);
   nxsem_init(&priv->read_wait_sem, 0, 0);
 
   /* The wait semaphore is used for signaling and, hence, should not have
@@ -1185,7 +1179,6 @@ static int tun_dev_init(FAR struct tun_device_s *priv, FAR struct file *filep,
   ret = netdev_register(&priv->dev, tun ? NET_LL_TUN : NET_LL_ETHERNET);
   if (ret != OK)
     {
-      nxsem_destroy(&priv->waitsem);
       nxsem_destroy(&priv->read_wait_sem);
       return ret;
     }
@@ -1210,7 +1203,6 @@ static int tun_dev_uninit(FAR struct tun_device_s *priv)
 
   (void)netdev_unregister(&priv->dev);
 
-  nxsem_destroy(&priv->waitsem);
   nxsem_destroy(&priv->read_wait_sem);
 
   return OK;
@@ -1277,25 +1269,28 @@ static ssize_t tun_write(FAR struct file *filep, FAR const char *buffer,
       return -EBUSY;
     }
 
-  net_lock();
-
   if (buflen > CONFIG_NET_TUN_PKTSIZE)
     {
       ret = -EINVAL;
     }
   else
     {
+      /* Copy the packet under the device lock only.  The network is locked
+       * while the packet is processed.
+       */
+
       memcpy(priv->write_buf, buffer, buflen);
 
       priv->dev.d_buf = priv->write_buf;
       priv->dev.d_len = buflen;
 
+      net_lock();
       tun_net_receive(priv);
+      net_unlock();
 
       ret = (ssize_t)buflen;
     }
 
-  net_unlock();
   tun_unlock(priv);
 
   return ret;
@@ -1355,8 +1350,6 @@ static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
       tun_lock(priv);
     }
 
-  net_lock();
-
   read_d_len = priv->read_d_len;
   if (buflen < read_d_len)
     {
@@ -1368,9 +1361,14 @@ static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
       ret = (ssize_t)read_d_len;
     }
 
+  /* The read buffer is free again.  Lock the network only to poll it for
+   * new TX data.
+   */
+
   priv->read_d_len = 0;
-  tun_txdone(priv);
 
+  net_lock();
+  tun_txdone(priv);
   net_unlock();
 
 out:
@@ -45,6 +45,7 @@
 #include <sys/ioctl.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sched.h>
@@ -61,6 +62,7 @@
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/drivers/drivers.h>
 
 #include "pipe_common.h"
 
@@ -145,12 +147,466 @@ static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev,
           if (fds->revents != 0)
             {
               finfo("Report events: %02x\n", fds->revents);
-              nxsem_post(fds->sem);
+              poll_notify(fds);
             }
         }
     }
 }
 
+/****************************************************************************
+ * Name: pipecommon_wakeup
+ *
+ * Description:
+ *   Wake up all threads waiting on a reader or writer semaphore.
+ *
+ ****************************************************************************/
+
+static void pipecommon_wakeup(FAR sem_t *sem)
+{
+  int sval;
+
+  while (nxsem_getvalue(sem, &sval) == 0 && sval < 0)
+    {
+      nxsem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_rdspan and pipecommon_wrspan
+ *
+ * Description:
+ *   Return the number of bytes that can be read at d_rdndx (or written at
+ *   d_wrndx) without wrapping around the end of the buffer.  One byte of
+ *   the buffer is always left unused to tell a full buffer from an empty
+ *   one.
+ *
+ ****************************************************************************/
+
+static inline size_t pipecommon_rdspan(FAR struct pipe_dev_s *dev)
+{
+  if (dev->d_wrndx >= dev->d_rdndx)
+    {
+      return dev->d_wrndx - dev->d_rdndx;
+    }
+
+  return dev->d_bufsize - dev->d_rdndx;
+}
+
+static inline size_t pipecommon_wrspan(FAR struct pipe_dev_s *dev)
+{
+  if (dev->d_wrndx < dev->d_rdndx)
+    {
+      return dev->d_rdndx - dev->d_wrndx - 1;
+    }
+  else if (dev->d_rdndx == 0)
+    {
+      return dev->d_bufsize - dev->d_wrndx - 1;
+    }
+
+  return dev->d_bufsize - dev->d_wrndx;
+}
+
+/****************************************************************************
+ * Name: pipecommon_rdadvance and pipecommon_wradvance
+ *
+ * Description:
+ *   Advance the read (or write) index by 'n' bytes, wrapping to the
+ *   beginning of the buffer if necessary.
+ *
+ ****************************************************************************/
+
+static inline void pipecommon_rdadvance(FAR struct pipe_dev_s *dev,
+                                        size_t n)
+{
+  size_t ndx = dev->d_rdndx + n;
+
+  dev->d_rdndx = ndx >= dev->d_bufsize ? ndx - dev->d_bufsize : ndx;
+}
+
+static inline void pipecommon_wradvance(FAR struct pipe_dev_s *dev,
+                                        size_t n)
+{
+  size_t ndx = dev->d_wrndx + n;
+
+  dev->d_wrndx = ndx >= dev->d_bufsize ? ndx - dev->d_bufsize : ndx;
+}
+
+/****************************************************************************
+ * Name: pipecommon_copyout
+ *
+ * Description:
+ *   Copy up to 'len' bytes out of the pipe buffer.  This takes at most two
+ *   copies:  up to the end of the buffer, then from its beginning.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_copyout(FAR struct pipe_dev_s *dev,
+                                 FAR char *buffer, size_t len)
+{
+  size_t nread = 0;
+  size_t n;
+
+  while (nread < len && (n = pipecommon_rdspan(dev)) > 0)
+    {
+      if (n > len - nread)
+        {
+          n = len - nread;
+        }
+
+      memcpy(&buffer[nread], &dev->d_buffer[dev->d_rdndx], n);
+      pipecommon_rdadvance(dev, n);
+      nread += n;
+    }
+
+  return nread;
+}
+
+/****************************************************************************
+ * Name: pipecommon_copyin
+ *
+ * Description:
+ *   Copy up to 'len' bytes into the free space of the pipe buffer.  This
+ *   takes at most two copies:  up to the end of the buffer, then from its
+ *   beginning.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_copyin(FAR struct pipe_dev_s *dev,
+                                FAR const char *buffer, size_t len)
+{
+  size_t nwritten = 0;
+  size_t n;
+
+  while (nwritten < len && (n = pipecommon_wrspan(dev)) > 0)
+    {
+      if (n > len - nwritten)
+        {
+          n = len - nwritten;
+        }
+
+      memcpy(&dev->d_buffer[dev->d_wrndx], &buffer[nwritten], n);
+      pipecommon_wradvance(dev, n);
+      nwritten += n;
+    }
+
+  return nwritten;
+}
+
+/****************************************************************************
+ * Name: pipecommon_waitdata
+ *
+ * Description:
+ *   Wait until the pipe holds data.  Called with d_bfsem held.
+ *
+ * Returned Value:
+ *   A positive value if there is data to read; d_bfsem is still held.
+ *   Zero at end of file (no writers) or a negated errno value on failure;
+ *   d_bfsem has been released.
+ *
+ ****************************************************************************/
+
+static int pipecommon_waitdata(FAR struct file *filep,
+                               FAR struct pipe_dev_s *dev)
+{
+  int ret;
+
+  /* The pipe cannot be read while a splice is writing out of the buffer */
+
+  while (PIPE_IS_RDBUSY(dev->d_flags) || dev->d_wrndx == dev->d_rdndx)
+    {
+      /* If O_NONBLOCK was set, then return EGAIN */
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          nxsem_post(&dev->d_bfsem);
+          return -EAGAIN;
+        }
+
+      /* If there are no writers on the pipe, then return end of file */
+
+      if (!PIPE_IS_RDBUSY(dev->d_flags) && dev->d_nwriters <= 0)
+        {
+          nxsem_post(&dev->d_bfsem);
+          return 0;
+        }
+
+      /* Otherwise, wait for something to be written to the pipe */
+
+      sched_lock();
+      nxsem_post(&dev->d_bfsem);
+      ret = nxsem_wait(&dev->d_rdsem);
+      sched_unlock();
+
+      if (ret < 0 || (ret = nxsem_wait(&dev->d_bfsem)) < 0)
+        {
+          return ret;
+        }
+    }
+
+  return 1;
+}
+
+/****************************************************************************
+ * Name: pipecommon_spliceout
+ *
+ * Description:
+ *   Move up to 'len' bytes from the pipe to another file without copying
+ *   them through a user buffer.  Behaves like pipecommon_read() except
+ *   that the data is written from the pipe buffer to 'outfilep'.
+ *
+ *   d_bfsem is not held while writing to 'outfilep', so the write may block
+ *   without stalling writers of this pipe.  Instead, PIPE_FLAG_RDBUSY keeps
+ *   other readers away from the span being written until it is consumed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_PIPE_SPLICE
+static ssize_t pipecommon_spliceout(FAR struct file *filep,
+                                    FAR struct file *outfilep, size_t len)
+{
+  FAR struct pipe_dev_s *dev    = filep->f_inode->i_private;
+  FAR const uint8_t     *src;
+  ssize_t                nmoved = 0;
+  ssize_t                nwritten;
+  size_t                 n;
+  int                    ret;
+
+  ret = nxsem_wait(&dev->d_bfsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = pipecommon_waitdata(filep, dev);
+  if (ret <= 0)
+    {
+      return ret;
+    }
+
+  /* Write directly from the pipe buffer, one contiguous span at a time */
+
+  dev->d_flags |= PIPE_FLAG_RDBUSY;
+
+  while ((size_t)nmoved < len && (n = pipecommon_rdspan(dev)) > 0)
+    {
+      if (n > len - nmoved)
+        {
+          n = len - nmoved;
+        }
+
+      /* Writers only add data beyond d_wrndx, so the span stays valid
+       * while d_bfsem is released.
+       */
+
+      src = &dev->d_buffer[dev->d_rdndx];
+      nxsem_post(&dev->d_bfsem);
+      nwritten = file_write(outfilep, src, n);
+      pipecommon_semtake(&dev->d_bfsem);
+
+      if (nwritten <= 0)
+        {
+          ret = nwritten;
+          break;
+        }
+
+      pipecommon_rdadvance(dev, nwritten);
+      nmoved += nwritten;
+
+      /* Notify all waiting writers that bytes have been removed from the
+       * buffer and all poll/select waiters that they can write to the FIFO.
+       */
+
+      pipecommon_wakeup(&dev->d_wrsem);
+      pipecommon_pollnotify(dev, POLLOUT);
+
+      if ((size_t)nwritten < n)
+        {
+          break;
+        }
+    }
+
+  /* Let any readers that waited for the splice continue */
+
+  dev->d_flags &= ~PIPE_FLAG_RDBUSY;
+  pipecommon_wakeup(&dev->d_rdsem);
+
+  nxsem_post(&dev->d_bfsem);
+  return nmoved > 0 ? nmoved : ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: pipecommon_splicein
+ *
+ * Description:
+ *   Move up to 'len' bytes from another file into the pipe without copying
+ *   them through a user buffer.  The data is read from 'infilep' directly
+ *   into the free space of the pipe buffer.  Like a partial write, this
+ *   returns as soon as some data has been moved.
+ *
+ *   d_bfsem is not held while reading from 'infilep', so the read may block
+ *   without stalling readers of this pipe.  Instead, PIPE_FLAG_WRBUSY keeps
+ *   other writers away from the free space being filled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_PIPE_SPLICE
+static ssize_t pipecommon_splicein(FAR struct file *filep,
+                                   FAR struct file *infilep, size_t len)
+{
+  FAR struct pipe_dev_s *dev    = filep->f_inode->i_private;
+  FAR uint8_t           *dest;
+  ssize_t                nmoved = 0;
+  ssize_t                nread;
+  size_t                 n;
+  int                    ret;
+
+  if (dev->d_nreaders <= 0)
+    {
+      return -EPIPE;
+    }
+
+  ret = nxsem_wait(&dev->d_bfsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Wait for free space in the pipe buffer that no other splice is
+   * filling.
+   */
+
+  while (PIPE_IS_WRBUSY(dev->d_flags) || pipecommon_wrspan(dev) == 0)
+    {
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          nxsem_post(&dev->d_bfsem);
+          return -EAGAIN;
+        }
+
+      sched_lock();
+      nxsem_post(&dev->d_bfsem);
+      pipecommon_semtake(&dev->d_wrsem);
+      sched_unlock();
+      pipecommon_semtake(&dev->d_bfsem);
+    }
+
+  /* Read directly into the pipe buffer, one contiguous span at a time */
+
+  dev->d_flags |= PIPE_FLAG_WRBUSY;
+
+  while ((size_t)nmoved < len && (n = pipecommon_wrspan(dev)) > 0)
+    {
+      if (n > len - nmoved)
+        {
+          n = len - nmoved;
+        }
+
+      /* Readers only remove data before d_wrndx, so the free space stays
+       * valid while d_bfsem is released.
+       */
+
+      dest = &dev->d_buffer[dev->d_wrndx];
+      nxsem_post(&dev->d_bfsem);
+      nread = file_read(infilep, dest, n);
+      pipecommon_semtake(&dev->d_bfsem);
+
+      if (nread <= 0)
+        {
+          ret = nread;
+          break;
+        }
+
+      pipecommon_wradvance(dev, nread);
+      nmoved += nread;
+
+      /* Notify all waiting readers and poll/select waiters that more data
+       * is available.
+       */
+
+      pipecommon_wakeup(&dev->d_rdsem);
+      pipecommon_pollnotify(dev, POLLIN);
+
+      if ((size_t)nread < n)
+        {
+          break;
+        }
+    }
+
+  /* Let any writers that waited for the splice continue */
+
+  dev->d_flags &= ~PIPE_FLAG_WRBUSY;
+  pipecommon_wakeup(&dev->d_wrsem);
+
+  nxsem_post(&dev->d_bfsem);
+  return nmoved > 0 ? nmoved : ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: pipecommon_splice
+ *
+ * Description:
+ *   Handle the PIPEIOC_SPLICEIN and PIPEIOC_SPLICEOUT commands.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_PIPE_SPLICE
+static int pipecommon_splice(FAR struct file *filep, int cmd,
+                             FAR struct pipe_splice_s *splice)
+{
+  FAR struct file *other;
+  int ret;
+
+  if (splice == NULL)
+    {
+      return -EINVAL;
+    }
+
+  ret = fs_getfilep(splice->fd, &other);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Splicing a pipe to itself would deadlock on d_bfsem */
+
+  if (other->f_inode == filep->f_inode)
+    {
+      return -EINVAL;
+    }
+
+  if (splice->len == 0)
+    {
+      return 0;
+    }
+
+  if (splice->len > INT_MAX)
+    {
+      splice->len = INT_MAX;
+    }
+
+  if (cmd == PIPEIOC_SPLICEOUT)
+    {
+      if ((filep->f_oflags & O_RDOK) == 0)
+        {
+          return -EBADF;
+        }
+
+      return (int)pipecommon_spliceout(filep, other, splice->len);
+    }
+  else
+    {
+      if ((filep->f_oflags & O_WROK) == 0)
+        {
+          return -EBADF;
+        }
+
+      return (int)pipecommon_splicein(filep, other, splice->len);
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -423,8 +879,7 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 #ifdef CONFIG_DEV_PIPEDUMP
   FAR uint8_t           *start  = (FAR uint8_t *)buffer;
 #endif
-  ssize_t                nread  = 0;
-  int                    sval;
+  ssize_t                nread;
   int                    ret;
 
   DEBUGASSERT(dev);
@@ -444,57 +899,21 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
   /* If the pipe is empty, then wait for something to be written to it */
 
-  while (dev->d_wrndx == dev->d_rdndx)
+  ret = pipecommon_waitdata(filep, dev);
+  if (ret <= 0)
     {
-      /* If O_NONBLOCK was set, then return EGAIN */
-
-      if (filep->f_oflags & O_NONBLOCK)
-        {
-          nxsem_post(&dev->d_bfsem);
-          return -EAGAIN;
-        }
-
-      /* If there are no writers on the pipe, then return end of file */
-
-      if (dev->d_nwriters <= 0)
-        {
-          nxsem_post(&dev->d_bfsem);
-          return 0;
-        }
-
-      /* Otherwise, wait for something to be written to the pipe */
-
-      sched_lock();
-      nxsem_post(&dev->d_bfsem);
-      ret = nxsem_wait(&dev->d_rdsem);
-      sched_unlock();
-
-      if (ret < 0 || (ret = nxsem_wait(&dev->d_bfsem)) < 0)
-        {
-          return ret;
-        }
+      return ret;
     }
 
-  /* Then return whatever is available in the pipe (which is at least one byte) */
-
-  nread = 0;
-  while ((size_t)nread < len && dev->d_wrndx != dev->d_rdndx)
-    {
-      *buffer++ = dev->d_buffer[dev->d_rdndx];
-      if (++dev->d_rdndx >= dev->d_bufsize)
-        {
-          dev->d_rdndx = 0;
-        }
+  /* Then return whatever is available in the pipe (which is at least one
+   * byte).
+   */
 
-      nread++;
-    }
+  nread = pipecommon_copyout(dev, buffer, len);
 
   /* Notify all waiting writers that bytes have been removed from the buffer */
 
-  while (nxsem_getvalue(&dev->d_wrsem, &sval) == 0 && sval < 0)
-    {
-      nxsem_post(&dev->d_wrsem);
-    }
+  pipecommon_wakeup(&dev->d_wrsem);
 
   /* Notify all poll/select waiters that they can write to the FIFO */
 
@@ -516,8 +935,6 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct pipe_dev_s *dev      = inode->i_private;
   ssize_t                nwritten = 0;
   ssize_t                last;
-  int                    nxtwrndx;
-  int                    sval;
   int                    ret;
 
   DEBUGASSERT(dev);
@@ -569,86 +986,83 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
   last = 0;
   for (; ; )
     {
-      /* Calculate the write index AFTER the next byte is written */
+      /* Copy as much as will fit into the circular buffer, unless a splice
+       * is filling the free space.
+       */
 
-      nxtwrndx = dev->d_wrndx + 1;
-      if (nxtwrndx >= dev->d_bufsize)
+      if (!PIPE_IS_WRBUSY(dev->d_flags))
         {
-          nxtwrndx = 0;
+          nwritten += pipecommon_copyin(dev, &buffer[nwritten],
+                                        len - nwritten);
         }
 
-      /* Would the next write overflow the circular buffer? */
+      /* Is the write complete? */
 
-      if (nxtwrndx != dev->d_rdndx)
+      if ((size_t)nwritten >= len)
         {
-          /* No... copy the byte */
+          /* Yes.. Notify all of the waiting readers that more data is
+           * available.
+           */
 
-          dev->d_buffer[dev->d_wrndx] = *buffer++;
-          dev->d_wrndx = nxtwrndx;
+          pipecommon_wakeup(&dev->d_rdsem);
 
-          /* Is the write complete? */
+          /* Notify all poll/select waiters that they can read from the
+           * FIFO.
+           */
 
-          nwritten++;
-          if ((size_t)nwritten >= len)
-            {
-              /* Yes.. Notify all of the waiting readers that more data is available */
+          pipecommon_pollnotify(dev, POLLIN);
 
-              while (nxsem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
-                {
-                  nxsem_post(&dev->d_rdsem);
-                }
-
-              /* Notify all poll/select waiters that they can read from the FIFO */
+          /* Return the number of bytes written */
 
-              pipecommon_pollnotify(dev, POLLIN);
+          nxsem_post(&dev->d_bfsem);
+          return len;
+        }
 
-              /* Return the number of bytes written */
+      /* There is not enough room for the rest of the data.  Was anything
+       * written in this pass?
+       */
 
-              nxsem_post(&dev->d_bfsem);
-              return len;
-            }
-        }
-      else
+      if (last < nwritten)
         {
-          /* There is not enough room for the next byte.  Was anything written in this pass? */
-
-          if (last < nwritten)
-            {
-              /* Yes.. Notify all of the waiting readers that more data is available */
+          /* Yes.. Notify all of the waiting readers that more data is
+           * available.
+           */
 
-              while (nxsem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
-                {
-                  nxsem_post(&dev->d_rdsem);
-                }
+          pipecommon_wakeup(&dev->d_rdsem);
 
-              /* Notify all poll/select waiters that they can read from the FIFO */
+          /* Notify all poll/select waiters that they can read from the
+           * FIFO.
+           */
 
-              pipecommon_pollnotify(dev, POLLIN);
-            }
+          pipecommon_pollnotify(dev, POLLIN);
+        }
 
-          last = nwritten;
+      last = nwritten;
 
-          /* If O_NONBLOCK was set, then return partial bytes written or EGAIN */
+      /* If O_NONBLOCK was set, then return partial bytes written or
+       * EGAIN.
+       */
 
-          if (filep->f_oflags & O_NONBLOCK)
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          if (nwritten == 0)
             {
-              if (nwritten == 0)
-                {
-                  nwritten = -EAGAIN;
-                }
-
-              nxsem_post(&dev->d_bfsem);
-              return nwritten;
+              nwritten = -EAGAIN;
             }
 
-          /* There is more to be written.. wait for data to be removed from the pipe */
-
-          sched_lock();
           nxsem_post(&dev->d_bfsem);
-          pipecommon_semtake(&dev->d_wrsem);
-          sched_unlock();
-          pipecommon_semtake(&dev->d_bfsem);
+          return nwritten;
         }
+
+      /* There is more to be written.. wait for data to be removed from the
+       * pipe.
+       */
+
+      sched_lock();
+      nxsem_post(&dev->d_bfsem);
+      pipecommon_semtake(&dev->d_wrsem);
+      sched_unlock();
+      pipecommon_semtake(&dev->d_bfsem);
     }
 }
 
@@ -793,6 +1207,16 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     }
 #endif
 
+#ifdef CONFIG_DEV_PIPE_SPLICE
+  /* The splice commands manage d_bfsem themselves since they may block */
+
+  if (cmd == PIPEIOC_SPLICEIN || cmd == PIPEIOC_SPLICEOUT)
+    {
+      return pipecommon_splice(filep, cmd,
+                               (FAR struct pipe_splice_s *)((uintptr_t)arg));
+    }
+#endif
+
   pipecommon_semtake(&dev->d_bfsem);
 
   switch (cmd)
@@ -98,6 +98,8 @@
 
 #define PIPE_FLAG_POLICY    (1 << 0) /* Bit 0: Policy=Free buffer when empty */
 #define PIPE_FLAG_UNLINKED  (1 << 1) /* Bit 1: The driver has been unlinked */
+#define PIPE_FLAG_RDBUSY    (1 << 2) /* Bit 2: A splice is emptying the buffer */
+#define PIPE_FLAG_WRBUSY    (1 << 3) /* Bit 3: A splice is filling the buffer */
 
 #define PIPE_POLICY_0(f)    do { (f) &= ~PIPE_FLAG_POLICY; } while (0)
 #define PIPE_POLICY_1(f)    do { (f) |= PIPE_FLAG_POLICY; } while (0)
@@ -107,6 +109,9 @@
 #define PIPE_UNLINK(f)      do { (f) |= PIPE_FLAG_UNLINKED; } while (0)
 #define PIPE_IS_UNLINKED(f) (((f) & PIPE_FLAG_UNLINKED) != 0)
 
+#define PIPE_IS_RDBUSY(f)   (((f) & PIPE_FLAG_RDBUSY) != 0)
+#define PIPE_IS_WRBUSY(f)   (((f) & PIPE_FLAG_WRBUSY) != 0)
+
 
 /****************************************************************************
  * Public Types
@@ -808,7 +808,7 @@ static void max44009_notify(FAR struct max44009_dev_s *priv)
         {
           fds->revents |= POLLIN;
           max44009_dbg("Report events: %02x\n", fds->revents);
-          nxsem_post(fds->sem);
+          poll_notify(fds);
           priv->int_pending = false;
         }
     }
@@ -56,6 +56,7 @@
 #include <nuttx/sched.h>
 #include <nuttx/signal.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/serial/serial.h>
 #include <nuttx/fs/ioctl.h>
@@ -98,7 +99,14 @@ static void    uart_pollnotify(FAR uart_dev_t *dev, pollevent_t eventset);
 
 /* Write support */
 
+static size_t  uart_putxmitbuf(FAR uart_dev_t *dev, FAR const char *buffer,
+                               size_t buflen);
+static int     uart_waitxmit(FAR uart_dev_t *dev);
 static int     uart_putxmitchar(FAR uart_dev_t *dev, int ch, bool oktoblock);
+static ssize_t uart_putxmitrun(FAR uart_dev_t *dev, FAR const char *buffer,
+                               size_t buflen, bool oktoblock);
+static inline size_t uart_xmitrun(FAR uart_dev_t *dev, FAR const char *buffer,
+                                  size_t buflen);
 static inline ssize_t uart_irqwrite(FAR uart_dev_t *dev, FAR const char *buffer,
                                     size_t buflen);
 static int     uart_tcdrain(FAR uart_dev_t *dev, clock_t timeout);
@@ -196,181 +204,307 @@ static void uart_pollnotify(FAR uart_dev_t *dev, pollevent_t eventset)
 #endif
           if (fds->revents != 0)
             {
-              irqstate_t flags;
-              int semcount;
-
               finfo("Report events: %02x\n", fds->revents);
+              poll_notify(fds);
+            }
+        }
+    }
+}
 
-              /* Limit the number of times that the semaphore is posted.
-               * The critical section is needed to make the following
-               * operation atomic.
-               */
+/************************************************************************************
+ * Name: uart_putxmitbuf
+ *
+ * Description:
+ *   Copy as much of 'buffer' as will fit into the TX buffer without blocking.  This
+ *   takes at most two copies:  up to the end of the buffer, then from its beginning.
+ *
+ *   The TX buffer is a single-producer, single-consumer ring:  Only the writer
+ *   holding xmit.sem moves xmit.head and only uart_xmitchars() moves xmit.tail.  No
+ *   critical section is needed as long as the data is stored before the new head
+ *   is published.
+ *
+ * Returned Value:
+ *   The number of bytes copied into the TX buffer.
+ *
+ ************************************************************************************/
 
-              flags = enter_critical_section();
-              nxsem_getvalue(fds->sem, &semcount);
-              if (semcount < 1)
-                {
-                  nxsem_post(fds->sem);
-                }
+static size_t uart_putxmitbuf(FAR uart_dev_t *dev, FAR const char *buffer,
+                              size_t buflen)
+{
+  size_t nput = 0;
+  size_t n;
+  int head;
+  int tail;
 
-              leave_critical_section(flags);
-            }
+  head = dev->xmit.head;
+  tail = dev->xmit.tail;
+  SP_DMB();
+
+  while (nput < buflen)
+    {
+      /* Get the contiguous free space at the head, leaving one slot empty to
+       * tell a full buffer from an empty one.
+       */
+
+      if (head < tail)
+        {
+          n = tail - head - 1;
+        }
+      else if (tail == 0)
+        {
+          n = dev->xmit.size - head - 1;
+        }
+      else
+        {
+          n = dev->xmit.size - head;
         }
+
+      if (n == 0)
+        {
+          break;
+        }
+
+      if (n > buflen - nput)
+        {
+          n = buflen - nput;
+        }
+
+      memcpy(&dev->xmit.buffer[head], &buffer[nput], n);
+      nput += n;
+      head += n;
+
+      if (head >= dev->xmit.size)
+        {
+          head = 0;
+        }
+    }
+
+  if (nput > 0)
+    {
+      /* Publish the new data to uart_xmitchars() */
+
+      SP_DMB();
+      dev->xmit.head = head;
     }
+
+  return nput;
 }
 
 /************************************************************************************
- * Name: uart_putxmitchar
+ * Name: uart_waitxmit
+ *
+ * Description:
+ *   Wait for space in the full TX buffer.  DMA or the TX interrupt is started so
+ *   that the hardware drains the buffer.
+ *
+ * Returned Value:
+ *   OK when there is space in the TX buffer, -EINTR if the wait was interrupted by
+ *   a signal, or -ENOTCONN if a removable device was disconnected.
+ *
  ************************************************************************************/
 
-static int uart_putxmitchar(FAR uart_dev_t *dev, int ch, bool oktoblock)
+static int uart_waitxmit(FAR uart_dev_t *dev)
 {
   irqstate_t flags;
   int nexthead;
   int ret;
 
-#ifdef CONFIG_SMP
-  flags = enter_critical_section();
-#endif
-
-  /* Increment to see what the next head pointer will be.  We need to use the "next"
-   * head pointer to determine when the circular buffer would overrun
+  /* The following steps must be atomic with respect to serial interrupt
+   * handling.
    */
 
+  flags = enter_critical_section();
+
   nexthead = dev->xmit.head + 1;
   if (nexthead >= dev->xmit.size)
     {
       nexthead = 0;
     }
 
-  /* Loop until we are able to add the character to the TX buffer. */
+  /* Check again...  In certain race conditions an interrupt may have occurred
+   * before entering the critical section and the TX buffer may no longer be
+   * full.
+   *
+   * NOTE: On certain devices, such as USB CDC/ACM, the entire TX buffer may have
+   * been emptied in this race condition.  In that case, the logic would hang
+   * below waiting for space in the TX buffer without this test.
+   */
 
-  for (; ; )
+  if (nexthead != dev->xmit.tail)
     {
-      /* Check if the TX buffer is full */
-
-      if (nexthead != dev->xmit.tail)
-        {
-          /* No.. not full.  Add the character to the TX buffer and return. */
+      ret = OK;
+    }
 
-          dev->xmit.buffer[dev->xmit.head] = ch;
-          dev->xmit.head = nexthead;
-          ret = OK;
-          goto err_out;
-        }
+#ifdef CONFIG_SERIAL_REMOVABLE
+  /* Check if the removable device is no longer connected while we have
+   * interrupts off.  We do not want the transition to occur as a race condition
+   * before we begin the wait.
+   */
 
-      /* The TX buffer is full.  Should be block, waiting for the hardware
-       * to remove some data from the TX buffer?
-       */
+  else if (dev->disconnected)
+    {
+      ret = -ENOTCONN;
+    }
+#endif
+  else
+    {
+      /* Inform the interrupt level logic that we are waiting. */
 
-      else if (oktoblock)
-        {
-          /* The following steps must be atomic with respect to serial
-           * interrupt handling.
-           */
+      dev->xmitwaiting = true;
 
-          flags = enter_critical_section();
+      /* Wait for some characters to be sent from the buffer with the TX
+       * interrupt enabled.  When the TX interrupt is enabled, uart_xmitchars()
+       * should execute and remove some of the data from the TX buffer.
+       *
+       * NOTE that interrupts will be re-enabled while we wait for the
+       * semaphore.
+       */
 
-          /* Check again...  In certain race conditions an interrupt may
-           * have occurred between the test at the top of the loop and
-           * entering the critical section and the TX buffer may no longer
-           * be full.
-           *
-           * NOTE: On certain devices, such as USB CDC/ACM, the entire TX
-           * buffer may have been emptied in this race condition.  In that
-           * case, the logic would hang below waiting for space in the TX
-           * buffer without this test.
-           */
+#ifdef CONFIG_SERIAL_TXDMA
+      uart_dmatxavail(dev);
+#endif
+      uart_enabletxint(dev);
+      ret = uart_takesem(&dev->xmitsem, true);
+      uart_disabletxint(dev);
+    }
 
-          if (nexthead != dev->xmit.tail)
-            {
-              ret = OK;
-            }
+  leave_critical_section(flags);
 
 #ifdef CONFIG_SERIAL_REMOVABLE
-          /* Check if the removable device is no longer connected while we
-           * have interrupts off.  We do not want the transition to occur
-           * as a race condition before we begin the wait.
-           */
+  /* Check if the removable device was disconnected while we were waiting. */
 
-          else if (dev->disconnected)
-            {
-              ret = -ENOTCONN;
-            }
+  if (dev->disconnected)
+    {
+      return -ENOTCONN;
+    }
 #endif
-          else
-            {
-              /* Inform the interrupt level logic that we are waiting. */
 
-              dev->xmitwaiting = true;
+  /* Check if we were awakened by signal.  A signal received while waiting for
+   * the xmit buffer to become non-full will abort the transfer.
+   */
 
-              /* Wait for some characters to be sent from the buffer with
-               * the TX interrupt enabled.  When the TX interrupt is enabled,
-               * uart_xmitchars() should execute and remove some of the data
-               * from the TX buffer.
-               *
-               * NOTE that interrupts will be re-enabled while we wait for
-               * the semaphore.
-               */
+  return ret < 0 ? -EINTR : OK;
+}
 
-#ifdef CONFIG_SERIAL_TXDMA
-              uart_dmatxavail(dev);
-#endif
-              uart_enabletxint(dev);
-              ret = uart_takesem(&dev->xmitsem, true);
-              uart_disabletxint(dev);
-            }
+/************************************************************************************
+ * Name: uart_putxmitchar
+ ************************************************************************************/
 
-          leave_critical_section(flags);
+static int uart_putxmitchar(FAR uart_dev_t *dev, int ch, bool oktoblock)
+{
+  char c = ch;
+  int ret;
 
-#ifdef CONFIG_SERIAL_REMOVABLE
-          /* Check if the removable device was disconnected while we were
-           * waiting.
-           */
+  /* Loop until we are able to add the character to the TX buffer. */
 
-          if (dev->disconnected)
-            {
-              ret = -ENOTCONN;
-              goto err_out;
-            }
-#endif
-          /* Check if we were awakened by signal. */
+  while (uart_putxmitbuf(dev, &c, 1) == 0)
+    {
+      /* The TX buffer is full.  The caller may have requested that we not
+       * block for space.  Return the EAGAIN error to signal this situation.
+       */
 
-          if (ret < 0)
-            {
-              /* A signal received while waiting for the xmit buffer to become
-               * non-full will abort the transfer.
-               */
+      if (!oktoblock)
+        {
+          return -EAGAIN;
+        }
 
-              ret = -EINTR;
-              goto err_out;
-            }
+      /* Otherwise wait for the hardware to remove some data */
+
+      ret = uart_waitxmit(dev);
+      if (ret < 0)
+        {
+          return ret;
         }
+    }
 
-      /* The caller has request that we not block for data.  So return the
-       * EAGAIN error to signal this situation.
-       */
+  return OK;
+}
 
-      else
+/************************************************************************************
+ * Name: uart_putxmitrun
+ *
+ * Description:
+ *   Copy a run of characters that need no output post-processing into the TX
+ *   buffer, waiting for space if necessary.
+ *
+ * Returned Value:
+ *   The number of characters copied.  A negated errno value if none could be
+ *   copied; see uart_putxmitchar().
+ *
+ ************************************************************************************/
+
+static ssize_t uart_putxmitrun(FAR uart_dev_t *dev, FAR const char *buffer,
+                               size_t buflen, bool oktoblock)
+{
+  size_t nput = 0;
+  int ret;
+
+  for (; ; )
+    {
+      nput += uart_putxmitbuf(dev, &buffer[nput], buflen - nput);
+      if (nput >= buflen)
         {
-          ret = -EAGAIN;
-          goto err_out;
+          return nput;
+        }
+
+      ret = oktoblock ? uart_waitxmit(dev) : -EAGAIN;
+      if (ret < 0)
+        {
+          return nput > 0 ? (ssize_t)nput : ret;
         }
     }
+}
 
-  /* We won't get here.  Some compilers may complain that this code is
-   * unreachable.
-   */
+/************************************************************************************
+ * Name: uart_xmitrun
+ *
+ * Description:
+ *   Return the number of leading characters in 'buffer' that can be copied to the
+ *   TX buffer unchanged, i.e., that need no CR insertion or CR-to-NL mapping.
+ *
+ ************************************************************************************/
 
-  ret = OK;
+static inline size_t uart_xmitrun(FAR uart_dev_t *dev, FAR const char *buffer,
+                                  size_t buflen)
+{
+  bool crnl = false;
+  bool nlcr;
+  size_t i;
 
-err_out:
+#ifdef CONFIG_SERIAL_TERMIOS
+  if ((dev->tc_oflag & OPOST) == 0)
+    {
+      return buflen;
+    }
 
-#ifdef CONFIG_SMP
-  leave_critical_section(flags);
+  crnl = (dev->tc_oflag & OCRNL) != 0;
+  nlcr = (dev->tc_oflag & (ONLCR | ONLRET)) != 0;
+#else
+  nlcr = dev->isconsole;
 #endif
 
-  return ret;
+  if (!crnl)
+    {
+      FAR const char *nl;
+
+      if (!nlcr)
+        {
+          return buflen;
+        }
+
+      nl = memchr(buffer, '\n', buflen);
+      return nl != NULL ? (size_t)(nl - buffer) : buflen;
+    }
+
+  for (i = 0; i < buflen; i++)
+    {
+      if (buffer[i] == '\r' || (nlcr && buffer[i] == '\n'))
+        {
+          break;
+        }
+    }
+
+  return i;
 }
 
 /************************************************************************************
@@ -1083,6 +1217,8 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct inode *inode    = filep->f_inode;
   FAR uart_dev_t   *dev      = inode->i_private;
   ssize_t           nwritten = buflen;
+  ssize_t           nput;
+  size_t            run;
   bool              oktoblock;
   int               ret;
   char              ch;
@@ -1153,16 +1289,35 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
    */
 
   uart_disabletxint(dev);
-  for (; buflen; buflen--)
+  while (buflen > 0)
     {
-      ch  = *buffer++;
-      ret = OK;
+      /* Copy the run of characters that need no post-processing in bulk */
 
-#ifdef CONFIG_SERIAL_TERMIOS
-      /* Do output post-processing */
+      run = uart_xmitrun(dev, buffer, buflen);
+      if (run > 0)
+        {
+          nput = uart_putxmitrun(dev, buffer, run, oktoblock);
+          if (nput > 0)
+            {
+              buffer += nput;
+              buflen -= nput;
+            }
 
-      if ((dev->tc_oflag & OPOST) != 0)
+          if (nput == (ssize_t)run)
+            {
+              continue;
+            }
+
+          ret = nput < 0 ? (int)nput : -EAGAIN;
+        }
+      else
         {
+          /* The next character needs post-processing */
+
+          ch  = *buffer;
+          ret = OK;
+
+#ifdef CONFIG_SERIAL_TERMIOS
           /* Mapping CR to NL? */
 
           if ((ch == '\r') && (dev->tc_oflag & OCRNL) != 0)
@@ -1184,60 +1339,59 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
            * OLCUC  - Not specified by POSIX
            * ONOCR  - low-speed interactive optimization
            */
-        }
 
 #else /* !CONFIG_SERIAL_TERMIOS */
-      /* If this is the console, convert \n -> \r\n */
+          /* This is the console, convert \n -> \r\n */
 
-      if (dev->isconsole && ch == '\n')
-        {
           ret = uart_putxmitchar(dev, '\r', oktoblock);
-        }
 #endif
 
-      /* Put the character into the transmit buffer */
+          /* Put the character into the transmit buffer */
 
-      if (ret >= 0)
-        {
-          ret = uart_putxmitchar(dev, ch, oktoblock);
+          if (ret >= 0)
+            {
+              ret = uart_putxmitchar(dev, ch, oktoblock);
+            }
+
+          if (ret >= 0)
+            {
+              buffer++;
+              buflen--;
+              continue;
+            }
         }
 
-      /* uart_putxmitchar() might return an error under one of two
-       * conditions:  (1) The wait for buffer space might have been
-       * interrupted by a signal (ret should be -EINTR), (2) if
-       * CONFIG_SERIAL_REMOVABLE is defined, then uart_putxmitchar()
-       * might also return if the serial device was disconnected
-       * (with -ENOTCONN), or (3) if O_NONBLOCK is specified, then
-       * then uart_putxmitchar() might return -EAGAIN if the output
-       * TX buffer is full.
+      /* uart_putxmitchar() and uart_putxmitrun() might return an error under
+       * one of three conditions:  (1) The wait for buffer space might have
+       * been interrupted by a signal (ret should be -EINTR), (2) if
+       * CONFIG_SERIAL_REMOVABLE is defined, then they might also return if
+       * the serial device was disconnected (with -ENOTCONN), or (3) if
+       * O_NONBLOCK is specified, then they might return -EAGAIN if the
+       * output TX buffer is full.  A partial run is treated the same way.
+       *
+       * POSIX requires that we return -1 and errno set if no data was
+       * transferred.  Otherwise, we return the number of bytes in the
+       * interrupted transfer.
        */
 
-      if (ret < 0)
+      if (buflen < (size_t)nwritten)
         {
-          /* POSIX requires that we return -1 and errno set if no data was
-           * transferred.  Otherwise, we return the number of bytes in the
-           * interrupted transfer.
+          /* Some data was transferred.  Return the number of bytes that
+           * were successfully transferred.
            */
 
-          if (buflen < (size_t)nwritten)
-            {
-              /* Some data was transferred.  Return the number of bytes that
-               * were successfully transferred.
-               */
-
-              nwritten -= buflen;
-            }
-          else
-            {
-              /* No data was transferred. Return the negated errno value.
-               * The VFS layer will set the errno value appropriately).
-               */
-
-              nwritten = ret;
-            }
+          nwritten -= buflen;
+        }
+      else
+        {
+          /* No data was transferred. Return the negated errno value.
+           * The VFS layer will set the errno value appropriately).
+           */
 
-          break;
+          nwritten = ret;
         }
+
+      break;
     }
 
   if (dev->xmit.head != dev->xmit.tail)
@@ -44,6 +44,7 @@
 #include <semaphore.h>
 #include <debug.h>
 
+#include <nuttx/spinlock.h>
 #include <nuttx/serial/serial.h>
 
 #if defined(CONFIG_SERIAL_TXDMA) || defined(CONFIG_SERIAL_RXDMA)
@@ -152,18 +153,26 @@ static int uart_recvchars_signo(FAR uart_dev_t *dev)
 void uart_xmitchars_dma(FAR uart_dev_t *dev)
 {
   FAR struct uart_dmaxfer_s *xfer = &dev->dmatx;
+  int head;
 
-  if (dev->xmit.head == dev->xmit.tail)
+  /* uart_putxmitbuf() stores the data before it publishes the new head, so
+   * start the transfer only after reading the head.
+   */
+
+  head = dev->xmit.head;
+  SP_DMB();
+
+  if (head == dev->xmit.tail)
     {
       /* No data to transfer. */
 
       return;
     }
 
-  if (dev->xmit.tail < dev->xmit.head)
+  if (dev->xmit.tail < head)
     {
       xfer->buffer  = &dev->xmit.buffer[dev->xmit.tail];
-      xfer->length  = dev->xmit.head - dev->xmit.tail;
+      xfer->length  = head - dev->xmit.tail;
       xfer->nbuffer = NULL;
       xfer->nlength = 0;
     }
@@ -172,7 +181,7 @@ void uart_xmitchars_dma(FAR uart_dev_t *dev)
       xfer->buffer  = &dev->xmit.buffer[dev->xmit.tail];
       xfer->length  = dev->xmit.size - dev->xmit.tail;
       xfer->nbuffer = dev->xmit.buffer;
-      xfer->nlength = dev->xmit.head;
+      xfer->nlength = head;
     }
 
   uart_dmasend(dev);
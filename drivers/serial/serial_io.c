@@ -50,6 +50,7 @@
 #include <semaphore.h>
 #include <debug.h>
 
+#include <nuttx/spinlock.h>
 #include <nuttx/serial/serial.h>
 
 /****************************************************************************
@@ -71,28 +72,48 @@
 void uart_xmitchars(FAR uart_dev_t *dev)
 {
   uint16_t nbytes = 0;
+  int head;
+  int tail;
 
 #ifdef CONFIG_SMP
   irqstate_t flags = enter_critical_section();
 #endif
 
+  /* uart_putxmitbuf() stores the data before it publishes the new head, so
+   * read the data only after reading the head.
+   */
+
+  head = dev->xmit.head;
+  tail = dev->xmit.tail;
+  SP_DMB();
+
   /* Send while we still have data in the TX buffer & room in the fifo */
 
-  while (dev->xmit.head != dev->xmit.tail && uart_txready(dev))
+  while (head != tail && uart_txready(dev))
     {
       /* Send the next byte */
 
-      uart_send(dev, dev->xmit.buffer[dev->xmit.tail]);
+      uart_send(dev, dev->xmit.buffer[tail]);
       nbytes++;
 
       /* Increment the tail index */
 
-      if (++(dev->xmit.tail) >= dev->xmit.size)
+      if (++tail >= dev->xmit.size)
         {
-          dev->xmit.tail = 0;
+          tail = 0;
         }
     }
 
+  if (nbytes)
+    {
+      /* Finish reading the data before handing the space back to
+       * uart_putxmitbuf().
+       */
+
+      SP_DMB();
+      dev->xmit.tail = tail;
+    }
+
   /* When all of the characters have been sent from the buffer disable the TX
    * interrupt.
    *
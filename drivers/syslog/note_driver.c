@@ -40,10 +40,14 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <sched.h>
+#include <fcntl.h>
 #include <assert.h>
 #include <errno.h>
 
+#include <nuttx/clock.h>
+#include <nuttx/signal.h>
 #include <nuttx/sched_note.h>
 #include <nuttx/fs/fs.h>
 
@@ -56,6 +60,8 @@
 
 static ssize_t note_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
+static int     note_ioctl(FAR struct file *filep, int cmd,
+                 unsigned long arg);
 
 /****************************************************************************
  * Private Data
@@ -68,7 +74,7 @@ static const struct file_operations note_fops =
   note_read,     /* read */
   NULL,          /* write */
   NULL,          /* seek */
-  NULL,          /* ioctl */
+  note_ioctl,    /* ioctl */
   NULL           /* poll */
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   , 0            /* unlink */
@@ -91,6 +97,23 @@ static ssize_t note_read(FAR struct file *filep, FAR char *buffer,
 
   DEBUGASSERT(filep != 0 && buffer != NULL && buflen > 0);
 
+  /* In the streaming mode, wait for the next note.  The notes are added
+   * from deep within the scheduler where nothing can be signaled, so just
+   * check again on each clock tick.
+   */
+
+  if (filep->f_priv != NULL && (filep->f_oflags & O_NONBLOCK) == 0)
+    {
+      while (sched_note_size() == 0)
+        {
+          int ret = nxsig_usleep(USEC_PER_TICK);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
   /* Then loop, adding as many notes as possible to the user buffer. */
 
   retlen = 0;
@@ -139,6 +162,49 @@ static ssize_t note_read(FAR struct file *filep, FAR char *buffer,
   return retlen;
 }
 
+/****************************************************************************
+ * Name: note_ioctl
+ ****************************************************************************/
+
+static int note_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  int ret = OK;
+
+  switch (cmd)
+    {
+      /* Select the streaming mode.  The mode is kept in the private data
+       * of this open file so that each reader selects its own mode.
+       */
+
+      case NOTEIOC_STREAM:
+        filep->f_priv = (FAR void *)(uintptr_t)(arg != 0);
+        break;
+
+      /* Return the number of notes lost because the buffers were full */
+
+      case NOTEIOC_OVERFLOW:
+        {
+          FAR uint32_t *count = (FAR uint32_t *)((uintptr_t)arg);
+
+          if (count == NULL)
+            {
+              ret = -EINVAL;
+            }
+          else
+            {
+              *count = sched_note_overflow();
+            }
+        }
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -48,19 +48,33 @@
 #include <string.h>
 #include <fcntl.h>
 #include <lzf.h>
+#include <queue.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/dirent.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/fs/cromfs.h>
 
 #include "cromfs.h"
 
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_CROMFS)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Size of a cached block holding 'n' bytes of decompressed data */
+
+#ifdef CONFIG_CROMFS_CACHE
+#  define SIZEOF_CROMFS_CACHEBLOCK_S(n) \
+     (sizeof(struct cromfs_cacheblock_s) - 1 + (n))
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -75,6 +89,33 @@ struct cromfs_file_s
   FAR uint8_t *ff_buffer;                   /* Cached, decompressed data */
 };
 
+#ifdef CONFIG_CROMFS_CACHE
+/* This structure represents one decompressed block in the cache */
+
+struct cromfs_cacheblock_s
+{
+  dq_entry_t cb_link;                       /* Supports a doubly linked list */
+  uint32_t cb_offset;                       /* Offset of the compressed data */
+  uint16_t cb_ulen;                         /* Length of decompressed data */
+  uint8_t  cb_data[1];                      /* Decompressed data */
+};
+
+/* This structure represents the cache of decompressed blocks that is shared
+ * by all open files.
+ */
+
+struct cromfs_cache_s
+{
+  sem_t      cc_sem;                        /* Protects the cache */
+  dq_queue_t cc_lru;                        /* Blocks, most recent first */
+  size_t     cc_used;                       /* Memory used by cached blocks */
+  uint16_t   cc_nblocks;                    /* Number of cached blocks */
+  uint32_t   cc_hits;                       /* Statistics */
+  uint32_t   cc_misses;
+  uint32_t   cc_evictions;
+};
+#endif
+
 /* This is the form of the callback from cromfs_foreach_node(): */
 
 typedef CODE int (*cromfs_foreach_t)(FAR const struct cromfs_volume_s *fs,
@@ -114,6 +155,14 @@ static int      cromfs_comparenode(FAR const struct cromfs_volume_s *fs,
 static int      cromfs_findnode(FAR const struct cromfs_volume_s *fs,
                                 FAR const struct cromfs_node_s **node,
                                 FAR const char *relpath);
+#ifdef CONFIG_CROMFS_CACHE
+static int      cromfs_cache_read(FAR const struct cromfs_volume_s *fs,
+                                  FAR const uint8_t *src, uint16_t clen,
+                                  uint16_t ulen, FAR uint8_t *dest,
+                                  unsigned int copyoffs,
+                                  unsigned int copysize);
+static void     cromfs_cache_flush(void);
+#endif
 
 /* Common file system methods */
 
@@ -193,6 +242,21 @@ const struct mountpt_operations cromfs_operations =
 
 extern const struct cromfs_volume_s g_cromfs_image;
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_CROMFS_CACHE
+/* Since there is only a single CROMFS image, there is also only a single
+ * cache of decompressed blocks.
+ */
+
+static struct cromfs_cache_s g_cromfs_cache =
+{
+  SEM_INITIALIZER(1)
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -477,6 +541,150 @@ static int cromfs_findnode(FAR const struct cromfs_volume_s *fs,
     }
 }
 
+#ifdef CONFIG_CROMFS_CACHE
+/****************************************************************************
+ * Name: cromfs_cache_read
+ *
+ * Description:
+ *   Copy 'copysize' bytes, starting at offset 'copyoffs', of the
+ *   decompressed block whose compressed data begins at 'src' to 'dest'.
+ *   The block is decompressed into the cache if it is not already there,
+ *   discarding the least recently used blocks as necessary to stay within
+ *   CONFIG_CROMFS_CACHE_SIZE.
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value if the block could not be
+ *   cached.  In that case, the caller must decompress the block itself.
+ *
+ ****************************************************************************/
+
+static int cromfs_cache_read(FAR const struct cromfs_volume_s *fs,
+                             FAR const uint8_t *src, uint16_t clen,
+                             uint16_t ulen, FAR uint8_t *dest,
+                             unsigned int copyoffs, unsigned int copysize)
+{
+  FAR struct cromfs_cache_s *cache = &g_cromfs_cache;
+  FAR struct cromfs_cacheblock_s *block;
+  FAR struct cromfs_cacheblock_s *victim;
+  unsigned int decomplen;
+  uint32_t voloffs;
+  size_t blksize;
+  int ret;
+
+  voloffs = cromfs_addr2offset(fs, src);
+
+  ret = nxsem_wait_uninterruptible(&cache->cc_sem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Is the block already in the cache? */
+
+  for (block = (FAR struct cromfs_cacheblock_s *)dq_peek(&cache->cc_lru);
+       block != NULL;
+       block = (FAR struct cromfs_cacheblock_s *)dq_next(&block->cb_link))
+    {
+      if (block->cb_offset == voloffs)
+        {
+          break;
+        }
+    }
+
+  if (block != NULL)
+    {
+      /* Yes.. make it the most recently used block */
+
+      cache->cc_hits++;
+      dq_rem(&block->cb_link, &cache->cc_lru);
+      dq_addfirst(&block->cb_link, &cache->cc_lru);
+    }
+  else
+    {
+      cache->cc_misses++;
+
+      blksize = SIZEOF_CROMFS_CACHEBLOCK_S(ulen);
+      if (blksize > CONFIG_CROMFS_CACHE_SIZE)
+        {
+          ret = -ENOMEM;
+          goto errout_with_semaphore;
+        }
+
+      /* Discard the least recently used blocks until the new block fits */
+
+      while (cache->cc_used + blksize > CONFIG_CROMFS_CACHE_SIZE)
+        {
+          victim = (FAR struct cromfs_cacheblock_s *)
+                   dq_remlast(&cache->cc_lru);
+          DEBUGASSERT(victim != NULL);
+
+          cache->cc_used -= SIZEOF_CROMFS_CACHEBLOCK_S(victim->cb_ulen);
+          cache->cc_nblocks--;
+          cache->cc_evictions++;
+          kmm_free(victim);
+        }
+
+      block = (FAR struct cromfs_cacheblock_s *)kmm_malloc(blksize);
+      if (block == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout_with_semaphore;
+        }
+
+      decomplen = lzf_decompress(src, clen, block->cb_data, ulen);
+      if (decomplen != ulen)
+        {
+          kmm_free(block);
+          ret = -EIO;
+          goto errout_with_semaphore;
+        }
+
+      block->cb_offset = voloffs;
+      block->cb_ulen   = ulen;
+
+      dq_addfirst(&block->cb_link, &cache->cc_lru);
+      cache->cc_used += blksize;
+      cache->cc_nblocks++;
+    }
+
+  finfo("voloffs=%lu ulen=%u copyoffs=%u copysize=%u\n",
+        (unsigned long)voloffs, block->cb_ulen, copyoffs, copysize);
+  DEBUGASSERT(block->cb_ulen >= (copyoffs + copysize));
+
+  memcpy(dest, &block->cb_data[copyoffs], copysize);
+  ret = OK;
+
+errout_with_semaphore:
+  nxsem_post(&cache->cc_sem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cromfs_cache_flush
+ *
+ * Description:
+ *   Discard all cached blocks.
+ *
+ ****************************************************************************/
+
+static void cromfs_cache_flush(void)
+{
+  FAR struct cromfs_cache_s *cache = &g_cromfs_cache;
+  FAR dq_entry_t *block;
+
+  (void)nxsem_wait_uninterruptible(&cache->cc_sem);
+
+  while ((block = dq_remfirst(&cache->cc_lru)) != NULL)
+    {
+      kmm_free(block);
+    }
+
+  cache->cc_used    = 0;
+  cache->cc_nblocks = 0;
+  nxsem_post(&cache->cc_sem);
+}
+#endif /* CONFIG_CROMFS_CACHE */
+
 /****************************************************************************
  * Name: cromfs_open
  ****************************************************************************/
@@ -727,81 +935,113 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
         }
       else
         {
-          /* If the source of the data is at the beginning of the compressed
-           * data buffer and if the uncompressed data would not overrun the
-           * buffer, then we can decompress directly into the user buffer.
-           */
+#ifdef CONFIG_CROMFS_CACHE
+          /* Get the data from the shared cache of decompressed blocks */
+
+          copyoffs = (blkoffs >= filep->f_pos) ? 0 : filep->f_pos - blkoffs;
+          DEBUGASSERT(ulen > copyoffs);
+          copysize = ulen - copyoffs;
 
-          if (filep->f_pos <= blkoffs && ulen <= remaining)
+          if (copysize > remaining)  /* Clip to the size really needed */
             {
-              uint32_t voloffs;
+              copysize = remaining;
+            }
 
-              copyoffs = 0;
-              copysize = ulen;
+          /* The data is copied to the user buffer unless the block cannot
+           * be cached.  Then fall back to decompressing it as if there were
+           * no cache.
+           */
 
-              /* Get the address and offset in the CROMFS image to obtain
-               * the data.  Check if we already have this offset in the
-               * cache.
+          src = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
+          if (cromfs_cache_read(fs, src, clen, ulen, dest, copyoffs,
+                                copysize) < 0)
+#endif
+            {
+              /* If the source of the data is at the beginning of the
+               * compressed data buffer and if the uncompressed data would not
+               * overrun the buffer, then we can decompress directly into the
+               * user buffer.
                */
 
-              src     = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
+              if (filep->f_pos <= blkoffs && ulen <= remaining)
                 {
-                  unsigned int decomplen;
-
-                  decomplen = lzf_decompress(src, clen, dest, fs->cv_bsize);
-
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
+                  uint32_t voloffs;
+
+                  copyoffs = 0;
+                  copysize = ulen;
+
+                  /* Get the address and offset in the CROMFS image to obtain
+                   * the data.  Check if we already have this offset in the
+                   * cache.
+                   */
+
+                  src     = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
+                  voloffs = cromfs_addr2offset(fs, src);
+                  if (voloffs == ff->ff_offset)
+                    {
+                      /* The block is already decompressed in the file buffer */
+
+                      DEBUGASSERT(ff->ff_ulen >= copysize);
+                      memcpy(dest, ff->ff_buffer, copysize);
+                    }
+                  else
+                    {
+                      /* Decompress directly into the user buffer.  The
+                       * file buffer does not receive the data so ff_offset
+                       * must not be updated.
+                       */
+
+                      (void)lzf_decompress(src, clen, dest, ulen);
+                    }
+
+                  finfo("voloffs=%lu blkoffs=%lu ulen=%u ff_offset=%u "
+                        "copysize=%u\n",
+                        (unsigned long)voloffs, (unsigned long)blkoffs, ulen,
+                        ff->ff_offset, copysize);
                 }
+              else
+                {
+                  uint32_t voloffs;
 
-              finfo("voloffs=%lu blkoffs=%lu ulen=%u ff_offset=%u copysize=%u\n",
-                    (unsigned long)voloffs, (unsigned long)blkoffs, ulen,
-                    ff->ff_offset, copysize);
-              DEBUGASSERT(ff->ff_ulen >= copysize);
-            }
-          else
-            {
-              uint32_t voloffs;
-
-              /* No, we will need to decompress into the our intermediate
-               * decompression buffer.
-               */
+                  /* No, we will need to decompress into the our intermediate
+                   * decompression buffer.
+                   */
 
-              copyoffs = (blkoffs >= filep->f_pos) ? 0 : filep->f_pos - blkoffs;
-              DEBUGASSERT(ulen > copyoffs);
-              copysize = ulen - copyoffs;
+                  copyoffs = (blkoffs >= filep->f_pos) ?
+                             0 : filep->f_pos - blkoffs;
+                  DEBUGASSERT(ulen > copyoffs);
+                  copysize = ulen - copyoffs;
 
-              if (copysize > remaining)  /* Clip to the size really needed */
-                {
-                  copysize = remaining;
-                }
+                  if (copysize > remaining)  /* Clip to the size really needed */
+                    {
+                      copysize = remaining;
+                    }
 
-              DEBUGASSERT((copyoffs + copysize) <=  fs->cv_bsize);
+                  DEBUGASSERT((copyoffs + copysize) <=  fs->cv_bsize);
 
-              src = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
-                {
-                  unsigned int decomplen;
+                  src = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
+                  voloffs = cromfs_addr2offset(fs, src);
+                  if (voloffs != ff->ff_offset)
+                    {
+                      unsigned int decomplen;
 
-                  decomplen = lzf_decompress(src, clen, ff->ff_buffer,
-                                             fs->cv_bsize);
+                      decomplen = lzf_decompress(src, clen, ff->ff_buffer,
+                                                 fs->cv_bsize);
 
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
-                }
+                      ff->ff_offset = voloffs;
+                      ff->ff_ulen   = decomplen;
+                    }
 
-              finfo("voloffs=%lu blkoffs=%lu ulen=%u clen=%u ff_offset=%u "
-                    "copyoffs=%u copysize=%u\n",
-                    (unsigned long)voloffs, (unsigned long)blkoffs, ulen,
-                    clen, ff->ff_offset, copyoffs, copysize);
-              DEBUGASSERT(ff->ff_ulen >= (copyoffs + copysize));
+                  finfo("voloffs=%lu blkoffs=%lu ulen=%u clen=%u "
+                        "ff_offset=%u copyoffs=%u copysize=%u\n",
+                        (unsigned long)voloffs, (unsigned long)blkoffs, ulen,
+                        clen, ff->ff_offset, copyoffs, copysize);
+                  DEBUGASSERT(ff->ff_ulen >= (copyoffs + copysize));
 
-              /* Then copy to user buffer */
+                  /* Then copy to user buffer */
 
-              memcpy(dest, &ff->ff_buffer[copyoffs], copysize);
+                  memcpy(dest, &ff->ff_buffer[copyoffs], copysize);
+                }
             }
         }
 
@@ -826,7 +1066,38 @@ static int cromfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
   finfo("cmd: %d arg: %08lx\n", cmd, arg);
 
-  /* No IOCTL commands yet supported */
+#ifdef CONFIG_CROMFS_CACHE
+  if (cmd == FIOC_CACHESTATS)
+    {
+      FAR struct cromfs_cachestats_s *stats =
+        (FAR struct cromfs_cachestats_s *)((uintptr_t)arg);
+      FAR struct cromfs_cache_s *cache = &g_cromfs_cache;
+      int ret;
+
+      if (stats == NULL)
+        {
+          return -EINVAL;
+        }
+
+      ret = nxsem_wait_uninterruptible(&cache->cc_sem);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      stats->cs_hits      = cache->cc_hits;
+      stats->cs_misses    = cache->cc_misses;
+      stats->cs_evictions = cache->cc_evictions;
+      stats->cs_nblocks   = cache->cc_nblocks;
+      stats->cs_used      = cache->cc_used;
+      stats->cs_size      = CONFIG_CROMFS_CACHE_SIZE;
+
+      nxsem_post(&cache->cc_sem);
+      return OK;
+    }
+#endif
+
+  /* No other IOCTL commands are supported */
 
   return -ENOTTY;
 }
@@ -1131,6 +1402,13 @@ static int cromfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 {
   finfo("handle: %p blkdriver: %p flags: %02x\n",
         handle, blkdriver, flags);
+
+#ifdef CONFIG_CROMFS_CACHE
+  /* Release the memory held by the cache */
+
+  cromfs_cache_flush();
+#endif
+
   return OK;
 }
 
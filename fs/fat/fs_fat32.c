@@ -496,6 +496,14 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
   bool force_indirect = false;
 #endif
 
+#ifdef CONFIG_FAT_EXTENTCACHE
+  unsigned int clustersize;
+#ifndef CONFIG_FAT_FORCE_INDIRECT
+  unsigned int maxsectors;
+  int nclusters;
+#endif
+#endif
+
   /* Sanity checks */
 
   DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
@@ -569,6 +577,10 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
   readsize    = 0;
   sectorindex = filep->f_pos & SEC_NDXMASK(fs);
 
+#ifdef CONFIG_FAT_EXTENTCACHE
+  clustersize = fs->fs_fatsecperclus * fs->fs_hwsectorsize;
+#endif
+
   while (buflen > 0)
     {
       bytesread  = 0;
@@ -581,7 +593,12 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
         {
           /* Find the next cluster in the FAT. */
 
+#ifdef CONFIG_FAT_EXTENTCACHE
+          cluster = fat_extentnext(fs, ff, filep->f_pos / clustersize - 1,
+                                   ff->ff_currentcluster);
+#else
           cluster = fat_getcluster(fs, ff->ff_currentcluster);
+#endif
           if (cluster < 2 || cluster >= fs->fs_nclusters)
             {
               ret = -EINVAL; /* Not the right error */
@@ -618,7 +635,32 @@ fat_read_restart:
 
           if (nsectors > ff->ff_sectorsincluster)
             {
+#ifdef CONFIG_FAT_EXTENTCACHE
+              /* ... or in the following clusters if they are contiguous
+               * on the media.
+               */
+
+              nclusters = 1 + (nsectors - ff->ff_sectorsincluster +
+                               fs->fs_fatsecperclus - 1) /
+                              fs->fs_fatsecperclus;
+
+              nclusters = fat_extentmap(fs, ff, filep->f_pos / clustersize,
+                                        ff->ff_currentcluster, nclusters);
+              if (nclusters < 0)
+                {
+                  ret = nclusters;
+                  goto errout_with_semaphore;
+                }
+
+              maxsectors = ff->ff_sectorsincluster +
+                           (nclusters - 1) * fs->fs_fatsecperclus;
+              if (nsectors > maxsectors)
+                {
+                  nsectors = maxsectors;
+                }
+#else
               nsectors = ff->ff_sectorsincluster;
+#endif
             }
 
           /* We are not sure of the state of the file buffer so
@@ -652,7 +694,25 @@ fat_read_restart:
               goto errout_with_semaphore;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
+#ifdef CONFIG_FAT_EXTENTCACHE
+          if (nsectors > ff->ff_sectorsincluster)
+            {
+              /* The read continued into following clusters */
+
+              nclusters = (nsectors - ff->ff_sectorsincluster +
+                           fs->fs_fatsecperclus - 1) / fs->fs_fatsecperclus;
+
+              ff->ff_currentcluster   += nclusters;
+              ff->ff_sectorsincluster  = ff->ff_sectorsincluster +
+                                         nclusters * fs->fs_fatsecperclus -
+                                         nsectors;
+            }
+          else
+#endif
+            {
+              ff->ff_sectorsincluster -= nsectors;
+            }
+
           ff->ff_currentsector    += nsectors;
           bytesread                = nsectors * fs->fs_hwsectorsize;
         }
@@ -730,6 +790,10 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
   bool force_indirect = false;
 #endif
 
+#ifdef CONFIG_FAT_EXTENTCACHE
+  uint32_t fileclus;
+#endif
+
   /* Sanity checks.  I have seen the following assertion misfire if
    * CONFIG_DEBUG_MM is enabled while re-directing output to a
    * file.  In this case, the debug output can get generated while
@@ -848,6 +912,15 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
               goto errout_with_semaphore;
             }
 
+#ifdef CONFIG_FAT_EXTENTCACHE
+          /* Remember this step of the chain */
+
+          fileclus = filep->f_pos /
+                     (fs->fs_fatsecperclus * fs->fs_hwsectorsize);
+          fat_extentadd(ff, fileclus - 1, ff->ff_currentcluster);
+          fat_extentadd(ff, fileclus, cluster);
+#endif
+
           /* Setup to write the first sector from the new cluster */
 
           ff->ff_currentcluster   = cluster;
@@ -1027,6 +1100,10 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
   int32_t cluster;
   off_t position;
   unsigned int clustersize;
+#ifdef CONFIG_FAT_EXTENTCACHE
+  uint32_t fileclus;
+  uint32_t known;
+#endif
   int ret;
 
   /* Sanity checks */
@@ -1152,6 +1229,26 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
        */
 
       clustersize = fs->fs_fatsecperclus * fs->fs_hwsectorsize;
+
+#ifdef CONFIG_FAT_EXTENTCACHE
+      /* Start from the closest known cluster at or before the requested
+       * position rather than from the beginning of the chain.
+       */
+
+      fileclus = position / clustersize;
+      known    = fat_extentfind(ff, &fileclus);
+      if (known != 0)
+        {
+          cluster       = known;
+          filep->f_pos  = (off_t)fileclus * clustersize;
+          position     -= filep->f_pos;
+        }
+      else
+        {
+          fileclus = 0;
+        }
+#endif
+
       for (; ; )
         {
           /* Skip over clusters prior to the one containing
@@ -1187,7 +1284,11 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
             {
               /* Otherwise we can only follow the existing chain */
 
+#ifdef CONFIG_FAT_EXTENTCACHE
+              cluster = fat_extentnext(fs, ff, fileclus, cluster);
+#else
               cluster = fat_getcluster(fs, cluster);
+#endif
             }
 
           if (cluster < 0)
@@ -1218,6 +1319,13 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
               goto errout_with_semaphore;
             }
 
+#ifdef CONFIG_FAT_EXTENTCACHE
+          /* Remember this step of the chain */
+
+          fat_extentadd(ff, fileclus, ff->ff_currentcluster);
+          fat_extentadd(ff, ++fileclus, cluster);
+#endif
+
           /* Otherwise, update the position and continue looking */
 
           filep->f_pos += clustersize;
@@ -1514,6 +1622,10 @@ static int fat_dup(FAR const struct file *oldp, FAR struct file *newp)
   newff->ff_startcluster     = oldff->ff_startcluster;     /* Start cluster of file on media */
   newff->ff_currentsector    = oldff->ff_currentsector;    /* Current sector */
   newff->ff_cachesector      = 0;                          /* Sector in file buffer */
+#ifdef CONFIG_FAT_EXTENTCACHE
+  newff->ff_nextents         = oldff->ff_nextents;         /* Known cluster runs */
+  memcpy(newff->ff_extents, oldff->ff_extents, sizeof(newff->ff_extents));
+#endif
 
   /* Attach the private date to the struct file instance */
 
@@ -1800,6 +1912,12 @@ static int fat_truncate(FAR struct file *filep, off_t length)
           ret = fat_dirshrink(fs, direntry, length);
         }
 
+#ifdef CONFIG_FAT_EXTENTCACHE
+      /* Clusters have been removed from the chain */
+
+      fat_extentreset(ff);
+#endif
+
       if (ret >= 0)
         {
           /* The truncation has completed without error.  Update the file
@@ -2172,6 +2290,15 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
         }
     }
 
+#ifdef CONFIG_FAT_SECTORCACHE
+  /* Write any dirty sectors that are still in the sector cache */
+
+  if (fs->fs_cachebuffer)
+    {
+      (void)fat_fscachesync(fs);
+    }
+
+#endif
   /* Unmount ... close the block driver */
 
   if (fs->fs_blkdriver)
@@ -2199,10 +2326,18 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
   /* Release the mountpoint private data */
 
+#ifdef CONFIG_FAT_SECTORCACHE
+  if (fs->fs_cachebuffer)
+    {
+      fat_io_free(fs->fs_cachebuffer,
+                  FAT_CACHE_NSECTORS * fs->fs_hwsectorsize);
+    }
+#else
   if (fs->fs_buffer)
     {
       fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
     }
+#endif
 
   nxsem_destroy(&fs->fs_sem);
   kmm_free(fs);
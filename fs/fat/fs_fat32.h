@@ -863,6 +863,25 @@
 #  define fat_io_free(m,s) kmm_free(m)
 #endif
 
+/****************************************************************************
+ * Multi-sector cache
+ *
+ *   With CONFIG_FAT_SECTORCACHE, fs_buffer refers to one entry of an LRU
+ *   cache of CONFIG_FAT_SECTORCACHE_NSECTORS sectors.  fs_currentsector and
+ *   fs_dirty describe that entry.  The entry buffers are allocated as a
+ *   single block so that consecutive entries can be read ahead or written
+ *   back with one multi-sector transfer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_SECTORCACHE
+#  define FAT_CACHE_NSECTORS   CONFIG_FAT_SECTORCACHE_NSECTORS
+#  define FAT_CACHE_BUFFER(fs,i) \
+     (&(fs)->fs_cachebuffer[(i) * (fs)->fs_hwsectorsize])
+#else
+#  define fat_fscachesync(fs)  fat_fscacheflush(fs)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -873,6 +892,19 @@
  */
 
 struct fat_file_s;
+
+#ifdef CONFIG_FAT_SECTORCACHE
+/* One entry in the multi-sector cache */
+
+struct fat_cacheentry_s
+{
+  off_t    ce_sector;              /* The sector buffered in this entry */
+  uint32_t ce_stamp;               /* Time of the last access (for LRU) */
+  bool     ce_valid;               /* true: ce_sector is buffered */
+  bool     ce_dirty;               /* true: Must be written back */
+};
+#endif
+
 struct fat_mountpt_s
 {
   struct inode      *fs_blkdriver; /* The block driver inode that hosts the FAT32 fs */
@@ -901,6 +933,13 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one sector
                                     * from the device */
+#ifdef CONFIG_FAT_SECTORCACHE
+  uint8_t *fs_cachebuffer;         /* Buffers of all cache entries */
+  uint32_t fs_cachestamp;          /* LRU clock */
+  off_t    fs_cachenext;           /* Sector following the last cache miss */
+  uint8_t  fs_cachendx;            /* The entry that fs_buffer refers to */
+  struct fat_cacheentry_s fs_cache[FAT_CACHE_NSECTORS];
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -908,6 +947,17 @@ struct fat_mountpt_s
  * opened file.
  */
 
+#ifdef CONFIG_FAT_EXTENTCACHE
+/* One run of physically contiguous clusters of an open file */
+
+struct fat_extent_s
+{
+  uint32_t fe_fileclus;            /* Index of the first cluster in the file */
+  uint32_t fe_cluster;             /* Its cluster number on the media */
+  uint32_t fe_nclusters;           /* Number of contiguous clusters */
+};
+#endif
+
 struct fat_file_s
 {
   struct fat_file_s *ff_next;      /* Retained in a singly linked list */
@@ -922,6 +972,10 @@ struct fat_file_s
   off_t    ff_currentsector;       /* Current sector being operated on */
   off_t    ff_cachesector;         /* Current sector in the file buffer */
   uint8_t *ff_buffer;              /* File buffer (for partial sector accesses) */
+#ifdef CONFIG_FAT_EXTENTCACHE
+  uint8_t  ff_nextents;            /* Number of valid entries in ff_extents */
+  struct fat_extent_s ff_extents[CONFIG_FAT_EXTENTCACHE_NEXTENTS];
+#endif
 };
 
 /* This structure holds the sequence of directory entries used by one
@@ -1082,10 +1136,33 @@ EXTERN int    fat_remove(struct fat_mountpt_s *fs, const char *relpath, bool dir
 
 EXTERN int    fat_fscacheflush(struct fat_mountpt_s *fs);
 EXTERN int    fat_fscacheread(struct fat_mountpt_s *fs, off_t sector);
+#ifdef CONFIG_FAT_SECTORCACHE
+EXTERN void   fat_fscacheinit(struct fat_mountpt_s *fs);
+EXTERN int    fat_fscachesync(struct fat_mountpt_s *fs);
+EXTERN int    fat_fscachehwread(struct fat_mountpt_s *fs, off_t sector,
+                                unsigned int nsectors);
+EXTERN void   fat_fscachehwwrite(struct fat_mountpt_s *fs,
+                                 FAR const uint8_t *buffer, off_t sector, unsigned int nsectors);
+#endif
 EXTERN int    fat_ffcacheflush(struct fat_mountpt_s *fs, struct fat_file_s *ff);
 EXTERN int    fat_ffcacheread(struct fat_mountpt_s *fs, struct fat_file_s *ff, off_t sector);
 EXTERN int    fat_ffcacheinvalidate(struct fat_mountpt_s *fs, struct fat_file_s *ff);
 
+/* Cluster extent cache */
+
+#ifdef CONFIG_FAT_EXTENTCACHE
+EXTERN void   fat_extentreset(struct fat_file_s *ff);
+EXTERN void   fat_extentadd(struct fat_file_s *ff, uint32_t fileclus,
+                            uint32_t cluster);
+EXTERN uint32_t fat_extentfind(struct fat_file_s *ff,
+                               FAR uint32_t *fileclus);
+EXTERN off_t  fat_extentnext(struct fat_mountpt_s *fs, struct fat_file_s *ff,
+                             uint32_t fileclus, uint32_t cluster);
+EXTERN int    fat_extentmap(struct fat_mountpt_s *fs, struct fat_file_s *ff,
+                            uint32_t fileclus, uint32_t cluster,
+                            int maxclusters);
+#endif
+
 /* FSINFO sector support */
 
 EXTERN int    fat_updatefsinfo(struct fat_mountpt_s *fs);
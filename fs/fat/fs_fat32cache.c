@@ -0,0 +1,545 @@
+/****************************************************************************
+ * fs/fat/fs_fat32cache.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "fs_fat32.h"
+
+#ifdef CONFIG_FAT_SECTORCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FAT_ISFATSECTOR(fs,s) \
+  ((s) >= (fs)->fs_fatbase && (s) < (fs)->fs_fatbase + (fs)->fs_nfatsects)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fat_cachesave
+ *
+ * Description:
+ *   Update the current cache entry from fs_currentsector and fs_dirty.  The
+ *   FAT logic may change either directly, for example to reuse fs_buffer
+ *   for a new sector.  In that case, the current entry supersedes any other
+ *   copy of the same sector in the cache.
+ *
+ ****************************************************************************/
+
+static void fat_cachesave(FAR struct fat_mountpt_s *fs)
+{
+  FAR struct fat_cacheentry_s *entry = &fs->fs_cache[fs->fs_cachendx];
+  int i;
+
+  if (fs->fs_currentsector < 0)
+    {
+      entry->ce_valid = false;
+      entry->ce_dirty = false;
+      return;
+    }
+
+  entry->ce_sector = fs->fs_currentsector;
+  entry->ce_valid  = true;
+  entry->ce_dirty  = fs->fs_dirty;
+
+  for (i = 0; i < FAT_CACHE_NSECTORS; i++)
+    {
+      if (i != fs->fs_cachendx && fs->fs_cache[i].ce_valid &&
+          fs->fs_cache[i].ce_sector == entry->ce_sector)
+        {
+          fs->fs_cache[i].ce_valid = false;
+          fs->fs_cache[i].ce_dirty = false;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: fat_cacheselect
+ *
+ * Description:
+ *   Make a cache entry the one that fs_buffer refers to.
+ *
+ ****************************************************************************/
+
+static void fat_cacheselect(FAR struct fat_mountpt_s *fs, int ndx)
+{
+  FAR struct fat_cacheentry_s *entry = &fs->fs_cache[ndx];
+
+  fs->fs_cachendx      = ndx;
+  fs->fs_buffer        = FAT_CACHE_BUFFER(fs, ndx);
+  fs->fs_currentsector = entry->ce_sector;
+  fs->fs_dirty         = entry->ce_dirty;
+  entry->ce_stamp      = ++fs->fs_cachestamp;
+}
+
+/****************************************************************************
+ * Name: fat_cachevictim
+ *
+ * Description:
+ *   Select the cache entry to be replaced:  An unused entry if there is
+ *   one, otherwise the least recently used one.  The current entry is never
+ *   selected.
+ *
+ ****************************************************************************/
+
+static int fat_cachevictim(FAR struct fat_mountpt_s *fs)
+{
+  int victim = -1;
+  int i;
+
+  for (i = 0; i < FAT_CACHE_NSECTORS; i++)
+    {
+      if (i == fs->fs_cachendx)
+        {
+          continue;
+        }
+
+      if (!fs->fs_cache[i].ce_valid)
+        {
+          return i;
+        }
+
+      if (victim < 0 ||
+          (int32_t)(fs->fs_cache[i].ce_stamp -
+                    fs->fs_cache[victim].ce_stamp) < 0)
+        {
+          victim = i;
+        }
+    }
+
+  return victim;
+}
+
+/****************************************************************************
+ * Name: fat_cachewriteback
+ *
+ * Description:
+ *   Write 'nsectors' consecutive cache entries, starting with entry 'ndx',
+ *   back to the media.  The entries must hold consecutive sectors that lie
+ *   either all inside or all outside of the first FAT.  Sectors of the
+ *   first FAT are also written to each FAT copy.
+ *
+ ****************************************************************************/
+
+static int fat_cachewriteback(FAR struct fat_mountpt_s *fs, int ndx,
+                              int nsectors)
+{
+  FAR uint8_t *buffer = FAT_CACHE_BUFFER(fs, ndx);
+  off_t sector = fs->fs_cache[ndx].ce_sector;
+  int ret;
+  int i;
+
+  ret = fat_hwwrite(fs, buffer, sector, nsectors);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Does the sector lie in the FAT region? */
+
+  if (FAT_ISFATSECTOR(fs, sector))
+    {
+      /* Yes, then make the change in the FAT copy as well */
+
+      for (i = fs->fs_fatnumfats; i >= 2; i--)
+        {
+          sector += fs->fs_nfatsects;
+          ret = fat_hwwrite(fs, buffer, sector, nsectors);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  /* No longer dirty */
+
+  for (i = ndx; i < ndx + nsectors; i++)
+    {
+      fs->fs_cache[i].ce_dirty = false;
+      if (i == fs->fs_cachendx)
+        {
+          fs->fs_dirty = false;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_cachereadahead
+ *
+ * Description:
+ *   Return the number of sectors, starting with 'sector', that can be read
+ *   into consecutive cache entries starting with entry 'victim'.  Entries
+ *   beyond the victim are only reused if they are clean and the sectors to
+ *   be read are not cached already.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_SECTORCACHE_READAHEAD > 0
+static int fat_cachereadahead(FAR struct fat_mountpt_s *fs, int victim,
+                              off_t sector)
+{
+  int nsectors;
+  int i;
+
+  for (nsectors = 1;
+       nsectors <= CONFIG_FAT_SECTORCACHE_READAHEAD &&
+       victim + nsectors < FAT_CACHE_NSECTORS &&
+       sector + nsectors < fs->fs_hwnsectors;
+       nsectors++)
+    {
+      FAR struct fat_cacheentry_s *entry = &fs->fs_cache[victim + nsectors];
+
+      if (victim + nsectors == fs->fs_cachendx || entry->ce_dirty)
+        {
+          break;
+        }
+
+      for (i = 0; i < FAT_CACHE_NSECTORS; i++)
+        {
+          if (fs->fs_cache[i].ce_valid &&
+              fs->fs_cache[i].ce_sector == sector + nsectors)
+            {
+              return nsectors;
+            }
+        }
+    }
+
+  return nsectors;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fat_fscacheinit
+ *
+ * Description:
+ *   Initialize the sector cache after fs_cachebuffer has been allocated.
+ *   Nothing is cached.
+ *
+ ****************************************************************************/
+
+void fat_fscacheinit(struct fat_mountpt_s *fs)
+{
+  memset(fs->fs_cache, 0, sizeof(fs->fs_cache));
+
+  fs->fs_cachendx      = 0;
+  fs->fs_cachestamp    = 0;
+  fs->fs_cachenext     = -1;
+  fs->fs_buffer        = FAT_CACHE_BUFFER(fs, 0);
+  fs->fs_currentsector = -1;
+  fs->fs_dirty         = false;
+}
+
+/****************************************************************************
+ * Name: fat_fscacheflush
+ *
+ * Description:
+ *   Flush any dirty sector if fs_buffer as necessary
+ *
+ ****************************************************************************/
+
+int fat_fscacheflush(struct fat_mountpt_s *fs)
+{
+  fat_cachesave(fs);
+
+  if (fs->fs_cache[fs->fs_cachendx].ce_dirty)
+    {
+      return fat_cachewriteback(fs, fs->fs_cachendx, 1);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_fscachesync
+ *
+ * Description:
+ *   Write all dirty sectors in the cache back to the media.  The sectors are
+ *   written in ascending order and sectors that are adjacent both on the
+ *   media and in the cache are written with a single transfer.
+ *
+ ****************************************************************************/
+
+int fat_fscachesync(struct fat_mountpt_s *fs)
+{
+  uint8_t order[FAT_CACHE_NSECTORS];
+  int ndirty = 0;
+  int nsectors;
+  int ret;
+  int i;
+  int j;
+
+  fat_cachesave(fs);
+
+  /* Sort the dirty entries by sector number */
+
+  for (i = 0; i < FAT_CACHE_NSECTORS; i++)
+    {
+      if (fs->fs_cache[i].ce_dirty)
+        {
+          for (j = ndirty;
+               j > 0 && fs->fs_cache[order[j - 1]].ce_sector >
+                        fs->fs_cache[i].ce_sector;
+               j--)
+            {
+              order[j] = order[j - 1];
+            }
+
+          order[j] = i;
+          ndirty++;
+        }
+    }
+
+  /* Write back runs of adjacent entries */
+
+  for (i = 0; i < ndirty; i += nsectors)
+    {
+      FAR struct fat_cacheentry_s *first = &fs->fs_cache[order[i]];
+
+      for (nsectors = 1; i + nsectors < ndirty; nsectors++)
+        {
+          FAR struct fat_cacheentry_s *next =
+            &fs->fs_cache[order[i + nsectors]];
+
+          if (order[i + nsectors] != order[i] + nsectors ||
+              next->ce_sector != first->ce_sector + nsectors ||
+              FAT_ISFATSECTOR(fs, next->ce_sector) !=
+              FAT_ISFATSECTOR(fs, first->ce_sector))
+            {
+              break;
+            }
+        }
+
+      ret = fat_cachewriteback(fs, order[i], nsectors);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_fscacheread
+ *
+ * Description:
+ *   Read the specified sector into the sector cache, flushing any existing
+ *   dirty sectors as necessary.
+ *
+ ****************************************************************************/
+
+int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
+{
+  int nsectors;
+  int victim;
+  int ret;
+  int i;
+
+  /* fs->fs_currentsector holds the current sector that is buffered in
+   * fs->fs_buffer. If the requested sector is the same as this sector, then
+   * we do nothing.
+   */
+
+  if (fs->fs_currentsector == sector)
+    {
+      return OK;
+    }
+
+  fat_cachesave(fs);
+
+  /* Is the sector in some other cache entry? */
+
+  for (i = 0; i < FAT_CACHE_NSECTORS; i++)
+    {
+      if (fs->fs_cache[i].ce_valid && fs->fs_cache[i].ce_sector == sector)
+        {
+          fat_cacheselect(fs, i);
+          return OK;
+        }
+    }
+
+  /* No.. Replace the least recently used entry, writing it back first if it
+   * is dirty.
+   */
+
+  victim = fat_cachevictim(fs);
+  if (fs->fs_cache[victim].ce_dirty)
+    {
+      ret = fat_cachewriteback(fs, victim, 1);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  fs->fs_cache[victim].ce_valid = false;
+
+  /* Read ahead if this miss immediately follows the previous one */
+
+  nsectors = 1;
+#if CONFIG_FAT_SECTORCACHE_READAHEAD > 0
+  if (sector == fs->fs_cachenext)
+    {
+      nsectors = fat_cachereadahead(fs, victim, sector);
+    }
+#endif
+
+  for (i = victim + 1; i < victim + nsectors; i++)
+    {
+      fs->fs_cache[i].ce_valid = false;
+    }
+
+  ret = fat_hwread(fs, FAT_CACHE_BUFFER(fs, victim), sector, nsectors);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Update the entries.  The requested sector is the most recently used. */
+
+  for (i = nsectors - 1; i >= 0; i--)
+    {
+      FAR struct fat_cacheentry_s *entry = &fs->fs_cache[victim + i];
+
+      entry->ce_sector = sector + i;
+      entry->ce_valid  = true;
+      entry->ce_dirty  = false;
+      entry->ce_stamp  = ++fs->fs_cachestamp;
+    }
+
+  fs->fs_cachenext = sector + nsectors;
+  fat_cacheselect(fs, victim);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_fscachehwread
+ *
+ * Description:
+ *   Called by fat_hwread() before reading sectors from the media.  Dirty
+ *   cached copies of the sectors are written back first so that the media
+ *   is current.
+ *
+ ****************************************************************************/
+
+int fat_fscachehwread(struct fat_mountpt_s *fs, off_t sector,
+                      unsigned int nsectors)
+{
+  int ret;
+  int i;
+
+  fat_cachesave(fs);
+
+  for (i = 0; i < FAT_CACHE_NSECTORS; i++)
+    {
+      FAR struct fat_cacheentry_s *entry = &fs->fs_cache[i];
+
+      if (entry->ce_dirty && entry->ce_sector >= sector &&
+          entry->ce_sector < sector + nsectors)
+        {
+          ret = fat_cachewriteback(fs, i, 1);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_fscachehwwrite
+ *
+ * Description:
+ *   Called by fat_hwwrite() after writing sectors to the media from
+ *   'buffer'.  Cached copies of the sectors, other than the ones that were
+ *   just written, are out of date and are discarded.
+ *
+ ****************************************************************************/
+
+void fat_fscachehwwrite(struct fat_mountpt_s *fs, FAR const uint8_t *buffer,
+                        off_t sector, unsigned int nsectors)
+{
+  int i;
+
+  fat_cachesave(fs);
+
+  for (i = 0; i < FAT_CACHE_NSECTORS; i++)
+    {
+      FAR struct fat_cacheentry_s *entry = &fs->fs_cache[i];
+
+      if (entry->ce_valid && entry->ce_sector >= sector &&
+          entry->ce_sector < sector + nsectors &&
+          FAT_CACHE_BUFFER(fs, i) !=
+          &buffer[(entry->ce_sector - sector) * fs->fs_hwsectorsize])
+        {
+          entry->ce_valid = false;
+          entry->ce_dirty = false;
+
+          if (i == fs->fs_cachendx)
+            {
+              fs->fs_currentsector = -1;
+              fs->fs_dirty         = false;
+            }
+        }
+    }
+}
+
+#endif /* CONFIG_FAT_SECTORCACHE */
@@ -0,0 +1,357 @@
+/****************************************************************************
+ * fs_fat32extent.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "fs_fat32.h"
+
+#ifdef CONFIG_FAT_EXTENTCACHE
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fat_extentindex
+ *
+ * Description:
+ *   Return the index of the last extent that starts at or before file
+ *   cluster 'fileclus', or -1 if there is none.  ff_extents is sorted by
+ *   fe_fileclus.
+ *
+ ****************************************************************************/
+
+static int fat_extentindex(FAR struct fat_file_s *ff, uint32_t fileclus)
+{
+  int ndx;
+
+  for (ndx = ff->ff_nextents - 1; ndx >= 0; ndx--)
+    {
+      if (ff->ff_extents[ndx].fe_fileclus <= fileclus)
+        {
+          break;
+        }
+    }
+
+  return ndx;
+}
+
+/****************************************************************************
+ * Name: fat_extentremove
+ *
+ * Description:
+ *   Remove one extent from ff_extents.
+ *
+ ****************************************************************************/
+
+static void fat_extentremove(FAR struct fat_file_s *ff, int ndx)
+{
+  ff->ff_nextents--;
+  memmove(&ff->ff_extents[ndx], &ff->ff_extents[ndx + 1],
+          (ff->ff_nextents - ndx) * sizeof(struct fat_extent_s));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fat_extentreset
+ *
+ * Description:
+ *   Forget the cluster chain of the file.  This must be called whenever
+ *   clusters are removed from the chain.
+ *
+ ****************************************************************************/
+
+void fat_extentreset(struct fat_file_s *ff)
+{
+  ff->ff_nextents = 0;
+}
+
+/****************************************************************************
+ * Name: fat_extentadd
+ *
+ * Description:
+ *   Record that cluster number 'fileclus' of the file (counting from zero)
+ *   is stored in cluster 'cluster' of the media.  The entry is merged with
+ *   the adjacent extents when the clusters are contiguous.
+ *
+ ****************************************************************************/
+
+void fat_extentadd(struct fat_file_s *ff, uint32_t fileclus,
+                   uint32_t cluster)
+{
+  FAR struct fat_extent_s *extent;
+  FAR struct fat_extent_s *next;
+  int ndx;
+  int i;
+
+  ndx = fat_extentindex(ff, fileclus);
+  if (ndx >= 0)
+    {
+      extent = &ff->ff_extents[ndx];
+
+      if (fileclus < extent->fe_fileclus + extent->fe_nclusters)
+        {
+          /* Already known.  A mismatch means that the chain has changed
+           * underneath us, so discard everything that was recorded.
+           */
+
+          if (extent->fe_cluster + (fileclus - extent->fe_fileclus) ==
+              cluster)
+            {
+              return;
+            }
+
+          ff->ff_nextents = 0;
+          ndx = -1;
+        }
+      else if (fileclus == extent->fe_fileclus + extent->fe_nclusters &&
+               cluster == extent->fe_cluster + extent->fe_nclusters)
+        {
+          /* Append to the extent and merge it with the following one if
+           * they now touch.
+           */
+
+          extent->fe_nclusters++;
+
+          if (ndx + 1 < ff->ff_nextents)
+            {
+              next = &ff->ff_extents[ndx + 1];
+              if (next->fe_fileclus ==
+                  extent->fe_fileclus + extent->fe_nclusters &&
+                  next->fe_cluster ==
+                  extent->fe_cluster + extent->fe_nclusters)
+                {
+                  extent->fe_nclusters += next->fe_nclusters;
+                  fat_extentremove(ff, ndx + 1);
+                }
+            }
+
+          return;
+        }
+    }
+
+  /* Prepend to the following extent? */
+
+  if (ndx + 1 < ff->ff_nextents)
+    {
+      next = &ff->ff_extents[ndx + 1];
+      if (next->fe_fileclus == fileclus + 1 &&
+          next->fe_cluster == cluster + 1)
+        {
+          next->fe_fileclus = fileclus;
+          next->fe_cluster  = cluster;
+          next->fe_nclusters++;
+          return;
+        }
+    }
+
+  /* No.. a new extent is needed.  If the map is full, forget the shortest
+   * extent.
+   */
+
+  if (ff->ff_nextents >= CONFIG_FAT_EXTENTCACHE_NEXTENTS)
+    {
+      int victim = 0;
+
+      for (i = 1; i < ff->ff_nextents; i++)
+        {
+          if (ff->ff_extents[i].fe_nclusters <
+              ff->ff_extents[victim].fe_nclusters)
+            {
+              victim = i;
+            }
+        }
+
+      fat_extentremove(ff, victim);
+      if (victim <= ndx)
+        {
+          ndx--;
+        }
+    }
+
+  /* Insert the new extent after entry 'ndx' */
+
+  ndx++;
+  memmove(&ff->ff_extents[ndx + 1], &ff->ff_extents[ndx],
+          (ff->ff_nextents - ndx) * sizeof(struct fat_extent_s));
+
+  extent               = &ff->ff_extents[ndx];
+  extent->fe_fileclus  = fileclus;
+  extent->fe_cluster   = cluster;
+  extent->fe_nclusters = 1;
+  ff->ff_nextents++;
+}
+
+/****************************************************************************
+ * Name: fat_extentfind
+ *
+ * Description:
+ *   Find the known cluster of the file closest to, but not after, file
+ *   cluster '*fileclus'.
+ *
+ * Returned Value:
+ *   The cluster number on the media, with '*fileclus' updated to its index
+ *   in the file.  Zero if no cluster at or before '*fileclus' is known.
+ *
+ ****************************************************************************/
+
+uint32_t fat_extentfind(struct fat_file_s *ff, FAR uint32_t *fileclus)
+{
+  FAR struct fat_extent_s *extent;
+  uint32_t offset;
+  int ndx;
+
+  ndx = fat_extentindex(ff, *fileclus);
+  if (ndx < 0)
+    {
+      return 0;
+    }
+
+  extent = &ff->ff_extents[ndx];
+  offset = *fileclus - extent->fe_fileclus;
+  if (offset >= extent->fe_nclusters)
+    {
+      offset    = extent->fe_nclusters - 1;
+      *fileclus = extent->fe_fileclus + offset;
+    }
+
+  return extent->fe_cluster + offset;
+}
+
+/****************************************************************************
+ * Name: fat_extentnext
+ *
+ * Description:
+ *   Get the cluster that follows file cluster 'fileclus', which is stored
+ *   in 'cluster', in the chain.  The FAT is only read if the answer is not
+ *   already known.
+ *
+ * Returned Value:
+ *   The same as fat_getcluster().
+ *
+ ****************************************************************************/
+
+off_t fat_extentnext(struct fat_mountpt_s *fs, struct fat_file_s *ff,
+                     uint32_t fileclus, uint32_t cluster)
+{
+  uint32_t nextclus = fileclus + 1;
+  off_t next;
+
+  next = fat_extentfind(ff, &nextclus);
+  if (next != 0 && nextclus == fileclus + 1)
+    {
+      return next;
+    }
+
+  next = fat_getcluster(fs, cluster);
+  if (next >= 2 && next < fs->fs_nclusters)
+    {
+      fat_extentadd(ff, fileclus, cluster);
+      fat_extentadd(ff, fileclus + 1, next);
+    }
+
+  return next;
+}
+
+/****************************************************************************
+ * Name: fat_extentmap
+ *
+ * Description:
+ *   Determine how many clusters, up to 'maxclusters', are physically
+ *   contiguous starting with file cluster 'fileclus' which is stored in
+ *   'cluster'.  The FAT is consulted only for the part of the chain that
+ *   is not yet known; whatever is learned is recorded.
+ *
+ * Returned Value:
+ *   The number of contiguous clusters (at least one) or a negated errno
+ *   value on failure.
+ *
+ ****************************************************************************/
+
+int fat_extentmap(struct fat_mountpt_s *fs, struct fat_file_s *ff,
+                  uint32_t fileclus, uint32_t cluster, int maxclusters)
+{
+  uint32_t nextclus;
+  off_t next;
+  int ncontig;
+
+  fat_extentadd(ff, fileclus, cluster);
+
+  for (ncontig = 1; ncontig < maxclusters; ncontig++)
+    {
+      nextclus = fileclus + ncontig;
+      next     = fat_extentfind(ff, &nextclus);
+
+      if (next == 0 || nextclus != fileclus + ncontig)
+        {
+          /* Not known yet.. get it from the FAT */
+
+          next = fat_getcluster(fs, cluster + ncontig - 1);
+          if (next < 0)
+            {
+              return next;
+            }
+          else if (next < 2 || next >= fs->fs_nclusters)
+            {
+              break;
+            }
+
+          fat_extentadd(ff, fileclus + ncontig, next);
+        }
+
+      if (next != cluster + ncontig)
+        {
+          break;
+        }
+    }
+
+  return ncontig;
+}
+
+#endif /* CONFIG_FAT_EXTENTCACHE */
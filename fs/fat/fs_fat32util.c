@@ -549,6 +549,19 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   fs->fs_hwsectorsize = geo.geo_sectorsize;
   fs->fs_hwnsectors   = geo.geo_nsectors;
 
+#ifdef CONFIG_FAT_SECTORCACHE
+  /* Allocate the sector cache.  fs_buffer refers to one of its entries. */
+
+  fs->fs_cachebuffer = (FAR uint8_t *)
+    fat_io_alloc(FAT_CACHE_NSECTORS * fs->fs_hwsectorsize);
+  if (!fs->fs_cachebuffer)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  fat_fscacheinit(fs);
+#else
   /* Allocate a buffer to hold one hardware sector */
 
   fs->fs_buffer = (FAR uint8_t *)fat_io_alloc(fs->fs_hwsectorsize);
@@ -557,6 +570,7 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
       ret = -ENOMEM;
       goto errout;
     }
+#endif
 
   /* Search FAT boot record on the drive.  First check the MBR at sector
    * zero.  This could be either the boot record or a partition that refers
@@ -685,7 +699,13 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   return OK;
 
 errout_with_buffer:
+#ifdef CONFIG_FAT_SECTORCACHE
+  fat_io_free(fs->fs_cachebuffer,
+              FAT_CACHE_NSECTORS * fs->fs_hwsectorsize);
+  fs->fs_cachebuffer = NULL;
+#else
   fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
+#endif
   fs->fs_buffer = 0;
 
 errout:
@@ -754,8 +774,25 @@ int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
       struct inode *inode = fs->fs_blkdriver;
       if (inode && inode->u.i_bops && inode->u.i_bops->read)
         {
-          ssize_t nsectorsread = inode->u.i_bops->read(inode, buffer,
-                                                       sector, nsectors);
+          ssize_t nsectorsread;
+
+#ifdef CONFIG_FAT_SECTORCACHE
+          /* Make sure that the media holds any dirty cached sectors */
+
+          if (fs->fs_cachebuffer != NULL)
+            {
+              ret = fat_fscachehwread(fs, sector, nsectors);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+
+              ret = -ENODEV;
+            }
+#endif
+
+          nsectorsread = inode->u.i_bops->read(inode, buffer, sector,
+                                               nsectors);
           if (nsectorsread == nsectors)
             {
               ret = OK;
@@ -790,6 +827,15 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
           ssize_t nsectorswritten =
               inode->u.i_bops->write(inode, buffer, sector, nsectors);
 
+#ifdef CONFIG_FAT_SECTORCACHE
+          /* Discard any cached sectors that are now stale */
+
+          if (fs->fs_cachebuffer != NULL)
+            {
+              fat_fscachehwwrite(fs, buffer, sector, nsectors);
+            }
+#endif
+
           if (nsectorswritten == nsectors)
             {
               ret = OK;
@@ -1768,6 +1814,7 @@ int fat_dirextend(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
   return OK;
 }
 
+#ifndef CONFIG_FAT_SECTORCACHE
 /****************************************************************************
  * Name: fat_fscacheflush
  *
@@ -1867,6 +1914,7 @@ int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
 
   return OK;
 }
+#endif /* !CONFIG_FAT_SECTORCACHE */
 
 /****************************************************************************
  * Name: fat_ffcacheflush
@@ -1997,9 +2045,9 @@ int fat_updatefsinfo(struct fat_mountpt_s *fs)
 {
   int ret;
 
-  /* Flush the fs_buffer if it is dirty */
+  /* Flush the fs_buffer and any other cached sectors if they are dirty */
 
-  ret = fat_fscacheflush(fs);
+  ret = fat_fscachesync(fs);
   if (ret == OK)
     {
       /* The FSINFO sector only has to be update for the case of a FAT32 file
@@ -80,6 +80,10 @@ int file_close(FAR struct file *filep)
 
   if (inode)
     {
+      /* Remove the file from any epoll interest list */
+
+      epoll_detach(filep);
+
       /* Close the file, driver, or mountpoint. */
 
       if (inode->u.i_ops && inode->u.i_ops->close)
@@ -83,8 +83,10 @@ extern const struct procfs_operations critmon_operations;
 extern const struct procfs_operations meminfo_operations;
 extern const struct procfs_operations iobinfo_operations;
 extern const struct procfs_operations module_operations;
+extern const struct procfs_operations spinlock_operations;
 extern const struct procfs_operations uptime_operations;
 extern const struct procfs_operations version_operations;
+extern const struct procfs_operations wqueue_operations;
 
 /* This is not good.  These are implemented in other sub-systems.  Having to
  * deal with them here is not a good coupling. What is really needed is a
@@ -124,7 +126,8 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "[0-9]*",        &proc_operations,            PROCFS_DIR_TYPE    },
 #endif
 
-#if defined(CONFIG_SCHED_CPULOAD) && !defined(CONFIG_FS_PROCFS_EXCLUDE_CPULOAD)
+#if (defined(CONFIG_SCHED_CPULOAD) || defined(CONFIG_SCHED_SCHEDSTAT)) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_CPULOAD)
   { "cpuload",       &cpuload_operations,         PROCFS_FILE_TYPE   },
 #endif
 
@@ -182,6 +185,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "self/**",       &proc_operations,            PROCFS_UNKOWN_TYPE },
 #endif
 
+#if defined(CONFIG_SPINLOCK_STATS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SPINLOCK)
+  { "spinlock",      &spinlock_operations,        PROCFS_FILE_TYPE   },
+#endif
+
 #if !defined(CONFIG_FS_PROCFS_EXCLUDE_UPTIME)
   { "uptime",        &uptime_operations,          PROCFS_FILE_TYPE   },
 #endif
@@ -189,6 +196,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
 #if !defined(CONFIG_FS_PROCFS_EXCLUDE_VERSION)
   { "version",       &version_operations,         PROCFS_FILE_TYPE   },
 #endif
+
+#if defined(CONFIG_SCHED_HPWORK_PERCPU) && !defined(CONFIG_FS_PROCFS_EXCLUDE_WQUEUE)
+  { "wqueue",        &wqueue_operations,          PROCFS_FILE_TYPE   },
+#endif
 };
 
 #ifdef CONFIG_FS_PROCFS_REGISTER
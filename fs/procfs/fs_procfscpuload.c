@@ -60,17 +60,32 @@
 #include <nuttx/fs/procfs.h>
 
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
-#if defined(CONFIG_SCHED_CPULOAD) && !defined(CONFIG_FS_PROCFS_EXCLUDE_CPULOAD)
+#if (defined(CONFIG_SCHED_CPULOAD) || defined(CONFIG_SCHED_SCHEDSTAT)) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_CPULOAD)
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
 /* Determines the size of an intermediate buffer that must be large enough
- * to handle the longest line generated by this logic.
+ * to handle the longest line generated by this logic.  With
+ * CONFIG_SCHED_SCHEDSTAT, the buffer also holds one line with the IDLE and
+ * interrupt times of each CPU.
  */
 
-#define CPULOAD_LINELEN 16
+#define CPULOAD_TOTALLEN 16
+
+#ifdef CONFIG_SCHED_SCHEDSTAT
+#  ifdef CONFIG_SMP
+#    define CPULOAD_NCPUS CONFIG_SMP_NCPUS
+#  else
+#    define CPULOAD_NCPUS 1
+#  endif
+#  define CPULOAD_CPULEN  64
+#  define CPULOAD_LINELEN (CPULOAD_TOTALLEN + CPULOAD_NCPUS * CPULOAD_CPULEN)
+#else
+#  define CPULOAD_LINELEN CPULOAD_TOTALLEN
+#endif
 
 /****************************************************************************
  * Private Types
@@ -224,10 +239,19 @@ static ssize_t cpuload_read(FAR struct file *filep, FAR char *buffer,
 
   if (filep->f_pos == 0)
     {
+#ifdef CONFIG_SCHED_CPULOAD
       struct cpuload_s cpuload;
       uint32_t intpart;
       uint32_t fracpart;
+#endif
+#ifdef CONFIG_SCHED_SCHEDSTAT
+      struct cpustat_s cpustat;
+      int cpu;
+#endif
+
+      linesize = 0;
 
+#ifdef CONFIG_SCHED_CPULOAD
       /* Sample the counts for the IDLE thread.  clock_cpuload should only
        * fail if the PID is not valid.  This, however, should never happen
        * for the IDLE thread.
@@ -253,8 +277,28 @@ static ssize_t cpuload_read(FAR struct file *filep, FAR char *buffer,
           fracpart = 0;
         }
 
-      linesize = snprintf(attr->line, CPULOAD_LINELEN, "%3d.%01d%%\n",
+      linesize = snprintf(attr->line, CPULOAD_TOTALLEN, "%3d.%01d%%\n",
                           intpart, fracpart);
+#endif
+
+#ifdef CONFIG_SCHED_SCHEDSTAT
+      /* Then add the time that each CPU spent in its IDLE thread and in
+       * interrupt handlers.
+       */
+
+      for (cpu = 0; cpu < CPULOAD_NCPUS; cpu++)
+        {
+          DEBUGVERIFY(clock_cpustat(cpu, &cpustat));
+
+          linesize += snprintf(&attr->line[linesize], CPULOAD_CPULEN,
+                               "CPU%d: idle %lu.%09lu irq %lu.%09lu\n",
+                               cpu,
+                               (unsigned long)(cpustat.idle / NSEC_PER_SEC),
+                               (unsigned long)(cpustat.idle % NSEC_PER_SEC),
+                               (unsigned long)(cpustat.irq / NSEC_PER_SEC),
+                               (unsigned long)(cpustat.irq % NSEC_PER_SEC));
+        }
+#endif
 
       /* Save the linesize in case we are re-entered with f_pos > 0 */
 
@@ -151,6 +151,9 @@ static FAR const char *g_iob_user_names[] =
 #ifdef CONFIG_NET_IPFORWARD
   "ipforward",
 #endif
+#ifdef CONFIG_NETDEV_IOB_RECEIVE
+  "netdev",
+#endif
 #ifdef CONFIG_WIRELESS_IEEE802154
   "rad802154",
 #endif
@@ -275,6 +278,7 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
 {
   FAR struct iobinfo_file_s *iobfile;
   FAR struct iob_userstats_s *userstats;
+  struct iob_poolstats_s poolstats;
   size_t linesize;
   size_t copysize;
   size_t totalsize;
@@ -352,6 +356,44 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
       totalsize += copysize;
     }
 
+  /* Then the statistics of each buffer size class */
+
+  if (totalsize < buflen)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = snprintf(iobfile->line, IOBINFO_LINELEN,
+                            "\n%10s%10s%10s%10s%12s%12s\n",
+                            "BUFSIZE", "NBUFFERS", "FREE", "CACHED",
+                            "ALLOC", "FAIL");
+
+      copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  for (i = 0; i < IOB_NPOOLS; i++)
+    {
+      if (totalsize < buflen)
+        {
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          iob_getpoolstats(i, &poolstats);
+          linesize   = snprintf(iobfile->line, IOBINFO_LINELEN,
+                                "%10u%10u%10u%10u%12lu%12lu\n",
+                                poolstats.bufsize, poolstats.nbuffers,
+                                poolstats.nfree, poolstats.ncached,
+                                (unsigned long)poolstats.nalloc,
+                                (unsigned long)poolstats.nfail);
+
+          copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                                     &offset);
+          totalsize += copysize;
+        }
+    }
+
   /* Update the file offset */
 
   filep->f_pos += totalsize;
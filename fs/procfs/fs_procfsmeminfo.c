@@ -279,6 +279,14 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
 {
   FAR struct meminfo_file_s *procfile;
   struct mallinfo mem;
+#ifdef CONFIG_MM_CACHE
+#ifdef CONFIG_MM_KERNEL_HEAP
+  struct mallinfo kmem;
+#endif
+#if !defined(CONFIG_BUILD_KERNEL)
+  struct mallinfo umem;
+#endif
+#endif
   size_t linesize;
   size_t copysize;
   size_t totalsize;
@@ -327,6 +335,9 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
       copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
                                  &offset);
       totalsize += copysize;
+#ifdef CONFIG_MM_CACHE
+      kmem       = mem;
+#endif
     }
 #endif
 
@@ -353,6 +364,9 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
       copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
                                  &offset);
       totalsize += copysize;
+#ifdef CONFIG_MM_CACHE
+      umem       = mem;
+#endif
     }
 #endif
 
@@ -411,6 +425,56 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
     }
 #endif
 
+#ifdef CONFIG_MM_CACHE
+  /* Followed by the statistics of the small-object caches.  The cached
+   * bytes are included in the 'used' column above.
+   */
+
+  if (totalsize < buflen)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
+                            "              hits     misses     cached\n");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+#ifdef CONFIG_MM_KERNEL_HEAP
+  if (totalsize < buflen)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
+                            "Kcache:%11lu%11lu%11lu\n",
+                            kmem.cachehits, kmem.cachemisses,
+                            (unsigned long)kmem.cacheblks);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+#endif
+
+#if !defined(CONFIG_BUILD_KERNEL)
+  if (totalsize < buflen)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
+                            "Ucache:%11lu%11lu%11lu\n",
+                            umem.cachehits, umem.cachemisses,
+                            (unsigned long)umem.cacheblks);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+#endif
+#endif /* CONFIG_MM_CACHE */
+
   /* Update the file offset */
 
   filep->f_pos += totalsize;
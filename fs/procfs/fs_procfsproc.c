@@ -66,7 +66,8 @@
 #include <nuttx/fs/procfs.h>
 #include <nuttx/fs/dirent.h>
 
-#if defined(CONFIG_SCHED_CPULOAD) || defined(CONFIG_SCHED_CRITMONITOR)
+#if defined(CONFIG_SCHED_CPULOAD) || defined(CONFIG_SCHED_CRITMONITOR) || \
+    defined(CONFIG_SCHED_SCHEDSTAT)
 #  include <nuttx/clock.h>
 #endif
 
@@ -113,6 +114,9 @@ enum proc_node_e
 #endif
 #ifdef CONFIG_SCHED_CRITMONITOR
   PROC_CRITMON,                       /* Critical section monitor */
+#endif
+#ifdef CONFIG_SCHED_SCHEDSTAT
+  PROC_SCHEDSTAT,                     /* Scheduler statistics */
 #endif
   PROC_STACK,                         /* Task stack info */
   PROC_GROUP,                         /* Group directory */
@@ -199,6 +203,11 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
 #endif
+#ifdef CONFIG_SCHED_SCHEDSTAT
+static ssize_t proc_schedstat(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
+                 off_t offset);
+#endif
 static ssize_t proc_stack(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
@@ -294,6 +303,13 @@ static const struct proc_node_s g_critmon =
 };
 #endif
 
+#ifdef CONFIG_SCHED_SCHEDSTAT
+static const struct proc_node_s g_schedstat =
+{
+  "schedstat",     "schedstat", (uint8_t)PROC_SCHEDSTAT, DTYPE_FILE        /* Scheduler statistics */
+};
+#endif
+
 static const struct proc_node_s g_stack =
 {
   "stack",        "stack",   (uint8_t)PROC_STACK,        DTYPE_FILE        /* Task stack info */
@@ -333,6 +349,9 @@ static FAR const struct proc_node_s * const g_nodeinfo[] =
 #endif
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section Monitor */
+#endif
+#ifdef CONFIG_SCHED_SCHEDSTAT
+  &g_schedstat,    /* Scheduler statistics */
 #endif
   &g_stack,        /* Task stack info */
   &g_group,        /* Group directory */
@@ -356,6 +375,9 @@ static const struct proc_node_s * const g_level0info[] =
 #endif
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section monitor */
+#endif
+#ifdef CONFIG_SCHED_SCHEDSTAT
+  &g_schedstat,    /* Scheduler statistics */
 #endif
   &g_stack,        /* Task stack info */
   &g_group,        /* Group directory */
@@ -851,6 +873,81 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
 }
 #endif
 
+/****************************************************************************
+ * Name: proc_schedstat
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_SCHEDSTAT
+static ssize_t proc_schedstat(FAR struct proc_file_s *procfile,
+                              FAR struct tcb_s *tcb, FAR char *buffer,
+                              size_t buflen, off_t offset)
+{
+  struct schedstat_s stat;
+  size_t remaining;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+
+  remaining = buflen;
+  totalsize = 0;
+
+  /* Sample the statistics for the thread.  clock_schedstat should only
+   * fail if the PID is not valid.  This could happen if the thread exited
+   * sometime after the procfs entry was opened.
+   */
+
+  if (clock_schedstat(procfile->pid, &stat) < 0)
+    {
+      memset(&stat, 0, sizeof(struct schedstat_s));
+    }
+
+  /* Generate output for the time spent running */
+
+  linesize = snprintf(procfile->line, STATUS_LINELEN, "%lu.%09lu,",
+                      (unsigned long)(stat.run / NSEC_PER_SEC),
+                      (unsigned long)(stat.run % NSEC_PER_SEC));
+  copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                           &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Generate output for the time spent waiting to run */
+
+  linesize = snprintf(procfile->line, STATUS_LINELEN, "%lu.%09lu,",
+                      (unsigned long)(stat.wait / NSEC_PER_SEC),
+                      (unsigned long)(stat.wait % NSEC_PER_SEC));
+  copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                           &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Generate output for the voluntary and involuntary context switches */
+
+  linesize = snprintf(procfile->line, STATUS_LINELEN, "%lu,%lu\n",
+                      (unsigned long)stat.nvcsw,
+                      (unsigned long)stat.nivcsw);
+  copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                           &offset);
+
+  totalsize += copysize;
+  return totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: proc_stack
  ****************************************************************************/
@@ -1442,6 +1539,11 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer,
     case PROC_CRITMON: /* Critical section monitor */
       ret = proc_critmon(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
+#endif
+#ifdef CONFIG_SCHED_SCHEDSTAT
+    case PROC_SCHEDSTAT: /* Scheduler statistics */
+      ret = proc_schedstat(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
 #endif
     case PROC_STACK: /* Task stack info */
       ret = proc_stack(procfile, tcb, buffer, buflen, filep->f_pos);
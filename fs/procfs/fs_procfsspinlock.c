@@ -0,0 +1,340 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsspinlock.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/statfs.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_SPINLOCK_STATS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_SPINLOCK)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define SPINLOCK_LINELEN 80
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct spinlock_file_s
+{
+  struct procfs_file_s  base;   /* Base open file structure */
+  unsigned int linesize;        /* Number of valid characters in line[] */
+  char line[SPINLOCK_LINELEN];    /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static unsigned long spinlock_nsec(uint32_t elapsed);
+
+/* File system methods */
+
+static int     spinlock_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     spinlock_close(FAR struct file *filep);
+static ssize_t spinlock_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     spinlock_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     spinlock_stat(FAR const char *relpath,
+                 FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations spinlock_operations =
+{
+  spinlock_open,        /* open */
+  spinlock_close,       /* close */
+  spinlock_read,        /* read */
+  NULL,               /* write */
+
+  spinlock_dup,         /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  spinlock_stat         /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spinlock_nsec
+ *
+ * Description:
+ *   Convert a hold time in up_perf_gettime() counts to nanoseconds.  Zero
+ *   is shown if the architecture has no such counter.
+ *
+ ****************************************************************************/
+
+static unsigned long spinlock_nsec(uint32_t elapsed)
+{
+#ifdef CONFIG_ARCH_HAVE_PERF_EVENTS
+  return (unsigned long)((uint64_t)elapsed * 1000000000ull /
+                         up_perf_getfreq());
+#else
+  return 0;
+#endif
+}
+
+/****************************************************************************
+ * Name: spinlock_open
+ ****************************************************************************/
+
+static int spinlock_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct spinlock_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "spinlock" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "spinlock") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = (FAR struct spinlock_file_s *)
+    kmm_zalloc(sizeof(struct spinlock_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spinlock_close
+ ****************************************************************************/
+
+static int spinlock_close(FAR struct file *filep)
+{
+  FAR struct spinlock_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct spinlock_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spinlock_read
+ ****************************************************************************/
+
+static ssize_t spinlock_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct spinlock_file_s *attr;
+  FAR struct spinlock_stats_s *stats;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct spinlock_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  offset = filep->f_pos;
+
+  /* Generate the header line */
+
+  linesize  = snprintf(attr->line, SPINLOCK_LINELEN,
+                       "%-12s %10s %10s %10s %11s\n",
+                       "NAME", "LOCKS", "CONTENDED", "SPINS",
+                       "MAXHOLD(ns)");
+  copysize  = procfs_memcpy(attr->line, linesize, buffer, buflen, &offset);
+  totalsize = copysize;
+
+  /* Then one line for each named ticket lock */
+
+  for (stats = spin_stats_next(NULL);
+       stats != NULL && totalsize < buflen;
+       stats = spin_stats_next(stats))
+    {
+      linesize   = snprintf(attr->line, SPINLOCK_LINELEN,
+                            "%-12s %10lu %10lu %10lu %11lu\n",
+                            stats->name, (unsigned long)stats->nlocks,
+                            (unsigned long)stats->ncontended,
+                            (unsigned long)stats->nspins,
+                            spinlock_nsec(stats->maxhold));
+      copysize   = procfs_memcpy(attr->line, linesize, buffer + totalsize,
+                                 buflen - totalsize, &offset);
+      totalsize += copysize;
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: spinlock_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int spinlock_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct spinlock_file_s *oldattr;
+  FAR struct spinlock_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct spinlock_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct spinlock_file_s *)
+    kmm_malloc(sizeof(struct spinlock_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct spinlock_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spinlock_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int spinlock_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "spinlock" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "spinlock") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "spinlock" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_SPINLOCK_STATS && !CONFIG_FS_PROCFS_EXCLUDE_SPINLOCK */
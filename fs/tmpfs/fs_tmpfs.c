@@ -67,9 +67,7 @@
 #  warning CONFIG_FS_TMPFS_DIRECTORY_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
-#if CONFIG_FS_TMPFS_FILE_FREEGUARD <= CONFIG_FS_TMPFS_FILE_ALLOCGUARD
-#  warning CONFIG_FS_TMPFS_FILE_FREEGUARD needs to be > ALLOCGUARD
-#endif
+#define TMPFS_FILE_BLOCKSIZE CONFIG_FS_TMPFS_FILE_BLOCKSIZE
 
 #define tmpfs_lock_file(tfo) \
            (tmpfs_lock_object((FAR struct tmpfs_object_s *)tfo))
@@ -94,8 +92,14 @@ static void tmpfs_lock_object(FAR struct tmpfs_object_s *to);
 static void tmpfs_unlock_object(FAR struct tmpfs_object_s *to);
 static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
               unsigned int nentries);
-static int  tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
+static FAR uint8_t *tmpfs_file_block(FAR struct tmpfs_file_s *tfo,
+              unsigned int blkno, bool alloc);
+static void tmpfs_free_blocks(FAR struct tmpfs_file_s *tfo,
+              unsigned int first);
+static void tmpfs_resize_file(FAR struct tmpfs_file_s *tfo,
               size_t newsize);
+static FAR uint8_t *tmpfs_contig_file(FAR struct tmpfs_file_s *tfo);
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
@@ -373,72 +377,252 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
 }
 
 /****************************************************************************
- * Name: tmpfs_realloc_file
+ * Name: tmpfs_file_block
+ *
+ * Description:
+ *   Return the memory holding block 'blkno' of the file.  If the block is
+ *   a hole, either return NULL or, if 'alloc' is true, allocate a new
+ *   zeroed block, growing the block table if necessary.
+ *
  ****************************************************************************/
 
-static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
-                              size_t newsize)
+static FAR uint8_t *tmpfs_file_block(FAR struct tmpfs_file_s *tfo,
+                                     unsigned int blkno, bool alloc)
 {
-  FAR struct tmpfs_file_s *oldtfo = *tfo;
-  FAR struct tmpfs_file_s *newtfo;
-  size_t objsize;
-  size_t allocsize;
-  size_t delta;
+  FAR uint8_t **newblocks;
+  FAR uint8_t *block;
+  unsigned int nblocks;
 
-  /* Check if the current allocation is sufficient */
+  if (blkno < tfo->tfo_nblocks && tfo->tfo_blocks[blkno] != NULL)
+    {
+      return tfo->tfo_blocks[blkno];
+    }
 
-  objsize = SIZEOF_TMPFS_FILE(newsize);
+  if (!alloc)
+    {
+      return NULL;
+    }
 
-  /* Are we growing or shrinking the object? */
+  /* Grow the block table geometrically so that appending to a file only
+   * occasionally needs to reallocate the table.
+   */
 
-  if (objsize <= oldtfo->tfo_alloc)
+  if (blkno >= tfo->tfo_nblocks)
     {
-      /* Shrinking ... Shrink unconditionally if the size is shrinking to
-       * zero.
-       */
+      nblocks = tfo->tfo_nblocks > 0 ? 2 * tfo->tfo_nblocks : 4;
+      if (nblocks <= blkno)
+        {
+          nblocks = blkno + 1;
+        }
 
-      if (newsize > 0)
+      newblocks = (FAR uint8_t **)
+        kmm_realloc(tfo->tfo_blocks, nblocks * sizeof(FAR uint8_t *));
+      if (newblocks == NULL)
         {
-          /* Otherwise, don't realloc unless the object has shrunk by a
-           * lot.
-           */
+          return NULL;
+        }
 
-          delta = oldtfo->tfo_alloc - objsize;
-          if (delta <= CONFIG_FS_TMPFS_FILE_FREEGUARD)
-            {
-              /* Hasn't shrunk enough.. Return doing nothing for now */
+      memset(&newblocks[tfo->tfo_nblocks], 0,
+             (nblocks - tfo->tfo_nblocks) * sizeof(FAR uint8_t *));
+
+      tfo->tfo_alloc  += (nblocks - tfo->tfo_nblocks) *
+                         sizeof(FAR uint8_t *);
+      tfo->tfo_blocks  = newblocks;
+      tfo->tfo_nblocks = nblocks;
+    }
 
-              oldtfo->tfo_size = newsize;
-              return OK;
+  /* Data beyond the end of the file is always zero, so that extending the
+   * file later does not expose stale data.
+   */
+
+  block = (FAR uint8_t *)kmm_zalloc(TMPFS_FILE_BLOCKSIZE);
+  if (block == NULL)
+    {
+      return NULL;
+    }
+
+  tfo->tfo_alloc         += TMPFS_FILE_BLOCKSIZE;
+  tfo->tfo_blocks[blkno]  = block;
+  return block;
+}
+
+/****************************************************************************
+ * Name: tmpfs_free_blocks
+ *
+ * Description:
+ *   Release all blocks of the file from block 'first' on.  Blocks that are
+ *   part of the contiguous region are only cleared since they may be
+ *   mapped.
+ *
+ ****************************************************************************/
+
+static void tmpfs_free_blocks(FAR struct tmpfs_file_s *tfo,
+                              unsigned int first)
+{
+  unsigned int i;
+
+  for (i = first; i < tfo->tfo_nblocks; i++)
+    {
+      if (i < tfo->tfo_ncontig)
+        {
+          memset(tfo->tfo_blocks[i], 0, TMPFS_FILE_BLOCKSIZE);
+        }
+      else if (tfo->tfo_blocks[i] != NULL)
+        {
+          kmm_free(tfo->tfo_blocks[i]);
+          tfo->tfo_blocks[i] = NULL;
+          tfo->tfo_alloc    -= TMPFS_FILE_BLOCKSIZE;
+        }
+    }
+
+  /* Release the block table too if the file is now empty */
+
+  if (first == 0 && tfo->tfo_ncontig == 0 && tfo->tfo_blocks != NULL)
+    {
+      kmm_free(tfo->tfo_blocks);
+      tfo->tfo_alloc  -= tfo->tfo_nblocks * sizeof(FAR uint8_t *);
+      tfo->tfo_blocks  = NULL;
+      tfo->tfo_nblocks = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_resize_file
+ ****************************************************************************/
+
+static void tmpfs_resize_file(FAR struct tmpfs_file_s *tfo,
+                              size_t newsize)
+{
+  FAR uint8_t *block;
+  size_t offset;
+
+  /* Growing the file just extends the hole at the end of the file.
+   * Shrinking it clears the tail of the last partial block and frees all
+   * of the blocks beyond it.
+   */
+
+  if (newsize < tfo->tfo_size)
+    {
+      offset = newsize % TMPFS_FILE_BLOCKSIZE;
+      if (offset > 0)
+        {
+          block = tmpfs_file_block(tfo, newsize / TMPFS_FILE_BLOCKSIZE,
+                                   false);
+          if (block != NULL)
+            {
+              memset(&block[offset], 0, TMPFS_FILE_BLOCKSIZE - offset);
             }
         }
+
+      tmpfs_free_blocks(tfo, (newsize + TMPFS_FILE_BLOCKSIZE - 1) /
+                             TMPFS_FILE_BLOCKSIZE);
     }
 
-  /* Added some additional amount to the new size to account frequent
-   * reallocations.
+  tfo->tfo_size = newsize;
+}
+
+/****************************************************************************
+ * Name: tmpfs_contig_file
+ *
+ * Description:
+ *   Return the address of the file data in one contiguous piece of memory,
+ *   moving the file data into a single allocation if it is not already
+ *   contiguous.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *tmpfs_contig_file(FAR struct tmpfs_file_s *tfo)
+{
+  FAR uint8_t *contig;
+  unsigned int nblocks;
+  unsigned int i;
+
+  nblocks = (tfo->tfo_size + TMPFS_FILE_BLOCKSIZE - 1) /
+            TMPFS_FILE_BLOCKSIZE;
+
+  /* A file that fits in one block is always contiguous */
+
+  if (nblocks <= 1 && tfo->tfo_ncontig == 0)
+    {
+      return tmpfs_file_block(tfo, 0, true);
+    }
+
+  if (nblocks <= tfo->tfo_ncontig)
+    {
+      return tfo->tfo_contig;
+    }
+
+  /* Make sure that the block table covers the whole file */
+
+  if (tmpfs_file_block(tfo, nblocks - 1, true) == NULL)
+    {
+      return NULL;
+    }
+
+  contig = (FAR uint8_t *)kmm_malloc(nblocks * TMPFS_FILE_BLOCKSIZE);
+  if (contig == NULL)
+    {
+      return NULL;
+    }
+
+  /* Move each block into the new region.  Blocks from any previous region
+   * are released with that region.
    */
 
-  allocsize = objsize + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
+  for (i = 0; i < nblocks; i++)
+    {
+      FAR uint8_t *block = tfo->tfo_blocks[i];
 
-  /* Realloc the file object */
+      if (block != NULL)
+        {
+          memcpy(&contig[i * TMPFS_FILE_BLOCKSIZE], block,
+                 TMPFS_FILE_BLOCKSIZE);
 
-  newtfo = (FAR struct tmpfs_file_s *)kmm_realloc(oldtfo, allocsize);
-  if (newtfo == NULL)
+          if (i >= tfo->tfo_ncontig)
+            {
+              kmm_free(block);
+              tfo->tfo_alloc -= TMPFS_FILE_BLOCKSIZE;
+            }
+        }
+      else
+        {
+          memset(&contig[i * TMPFS_FILE_BLOCKSIZE], 0,
+                 TMPFS_FILE_BLOCKSIZE);
+        }
+
+      tfo->tfo_blocks[i] = &contig[i * TMPFS_FILE_BLOCKSIZE];
+    }
+
+  if (tfo->tfo_contig != NULL)
     {
-      return -ENOMEM;
+      kmm_free(tfo->tfo_contig);
+      tfo->tfo_alloc -= tfo->tfo_ncontig * TMPFS_FILE_BLOCKSIZE;
     }
 
-  /* Adjust the reference in the parent directory entry */
+  tfo->tfo_alloc   += nblocks * TMPFS_FILE_BLOCKSIZE;
+  tfo->tfo_contig   = contig;
+  tfo->tfo_ncontig  = nblocks;
+  return contig;
+}
+
+/****************************************************************************
+ * Name: tmpfs_free_file
+ ****************************************************************************/
 
-  DEBUGASSERT(newtfo->tfo_dirent);
-  newtfo->tfo_dirent->tde_object = (FAR struct tmpfs_object_s *)newtfo;
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo)
+{
+  unsigned int i;
 
-  /* Return the new address of the reallocated file object */
+  for (i = tfo->tfo_ncontig; i < tfo->tfo_nblocks; i++)
+    {
+      kmm_free(tfo->tfo_blocks[i]);
+    }
 
-  newtfo->tfo_alloc = allocsize;
-  newtfo->tfo_size  = newsize;
-  *tfo              = newtfo;
-  return OK;
+  kmm_free(tfo->tfo_contig);
+  kmm_free(tfo->tfo_blocks);
+
+  nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
+  kmm_free(tfo);
 }
 
 /****************************************************************************
@@ -476,8 +660,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
 
   if (tfo->tfo_refs == 1 && (tfo->tfo_flags & TFO_FLAG_UNLINKED) != 0)
     {
-      nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
     }
 
   /* Otherwise, just decrement the reference count on the file object */
@@ -623,12 +806,13 @@ static int tmpfs_add_dirent(FAR struct tmpfs_directory_s **tdo,
 static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
 {
   FAR struct tmpfs_file_s *tfo;
-  size_t allocsize;
 
-  /* Create a new zero length file object */
+  /* Create a new zero length file object.  No data blocks are allocated
+   * until the file is written.
+   */
 
-  allocsize = SIZEOF_TMPFS_FILE(CONFIG_FS_TMPFS_FILE_ALLOCGUARD);
-  tfo = (FAR struct tmpfs_file_s *)kmm_malloc(allocsize);
+  tfo = (FAR struct tmpfs_file_s *)
+    kmm_malloc(sizeof(struct tmpfs_file_s));
   if (tfo == NULL)
     {
       return NULL;
@@ -638,11 +822,15 @@ static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
    * locked with one reference count.
    */
 
-  tfo->tfo_alloc = allocsize;
-  tfo->tfo_type  = TMPFS_REGULAR;
-  tfo->tfo_refs  = 1;
-  tfo->tfo_flags = 0;
-  tfo->tfo_size  = 0;
+  tfo->tfo_alloc   = sizeof(struct tmpfs_file_s);
+  tfo->tfo_type    = TMPFS_REGULAR;
+  tfo->tfo_refs    = 1;
+  tfo->tfo_flags   = 0;
+  tfo->tfo_size    = 0;
+  tfo->tfo_nblocks = 0;
+  tfo->tfo_ncontig = 0;
+  tfo->tfo_blocks  = NULL;
+  tfo->tfo_contig  = NULL;
 
   tfo->tfo_exclsem.ts_holder = getpid();
   tfo->tfo_exclsem.ts_count  = 1;
@@ -1280,8 +1468,16 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
 
   /* Free the object now */
 
-  nxsem_destroy(&to->to_exclsem.ts_sem);
-  kmm_free(to);
+  if (to->to_type == TMPFS_REGULAR)
+    {
+      tmpfs_free_file((FAR struct tmpfs_file_s *)to);
+    }
+  else
+    {
+      nxsem_destroy(&to->to_exclsem.ts_sem);
+      kmm_free(to);
+    }
+
   return TMPFS_DELETED;
 }
 
@@ -1433,11 +1629,7 @@ static int tmpfs_open(FAR struct file *filep, FAR const char *relpath,
 
           if (tfo->tfo_size > 0)
             {
-              ret = tmpfs_realloc_file(&tfo, 0);
-              if (ret < 0)
-                {
-                  goto errout_with_filelock;
-                }
+              tmpfs_resize_file(tfo, 0);
             }
         }
     }
@@ -1548,7 +1740,7 @@ static int tmpfs_close(FAR struct file *filep)
        * have any other references.
        */
 
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
       return OK;
     }
 
@@ -1566,9 +1758,13 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
                           size_t buflen)
 {
   FAR struct tmpfs_file_s *tfo;
+  FAR uint8_t *block;
   ssize_t nread;
   off_t startpos;
   off_t endpos;
+  off_t pos;
+  size_t offset;
+  size_t nbytes;
 
   finfo("filep: %p buffer: %p buflen: %lu\n",
         filep, buffer, (unsigned long)buflen);
@@ -1591,12 +1787,33 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
   if (endpos > tfo->tfo_size)
     {
       endpos = tfo->tfo_size;
-      nread  = endpos - startpos;
+      nread  = endpos > startpos ? endpos - startpos : 0;
     }
 
-  /* Copy data from the memory object to the user buffer */
+  /* Copy data from the memory object to the user buffer one block at a
+   * time.  Holes in the file read as zero.
+   */
+
+  for (pos = startpos; pos < endpos; pos += nbytes, buffer += nbytes)
+    {
+      offset = pos % TMPFS_FILE_BLOCKSIZE;
+      nbytes = TMPFS_FILE_BLOCKSIZE - offset;
+      if (nbytes > endpos - pos)
+        {
+          nbytes = endpos - pos;
+        }
+
+      block = tmpfs_file_block(tfo, pos / TMPFS_FILE_BLOCKSIZE, false);
+      if (block != NULL)
+        {
+          memcpy(buffer, &block[offset], nbytes);
+        }
+      else
+        {
+          memset(buffer, 0, nbytes);
+        }
+    }
 
-  memcpy(buffer, &tfo->tfo_data[startpos], nread);
   filep->f_pos += nread;
 
   /* Release the lock on the file */
@@ -1613,10 +1830,13 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
                            size_t buflen)
 {
   FAR struct tmpfs_file_s *tfo;
+  FAR uint8_t *block;
   ssize_t nwritten;
   off_t startpos;
   off_t endpos;
-  int ret;
+  off_t pos;
+  size_t offset;
+  size_t nbytes;
 
   finfo("filep: %p buffer: %p buflen: %lu\n",
         filep, buffer, (unsigned long)buflen);
@@ -1630,38 +1850,52 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 
   tmpfs_lock_file(tfo);
 
-  /* Handle attempts to write beyond the end of the file */
+  /* Copy data from the user buffer to the memory object one block at a
+   * time, allocating only the blocks that are written.  Writing beyond the
+   * end of the file never moves the existing file data.
+   */
 
   startpos = filep->f_pos;
-  nwritten = buflen;
   endpos   = startpos + buflen;
 
-  if (endpos > tfo->tfo_size)
+  for (pos = startpos; pos < endpos; pos += nbytes, buffer += nbytes)
     {
-      /* Reallocate the file to handle the write past the end of the file. */
+      offset = pos % TMPFS_FILE_BLOCKSIZE;
+      nbytes = TMPFS_FILE_BLOCKSIZE - offset;
+      if (nbytes > endpos - pos)
+        {
+          nbytes = endpos - pos;
+        }
 
-      ret = tmpfs_realloc_file(&tfo, (size_t)endpos);
-      if (ret < 0)
+      block = tmpfs_file_block(tfo, pos / TMPFS_FILE_BLOCKSIZE, true);
+      if (block == NULL)
         {
-          goto errout_with_lock;
+          break;
         }
 
-      filep->f_priv = tfo;
+      memcpy(&block[offset], buffer, nbytes);
+    }
+
+  /* Return a partial write if we ran out of memory part way through */
+
+  nwritten = pos - startpos;
+  if (nwritten == 0 && buflen > 0)
+    {
+      tmpfs_unlock_file(tfo);
+      return -ENOMEM;
     }
 
-  /* Copy data from the memory object to the user buffer */
+  if (pos > tfo->tfo_size)
+    {
+      tfo->tfo_size = pos;
+    }
 
-  memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
   filep->f_pos += nwritten;
 
   /* Release the lock on the file */
 
   tmpfs_unlock_file(tfo);
   return nwritten;
-
-errout_with_lock:
-  tmpfs_unlock_file(tfo);
-  return (ssize_t)ret;
 }
 
 /****************************************************************************
@@ -1747,11 +1981,14 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   if (cmd == FIOC_MMAP && ppv != NULL)
     {
       /* Return the address on the media corresponding to the start of
-       * the file.
+       * the file.  The file data must be made contiguous first.
        */
 
-      *ppv = (FAR void *)tfo->tfo_data;
-      return OK;
+      tmpfs_lock_file(tfo);
+      *ppv = (FAR void *)tmpfs_contig_file(tfo);
+      tmpfs_unlock_file(tfo);
+
+      return *ppv != NULL ? OK : -ENOMEM;
     }
 
   ferr("ERROR: Invalid cmd: %d\n", cmd);
@@ -1833,7 +2070,6 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
 {
   FAR struct tmpfs_file_s *tfo;
   size_t oldsize;
-  int ret = OK;
 
   finfo("filep: %p length: %ld\n", filep, (long)length);
   DEBUGASSERT(filep != NULL && length >= 0);
@@ -1853,33 +2089,18 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
   oldsize = tfo->tfo_size;
   if (oldsize != length)
     {
-      /* The size is changing.. up or down.  Reallocate the file memory. */
-
-      ret = tmpfs_realloc_file(&tfo, (size_t)length);
-      if (ret < 0)
-        {
-          goto errout_with_lock;
-        }
-
-      filep->f_priv = tfo;
-
-      /* If the size has increased, then we need to zero the newly added
-       * memory.
+      /* The size is changing.. up or down.  Growing the file just extends
+       * the hole at the end of the file; shrinking it frees the blocks
+       * beyond the new end of file.
        */
 
-      if (length > oldsize)
-        {
-          memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
-        }
-
-      ret = OK;
+      tmpfs_resize_file(tfo, (size_t)length);
     }
 
   /* Release the lock on the file */
 
-errout_with_lock:
   tmpfs_unlock_file(tfo);
-  return ret;
+  return OK;
 }
 
 /****************************************************************************
@@ -2280,8 +2501,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
 
   else
     {
-      nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
     }
 
   /* Release the reference and lock on the parent directory */
@@ -137,6 +137,13 @@ struct tmpfs_directory_s
  * state.  The file memory object also serves as the open file object,
  * saving an allocation.  This has the negative side effect that no per-
  * open state can be retained (such as open flags).
+ *
+ * The file data is held in blocks of CONFIG_FS_TMPFS_FILE_BLOCKSIZE bytes.
+ * tfo_blocks[] maps each block of the file to its memory.  Holes in
+ * sparse files have no memory (NULL) and read as zero.  If the file is
+ * mapped with FIOC_MMAP, the first tfo_ncontig blocks are carved out of
+ * the single allocation at tfo_contig instead of being allocated one by
+ * one.
  */
 
 struct tmpfs_file_s
@@ -154,11 +161,12 @@ struct tmpfs_file_s
 
   uint8_t  tfo_flags;    /* See TFO_FLAG_* definitions */
   size_t   tfo_size;     /* Valid file size */
-  uint8_t  tfo_data[1];  /* File data starts here */
+  unsigned int tfo_nblocks;  /* Number of entries in tfo_blocks[] */
+  unsigned int tfo_ncontig;  /* Number of blocks in tfo_contig */
+  FAR uint8_t **tfo_blocks;  /* Block table (NULL entries are holes) */
+  FAR uint8_t *tfo_contig;   /* Contiguous blocks for FIOC_MMAP */
 };
 
-#define SIZEOF_TMPFS_FILE(n) (sizeof(struct tmpfs_file_s) + (n) - 1)
-
 /* This structure represents one instance of a TMPFS file system */
 
 struct tmpfs_s
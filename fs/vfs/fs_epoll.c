@@ -42,194 +42,1078 @@
 #include <sys/epoll.h>
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <fcntl.h>
 #include <poll.h>
 #include <errno.h>
-#include <string.h>
+#include <assert.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/cancelpt.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "inode/inode.h"
 
 /****************************************************************************
- * Public Functions
+ * Pre-processor Definitions
  ****************************************************************************/
 
+/* The events that are always reported, whether requested or not */
+
+#define EPOLL_ALWAYS  (EPOLLERR | EPOLLHUP)
+
+/* The events that may be requested */
+
+#define EPOLL_EVENTS  (EPOLLIN | EPOLLOUT | EPOLL_ALWAYS)
+
 /****************************************************************************
- * Name: epoll_create
+ * Private Types
+ ****************************************************************************/
+
+/* This describes one file descriptor in the interest list.  The pollfd stays
+ * set up in the driver for as long as the descriptor is registered.  The
+ * driver's poll_notify() then calls epoll_notify() which adds the node to
+ * the ready list so that epoll_wait() only visits ready descriptors.
+ *
+ * The node is keyed by the struct file or struct socket of the descriptor,
+ * not by the descriptor number, and holds no reference to it.  Closing the
+ * descriptor calls epoll_detach() which removes the node before the driver
+ * is closed.
+ */
+
+struct epoll_head_s;
+struct epoll_node_s
+{
+  struct pollfd             pfd;     /* Must be first:  see epoll_notify() */
+  FAR struct epoll_node_s  *flink;   /* Next node in the interest list */
+  FAR struct epoll_node_s  *rlink;   /* Next node in the ready list */
+  FAR struct epoll_node_s  *llink;   /* Next node to poll again */
+  FAR struct epoll_head_s  *eph;     /* The epoll instance */
+  uint32_t                  events;  /* Requested events and EPOLLET, etc. */
+  epoll_data_t              data;    /* Returned with each event */
+  bool                      armed;   /* The pollfd is set up in the driver */
+  bool                      ready;   /* The node is in the ready list */
+#ifdef CONFIG_NET
+  bool                      issock;  /* obj is a struct socket */
+#endif
+  FAR void                 *obj;     /* The struct file or struct socket */
+};
+
+/* This is the state of one epoll instance.  It is the i_private data of the
+ * unnamed inode that backs the epoll file descriptor.
+ */
+
+struct epoll_head_s
+{
+  FAR struct epoll_head_s  *flink;   /* Next instance in g_epoll_heads */
+  sem_t                     exclsem; /* Serializes the interest list */
+  sem_t                     waitsem; /* Posted when a node becomes ready */
+  FAR struct epoll_node_s  *nodes;   /* The interest list */
+  FAR struct epoll_node_s  *rhead;   /* Head of the ready list */
+  FAR struct epoll_node_s  *rtail;   /* Tail of the ready list */
+  FAR struct pollfd        *fds;     /* A poll() on the epoll descriptor */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int epoll_file_close(FAR struct file *filep);
+static int epoll_file_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                           bool setup);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_epoll_ops =
+{
+  NULL,             /* open */
+  epoll_file_close, /* close */
+  NULL,             /* read */
+  NULL,             /* write */
+  NULL,             /* seek */
+  NULL,             /* ioctl */
+  epoll_file_poll   /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL            /* unlink */
+#endif
+};
+
+/* All epoll instances, so that a closed descriptor can be removed from
+ * every interest list.  g_epoll_sem is taken before any exclsem.
+ */
+
+static FAR struct epoll_head_s *g_epoll_heads;
+static sem_t g_epoll_sem = SEM_INITIALIZER(1);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: epoll_head
  *
  * Description:
+ *   Return the epoll instance that corresponds to a file descriptor.
  *
- * Input Parameters:
+ ****************************************************************************/
+
+static int epoll_head(int epfd, FAR struct epoll_head_s **eph)
+{
+  FAR struct file *filep;
+  int ret;
+
+  ret = fs_getfilep(epfd, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (filep->f_inode == NULL || filep->f_inode->u.i_ops != &g_epoll_ops)
+    {
+      return -EINVAL;
+    }
+
+  *eph = (FAR struct epoll_head_s *)filep->f_inode->i_private;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: epoll_notify
+ *
+ * Description:
+ *   The poll notification callback of every registered pollfd.  Add the
+ *   node to the ready list and wake up the waiter.
+ *
+ * Assumptions:
+ *   May be called from interrupt handlers.
+ *
+ ****************************************************************************/
+
+static void epoll_notify(FAR struct pollfd *fds)
+{
+  FAR struct epoll_node_s *node = (FAR struct epoll_node_s *)fds;
+  FAR struct epoll_head_s *eph = node->eph;
+  FAR struct pollfd *epfds;
+  irqstate_t flags;
+  int semcount;
+
+  flags = enter_critical_section();
+  if (!node->ready)
+    {
+      node->ready = true;
+      node->rlink = NULL;
+
+      if (eph->rtail != NULL)
+        {
+          eph->rtail->rlink = node;
+        }
+      else
+        {
+          eph->rhead = node;
+        }
+
+      eph->rtail = node;
+    }
+
+  nxsem_getvalue(&eph->waitsem, &semcount);
+  if (semcount < 1)
+    {
+      nxsem_post(&eph->waitsem);
+    }
+
+  epfds = eph->fds;
+  leave_critical_section(flags);
+
+  /* The epoll descriptor itself is now readable */
+
+  if (epfds != NULL && (epfds->events & POLLIN) != 0)
+    {
+      epfds->revents |= POLLIN;
+      poll_notify(epfds);
+    }
+}
+
+/****************************************************************************
+ * Name: epoll_pollsetup
+ *
+ * Description:
+ *   Set up or tear down the poll of the file or socket held by a node.
+ *
+ ****************************************************************************/
+
+static int epoll_pollsetup(FAR struct epoll_node_s *node, bool setup)
+{
+#ifdef CONFIG_NET
+  if (node->issock)
+    {
+      return psock_poll((FAR struct socket *)node->obj, &node->pfd, setup);
+    }
+#endif
+
+  return file_poll((FAR struct file *)node->obj, &node->pfd, setup);
+}
+
+/****************************************************************************
+ * Name: epoll_arm
+ *
+ * Description:
+ *   Register the node with its driver.  A driver reports the events that
+ *   are already in effect at once so the node is queued if it is ready.
+ *
+ ****************************************************************************/
+
+static int epoll_arm(FAR struct epoll_node_s *node)
+{
+  int ret;
+
+  node->pfd.events  = (pollevent_t)((node->events & EPOLL_EVENTS) |
+                                    EPOLL_ALWAYS);
+  node->pfd.revents = 0;
+
+  ret = epoll_pollsetup(node, true);
+  if (ret >= 0)
+    {
+      node->armed = true;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: epoll_disarm
+ ****************************************************************************/
+
+static void epoll_disarm(FAR struct epoll_node_s *node)
+{
+  if (node->armed)
+    {
+      epoll_pollsetup(node, false);
+      node->armed = false;
+    }
+}
+
+/****************************************************************************
+ * Name: epoll_dequeue
+ *
+ * Description:
+ *   Remove a node from the ready list, if it is there.
+ *
+ ****************************************************************************/
+
+static void epoll_dequeue(FAR struct epoll_head_s *eph,
+                          FAR struct epoll_node_s *node)
+{
+  FAR struct epoll_node_s *prev = NULL;
+  FAR struct epoll_node_s *curr;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (node->ready)
+    {
+      for (curr = eph->rhead; curr != node; curr = curr->rlink)
+        {
+          prev = curr;
+        }
+
+      if (prev != NULL)
+        {
+          prev->rlink = node->rlink;
+        }
+      else
+        {
+          eph->rhead = node->rlink;
+        }
+
+      if (eph->rtail == node)
+        {
+          eph->rtail = prev;
+        }
+
+      node->ready = false;
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_release
+ *
+ * Description:
+ *   Tear down the poll of a node that has been removed from the interest
+ *   list and free it.
+ *
+ ****************************************************************************/
+
+static void epoll_release(FAR struct epoll_head_s *eph,
+                          FAR struct epoll_node_s *node)
+{
+  epoll_disarm(node);
+  epoll_dequeue(eph, node);
+  kmm_free(node);
+}
+
+/****************************************************************************
+ * Name: epoll_object
+ *
+ * Description:
+ *   Return the struct file or struct socket of a file descriptor.
+ *
+ ****************************************************************************/
+
+static int epoll_object(int fd, FAR void **obj, FAR bool *issock)
+{
+  FAR struct file *filep;
+  int ret;
+
+  *issock = false;
+  if ((unsigned int)fd < CONFIG_NFILE_DESCRIPTORS)
+    {
+      ret = fs_getfilep(fd, &filep);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (filep->f_inode == NULL)
+        {
+          return -EBADF;
+        }
+
+      *obj = filep;
+      return OK;
+    }
+
+#ifdef CONFIG_NET
+  else
+    {
+      FAR struct socket *psock = sockfd_socket(fd);
+
+      if (psock != NULL && psock->s_crefs > 0)
+        {
+          *obj    = psock;
+          *issock = true;
+          return OK;
+        }
+    }
+#endif
+
+  return -EBADF;
+}
+
+/****************************************************************************
+ * Name: epoll_find
+ *
+ * Description:
+ *   Find the node of a file or socket in the interest list.
+ *
+ ****************************************************************************/
+
+static FAR struct epoll_node_s *
+epoll_find(FAR struct epoll_head_s *eph, FAR const void *obj,
+           FAR struct epoll_node_s **prev)
+{
+  FAR struct epoll_node_s *node;
+
+  *prev = NULL;
+  for (node = eph->nodes; node != NULL; node = node->flink)
+    {
+      if (node->obj == obj)
+        {
+          break;
+        }
+
+      *prev = node;
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: epoll_unlink
+ *
+ * Description:
+ *   Remove a node from the interest list.  The list is only changed inside
+ *   a critical section so that epoll_detach() can search it without taking
+ *   exclsem.
+ *
+ ****************************************************************************/
+
+static void epoll_unlink(FAR struct epoll_head_s *eph,
+                         FAR struct epoll_node_s *node,
+                         FAR struct epoll_node_s *prev)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (prev != NULL)
+    {
+      prev->flink = node->flink;
+    }
+  else
+    {
+      eph->nodes = node->flink;
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_add
+ ****************************************************************************/
+
+static int epoll_add(FAR struct epoll_head_s *eph, int fd, FAR void *obj,
+                     bool issock, FAR struct epoll_event *ev)
+{
+  FAR struct epoll_node_s *node;
+  irqstate_t flags;
+  int ret;
+
+  node = (FAR struct epoll_node_s *)kmm_zalloc(sizeof(*node));
+  if (node == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  node->pfd.fd  = fd;
+  node->pfd.sem = &eph->waitsem;
+  node->pfd.cb  = epoll_notify;
+  node->eph     = eph;
+  node->events  = ev->events;
+  node->data    = ev->data;
+  node->obj     = obj;
+#ifdef CONFIG_NET
+  node->issock  = issock;
+#endif
+
+  ret = epoll_arm(node);
+  if (ret < 0)
+    {
+      epoll_release(eph, node);
+      return ret;
+    }
+
+  flags       = enter_critical_section();
+  node->flink = eph->nodes;
+  eph->nodes  = node;
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: epoll_rescan
+ *
+ * Description:
+ *   Queue the nodes that have events but are not in the ready list.  This
+ *   catches drivers that post the semaphore directly instead of calling
+ *   poll_notify().
+ *
+ ****************************************************************************/
+
+static void epoll_rescan(FAR struct epoll_head_s *eph)
+{
+  FAR struct epoll_node_s *node;
+
+  for (node = eph->nodes; node != NULL; node = node->flink)
+    {
+      if (node->armed && !node->ready && node->pfd.revents != 0)
+        {
+          epoll_notify(&node->pfd);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: epoll_collect
+ *
+ * Description:
+ *   Move up to maxevents events from the ready list to the caller's buffer.
  *
  * Returned Value:
+ *   The number of events returned.
+ *
+ * Assumptions:
+ *   The caller holds exclsem.
  *
  ****************************************************************************/
 
-int epoll_create(int size)
+static int epoll_collect(FAR struct epoll_head_s *eph,
+                         FAR struct epoll_event *evs, int maxevents)
 {
-  FAR struct epoll_head *eph =
-    (FAR struct epoll_head *)kmm_malloc(sizeof(struct epoll_head));
+  FAR struct epoll_node_s *again = NULL;
+  FAR struct epoll_node_s *node;
+  pollevent_t revents;
+  irqstate_t flags;
+  int nevents = 0;
 
-  eph->size = size;
-  eph->occupied = 0;
-  eph->evs = kmm_malloc(sizeof(struct epoll_event) * eph->size);
+  while (nevents < maxevents)
+    {
+      flags = enter_critical_section();
+      node  = eph->rhead;
+      if (node == NULL)
+        {
+          leave_critical_section(flags);
+          break;
+        }
 
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
+      eph->rhead = node->rlink;
+      if (eph->rhead == NULL)
+        {
+          eph->rtail = NULL;
+        }
+
+      node->ready       = false;
+      revents           = node->pfd.revents & node->pfd.events;
+      node->pfd.revents = 0;
+      leave_critical_section(flags);
+
+      if (revents == 0 || !node->armed)
+        {
+          continue;
+        }
+
+      evs[nevents].events = revents;
+      evs[nevents].data   = node->data;
+      nevents++;
+
+      if ((node->events & EPOLLONESHOT) != 0)
+        {
+          /* Disabled until re-armed by EPOLL_CTL_MOD */
+
+          epoll_disarm(node);
+        }
+      else if ((node->events & EPOLLET) == 0)
+        {
+          /* Level-triggered:  Poll the descriptor again below so that it is
+           * queued again while it stays ready.
+           */
+
+          node->llink = again;
+          again       = node;
+        }
+    }
+
+  while (again != NULL)
+    {
+      node  = again;
+      again = node->llink;
 
-  return (int)((intptr_t)eph);
+      epoll_disarm(node);
+      epoll_arm(node);
+    }
+
+  return nevents;
 }
 
 /****************************************************************************
- * Name: epoll_close
+ * Name: epoll_file_close
  *
  * Description:
+ *   Close one reference to the epoll descriptor.  The last close removes
+ *   all descriptors from the interest list and frees the instance.  The
+ *   inode is freed by inode_release().
+ *
+ ****************************************************************************/
+
+static int epoll_file_close(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct epoll_head_s *eph = (FAR struct epoll_head_s *)inode->i_private;
+  FAR struct epoll_node_s *node;
+
+  if (inode->i_crefs <= 1)
+    {
+      FAR struct epoll_head_s *prev = NULL;
+      FAR struct epoll_head_s *curr;
+
+      /* Make the instance invisible to epoll_detach() */
+
+      nxsem_wait_uninterruptible(&g_epoll_sem);
+      for (curr = g_epoll_heads; curr != eph; curr = curr->flink)
+        {
+          prev = curr;
+        }
+
+      if (prev != NULL)
+        {
+          prev->flink = eph->flink;
+        }
+      else
+        {
+          g_epoll_heads = eph->flink;
+        }
+
+      nxsem_post(&g_epoll_sem);
+
+      while ((node = eph->nodes) != NULL)
+        {
+          eph->nodes = node->flink;
+          epoll_release(eph, node);
+        }
+
+      nxsem_destroy(&eph->exclsem);
+      nxsem_destroy(&eph->waitsem);
+      kmm_free(eph);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: epoll_file_poll
+ *
+ * Description:
+ *   The epoll descriptor is readable while its ready list is not empty.
+ *
+ ****************************************************************************/
+
+static int epoll_file_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                           bool setup)
+{
+  FAR struct epoll_head_s *eph =
+    (FAR struct epoll_head_s *)filep->f_inode->i_private;
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = enter_critical_section();
+  if (setup)
+    {
+      if (eph->fds != NULL)
+        {
+          ret = -EBUSY;
+        }
+      else
+        {
+          eph->fds = fds;
+          if (eph->rhead != NULL)
+            {
+              fds->revents |= (fds->events & POLLIN);
+            }
+        }
+    }
+  else if (eph->fds == fds)
+    {
+      eph->fds = NULL;
+    }
+
+  leave_critical_section(flags);
+
+  if (setup && ret >= 0 && fds->revents != 0)
+    {
+      poll_notify(fds);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: epoll_create
+ *
+ * Description:
+ *   Create a new epoll instance and return a file descriptor that refers to
+ *   it.  The descriptor is released with close() or epoll_close().
  *
  * Input Parameters:
+ *   size - Ignored, but must be greater than zero
  *
  * Returned Value:
+ *   A file descriptor on success; -1 (ERROR) on failure with the errno
+ *   variable set appropriately.
  *
  ****************************************************************************/
 
-void epoll_close(int epfd)
+int epoll_create(int size)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
+  FAR struct epoll_head_s *eph;
+  FAR struct inode *inode;
+  int errcode;
+  int fd;
+
+  if (size <= 0)
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+  eph = (FAR struct epoll_head_s *)kmm_zalloc(sizeof(struct epoll_head_s));
+  if (eph == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout;
+    }
+
+  /* The epoll descriptor refers to an unnamed inode that is not in the
+   * pseudo-file system tree.  It is marked deleted so that inode_release()
+   * frees it when the last reference is closed.
    */
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
+  inode = (FAR struct inode *)kmm_zalloc(FSNODE_SIZE(0));
+  if (inode == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout_with_eph;
+    }
+
+  nxsem_init(&eph->exclsem, 0, 1);
 
-  kmm_free(eph->evs);
+  /* waitsem is used for signaling and, hence, should not have priority
+   * inheritance enabled.
+   */
+
+  nxsem_init(&eph->waitsem, 0, 0);
+  nxsem_setprotocol(&eph->waitsem, SEM_PRIO_NONE);
+
+  inode->i_crefs   = 1;
+  inode->i_flags   = FSNODEFLAG_TYPE_DRIVER | FSNODEFLAG_DELETED;
+  inode->u.i_ops   = &g_epoll_ops;
+  inode->i_private = eph;
+
+  fd = files_allocate(inode, O_RDOK, 0, 0);
+  if (fd < 0)
+    {
+      errcode = EMFILE;
+      goto errout_with_inode;
+    }
+
+  nxsem_wait_uninterruptible(&g_epoll_sem);
+  eph->flink    = g_epoll_heads;
+  g_epoll_heads = eph;
+  nxsem_post(&g_epoll_sem);
+
+  finfo("epfd=%d\n", fd);
+  return fd;
+
+errout_with_inode:
+  nxsem_destroy(&eph->exclsem);
+  nxsem_destroy(&eph->waitsem);
+  kmm_free(inode);
+
+errout_with_eph:
   kmm_free(eph);
+
+errout:
+  set_errno(errcode);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: epoll_close
+ *
+ * Description:
+ *   Close an epoll descriptor.  Equivalent to close(epfd).
+ *
+ ****************************************************************************/
+
+void epoll_close(int epfd)
+{
+  close(epfd);
 }
 
 /****************************************************************************
  * Name: epoll_ctl
  *
  * Description:
+ *   Add, modify or remove a file descriptor in the interest list of an
+ *   epoll instance.  The descriptor stays registered with its driver until
+ *   it is removed with EPOLL_CTL_DEL, it is closed, or the epoll
+ *   descriptor is closed.
  *
  * Input Parameters:
+ *   epfd - The epoll descriptor
+ *   op   - EPOLL_CTL_ADD, EPOLL_CTL_MOD or EPOLL_CTL_DEL
+ *   fd   - The file or socket descriptor
+ *   ev   - The requested events and the data to return with them.  Not
+ *          used by EPOLL_CTL_DEL.
  *
  * Returned Value:
+ *   Zero (OK) on success; -1 (ERROR) on failure with the errno variable set
+ *   appropriately.
  *
  ****************************************************************************/
 
-int epoll_ctl(int epfd, int op, int fd, struct epoll_event *ev)
+int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
+  FAR struct epoll_head_s *eph;
+  FAR struct epoll_node_s *node;
+  FAR struct epoll_node_s *prev;
+  FAR void *obj;
+  bool issock;
+  int ret;
+
+  ret = epoll_head(epfd, &eph);
+  if (ret < 0)
+    {
+      goto errout;
+    }
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
+  if (op != EPOLL_CTL_DEL && ev == NULL)
+    {
+      ret = -EFAULT;
+      goto errout;
+    }
 
+  ret = epoll_object(fd, &obj, &issock);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (!issock && ((FAR struct file *)obj)->f_inode->i_private == eph)
+    {
+      /* An epoll instance cannot watch itself */
+
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  ret = nxsem_wait_uninterruptible(&eph->exclsem);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  finfo("epfd=%d op=%d fd=%d ev=%08x\n",
+        epfd, op, fd, ev != NULL ? (unsigned int)ev->events : 0);
+
+  node = epoll_find(eph, obj, &prev);
   switch (op)
     {
       case EPOLL_CTL_ADD:
-        finfo("%08x CTL ADD(%d): fd=%d ev=%08x\n",
-              epfd, eph->occupied, fd, ev->events);
-
-        eph->evs[eph->occupied].events = ev->events | POLLERR | POLLHUP;
-        eph->evs[eph->occupied++].data.fd = fd;
-        return 0;
+        ret = node != NULL ? -EEXIST : epoll_add(eph, fd, obj, issock, ev);
+        break;
 
       case EPOLL_CTL_DEL:
-        {
-          int i;
+        if (node == NULL)
+          {
+            ret = -ENOENT;
+            break;
+          }
 
-          for (i = 0; i < eph->occupied; i++)
-            {
-              if (eph->evs[i].data.fd == fd)
-                {
-                  if (i != eph->occupied - 1)
-                    {
-                      memmove(&eph->evs[i], &eph->evs[i + 1],
-                              eph->occupied - i);
-                    }
-
-                  eph->occupied--;
-                  return 0;
-                }
-            }
-
-          return -ENOENT;
-        }
+        epoll_unlink(eph, node, prev);
+        epoll_release(eph, node);
+        break;
 
       case EPOLL_CTL_MOD:
-        {
-          int i;
+        if (node == NULL)
+          {
+            ret = -ENOENT;
+            break;
+          }
 
-          finfo("%08x CTL MOD(%d): fd=%d ev=%08x\n",
-                epfd, eph->occupied, fd, ev->events);
+        epoll_disarm(node);
+        epoll_dequeue(eph, node);
 
-          for (i = 0; i < eph->occupied; i++)
-            {
-              if (eph->evs[i].data.fd == fd)
-                {
-                  eph->evs[i].events = ev->events | POLLERR | POLLHUP;
-                  return 0;
-                }
-            }
+        node->events = ev->events;
+        node->data   = ev->data;
+        ret = epoll_arm(node);
+        break;
 
-          return -ENOENT;
-        }
+      default:
+        ret = -EINVAL;
+        break;
+    }
+
+  nxsem_post(&eph->exclsem);
+
+errout:
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
     }
 
-  return -EINVAL;
+  return OK;
 }
 
 /****************************************************************************
  * Name: epoll_wait
  *
  * Description:
+ *   Wait for events on an epoll instance.  Only the descriptors in the
+ *   ready list are visited, so the cost does not depend on the size of the
+ *   interest list.
  *
  * Input Parameters:
+ *   epfd      - The epoll descriptor
+ *   evs       - The buffer that receives the events
+ *   maxevents - The size of evs.  Must be greater than zero.
+ *   timeout   - The maximum wait in milliseconds.  Zero returns at once and
+ *               a negative value waits forever.
  *
  * Returned Value:
+ *   The number of events in evs, zero on timeout, or -1 (ERROR) on failure
+ *   with the errno variable set appropriately.
  *
  ****************************************************************************/
 
 int epoll_wait(int epfd, FAR struct epoll_event *evs, int maxevents,
                int timeout)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
+  FAR struct epoll_head_s *eph;
+  clock_t start;
+  clock_t ticks = 0;
+  bool woken = false;
+  int ret;
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
-  int counter;
-  int rc;
-  int i;
+  /* epoll_wait() is a cancellation point */
 
-  rc = poll((FAR struct pollfd *)eph->evs, eph->occupied, timeout);
+  (void)enter_cancellation_point();
 
-  if (rc <= 0)
+  ret = epoll_head(epfd, &eph);
+  if (ret < 0)
     {
-      if (rc < 0)
+      goto errout;
+    }
+
+  if (evs == NULL || maxevents <= 0)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  /* Round timeout up to next full tick, as poll() does */
+
+  start = clock_systimer();
+  if (timeout > 0)
+    {
+#if (MSEC_PER_TICK * USEC_PER_MSEC) != USEC_PER_TICK && \
+    defined(CONFIG_HAVE_LONG_LONG)
+      ticks = (((unsigned long long)timeout * USEC_PER_MSEC) +
+               (USEC_PER_TICK - 1)) /
+              USEC_PER_TICK;
+#else
+      ticks = ((unsigned int)timeout + (MSEC_PER_TICK - 1)) /
+              MSEC_PER_TICK;
+#endif
+    }
+
+  for (; ; )
+    {
+      ret = nxsem_wait_uninterruptible(&eph->exclsem);
+      if (ret < 0)
         {
-          ferr("ERROR: %08x poll fail: %d for %d, %d msecs\n",
-               epfd, rc, eph->occupied, timeout);
+          break;
+        }
 
-          for (i = 0; i < eph->occupied; i++)
+      /* If we were awakened but nothing is queued, a driver may have
+       * posted the semaphore without calling poll_notify().
+       */
+
+      if (woken && eph->rhead == NULL)
+        {
+          epoll_rescan(eph);
+        }
+
+      ret = epoll_collect(eph, evs, maxevents);
+      nxsem_post(&eph->exclsem);
+
+      if (ret > 0 || timeout == 0)
+        {
+          break;
+        }
+
+      /* Wait for a node to be queued, for a signal, or for the timeout.
+       * nxsem_tickwait() deducts the time already spent since start.
+       */
+
+      if (timeout > 0)
+        {
+          ret = nxsem_tickwait(&eph->waitsem, start, ticks);
+          if (ret == -ETIMEDOUT)
             {
-              ferr("  %02d: fd=%d\n", i, eph->evs[i].data.fd);
+              ret = 0;
+              break;
             }
         }
+      else
+        {
+          ret = nxsem_wait(&eph->waitsem);
+        }
+
+      if (ret < 0)
+        {
+          break;
+        }
 
-      return rc;
+      woken = true;
     }
 
-  /* Iterate over non NULL event fds */
+errout:
+  leave_cancellation_point();
 
-  for (i = 0, counter = 0; i < rc && counter < eph->size; counter++)
+  if (ret < 0)
     {
-      if (eph->evs[counter].revents != 0)
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: epoll_detach
+ *
+ * Description:
+ *   Remove a file or socket that is being closed from the interest list of
+ *   every epoll instance.  Called before the driver or socket is closed.
+ *
+ * Input Parameters:
+ *   obj - The struct file or struct socket of the descriptor
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void epoll_detach(FAR const void *obj)
+{
+  FAR struct epoll_head_s *eph;
+  FAR struct epoll_node_s *node;
+  FAR struct epoll_node_s *prev;
+  irqstate_t flags;
+
+  if (g_epoll_heads == NULL)
+    {
+      return;
+    }
+
+  nxsem_wait_uninterruptible(&g_epoll_sem);
+  for (eph = g_epoll_heads; eph != NULL; eph = eph->flink)
+    {
+      /* Most closed descriptors are not registered.  Check without taking
+       * exclsem, which may be held by a thread polling this descriptor.
+       */
+
+      flags = enter_critical_section();
+      node  = epoll_find(eph, obj, &prev);
+      leave_critical_section(flags);
+
+      if (node == NULL)
+        {
+          continue;
+        }
+
+      nxsem_wait_uninterruptible(&eph->exclsem);
+      node = epoll_find(eph, obj, &prev);
+      if (node != NULL)
         {
-          evs[i].data.fd = eph->evs[counter].data.fd;
-          evs[i].events  = eph->evs[counter].revents;
-          i += 1;
+          epoll_unlink(eph, node, prev);
+          epoll_release(eph, node);
         }
+
+      nxsem_post(&eph->exclsem);
     }
 
-  return i;
+  nxsem_post(&g_epoll_sem);
 }
-
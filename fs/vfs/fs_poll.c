@@ -47,6 +47,7 @@
 #include <errno.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/irq.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/cancelpt.h>
 #include <nuttx/fs/fs.h>
@@ -149,6 +150,7 @@ static inline int poll_setup(FAR struct pollfd *fds, nfds_t nfds,
        */
 
       fds[i].sem     = sem;
+      fds[i].cb      = NULL;
       fds[i].revents = 0;
       fds[i].priv    = NULL;
 
@@ -360,7 +362,7 @@ int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
               fds->revents |= (fds->events & (POLLIN | POLLOUT));
               if (fds->revents != 0)
                 {
-                  nxsem_post(fds->sem);
+                  poll_notify(fds);
                 }
             }
 
@@ -410,6 +412,55 @@ int fdesc_poll(int fd, FAR struct pollfd *fds, bool setup)
   return file_poll(filep, fds, setup);
 }
 
+/****************************************************************************
+ * Name: poll_notify
+ *
+ * Description:
+ *   Called by drivers to report the events that they have just added to
+ *   fds->revents.  This calls the notification callback of the pollfd, if
+ *   there is one, or else posts its semaphore.  Drivers must use this
+ *   rather than posting fds->sem directly so that epoll can keep track of
+ *   the ready descriptors.
+ *
+ *   This may be called from interrupt handlers.
+ *
+ * Input Parameters:
+ *   fds - The pollfd provided to the driver's poll method
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void poll_notify(FAR struct pollfd *fds)
+{
+  irqstate_t flags;
+  int semcount;
+
+  DEBUGASSERT(fds != NULL);
+
+  if (fds->cb != NULL)
+    {
+      fds->cb(fds);
+    }
+  else if (fds->sem != NULL)
+    {
+      /* Limit the number of times that the semaphore is posted.  The
+       * waiter only needs to be awakened once.  The critical section is
+       * needed to make the following operation atomic.
+       */
+
+      flags = enter_critical_section();
+      nxsem_getvalue(fds->sem, &semcount);
+      if (semcount < 1)
+        {
+          nxsem_post(fds->sem);
+        }
+
+      leave_critical_section(flags);
+    }
+}
+
 /****************************************************************************
  * Name: poll
  *
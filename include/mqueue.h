@@ -50,6 +50,14 @@
 
 #define MQ_NONBLOCK O_NONBLOCK
 
+/* Non-standard:  May be set in the mq_flags of the attributes passed to
+ * mq_open() when the message queue is created.  The message queue then
+ * accepts zero-copy messages up to mq_msgsize bytes, even if that is larger
+ * than CONFIG_MQ_MAXMSGSIZE.  See CONFIG_MQ_ZEROCOPY.
+ */
+
+#define MQ_ZEROCOPY (1 << 15)
+
 /********************************************************************************
  * Public Type Declarations
  ********************************************************************************/
@@ -2408,6 +2408,25 @@ uint32_t up_critmon_gettime(void);
 void up_critmon_convert(uint32_t elapsed, FAR struct timespec *ts);
 #endif
 
+/********************************************************************************
+ * Name: up_perf_*
+ *
+ * Description:
+ *   The first interface returns the current value of a free-running, high
+ *   resolution counter.  The counter is an unsigned 32-bit value that wraps
+ *   around; the elapsed count between two samples is obtained by unsigned
+ *   subtraction of the start value from the end value.
+ *
+ *   The second interface returns the frequency of that counter in Hz so
+ *   that elapsed counts may be converted to well known units.
+ *
+ ********************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_PERF_EVENTS
+uint32_t up_perf_gettime(void);
+uint32_t up_perf_getfreq(void);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -228,6 +228,26 @@ struct cpuload_s
 };
 #endif
 
+/* These structures are used to report the scheduler statistics of a
+ * particular thread and of a particular CPU.  Times are in nanoseconds.
+ */
+
+#ifdef CONFIG_SCHED_SCHEDSTAT
+struct schedstat_s
+{
+  uint64_t run;              /* Time spent running */
+  uint64_t wait;             /* Time spent ready to run but not running */
+  uint32_t nvcsw;            /* Number of voluntary context switches */
+  uint32_t nivcsw;           /* Number of involuntary context switches */
+};
+
+struct cpustat_s
+{
+  uint64_t idle;             /* Time spent in the IDLE thread */
+  uint64_t irq;              /* Time spent in interrupt handlers */
+};
+#endif
+
 /* This non-standard type used to hold relative clock ticks that may take
  * negative values.  Because of its non-portable nature the type sclock_t
  * should be used only within the OS proper and not by portable applications.
@@ -442,6 +462,46 @@ int clock_systimespec(FAR struct timespec *ts);
 int clock_cpuload(int pid, FAR struct cpuload_s *cpuload);
 #endif
 
+/****************************************************************************
+ * Name:  clock_schedstat
+ *
+ * Description:
+ *   Return the scheduler statistics of the selected PID, including the
+ *   time of its current state up to now.
+ *
+ * Input Parameters:
+ *   pid  - The task ID of the thread of interest.
+ *   stat - The location to return the statistics
+ *
+ * Returned Value:
+ *   OK (0) on success; -ESRCH if 'pid' does not refer to a valid thread.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_SCHEDSTAT
+int clock_schedstat(int pid, FAR struct schedstat_s *stat);
+#endif
+
+/****************************************************************************
+ * Name:  clock_cpustat
+ *
+ * Description:
+ *   Return the time that the selected CPU has spent in its IDLE thread and
+ *   in interrupt handlers.
+ *
+ * Input Parameters:
+ *   cpu  - The index of the CPU of interest.
+ *   stat - The location to return the statistics
+ *
+ * Returned Value:
+ *   OK (0) on success; -EINVAL if 'cpu' is not a valid CPU index.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_SCHEDSTAT
+int clock_cpustat(int cpu, FAR struct cpustat_s *stat);
+#endif
+
 /****************************************************************************
  * Name:  sched_oneshot_extclk
  *
@@ -45,6 +45,23 @@
 #include <sys/types.h>
 #include <stdbool.h>
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_PIPE_SPLICE
+/* Argument of the PIPEIOC_SPLICEIN and PIPEIOC_SPLICEOUT ioctl commands.
+ * Up to 'len' bytes are moved between the pipe and the open file 'fd'
+ * directly through the pipe buffer.
+ */
+
+struct pipe_splice_s
+{
+  int fd;      /* The other file descriptor */
+  size_t len;  /* Maximum number of bytes to move */
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
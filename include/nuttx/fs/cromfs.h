@@ -0,0 +1,85 @@
+/****************************************************************************
+ * include/nuttx/fs/cromfs.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FS_CROMFS_H
+#define __INCLUDE_NUTTX_FS_CROMFS_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <nuttx/fs/ioctl.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* CROMFS IOCTL commands
+ *
+ * Command:      FIOC_CACHESTATS
+ * Description:  Return the statistics of the CROMFS cache of decompressed
+ *               blocks.  May be issued on any file open on the CROMFS
+ *               volume.
+ * Argument:     A writable pointer to an instance of struct
+ *               cromfs_cachestats_s.
+ * Dependencies: CONFIG_CROMFS_CACHE=y
+ */
+
+/****************************************************************************
+ * Type Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_CROMFS_CACHE
+/* This is the structure referred to in the argument to the FIOC_CACHESTATS
+ * IOCTL command.
+ */
+
+struct cromfs_cachestats_s
+{
+  uint32_t cs_hits;        /* Reads satisfied from a cached block */
+  uint32_t cs_misses;      /* Reads that had to decompress a block */
+  uint32_t cs_evictions;   /* Blocks discarded to stay within the budget */
+  uint16_t cs_nblocks;     /* Number of blocks currently cached */
+  size_t   cs_used;        /* Memory currently used by cached blocks */
+  size_t   cs_size;        /* Memory budget (CONFIG_CROMFS_CACHE_SIZE) */
+};
+#endif
+
+#endif /* __INCLUDE_NUTTX_FS_CROMFS_H */
@@ -1301,6 +1301,45 @@ int file_fstat(FAR struct file *filep, FAR struct stat *buf);
 
 int fdesc_poll(int fd, FAR struct pollfd *fds, bool setup);
 
+/****************************************************************************
+ * Name: poll_notify
+ *
+ * Description:
+ *   Called by drivers to report the events that they have just added to
+ *   fds->revents.  This calls the notification callback of the pollfd, if
+ *   there is one, or else posts its semaphore.  Drivers must use this
+ *   rather than posting fds->sem directly so that epoll can keep track of
+ *   the ready descriptors.
+ *
+ *   This may be called from interrupt handlers.
+ *
+ * Input Parameters:
+ *   fds - The pollfd provided to the driver's poll method
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void poll_notify(FAR struct pollfd *fds);
+
+/****************************************************************************
+ * Name: epoll_detach
+ *
+ * Description:
+ *   Remove a file or socket that is being closed from the interest list of
+ *   every epoll instance.  Called before the driver or socket is closed.
+ *
+ * Input Parameters:
+ *   obj - The struct file or struct socket of the descriptor
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void epoll_detach(FAR const void *obj);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
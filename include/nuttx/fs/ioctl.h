@@ -97,6 +97,7 @@
 #define _NXTERMBASE     (0x2900) /* NxTerm character driver ioctl commands */
 #define _RFIOCBASE      (0x2a00) /* RF devices ioctl commands */
 #define _RPTUNBASE      (0x2b00) /* Remote processor tunnel ioctl commands */
+#define _NOTEBASE       (0x2c00) /* Scheduler note driver ioctl commands */
 #define _WLIOCBASE      (0x8b00) /* Wireless modules ioctl network commands */
 
 /* boardctl() commands share the same number space */
@@ -172,6 +173,12 @@
                                            * OUT: Instance number is returned on
                                            *      success.
                                            */
+#define FIOC_CACHESTATS _FIOC(0x000b)     /* IN:  Pointer to a file system
+                                           *      specific statistics structure
+                                           *      (struct cromfs_cachestats_s).
+                                           * OUT: Statistics of the file system
+                                           *      data cache.
+                                           */
 
 /* NuttX file system ioctl definitions **************************************/
 
@@ -382,6 +389,16 @@
                                              *       (default)
                                              *     1=fre when empty
                                              * OUT: None */
+#define PIPEIOC_SPLICEIN  _PIPEIOC(0x0002)  /* Move data from a file into
+                                             * the pipe
+                                             * IN: struct pipe_splice_s *
+                                             * OUT: Bytes moved or a
+                                             *      negated errno */
+#define PIPEIOC_SPLICEOUT _PIPEIOC(0x0003)  /* Move data from the pipe
+                                             * into a file
+                                             * IN: struct pipe_splice_s *
+                                             * OUT: Bytes moved or a
+                                             *      negated errno */
 
 /* RTC driver ioctl definitions *********************************************/
 
@@ -506,6 +523,11 @@
 #define _RPTUNIOCVALID(c)   (_IOC_TYPE(c)==_RPTUNBASE)
 #define _RPTUNIOC(nr)       _IOC(_RPTUNBASE,nr)
 
+/* Scheduler note driver ****************************************************/
+
+#define _NOTEIOCVALID(c)    (_IOC_TYPE(c)==_NOTEBASE)
+#define _NOTEIOC(nr)        _IOC(_NOTEBASE,nr)
+
 /* Wireless driver network ioctl definitions ********************************/
 
 /* (see nuttx/include/wireless/wireless.h */
@@ -84,10 +84,49 @@
 #  error CONFIG_IOB_NBUFFERS <= CONFIG_IOB_THROTTLE
 #endif
 
+/* Optional small and large I/O buffer size classes */
+
+#ifndef CONFIG_IOB_SMALL_NBUFFERS
+#  define CONFIG_IOB_SMALL_NBUFFERS 0
+#endif
+
+#ifndef CONFIG_IOB_LARGE_NBUFFERS
+#  define CONFIG_IOB_LARGE_NBUFFERS 0
+#endif
+
+#if CONFIG_IOB_SMALL_NBUFFERS > 0 && \
+    CONFIG_IOB_SMALL_BUFSIZE >= CONFIG_IOB_BUFSIZE
+#  error CONFIG_IOB_SMALL_BUFSIZE must be smaller than CONFIG_IOB_BUFSIZE
+#endif
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0 && \
+    CONFIG_IOB_LARGE_BUFSIZE <= CONFIG_IOB_BUFSIZE
+#  error CONFIG_IOB_LARGE_BUFSIZE must be larger than CONFIG_IOB_BUFSIZE
+#endif
+
+/* The size classes are numbered in order of increasing buffer size */
+
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+#  define IOB_SMALL_POOL   0
+#  define IOB_DEFAULT_POOL 1
+#else
+#  define IOB_DEFAULT_POOL 0
+#endif
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+#  define IOB_LARGE_POOL   (IOB_DEFAULT_POOL + 1)
+#  define IOB_NPOOLS       (IOB_DEFAULT_POOL + 2)
+#  define IOB_MAXBUFSIZE   CONFIG_IOB_LARGE_BUFSIZE
+#else
+#  define IOB_NPOOLS       (IOB_DEFAULT_POOL + 1)
+#  define IOB_MAXBUFSIZE   CONFIG_IOB_BUFSIZE
+#endif
+
 /* IOB helpers */
 
 #define IOB_DATA(p)      (&(p)->io_data[(p)->io_offset])
-#define IOB_FREESPACE(p) (CONFIG_IOB_BUFSIZE - (p)->io_len - (p)->io_offset)
+#define IOB_BUFSIZE(p)   ((p)->io_bufsize)
+#define IOB_FREESPACE(p) (IOB_BUFSIZE(p) - (p)->io_len - (p)->io_offset)
 
 #if CONFIG_IOB_NCHAINS > 0
 /* Queue helpers */
@@ -102,7 +141,8 @@
 
 /* Represents one I/O buffer.  A packet is contained by one or more I/O
  * buffers in a chain.  The io_pktlen is only valid for the I/O buffer at
- * the head of the chain.
+ * the head of the chain.  The buffers in a chain need not all be of the
+ * same size class; io_bufsize gives the size of each buffer's payload.
  */
 
 struct iob_s
@@ -113,7 +153,7 @@ struct iob_s
 
   /* Payload */
 
-#if CONFIG_IOB_BUFSIZE < 256
+#if IOB_MAXBUFSIZE < 256
   uint8_t  io_len;      /* Length of the data in the entry */
   uint8_t  io_offset;   /* Data begins at this offset */
 #else
@@ -121,8 +161,10 @@ struct iob_s
   uint16_t io_offset;   /* Data begins at this offset */
 #endif
   uint16_t io_pktlen;   /* Total length of the packet */
+  uint16_t io_bufsize;  /* Size of the payload buffer */
+  uint8_t  io_pool;     /* Size class of the buffer (IOB_*_POOL) */
 
-  uint8_t  io_data[CONFIG_IOB_BUFSIZE];
+  FAR uint8_t *io_data; /* Payload buffer of io_bufsize bytes */
 };
 
 #if CONFIG_IOB_NCHAINS > 0
@@ -202,6 +244,9 @@ enum iob_user_e
 #ifdef CONFIG_NET_IPFORWARD
   IOBUSER_NET_IPFORWARD,
 #endif
+#ifdef CONFIG_NETDEV_IOB_RECEIVE
+  IOBUSER_NET_NETDEV,
+#endif
 #ifdef CONFIG_WIRELESS_IEEE802154
   IOBUSER_WIRELESS_RAD802154,
 #endif
@@ -230,6 +275,18 @@ struct iob_userstats_s
   int totalproduced;
 };
 
+/* Statistics for one I/O buffer size class */
+
+struct iob_poolstats_s
+{
+  uint16_t bufsize;     /* Payload size of each buffer */
+  uint16_t nbuffers;    /* Number of buffers in the class */
+  uint16_t nfree;       /* Number of free buffers (including cached) */
+  uint16_t ncached;     /* Number of free buffers held in per-CPU caches */
+  uint32_t nalloc;      /* Number of successful allocations */
+  uint32_t nfail;       /* Number of allocations that found no buffer */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -265,6 +322,32 @@ FAR struct iob_s *iob_alloc(bool throttled, enum iob_user_e consumerid);
 
 FAR struct iob_s *iob_tryalloc(bool throttled, enum iob_user_e consumerid);
 
+/****************************************************************************
+ * Name: iob_alloc_size
+ *
+ * Description:
+ *   Allocate an I/O buffer suited to hold 'size' bytes of payload.  The
+ *   smallest size class that can hold 'size' bytes and has a free buffer
+ *   is used.  If there is no such buffer, this falls back to iob_alloc()
+ *   and a buffer of CONFIG_IOB_BUFSIZE bytes, so the returned buffer may
+ *   still be smaller than 'size'.  Use IOB_BUFSIZE() to get its size.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_size(unsigned int size, bool throttled,
+                                 enum iob_user_e consumerid);
+
+/****************************************************************************
+ * Name: iob_tryalloc_size
+ *
+ * Description:
+ *   Same as iob_alloc_size() but never waits for a buffer to become free.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_size(unsigned int size, bool throttled,
+                                    enum iob_user_e consumerid);
+
 /****************************************************************************
  * Name: iob_navail
  *
@@ -601,6 +684,23 @@ void iob_dump(FAR const char *msg, FAR struct iob_s *iob, unsigned int len,
 FAR struct iob_userstats_s * iob_getuserstats(enum iob_user_e userid);
 #endif
 
+/****************************************************************************
+ * Name: iob_getpoolstats
+ *
+ * Description:
+ *   Return the statistics of one I/O buffer size class.
+ *
+ * Input Parameters:
+ *   pool  - The size class, 0 through IOB_NPOOLS - 1
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void iob_getpoolstats(int pool, FAR struct iob_poolstats_s *stats);
+
 #endif /* CONFIG_MM_IOB */
 #endif /* _INCLUDE_NUTTX_MM_IOB_H */
 
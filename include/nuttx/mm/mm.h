@@ -47,6 +47,10 @@
 #include <string.h>
 #include <semaphore.h>
 
+#ifdef CONFIG_MM_CACHE
+#  include <nuttx/spinlock.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -162,6 +166,24 @@
 #define MM_MAX_CHUNK     (1 << MM_MAX_SHIFT)
 #define MM_NNODES        (MM_MAX_SHIFT - MM_MIN_SHIFT + 1)
 
+/* Free list definitions for the TLSF manager:
+ *
+ * MM_SL_SHIFT is the log2 of the number of second-level lists per
+ *   first-level (power-of-two) size range.
+ * MM_FL_SHIFT is the log2 of the smallest size handled by the two-level
+ *   mapping.  Smaller chunks are kept in MM_SL_COUNT exact-size lists in
+ *   the first row.
+ * MM_FL_COUNT is the number of first-level rows.  The last row holds all
+ *   free chunks of MM_MAX_CHUNK bytes or more in a single list.
+ */
+
+#ifdef CONFIG_MM_TLSF_MANAGER
+#  define MM_SL_SHIFT    CONFIG_MM_TLSF_SLSHIFT
+#  define MM_SL_COUNT    (1 << MM_SL_SHIFT)
+#  define MM_FL_SHIFT    (MM_MIN_SHIFT + MM_SL_SHIFT)
+#  define MM_FL_COUNT    (MM_MAX_SHIFT - MM_FL_SHIFT + 2)
+#endif
+
 #define MM_GRAN_MASK     (MM_MIN_CHUNK-1)
 #define MM_ALIGN_UP(a)   (((a) + MM_GRAN_MASK) & ~MM_GRAN_MASK)
 #define MM_ALIGN_DOWN(a) ((a) & ~MM_GRAN_MASK)
@@ -178,6 +200,33 @@
 #define MM_IS_ALLOCATED(n) \
   ((int)((struct mm_allocnode_s*)(n)->preceding) < 0))
 
+/* Small-object cache definitions *******************************************/
+/* When CONFIG_MM_CACHE is selected, small chunks released by mm_free() are
+ * kept in a front-end cache and handed back out by mm_malloc() without
+ * taking the heap semaphore.  There is one cache per CPU in the SMP
+ * configuration and a single cache otherwise.  Each cache holds up to
+ * CONFIG_MM_CACHE_DEPTH chunks of every chunk size (a multiple of
+ * MM_MIN_CHUNK) up to CONFIG_MM_CACHE_MAXSIZE bytes.
+ */
+
+#ifdef CONFIG_MM_CACHE
+#  ifndef CONFIG_MM_CACHE_MAXSIZE
+#    define CONFIG_MM_CACHE_MAXSIZE 256
+#  endif
+
+#  ifndef CONFIG_MM_CACHE_DEPTH
+#    define CONFIG_MM_CACHE_DEPTH 8
+#  endif
+
+#  define MM_CACHE_NCLASSES (CONFIG_MM_CACHE_MAXSIZE >> MM_MIN_SHIFT)
+
+#  ifdef CONFIG_SMP
+#    define MM_CACHE_NCACHES CONFIG_SMP_NCPUS
+#  else
+#    define MM_CACHE_NCACHES 1
+#  endif
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -232,6 +281,24 @@ struct mm_freenode_s
 #define CHECK_FREENODE_SIZE \
   DEBUGASSERT(sizeof(struct mm_freenode_s) == SIZEOF_MM_FREENODE)
 
+#ifdef CONFIG_MM_CACHE
+/* This describes one small-object cache.  Cached chunks remain marked as
+ * allocated in the heap.  They are linked through their first payload
+ * word into one LIFO list per chunk size.
+ */
+
+struct mm_cache_s
+{
+#ifdef CONFIG_SMP
+  spinlock_t mc_lock;                      /* Only contended when flushing */
+#endif
+  FAR void *mc_free[MM_CACHE_NCLASSES];    /* Cached chunks, by size class */
+  uint8_t mc_nfree[MM_CACHE_NCLASSES];     /* Number of chunks in each list */
+  uint32_t mc_hits;                        /* mm_malloc() served from cache */
+  uint32_t mc_misses;                      /* mm_malloc() went to the heap */
+};
+#endif
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s
@@ -257,12 +324,29 @@ struct mm_heap_s
   int mm_nregions;
 #endif
 
+#ifdef CONFIG_MM_TLSF_MANAGER
+  /* Free nodes are kept in segregated, doubly linked lists, one per size
+   * class.  A bit is set in the bitmaps for each non-empty list so that a
+   * suitable list can be found in constant time.
+   */
+
+  uint32_t mm_flbitmap;
+  uint32_t mm_slbitmap[MM_FL_COUNT];
+  FAR struct mm_freenode_s *mm_freelist[MM_FL_COUNT][MM_SL_COUNT];
+#else
   /* All free nodes are maintained in a doubly linked list.  This
    * array provides some hooks into the list at various points to
    * speed searches for free nodes.
    */
 
   struct mm_freenode_s mm_nodelist[MM_NNODES];
+#endif
+
+#ifdef CONFIG_MM_CACHE
+  /* Front-end caches of small chunks, one per CPU */
+
+  struct mm_cache_s mm_cache[MM_CACHE_NCACHES];
+#endif
 };
 
 /****************************************************************************
@@ -378,6 +462,7 @@ FAR void *kmm_malloc(size_t size);
 /* Functions contained in mm_free.c *****************************************/
 
 void mm_free(FAR struct mm_heap_s *heap, FAR void *mem);
+void mm_uncachedfree(FAR struct mm_heap_s *heap, FAR void *mem);
 
 /* Functions contained in kmm_free.c ****************************************/
 
@@ -509,14 +594,42 @@ int kmm_mallinfo(struct mallinfo *info);
 void mm_shrinkchunk(FAR struct mm_heap_s *heap,
                     FAR struct mm_allocnode_s *node, size_t size);
 
-/* Functions contained in mm_addfreechunk.c *********************************/
+/* Functions contained in mm_addfreechunk.c or mm_tlsf.c ********************/
 
 void mm_addfreechunk(FAR struct mm_heap_s *heap,
                      FAR struct mm_freenode_s *node);
 
+/* Functions contained in mm_delfreechunk.c or mm_tlsf.c ********************/
+
+void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node);
+
+/* Functions contained in mm_findfreechunk.c or mm_tlsf.c *******************/
+
+FAR struct mm_freenode_s *mm_findfreechunk(FAR struct mm_heap_s *heap,
+                                           size_t size);
+
 /* Functions contained in mm_size2ndx.c.c ***********************************/
 
+#ifndef CONFIG_MM_TLSF_MANAGER
 int mm_size2ndx(size_t size);
+#endif
+
+/* Functions contained in mm_tlsf.c *****************************************/
+
+#ifdef CONFIG_MM_TLSF_MANAGER
+void mm_tlsf_initialize(FAR struct mm_heap_s *heap);
+#endif
+
+/* Functions contained in mm_cache.c ****************************************/
+
+#ifdef CONFIG_MM_CACHE
+void mm_cache_initialize(FAR struct mm_heap_s *heap);
+FAR void *mm_cache_alloc(FAR struct mm_heap_s *heap, size_t alignsize);
+bool mm_cache_free(FAR struct mm_heap_s *heap, FAR void *mem);
+int mm_cache_flush(FAR struct mm_heap_s *heap);
+void mm_cache_info(FAR struct mm_heap_s *heap, FAR struct mallinfo *info);
+#endif
 
 #undef EXTERN
 #ifdef __cplusplus
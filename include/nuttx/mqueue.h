@@ -96,6 +96,20 @@
  * Public Type Declarations
  ****************************************************************************/
 
+#ifdef CONFIG_MQ_STATISTICS
+/* Statistics of one message queue as returned by nxmq_get_stats() */
+
+struct mqueue_stats_s
+{
+  uint32_t nsent;             /* Number of messages sent */
+  uint32_t nreceived;         /* Number of messages received */
+  int16_t maxmsgs;            /* High-watermark of the queued messages */
+  size_t maxbytes;            /* High-watermark of the queued bytes */
+  uint64_t maxlatency;        /* Longest time that a message was queued */
+  uint64_t totlatency;        /* Total time that messages were queued */
+};
+#endif
+
 /* This structure defines a message queue */
 
 struct mq_des; /* forward reference */
@@ -108,7 +122,9 @@ struct mqueue_inode_s
   int16_t nmsgs;              /* Number of message in the queue */
   int16_t nwaitnotfull;       /* Number tasks waiting for not full */
   int16_t nwaitnotempty;      /* Number tasks waiting for not empty */
-#if CONFIG_MQ_MAXMSGSIZE < 256
+#if defined(CONFIG_MQ_ZEROCOPY)
+  size_t maxmsgsize;          /* Max size of message in message queue */
+#elif CONFIG_MQ_MAXMSGSIZE < 256
   uint8_t maxmsgsize;         /* Max size of message in message queue */
 #else
   uint16_t maxmsgsize;        /* Max size of message in message queue */
@@ -117,6 +133,10 @@ struct mqueue_inode_s
   pid_t ntpid;                /* Notification: Receiving Task's PID */
   struct sigevent ntevent;    /* Notification description */
   struct sigwork_s ntwork;    /* Notification work */
+#ifdef CONFIG_MQ_STATISTICS
+  size_t nbytes;              /* Number of bytes in the queued messages */
+  struct mqueue_stats_s stats; /* Statistics (in up_perf_gettime() units) */
+#endif
 };
 
 /* This describes the message queue descriptor that is held in the
@@ -400,6 +420,123 @@ int nxmq_close_group(mqd_t mqdes, FAR struct task_group_s *group);
 
 int nxmq_desclose_group(mqd_t mqdes, FAR struct task_group_s *group);
 
+#ifdef CONFIG_MQ_ZEROCOPY
+/****************************************************************************
+ * Name: nxmq_alloc_buffer
+ *
+ * Description:
+ *   Allocate a buffer for a zero-copy message from the dedicated message
+ *   buffer pool.
+ *
+ * Input Parameters:
+ *   size - The size of the buffer in bytes
+ *
+ * Returned Value:
+ *   The allocated buffer or NULL if the pool is exhausted.
+ *
+ * Assumptions:
+ *   Must not be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+FAR void *nxmq_alloc_buffer(size_t size);
+
+/****************************************************************************
+ * Name: nxmq_free_buffer
+ *
+ * Description:
+ *   Return a buffer obtained from nxmq_alloc_buffer() or from
+ *   nxmq_receive_buffer() to the message buffer pool.
+ *
+ * Input Parameters:
+ *   buffer - The buffer to be freed
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Must not be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void nxmq_free_buffer(FAR void *buffer);
+
+/****************************************************************************
+ * Name: nxmq_send_buffer
+ *
+ * Description:
+ *   This function adds a message to the message queue (mqdes) without
+ *   copying it:  The message queue takes ownership of the buffer, which
+ *   must have been allocated with nxmq_alloc_buffer().  Otherwise, it
+ *   behaves like nxmq_send().
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor
+ *   buffer - The buffer holding the message
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned on
+ *   failure (see mq_send() for the list of valid return values).  The
+ *   caller still owns the buffer if the message was not sent.
+ *
+ ****************************************************************************/
+
+int nxmq_send_buffer(mqd_t mqdes, FAR void *buffer, size_t msglen,
+                     unsigned int prio);
+
+/****************************************************************************
+ * Name: nxmq_receive_buffer
+ *
+ * Description:
+ *   This function receives the oldest of the highest priority messages
+ *   from the message queue specified by "mqdes" without copying it:  The
+ *   caller takes ownership of the buffer holding the message and must
+ *   release it with nxmq_free_buffer().  Otherwise, it behaves like
+ *   nxmq_receive().
+ *
+ *   A message that was sent with mq_send() is copied into a new buffer.
+ *
+ * Input Parameters:
+ *   mqdes  - Message Queue Descriptor
+ *   buffer - The location to return the buffer holding the message
+ *   prio   - If not NULL, the location to store message priority.
+ *
+ * Returned Value:
+ *   The length of the message is returned on success.  A negated errno
+ *   value is returned on failure (see mq_receive() for the list of valid
+ *   return values).  ENOMEM is returned if a message sent with mq_send()
+ *   could not be copied into a buffer; that message is lost.
+ *
+ ****************************************************************************/
+
+ssize_t nxmq_receive_buffer(mqd_t mqdes, FAR void **buffer,
+                            FAR unsigned int *prio);
+#endif
+
+#ifdef CONFIG_MQ_STATISTICS
+/****************************************************************************
+ * Name: nxmq_get_stats
+ *
+ * Description:
+ *   Return the statistics of a message queue.  The latencies are returned
+ *   in nanoseconds.  The latency of a message is the time from its
+ *   insertion into the message queue until its removal by a receiver.
+ *
+ * Input Parameters:
+ *   mqdes - Message queue descriptor
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -EINVAL is returned if 'mqdes' or
+ *   'stats' is NULL.
+ *
+ ****************************************************************************/
+
+int nxmq_get_stats(mqd_t mqdes, FAR struct mqueue_stats_s *stats);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
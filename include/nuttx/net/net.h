@@ -256,6 +256,18 @@ struct socket
 #endif
 };
 
+/* This is a re-entrant mutex.  It is used to implement the network lock,
+ * the per-device lock and the per-connection locks (see net_lock(),
+ * netdev_lock() and the description of the network lock below).
+ */
+
+struct net_rmutex_s
+{
+  sem_t         rm_sem;      /* Underlying semaphore */
+  pid_t         rm_holder;   /* The thread that holds the mutex */
+  unsigned int  rm_count;    /* The number of times it holds the mutex */
+};
+
 /* This defines a list of sockets indexed by the socket descriptor */
 
 #ifdef CONFIG_NET
@@ -320,8 +332,56 @@ void net_initialize(void);
  *                       momentarily to wait for an IOB to become
  *                       available.
  *
+ * The network lock protects the state shared by all devices and all
+ * connections.  It is the lock of the devif input and poll path:  Drivers
+ * hold it around ipv4_input(), ipv6_input(), devif_poll() and
+ * devif_timer(), and everything that changes the state seen by that path,
+ * such as the connection lists, the callbacks and the protocol state, is
+ * done with the network locked.
+ *
+ * Each UDP and TCP connection with read-ahead buffering has a lock of its
+ * own that protects its read-ahead queue (see udp_conn_lock() and
+ * tcp_conn_lock()).  The input path adds data with both locks held;
+ * recvfrom() takes buffered data with only the connection lock held, so
+ * that it does not wait for the input path or for other connections.
+ * Likewise, send() and sendto() copy the user data into a write buffer
+ * with the network unlocked and lock it only to queue the buffer.  The
+ * connection lock is taken after the network lock.  Nothing may wait and
+ * no other lock may be taken while a connection lock is held.
+ *
+ * Each device also has a re-entrant lock of its own, netdev_lock(), that
+ * serializes the driver work of that one device:  receiving packets into
+ * d_buf, polling for transmit data and handling timeouts.  A driver holds
+ * only its device lock while it accesses its hardware and takes the
+ * network lock only around calls into the network stack, so that drivers
+ * for different devices may run concurrently on different CPUs.  When both
+ * are needed, the device lock must be taken first.  Driver callbacks that
+ * are called with the network locked, such as d_txavail(), must not wait
+ * for the device lock.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_rmutex_initialize, net_rmutex_lock, and net_rmutex_unlock
+ *
+ * Description:
+ *   Initialize, take and release a re-entrant mutex.  A thread that holds
+ *   the mutex may take it again; the mutex is released when it has been
+ *   released as many times as it was taken.
+ *
+ * Input Parameters:
+ *   rmutex - The re-entrant mutex
+ *
+ * Returned Value:
+ *   net_rmutex_lock() returns zero (OK) on success; a negated errno value
+ *   is returned on failure (probably -ECANCELED).
+ *
  ****************************************************************************/
 
+void net_rmutex_initialize(FAR struct net_rmutex_s *rmutex);
+int net_rmutex_lock(FAR struct net_rmutex_s *rmutex);
+void net_rmutex_unlock(FAR struct net_rmutex_s *rmutex);
+
 /****************************************************************************
  * Name: net_lock
  *
@@ -961,6 +1021,39 @@ ssize_t psock_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 #define psock_recv(psock,buf,len,flags) \
   psock_recvfrom(psock,buf,len,flags,NULL,0)
 
+/****************************************************************************
+ * Name: psock_recviob
+ *
+ * Description:
+ *   Lend the oldest buffered data of a TCP socket to the caller without
+ *   copying it.  The I/O buffer chain at the head of the read-ahead queue
+ *   of the socket is removed from the queue and returned.  The caller owns
+ *   the chain and must free it with iob_free_chain() when done with it.
+ *
+ *   This never waits for data.  Use poll() to wait until data is
+ *   available.
+ *
+ * Input Parameters:
+ *   psock - A pointer to a NuttX-specific, internal socket structure
+ *   iob   - The location to return the I/O buffer chain
+ *
+ * Returned Value:
+ *   The number of bytes in the returned I/O buffer chain on success.  Zero
+ *   is returned if no data is buffered and the peer has performed an
+ *   orderly shutdown.  Otherwise a negated errno value is returned:
+ *
+ *   EAGAIN     - No data is buffered
+ *   EBADF      - psock is not a valid socket
+ *   EOPNOTSUPP - The socket is not a TCP socket
+ *
+ ****************************************************************************/
+
+struct iob_s; /* Forward reference -- see nuttx/mm/iob.h */
+
+#ifdef CONFIG_NET_TCP_READAHEAD
+ssize_t psock_recviob(FAR struct socket *psock, FAR struct iob_s **iob);
+#endif
+
 /****************************************************************************
  * Name: nx_recvfrom
  *
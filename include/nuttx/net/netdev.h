@@ -63,6 +63,10 @@
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/ip.h>
 
+#ifdef CONFIG_NET
+#  include <nuttx/net/net.h>
+#endif
+
 #ifdef CONFIG_NET_IGMP
 #  include <nuttx/net/igmp.h>
 #endif
@@ -134,6 +138,11 @@
 #  define NETDEV_TXDONE(dev)      _NETDEV_STATISTIC(dev,tx_done)
 #  define NETDEV_TXERRORS(dev)    _NETDEV_ERROR(dev,tx_errors)
 #  define NETDEV_TXTIMEOUTS(dev)  _NETDEV_ERROR(dev,tx_timeouts)
+#  ifdef CONFIG_NETDEV_POLL_BATCH
+#    define NETDEV_TXBATCHES(dev) _NETDEV_STATISTIC(dev,tx_batches)
+#  else
+#    define NETDEV_TXBATCHES(dev)
+#  endif
 
 #  define NETDEV_ERRORS(dev)      _NETDEV_STATISTIC(dev,errors)
 
@@ -151,10 +160,18 @@
 #  define NETDEV_TXDONE(dev)
 #  define NETDEV_TXERRORS(dev)
 #  define NETDEV_TXTIMEOUTS(dev)
+#  define NETDEV_TXBATCHES(dev)
 
 #  define NETDEV_ERRORS(dev)
 #endif
 
+/* Transmit capabilities that a driver may advertise in d_txcaps */
+
+#ifdef CONFIG_NETDEV_TSO
+#  define NETDEV_TXCAP_SG         (1 << 0) /* TCP payload may be in d_sgiob */
+#  define NETDEV_TXCAP_TSO        (1 << 1) /* TCP payload may exceed the MSS */
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -189,6 +206,9 @@ struct netdev_statistics_s
   uint32_t tx_done;        /* Number of packets completed */
   uint32_t tx_errors;      /* Number of receive errors (incl timeouts) */
   uint32_t tx_timeouts;    /* Number of Tx timeout errors */
+#ifdef CONFIG_NETDEV_POLL_BATCH
+  uint32_t tx_batches;     /* Number of Tx batches passed to the driver */
+#endif
 
   /* Other status */
 
@@ -223,6 +243,8 @@ struct netdev_varaddr_s
  */
 
 struct devif_callback_s; /* Forward reference */
+struct devif_txbatch_s;  /* Forward reference */
+struct iob_s;            /* Forward reference */
 
 struct net_driver_s
 {
@@ -304,6 +326,15 @@ struct net_driver_s
 
   FAR uint8_t *d_buf;
 
+#ifdef CONFIG_NETDEV_IOB_RECEIVE
+  /* If the driver receives into I/O buffers, d_iob is the I/O buffer that
+   * d_buf points into.  The network may replace it with another I/O
+   * buffer while it processes a received packet.  See netdev_iob_prepare().
+   */
+
+  FAR struct iob_s *d_iob;
+#endif
+
   /* d_appdata points to the location where application data can be read from
    * or written to in the packet buffer.
    */
@@ -343,6 +374,33 @@ struct net_driver_s
 
   uint16_t d_sndlen;
 
+#ifdef CONFIG_NETDEV_TSO
+  /* Scatter-gather transmit and TCP segmentation offload.  The driver
+   * advertises its capabilities in d_txcaps (and the largest payload that
+   * it can segment in d_tsomax) before registering the device.
+   *
+   * When d_sgiob is non-NULL, the outgoing packet is a TCP segment whose
+   * d_sndlen bytes of payload are not in d_buf:  d_buf holds only the
+   * headers and the payload is at offset d_sgoffset in the I/O buffer
+   * chain d_sgiob.  The TCP checksum is not computed.  If d_sndlen is
+   * larger than d_sgmss, the packet must be split into segments of at most
+   * d_sgmss bytes.  The driver must consume the payload and set d_sgiob to
+   * NULL before returning from the poll callback.  See devif_segment().
+   */
+
+  uint8_t d_txcaps;             /* Transmit capabilities, see NETDEV_TXCAP_* */
+  uint16_t d_tsomax;            /* Maximum payload with NETDEV_TXCAP_TSO */
+  uint16_t d_sgmss;             /* Maximum segment size for d_sgiob payload */
+  uint16_t d_sgoffset;          /* Offset to the payload in d_sgiob */
+  FAR struct iob_s *d_sgiob;    /* I/O buffer chain holding the payload */
+#endif
+
+#ifdef CONFIG_NETDEV_POLL_BATCH
+  /* The batch being filled by devif_poll_batch() or devif_timer_batch() */
+
+  FAR struct devif_txbatch_s *d_txbatch;
+#endif
+
   /* Multicast group support */
 
 #ifdef CONFIG_NET_IGMP
@@ -384,6 +442,14 @@ struct net_driver_s
   FAR struct devif_callback_s *d_conncb;
   FAR struct devif_callback_s *d_devcb;
 
+#ifdef CONFIG_NET
+  /* This lock serializes the driver work for this device.  See
+   * netdev_lock().
+   */
+
+  struct net_rmutex_s d_lock;
+#endif
+
   /* Driver callbacks */
 
   int (*d_ifup)(FAR struct net_driver_s *dev);
@@ -405,6 +471,34 @@ struct net_driver_s
 
 typedef CODE int (*devif_poll_callback_t)(FAR struct net_driver_s *dev);
 
+#ifdef CONFIG_NETDEV_POLL_BATCH
+/* One transmit buffer provided by the driver to devif_poll_batch() */
+
+struct devif_txdesc_s
+{
+  FAR uint8_t *td_buf;          /* Packet buffer (as large as d_buf) */
+  uint16_t td_len;              /* Length of the queued packet */
+};
+
+/* Sends the tb_count packets queued in a batch */
+
+typedef CODE int (*devif_batch_callback_t)(FAR struct net_driver_s *dev,
+                                           FAR struct devif_txbatch_s *batch);
+
+/* A batch of outgoing packets.  The driver provides the transmit buffers
+ * and the callbacks; the network fills tb_desc[0..tb_count-1].
+ */
+
+struct devif_txbatch_s
+{
+  devif_poll_callback_t tb_prepare;   /* Per-packet setup (may be NULL) */
+  devif_batch_callback_t tb_flush;    /* Sends the queued packets */
+  FAR struct devif_txdesc_s *tb_desc; /* Transmit buffers */
+  uint16_t tb_ndesc;                  /* Number of transmit buffers */
+  uint16_t tb_count;                  /* Number of packets queued */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -546,6 +640,67 @@ int sixlowpan_input(FAR struct radio_driver_s *ieee,
 int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback);
 int devif_timer(FAR struct net_driver_s *dev, devif_poll_callback_t callback);
 
+/****************************************************************************
+ * Name: devif_poll_batch and devif_timer_batch
+ *
+ * Description:
+ *   Batched versions of devif_poll() and devif_timer().  Rather than
+ *   calling the driver after each packet, the network builds each packet
+ *   directly in the next free transmit buffer of the batch.  The tb_prepare
+ *   callback, if any, is called for each packet once it is complete (this
+ *   is where an Ethernet driver calls arp_out() or neighbor_out()).  When
+ *   all transmit buffers are used and when polling completes, the
+ *   tb_flush callback is called to send all of the queued packets
+ *   together.  TCP payloads passed with NETDEV_TXCAP_SG or
+ *   NETDEV_TXCAP_TSO are segmented into the transmit buffers.
+ *
+ *   d_buf is restored before returning.  Polling stops early if tb_flush
+ *   returns a non-zero value.
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver with the network
+ *   locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_POLL_BATCH
+int devif_poll_batch(FAR struct net_driver_s *dev,
+                     FAR struct devif_txbatch_s *batch);
+int devif_timer_batch(FAR struct net_driver_s *dev,
+                      FAR struct devif_txbatch_s *batch);
+#endif
+
+/****************************************************************************
+ * Name: devif_segment
+ *
+ * Description:
+ *   Software scatter-gather and TCP segmentation for drivers that
+ *   advertise NETDEV_TXCAP_SG or NETDEV_TXCAP_TSO but cannot gather or
+ *   segment in hardware.  Call this from the poll callback after arp_out()
+ *   or neighbor_out() in place of sending the packet directly.
+ *
+ *   If d_sgiob is NULL, the packet in d_buf is passed to the callback as
+ *   is.  Otherwise, the payload in d_sgiob is copied into d_buf one
+ *   segment at a time behind a copy of the headers.  The sequence number,
+ *   lengths, IP ID, flags and checksums are updated for each segment
+ *   before the callback is invoked to send it.
+ *
+ * Input Parameters:
+ *   dev      - The network device holding the outgoing packet
+ *   callback - Sends the packet currently in d_buf
+ *
+ * Returned Value:
+ *   The value returned by the last invocation of the callback.  If the
+ *   callback returns a non-zero value, the remaining segments are dropped
+ *   and will be retransmitted by TCP.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_TSO
+int devif_segment(FAR struct net_driver_s *dev,
+                  devif_poll_callback_t callback);
+#endif
+
 /****************************************************************************
  * Name: neighbor_out
  *
@@ -762,4 +917,111 @@ uint16_t ipv6_chksum(FAR struct net_driver_s *dev);
 
 int netdev_lladdrsize(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * Name: netdev_iob_prepare
+ *
+ * Description:
+ *   Let the driver receive packets directly into an I/O buffer.  An I/O
+ *   buffer large enough for a full packet is allocated and d_buf is set to
+ *   point to its payload.  The driver then receives into d_buf as usual.
+ *
+ *   While the network processes a received packet, it may take ownership
+ *   of the I/O buffer holding the packet and replace d_iob and d_buf with
+ *   a new I/O buffer.  The driver must therefore always use the current
+ *   value of d_buf and must not keep its own copies of the pointer.  The
+ *   replacement is ready to receive the next packet.
+ *
+ * Input Parameters:
+ *   dev - The device driver structure
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  -ENOMEM is returned if no sufficiently large
+ *   I/O buffer is available; d_buf is left unchanged in that case.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_IOB_RECEIVE
+int netdev_iob_prepare(FAR struct net_driver_s *dev);
+#endif
+
+/****************************************************************************
+ * Name: netdev_iob_release
+ *
+ * Description:
+ *   Stop receiving into I/O buffers.  The I/O buffer in d_iob is freed and
+ *   d_buf is set to 'buf', the packet buffer of the driver.
+ *
+ * Input Parameters:
+ *   dev - The device driver structure
+ *   buf - The packet buffer to use from now on
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_IOB_RECEIVE
+void netdev_iob_release(FAR struct net_driver_s *dev, FAR uint8_t *buf);
+#endif
+
+/****************************************************************************
+ * Name: netdev_iob_detach
+ *
+ * Description:
+ *   Take the I/O buffer holding the packet being received, trimmed to the
+ *   'buflen' bytes at 'buffer', so that it can be queued without copying
+ *   the data.  The device is given a new I/O buffer holding a copy of
+ *   everything in front of 'buffer' (the link layer and protocol headers)
+ *   so that the network can still build its response in d_buf.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure
+ *   buffer - The start of the data to take, within d_buf
+ *   buflen - The number of bytes of data to take
+ *
+ * Returned Value:
+ *   The detached I/O buffer, or NULL if the device is not receiving into
+ *   I/O buffers or no replacement I/O buffer is available.  In the latter
+ *   case, the caller must copy the data.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_IOB_RECEIVE
+FAR struct iob_s *netdev_iob_detach(FAR struct net_driver_s *dev,
+                                    FAR uint8_t *buffer, uint16_t buflen);
+#endif
+
+/****************************************************************************
+ * Name: netdev_lock and netdev_unlock
+ *
+ * Description:
+ *   Take or release the re-entrant lock of one network device.  Drivers
+ *   hold this lock while they access the hardware and the device packet
+ *   buffer, and take the network lock only around the calls into the
+ *   network stack (ipv4_input(), devif_poll(), etc.).  The device lock
+ *   must always be taken before the network lock.
+ *
+ * Input Parameters:
+ *   dev - A reference to the device to lock or unlock
+ *
+ * Returned Value:
+ *   netdev_lock() returns zero (OK) on success; a negated errno value is
+ *   returned on failure (probably -ECANCELED).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET
+#  define netdev_lock(dev)   net_rmutex_lock(&(dev)->d_lock)
+#  define netdev_unlock(dev) net_rmutex_unlock(&(dev)->d_lock)
+#endif
+
 #endif /* __INCLUDE_NUTTX_NET_NETDEV_H */
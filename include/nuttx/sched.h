@@ -707,6 +707,17 @@ struct tcb_s
   uint32_t crit_max;                     /* Max time in critical section        */
 #endif
 
+  /* Scheduler statistics *******************************************************/
+
+#ifdef CONFIG_SCHED_SCHEDSTAT
+  uint64_t run_time;                     /* Time running (up_perf_gettime)      */
+  uint64_t wait_time;                    /* Time ready but not running          */
+  uint32_t nvcsw;                        /* Number of voluntary switches        */
+  uint32_t nivcsw;                       /* Number of involuntary switches      */
+  uint32_t stat_start;                   /* Time of the last accounting         */
+  uint8_t  stat_state;                   /* See SCHEDSTAT_* in sched/sched.h    */
+#endif
+
   /* Library related fields *****************************************************/
 
   int pterrno;                           /* Current per-thread errno            */
@@ -47,6 +47,7 @@
 #include <stdbool.h>
 
 #include <nuttx/sched.h>
+#include <nuttx/fs/ioctl.h>
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION
 
@@ -66,6 +67,17 @@
 #  define CONFIG_SCHED_NOTE_BUFSIZE 2048
 #endif
 
+/* IOCTL commands supported by the /dev/note driver */
+
+#define NOTEIOC_STREAM   _NOTEIOC(0x0001) /* IN:  Non-zero: read() waits for
+                                           *      notes (int)
+                                           * OUT: None
+                                           */
+#define NOTEIOC_OVERFLOW _NOTEIOC(0x0002) /* IN:  Location to return value
+                                           *      (uint32_t *)
+                                           * OUT: Number of notes lost
+                                           */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -106,6 +118,8 @@ enum note_type_e
   NOTE_SPINLOCK_UNLOCK = 16,
   NOTE_SPINLOCK_ABORT  = 17
 #endif
+  ,
+  NOTE_OVERFLOW        = 18
 };
 
 /* This structure provides the common header of each note */
@@ -234,6 +248,17 @@ struct note_spinlock_s
   uint8_t nsp_value;            /* Value of spinlock */
 };
 #endif /* CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS */
+
+/* This is the specific form of the NOTE_OVERFLOW note.  It reports the
+ * number of notes that were lost on a CPU because its buffer was full.  It
+ * carries the common parameters of the first note added after the loss.
+ */
+
+struct note_overflow_s
+{
+  struct note_common_s nov_cmn; /* Common note parameters */
+  uint8_t nov_count[4];         /* Number of notes lost */
+};
 #endif /* CONFIG_SCHED_INSTRUMENTATION_BUFFER */
 
 /****************************************************************************
@@ -311,6 +336,8 @@ void sched_note_spinabort(FAR struct tcb_s *tcb, FAR volatile void *spinlock);
  * Description:
  *   Remove the next note from the tail of the circular buffer.  The note
  *   is also removed from the circular buffer to make room for further notes.
+ *   In SMP configurations, each CPU has its own circular buffer and the
+ *   oldest note of all CPUs is returned.
  *
  * Input Parameters:
  *   buffer - Location to return the next note
@@ -348,6 +375,25 @@ ssize_t sched_note_get(FAR uint8_t *buffer, size_t buflen);
 ssize_t sched_note_size(void);
 #endif
 
+/****************************************************************************
+ * Name: sched_note_overflow
+ *
+ * Description:
+ *   Return the total number of notes that were lost on all CPUs because
+ *   the circular buffers were full.
+ *
+ * Input Parameters:
+ *   None.
+ *
+ * Returned Value:
+ *   The number of lost notes.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_BUFFER
+uint32_t sched_note_overflow(void);
+#endif
+
 /****************************************************************************
  * Name: note_register
  *
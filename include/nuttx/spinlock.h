@@ -45,6 +45,8 @@
 #include <sys/types.h>
 #include <stdint.h>
 
+#include <arch/irq.h>
+
 #ifdef CONFIG_SPINLOCK
 
 /* The architecture specific spinlock.h header file must also provide the
@@ -96,6 +98,47 @@
 #  define SP_SECTION
 #endif
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_STATS
+/* The contention statistics of one ticket lock.  They are only modified by
+ * the holder of the lock.
+ */
+
+struct spinlock_stats_s
+{
+  FAR struct spinlock_stats_s *flink; /* Next named lock */
+  FAR const char *name;               /* Name shown in /proc/spinlock */
+  uint32_t nlocks;                    /* Number of acquisitions */
+  uint32_t ncontended;                /* Acquisitions that had to wait */
+  uint32_t nspins;                    /* Iterations spent waiting */
+  uint32_t maxhold;                   /* Longest hold (up_perf_gettime) */
+  uint32_t start;                     /* Time of the last acquisition */
+};
+#endif
+
+/* A ticket lock.  Unlike a plain spinlock, which is given to whichever CPU
+ * happens to win the test-and-set, a ticket lock is given to the waiting
+ * CPUs in the order in which they asked for it.  Only up_testset() is
+ * required from the architecture:  'guard' serializes drawing a ticket.
+ *
+ * The all-zero state is unlocked if SP_UNLOCKED is zero; otherwise use
+ * spin_ticket_initialize().  Statistics are kept for the locks that are
+ * named with spin_ticket_register().
+ */
+
+struct spin_ticket_s
+{
+  volatile spinlock_t guard;          /* Protects 'next' */
+  volatile uint16_t next;             /* The next ticket to be drawn */
+  volatile uint16_t owner;            /* The ticket now being served */
+#ifdef CONFIG_SPINLOCK_STATS
+  struct spinlock_stats_s stats;      /* Contention statistics */
+#endif
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -342,5 +385,176 @@ void spin_clrbit(FAR volatile cpu_set_t *set, unsigned int cpu,
                  FAR volatile spinlock_t *orlock);
 #endif
 
+/****************************************************************************
+ * Name: spin_lock_save
+ *
+ * Description:
+ *   Disable local interrupts and take the spinlock 'lock'.  This is the
+ *   per-object counterpart of spin_lock_irqsave():  Data that is shared
+ *   with interrupt handlers and other CPUs but that is otherwise
+ *   independent of the scheduler can be protected by its own spinlock
+ *   instead of by the critical section.
+ *
+ *   This is not re-entrant.  Do not call any kernel API that may suspend
+ *   the caller (e.g. nxsem_wait) while holding the lock.  If the critical
+ *   section is needed too, it must be entered first.
+ *
+ *   Without CONFIG_SPINLOCK, this is equivalent to up_irq_save() and the
+ *   lock argument is not evaluated.  The lock object itself may then be
+ *   omitted.
+ *
+ * Input Parameters:
+ *   lock - A reference to the spinlock object to lock.
+ *
+ * Returned Value:
+ *   An opaque, architecture-specific value that represents the state of
+ *   the interrupts prior to the call to spin_lock_save().
+ *
+ ****************************************************************************/
+
+irqstate_t spin_lock_save(FAR volatile spinlock_t *lock);
+
+/****************************************************************************
+ * Name: spin_unlock_restore
+ *
+ * Description:
+ *   Release the spinlock taken by spin_lock_save() and restore the
+ *   interrupt state as it was prior to that call.
+ *
+ * Input Parameters:
+ *   lock  - A reference to the spinlock object to unlock.
+ *   flags - The value returned by spin_lock_save().
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void spin_unlock_restore(FAR volatile spinlock_t *lock, irqstate_t flags);
+
+/****************************************************************************
+ * Name: spin_ticket_initialize
+ *
+ * Description:
+ *   Initialize a ticket lock to its unlocked state.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket lock to be initialized.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+/* void spin_ticket_initialize(FAR struct spin_ticket_s *lock); */
+#define spin_ticket_initialize(l) \
+  do \
+    { \
+      (l)->guard = SP_UNLOCKED; \
+      (l)->next  = 0; \
+      (l)->owner = 0; \
+    } \
+  while (0)
+
+/****************************************************************************
+ * Name: spin_ticket_register
+ *
+ * Description:
+ *   Give a ticket lock a name and add it to the list of locks shown in
+ *   /proc/spinlock.  The lock may already be in use.  Registered locks must
+ *   never be freed.  Without CONFIG_SPINLOCK_STATS this does nothing.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket lock.
+ *   name - The name of the lock.  The string is not copied.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_STATS
+void spin_ticket_register(FAR struct spin_ticket_s *lock,
+                          FAR const char *name);
+#else
+#  define spin_ticket_register(l,n)
+#endif
+
+/****************************************************************************
+ * Name: spin_ticket_lock_save
+ *
+ * Description:
+ *   Disable local interrupts and take the ticket lock 'lock'.  This is the
+ *   fair counterpart of spin_lock_save():  If several CPUs are waiting,
+ *   they get the lock in the order in which they called this function.
+ *
+ *   This is not re-entrant and the same rules as for spin_lock_save()
+ *   apply.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket lock to lock.
+ *
+ * Returned Value:
+ *   An opaque, architecture-specific value that represents the state of
+ *   the interrupts prior to the call to spin_ticket_lock_save().
+ *
+ ****************************************************************************/
+
+irqstate_t spin_ticket_lock_save(FAR struct spin_ticket_s *lock);
+
+/****************************************************************************
+ * Name: spin_ticket_unlock_restore
+ *
+ * Description:
+ *   Give the ticket lock to the next waiting CPU and restore the interrupt
+ *   state as it was prior to the call to spin_ticket_lock_save().
+ *
+ * Input Parameters:
+ *   lock  - A reference to the ticket lock to unlock.
+ *   flags - The value returned by spin_ticket_lock_save().
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void spin_ticket_unlock_restore(FAR struct spin_ticket_s *lock,
+                                irqstate_t flags);
+
+/****************************************************************************
+ * Name: spin_stats_next
+ *
+ * Description:
+ *   Walk the list of ticket locks named with spin_ticket_register().
+ *
+ * Input Parameters:
+ *   stats - The statistics returned by the previous call, or NULL to get
+ *           the first lock.
+ *
+ * Returned Value:
+ *   The statistics of the next named lock, or NULL if there are no more.
+ *   The counts are not copied and may change while they are read.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_STATS
+FAR struct spinlock_stats_s *
+  spin_stats_next(FAR struct spinlock_stats_s *stats);
+#endif
+
+#else /* CONFIG_SPINLOCK */
+
+/* There is only one CPU:  Memory barriers are not needed */
+
+#  define SP_DMB()
+#  define SP_DSB()
+
+#  define spin_lock_save(l)               up_irq_save()
+#  define spin_unlock_restore(l,f)        up_irq_restore(f)
+#  define spin_ticket_initialize(l)
+#  define spin_ticket_register(l,n)
+#  define spin_ticket_lock_save(l)        up_irq_save()
+#  define spin_ticket_unlock_restore(l,f) up_irq_restore(f)
+
 #endif /* CONFIG_SPINLOCK */
 #endif /* __INCLUDE_NUTTX_SPINLOCK_H */
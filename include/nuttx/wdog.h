@@ -43,6 +43,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
 #include <stdint.h>
 #include <queue.h>
 
@@ -146,6 +147,11 @@ struct wdog_s
   int                lag;        /* Timer associated with the delay */
   uint8_t            flags;      /* See WDOGF_* definitions above */
   uint8_t            argc;       /* The number of parameters to pass */
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  uint8_t            slot;       /* Timing wheel slot holding the watchdog */
+  FAR struct wdog_s *prev;       /* Support for doubly linked slot lists */
+  clock_t            expire;     /* Absolute expiration time in ticks */
+#endif
   wdparm_t           parm[CONFIG_MAX_WDOGPARMS];
 };
 
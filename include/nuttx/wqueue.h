@@ -276,8 +276,29 @@ struct work_s
   FAR void *arg;         /* Callback argument */
   clock_t qtime;         /* Time work queued */
   clock_t delay;         /* Delay until work performed */
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  uint8_t cpu;           /* CPU whose queue holds the work */
+#endif
 };
 
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+/* Statistics of one per-CPU, high-priority work queue as returned by
+ * work_cpustats().  Latencies are the times, in clock ticks, from when work
+ * became ready to run until it was started.
+ */
+
+struct work_cpustats_s
+{
+  uint32_t ws_queued;     /* Number of work items queued on this CPU */
+  uint32_t ws_run;        /* Number of work items run by this CPU's worker */
+  uint32_t ws_stolen;     /* Number of those taken from other CPUs' queues */
+  uint16_t ws_depth;      /* Number of work items currently queued */
+  uint16_t ws_maxdepth;   /* Largest number of work items queued at once */
+  clock_t  ws_avglatency; /* Average latency */
+  clock_t  ws_maxlatency; /* Longest latency */
+};
+#endif
+
 /* This is an enumeration of the various events that may be
  * notified via work_notifier_signal().
  */
@@ -406,6 +427,32 @@ int work_usrstart(void);
 int work_queue(int qid, FAR struct work_s *work, worker_t worker,
                FAR void *arg, clock_t delay);
 
+/****************************************************************************
+ * Name: work_queue_cpu
+ *
+ * Description:
+ *   Queue work like work_queue() with a hint of the CPU that should perform
+ *   it.  With CONFIG_SCHED_HPWORK_PERCPU, HPWORK work is queued on the
+ *   queue of that CPU (although an idle worker on another CPU may still
+ *   take it).  Otherwise the hint is ignored.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID
+ *   cpu    - The preferred CPU, or -1 for the current CPU
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.
+ *   arg    - The argument that will be passed to the worker callback
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+int work_queue_cpu(int qid, int cpu, FAR struct work_s *work,
+                   worker_t worker, FAR void *arg, clock_t delay);
+
 /****************************************************************************
  * Name: work_cancel
  *
@@ -463,6 +510,25 @@ int work_signal(int qid);
 
 #define work_available(work) ((work)->worker == NULL)
 
+/****************************************************************************
+ * Name: work_cpustats
+ *
+ * Description:
+ *   Return the statistics of the high-priority work queue of one CPU.
+ *
+ * Input Parameters:
+ *   cpu   - The CPU index
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero on success; -EINVAL if the CPU index is out of range.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+int work_cpustats(int cpu, FAR struct work_cpustats_s *stats);
+#endif
+
 /****************************************************************************
  * Name: lpwork_boostpriority
  *
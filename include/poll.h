@@ -110,6 +110,13 @@ typedef unsigned int nfds_t;
 
 typedef uint8_t pollevent_t;
 
+/* A poll notification callback.  If a struct pollfd provides one, the
+ * driver's poll_notify() calls it instead of posting the semaphore.
+ */
+
+struct pollfd;
+typedef CODE void (*pollcb_t)(FAR struct pollfd *fds);
+
 /* This is the Nuttx variant of the standard pollfd structure.  The poll()
  * interfaces receive a variable length array of such structures.
  *
@@ -131,6 +138,7 @@ struct pollfd
 
   FAR void    *ptr;     /* The psock or file being polled */
   FAR sem_t   *sem;     /* Pointer to semaphore used to post output event */
+  pollcb_t     cb;      /* Called instead of posting sem, if non-NULL */
   FAR void    *priv;    /* For use by drivers */
 };
 
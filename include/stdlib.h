@@ -95,6 +95,12 @@ struct mallinfo
                  * chunks handed out by malloc. */
   int fordblks; /* This is the total size of memory occupied
                  * by free (not in use) chunks.*/
+#ifdef CONFIG_MM_CACHE
+  int cacheblks; /* This is the total size of memory held in the small-
+                  * object caches (included in uordblks). */
+  unsigned long cachehits;   /* Allocations served by the caches */
+  unsigned long cachemisses; /* Cacheable allocations that missed */
+#endif
 };
 
 /* Structure type returned by the div() function. */
@@ -1,5 +1,5 @@
 /****************************************************************************
- * fs/vfs/fs_epoll.c
+ * include/sys/epoll.h
  *
  *   Copyright (C) 2015 Anton D. Kachalov. All rights reserved.
  *   Author: Anton D. Kachalov <mouse@mayc.ru>
@@ -40,6 +40,9 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
+#include <stdint.h>
 #include <poll.h>
 
 /****************************************************************************
@@ -50,6 +53,20 @@
 #define EPOLL_CTL_DEL 2 /* Remove a file descriptor from the interface.  */
 #define EPOLL_CTL_MOD 3 /* Change file descriptor epoll_event structure.  */
 
+/* Input flags that select the delivery mode of an event.  These do not fit
+ * in a pollevent_t and are never reported in the output event set:
+ *
+ *   EPOLLONESHOT
+ *     Report the file descriptor once, then disable it until it is re-armed
+ *     with EPOLL_CTL_MOD.
+ *   EPOLLET
+ *     Edge-triggered:  Report the file descriptor only when the driver
+ *     signals a new event, rather than for as long as it stays ready.
+ */
+
+#define EPOLLONESHOT  (1 << 30)
+#define EPOLLET       (1u << 31)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -76,35 +93,45 @@ enum EPOLL_EVENTS
 #define EPOLLHUP EPOLLHUP
   };
 
-typedef union poll_data
+typedef union epoll_data
 {
+  FAR void    *ptr;      /* Caller data returned with the event */
   int          fd;       /* The descriptor being polled */
+  uint32_t     u32;
+#ifdef __INT64_DEFINED
+  uint64_t     u64;
+#endif
 } epoll_data_t;
 
 struct epoll_event
 {
-  epoll_data_t data;
-  FAR sem_t   *sem;      /* Pointer to semaphore used to post output event */
-  pollevent_t  events;   /* The input event flags */
-  pollevent_t  revents;  /* The output event flags */
-  FAR void    *priv;     /* For use by drivers */
-};
-
-struct epoll_head
-{
-  int size;
-  int occupied;
-  FAR struct epoll_event *evs;
+  uint32_t     events;   /* Input: Requested events;  Output: Ready events */
+  epoll_data_t data;     /* Returned unmodified with each event */
 };
 
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
 int epoll_create(int size);
-int epoll_ctl(int epfd, int op, int fd, struct epoll_event *ev);
-int epoll_wait(int epfd, struct epoll_event *evs, int maxevents, int timeout);
+int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev);
+int epoll_wait(int epfd, FAR struct epoll_event *evs, int maxevents,
+               int timeout);
 
 void epoll_close(int epfd);
 
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
 #endif /* __INCLUDE_SYS_EPOLL_H */
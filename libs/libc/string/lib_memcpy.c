@@ -39,8 +39,50 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_MEMCPY_OPTSPEED
+
+/* The copy is done in units of the native word, uintptr_t */
+
+#define WORDSIZE      sizeof(uintptr_t)
+#define WORDMASK      (WORDSIZE - 1)
+
+/* Shorter copies are not worth the setup */
+
+#define MEMCPY_MINWORD  (2 * WORDSIZE)
+
+/* The GCC vector extension lets the compiler use SIMD registers for the
+ * bulk of an aligned copy, or it falls back to scalar code.
+ */
+
+#if defined(CONFIG_LIBC_STRING_VECTOR) && defined(__GNUC__)
+#  define MEMCPY_VECTOR 1
+typedef uint32_t memcpy_vec_t __attribute__((vector_size(16)));
+#  define VECSIZE     sizeof(memcpy_vec_t)
+#  define VECMASK     (VECSIZE - 1)
+#endif
+
+/* Shifts that merge two source words when the source and destination are
+ * not aligned the same way.  SHIFT_HEAD selects the bytes of the earlier
+ * word, SHIFT_TAIL those of the later word.
+ */
+
+#ifdef CONFIG_ENDIAN_BIG
+#  define SHIFT_HEAD(w, s) ((w) << (s))
+#  define SHIFT_TAIL(w, s) ((w) >> (s))
+#else
+#  define SHIFT_HEAD(w, s) ((w) >> (s))
+#  define SHIFT_TAIL(w, s) ((w) << (s))
+#endif
+
+#endif /* CONFIG_MEMCPY_OPTSPEED */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -50,6 +92,121 @@
  ****************************************************************************/
 
 #ifndef CONFIG_LIBC_ARCH_MEMCPY
+#ifdef CONFIG_MEMCPY_OPTSPEED
+FAR void *memcpy(FAR void *dest, FAR const void *src, size_t n)
+{
+  FAR unsigned char *pout = (FAR unsigned char *)dest;
+  FAR const unsigned char *pin = (FAR const unsigned char *)src;
+
+  if (n >= MEMCPY_MINWORD)
+    {
+      FAR uintptr_t *wout;
+      FAR const uintptr_t *win;
+
+      /* Copy the head bytes until the destination is word aligned */
+
+      while (((uintptr_t)pout & WORDMASK) != 0)
+        {
+          *pout++ = *pin++;
+          n--;
+        }
+
+      wout = (FAR uintptr_t *)pout;
+
+      if (((uintptr_t)pin & WORDMASK) == 0)
+        {
+          /* The source is aligned the same way */
+
+          win = (FAR const uintptr_t *)pin;
+
+#ifdef MEMCPY_VECTOR
+          if ((((uintptr_t)wout ^ (uintptr_t)win) & VECMASK) == 0)
+            {
+              while (((uintptr_t)wout & VECMASK) != 0 && n >= WORDSIZE)
+                {
+                  *wout++ = *win++;
+                  n      -= WORDSIZE;
+                }
+
+              while (n >= 4 * VECSIZE)
+                {
+                  FAR memcpy_vec_t *vout = (FAR memcpy_vec_t *)wout;
+                  FAR const memcpy_vec_t *vin =
+                    (FAR const memcpy_vec_t *)win;
+
+                  vout[0] = vin[0];
+                  vout[1] = vin[1];
+                  vout[2] = vin[2];
+                  vout[3] = vin[3];
+
+                  wout   += (4 * VECSIZE) / WORDSIZE;
+                  win    += (4 * VECSIZE) / WORDSIZE;
+                  n      -= 4 * VECSIZE;
+                }
+            }
+#endif
+
+          while (n >= 4 * WORDSIZE)
+            {
+              wout[0] = win[0];
+              wout[1] = win[1];
+              wout[2] = win[2];
+              wout[3] = win[3];
+
+              wout   += 4;
+              win    += 4;
+              n      -= 4 * WORDSIZE;
+            }
+
+          while (n >= WORDSIZE)
+            {
+              *wout++ = *win++;
+              n      -= WORDSIZE;
+            }
+
+          pin = (FAR const unsigned char *)win;
+        }
+      else
+        {
+          /* The source is misaligned with respect to the destination.
+           * Read aligned source words and merge each pair into one
+           * destination word.  The aligned reads never cross into another
+           * word than the one holding the last byte copied.
+           */
+
+          unsigned int offset = (uintptr_t)pin & WORDMASK;
+          unsigned int head   = 8 * offset;
+          unsigned int tail   = 8 * (WORDSIZE - offset);
+          uintptr_t prev;
+          uintptr_t next;
+
+          win  = (FAR const uintptr_t *)(pin - offset);
+          prev = *win++;
+
+          while (n >= WORDSIZE)
+            {
+              next    = *win++;
+              *wout++ = SHIFT_HEAD(prev, head) | SHIFT_TAIL(next, tail);
+              prev    = next;
+              n      -= WORDSIZE;
+            }
+
+          pin = (FAR const unsigned char *)win - WORDSIZE + offset;
+        }
+
+      pout = (FAR unsigned char *)wout;
+    }
+
+  /* Copy the remaining tail bytes */
+
+  while (n-- > 0)
+    {
+      *pout++ = *pin++;
+    }
+
+  return dest;
+}
+#else
 FAR void *memcpy(FAR void *dest, FAR const void *src, size_t n)
 {
   FAR unsigned char *pout = (FAR unsigned char *)dest;
@@ -58,3 +215,4 @@ FAR void *memcpy(FAR void *dest, FAR const void *src, size_t n)
   return dest;
 }
 #endif
+#endif
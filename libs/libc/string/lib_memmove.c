@@ -39,13 +39,165 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_MEMMOVE_OPTSPEED
+
+/* Overlapping moves are done in units of the native word, uintptr_t, when
+ * the source and destination are aligned the same way.
+ */
+
+#define WORDSIZE      sizeof(uintptr_t)
+#define WORDMASK      (WORDSIZE - 1)
+
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: memmove
+ ****************************************************************************/
+
 #ifndef CONFIG_LIBC_ARCH_MEMMOVE
+#ifdef CONFIG_MEMMOVE_OPTSPEED
+FAR void *memmove(FAR void *dest, FAR const void *src, size_t count)
+{
+  FAR unsigned char *tmp = (FAR unsigned char *)dest;
+  FAR const unsigned char *s = (FAR const unsigned char *)src;
+  bool aligned;
+
+  /* Regions that do not overlap can use the fastest available memcpy() */
+
+  if (tmp + count <= s || s + count <= tmp)
+    {
+      return memcpy(dest, src, count);
+    }
+
+  aligned = count >= 2 * WORDSIZE &&
+            (((uintptr_t)tmp ^ (uintptr_t)s) & WORDMASK) == 0;
+
+  if (tmp <= s)
+    {
+      /* Copy forward.  Each source word is read before the destination
+       * word that may overlay it is written.
+       */
+
+      if (aligned)
+        {
+          FAR uintptr_t *wout;
+          FAR const uintptr_t *win;
+
+          while (((uintptr_t)tmp & WORDMASK) != 0)
+            {
+              *tmp++ = *s++;
+              count--;
+            }
+
+          wout = (FAR uintptr_t *)tmp;
+          win  = (FAR const uintptr_t *)s;
+
+          while (count >= 4 * WORDSIZE)
+            {
+              uintptr_t w0 = win[0];
+              uintptr_t w1 = win[1];
+              uintptr_t w2 = win[2];
+              uintptr_t w3 = win[3];
+
+              wout[0] = w0;
+              wout[1] = w1;
+              wout[2] = w2;
+              wout[3] = w3;
+
+              wout   += 4;
+              win    += 4;
+              count  -= 4 * WORDSIZE;
+            }
+
+          while (count >= WORDSIZE)
+            {
+              *wout++ = *win++;
+              count  -= WORDSIZE;
+            }
+
+          tmp = (FAR unsigned char *)wout;
+          s   = (FAR const unsigned char *)win;
+        }
+
+      while (count-- > 0)
+        {
+          *tmp++ = *s++;
+        }
+    }
+  else
+    {
+      /* Copy backward from the end */
+
+      tmp += count;
+      s   += count;
+
+      if (aligned)
+        {
+          FAR uintptr_t *wout;
+          FAR const uintptr_t *win;
+
+          while (((uintptr_t)tmp & WORDMASK) != 0)
+            {
+              *--tmp = *--s;
+              count--;
+            }
+
+          wout = (FAR uintptr_t *)tmp;
+          win  = (FAR const uintptr_t *)s;
+
+          while (count >= 4 * WORDSIZE)
+            {
+              uintptr_t w0;
+              uintptr_t w1;
+              uintptr_t w2;
+              uintptr_t w3;
+
+              win    -= 4;
+              w3      = win[3];
+              w2      = win[2];
+              w1      = win[1];
+              w0      = win[0];
+
+              wout   -= 4;
+              wout[3] = w3;
+              wout[2] = w2;
+              wout[1] = w1;
+              wout[0] = w0;
+
+              count  -= 4 * WORDSIZE;
+            }
+
+          while (count >= WORDSIZE)
+            {
+              *--wout = *--win;
+              count  -= WORDSIZE;
+            }
+
+          tmp = (FAR unsigned char *)wout;
+          s   = (FAR const unsigned char *)win;
+        }
+
+      while (count-- > 0)
+        {
+          *--tmp = *--s;
+        }
+    }
+
+  return dest;
+}
+#else
 FAR void *memmove(FAR void *dest, FAR const void *src, size_t count)
 {
   FAR char *tmp;
@@ -75,3 +227,4 @@ FAR void *memmove(FAR void *dest, FAR const void *src, size_t count)
   return dest;
 }
 #endif
+#endif
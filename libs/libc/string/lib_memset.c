@@ -58,6 +58,18 @@
 #  undef CONFIG_MEMSET_64BIT
 #endif
 
+/* The GCC vector extension lets the compiler use SIMD registers for the
+ * bulk of a large memset(), or it falls back to scalar code.
+ */
+
+#if defined(CONFIG_MEMSET_OPTSPEED) && defined(CONFIG_LIBC_STRING_VECTOR) && \
+    defined(__GNUC__)
+#  define MEMSET_VECTOR 1
+typedef uint32_t memset_vec_t __attribute__((vector_size(16)));
+#  define VECSIZE     sizeof(memset_vec_t)
+#  define VECMASK     (VECSIZE - 1)
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -106,8 +118,55 @@ FAR void *memset(FAR void *s, int c, size_t n)
               n    -= 2;
             }
 
+#ifdef MEMSET_VECTOR
+          /* Fill large blocks with vector stores */
+
+          if (n >= 4 * VECSIZE)
+            {
+              memset_vec_t vec;
+
+              vec[0] = val32;
+              vec[1] = val32;
+              vec[2] = val32;
+              vec[3] = val32;
+
+              while ((addr & VECMASK) != 0)
+                {
+                  *(FAR uint32_t *)addr = val32;
+                  addr += 4;
+                  n    -= 4;
+                }
+
+              while (n >= 4 * VECSIZE)
+                {
+                  FAR memset_vec_t *vaddr = (FAR memset_vec_t *)addr;
+
+                  vaddr[0] = vec;
+                  vaddr[1] = vec;
+                  vaddr[2] = vec;
+                  vaddr[3] = vec;
+                  addr    += 4 * VECSIZE;
+                  n       -= 4 * VECSIZE;
+                }
+            }
+#endif
+
 #ifndef CONFIG_MEMSET_64BIT
-          /* Loop while there are at least 32-bits left to be written */
+          /* Loop while there are at least four 32-bit words left to be
+           * written, then while there is at least one.
+           */
+
+          while (n >= 16)
+            {
+              FAR uint32_t *waddr = (FAR uint32_t *)addr;
+
+              waddr[0] = val32;
+              waddr[1] = val32;
+              waddr[2] = val32;
+              waddr[3] = val32;
+              addr    += 16;
+              n       -= 16;
+            }
 
           while (n >= 4)
             {
@@ -131,7 +190,21 @@ FAR void *memset(FAR void *s, int c, size_t n)
                   n    -= 4;
                 }
 
-              /* Loop while there are at least 64-bits left to be written */
+              /* Loop while there are at least four 64-bit words left to be
+               * written, then while there is at least one.
+               */
+
+              while (n >= 32)
+                {
+                  FAR uint64_t *waddr = (FAR uint64_t *)addr;
+
+                  waddr[0] = val64;
+                  waddr[1] = val64;
+                  waddr[2] = val64;
+                  waddr[3] = val64;
+                  addr    += 32;
+                  n       -= 32;
+                }
 
               while (n >= 8)
                 {
@@ -42,9 +42,11 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <semaphore.h>
 #include <debug.h>
 
+#include <nuttx/spinlock.h>
 #include <nuttx/mm/iob.h>
 
 #ifdef CONFIG_MM_IOB
@@ -83,10 +85,58 @@
 #endif
 #endif /* CONFIG_DEBUG_FEATURES && CONFIG_IOB_DEBUG */
 
+#ifdef CONFIG_SMP
+#  define IOB_NCPUS CONFIG_SMP_NCPUS
+#else
+#  define IOB_NCPUS 1
+#endif
+
+#ifndef CONFIG_IOB_CACHE_SIZE
+#  define CONFIG_IOB_CACHE_SIZE 0
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Free buffers of one size class that are owned by one CPU.  Only that CPU
+ * touches the list, and then only with local interrupts disabled.  The
+ * statistics of all size classes are also kept per CPU.
+ */
+
+struct iob_cache_s
+{
+  FAR struct iob_s *ic_head;  /* List of free buffers */
+  uint16_t ic_count;          /* Number of buffers in the list */
+  uint32_t ic_nalloc;         /* Successful allocations on this CPU */
+  uint32_t ic_nfail;          /* Failed allocations on this CPU */
+};
+
+/* One I/O buffer size class.  The free buffers of the default class are
+ * kept in g_iob_freelist and g_iob_committed and are counted by g_iob_sem;
+ * only the statistics below are used for that class.
+ */
+
+struct iob_pool_s
+{
+  FAR struct iob_s *ip_freelist;  /* Free buffers not cached by a CPU */
+  uint16_t ip_nfree;              /* Number of buffers in ip_freelist */
+  uint16_t ip_bufsize;            /* Payload size of each buffer */
+  uint16_t ip_nbuffers;           /* Number of buffers in the class */
+#ifdef CONFIG_SMP
+  spinlock_t ip_lock;             /* Protects ip_freelist */
+#endif
+  struct iob_cache_s ip_cache[IOB_NCPUS];
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
+/* The I/O buffer size classes */
+
+extern struct iob_pool_s g_iob_pools[IOB_NPOOLS];
+
 /* A list of all free, unallocated I/O buffers */
 
 extern FAR struct iob_s *g_iob_freelist;
@@ -154,6 +204,34 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void);
 
 FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 
+/****************************************************************************
+ * Name: iob_pool_tryalloc
+ *
+ * Description:
+ *   Try to allocate a buffer from one of the optional small or large size
+ *   classes.  Buffers are taken from the per-CPU cache, which is refilled
+ *   from the shared free list of the class when it is empty.
+ *
+ ****************************************************************************/
+
+#if IOB_NPOOLS > 1
+FAR struct iob_s *iob_pool_tryalloc(int pool, enum iob_user_e consumerid);
+#endif
+
+/****************************************************************************
+ * Name: iob_pool_free
+ *
+ * Description:
+ *   Return a buffer of one of the optional small or large size classes to
+ *   the per-CPU cache.  When the cache grows too large, a batch of buffers
+ *   is returned to the shared free list of the class.
+ *
+ ****************************************************************************/
+
+#if IOB_NPOOLS > 1
+void iob_pool_free(FAR struct iob_s *iob, enum iob_user_e producerid);
+#endif
+
 /****************************************************************************
  * Name: iob_notifier_signal
  *
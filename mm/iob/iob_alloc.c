@@ -54,6 +54,37 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_sizepool
+ *
+ * Description:
+ *   Select the size class for a payload of 'size' bytes:  The small class
+ *   if the payload fits in a small buffer, the large class if it does not
+ *   fit in a default buffer, or otherwise the default class.
+ *
+ ****************************************************************************/
+
+#if IOB_NPOOLS > 1
+static int iob_sizepool(unsigned int size)
+{
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+  if (size <= CONFIG_IOB_SMALL_BUFSIZE)
+    {
+      return IOB_SMALL_POOL;
+    }
+#endif
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+  if (size > CONFIG_IOB_BUFSIZE)
+    {
+      return IOB_LARGE_POOL;
+    }
+#endif
+
+  return IOB_DEFAULT_POOL;
+}
+#endif
+
 /****************************************************************************
  * Name: iob_alloc_committed
  *
@@ -90,6 +121,8 @@ static FAR struct iob_s *iob_alloc_committed(enum iob_user_e consumerid)
       iob->io_offset = 0;    /* Offset to the beginning of data */
       iob->io_pktlen = 0;    /* Total length of the packet */
 
+      g_iob_pools[IOB_DEFAULT_POOL].ip_cache[up_cpu_index()].ic_nalloc++;
+
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
     defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
       iob_stats_onalloc(consumerid);
@@ -305,6 +338,8 @@ FAR struct iob_s *iob_tryalloc(bool throttled, enum iob_user_e consumerid)
           DEBUGASSERT(g_throttle_sem.semcount >= -CONFIG_IOB_THROTTLE);
 #endif
 
+          g_iob_pools[IOB_DEFAULT_POOL].ip_cache[up_cpu_index()].ic_nalloc++;
+
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
     defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
           iob_stats_onalloc(consumerid);
@@ -322,6 +357,69 @@ FAR struct iob_s *iob_tryalloc(bool throttled, enum iob_user_e consumerid)
         }
     }
 
+  g_iob_pools[IOB_DEFAULT_POOL].ip_cache[up_cpu_index()].ic_nfail++;
   leave_critical_section(flags);
   return NULL;
 }
+
+/****************************************************************************
+ * Name: iob_alloc_size
+ *
+ * Description:
+ *   Allocate an I/O buffer suited to hold 'size' bytes of payload.  The
+ *   smallest size class that can hold 'size' bytes and has a free buffer
+ *   is used.  If there is no such buffer, this falls back to iob_alloc()
+ *   and a buffer of CONFIG_IOB_BUFSIZE bytes, so the returned buffer may
+ *   still be smaller than 'size'.  Use IOB_BUFSIZE() to get its size.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_size(unsigned int size, bool throttled,
+                                 enum iob_user_e consumerid)
+{
+#if IOB_NPOOLS > 1
+  FAR struct iob_s *iob;
+  int pool;
+
+  pool = iob_sizepool(size);
+  if (pool != IOB_DEFAULT_POOL)
+    {
+      iob = iob_pool_tryalloc(pool, consumerid);
+      if (iob != NULL)
+        {
+          return iob;
+        }
+    }
+#endif
+
+  return iob_alloc(throttled, consumerid);
+}
+
+/****************************************************************************
+ * Name: iob_tryalloc_size
+ *
+ * Description:
+ *   Same as iob_alloc_size() but never waits for a buffer to become free.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_size(unsigned int size, bool throttled,
+                                    enum iob_user_e consumerid)
+{
+#if IOB_NPOOLS > 1
+  FAR struct iob_s *iob;
+  int pool;
+
+  pool = iob_sizepool(size);
+  if (pool != IOB_DEFAULT_POOL)
+    {
+      iob = iob_pool_tryalloc(pool, consumerid);
+      if (iob != NULL)
+        {
+          return iob;
+        }
+    }
+#endif
+
+  return iob_tryalloc(throttled, consumerid);
+}
@@ -129,6 +129,18 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob,
               next, next->io_pktlen, next->io_len);
     }
 
+#if IOB_NPOOLS > 1
+  /* Buffers of the optional small and large size classes go back to the
+   * per-CPU cache of their class.  Nothing ever waits for those.
+   */
+
+  if (iob->io_pool != IOB_DEFAULT_POOL)
+    {
+      iob_pool_free(iob, producerid);
+      return next;
+    }
+#endif
+
   /* Free the I/O buffer by adding it to the head of the free or the
    * committed list. We don't know what context we are called from so
    * we use extreme measures to protect the free list:  We disable
@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <stdbool.h>
 
 #include <nuttx/semaphore.h>
@@ -54,6 +55,12 @@
 #  define NULL ((FAR void *)0)
 #endif
 
+/* The payload buffers are kept in arrays of uint32_t so that they are
+ * suitably aligned for the packet headers that are overlaid on them.
+ */
+
+#define IOB_BUFWORDS(n) (((n) + sizeof(uint32_t) - 1) / sizeof(uint32_t))
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -61,6 +68,25 @@
 /* This is a pool of pre-allocated I/O buffers */
 
 static struct iob_s        g_iob_pool[CONFIG_IOB_NBUFFERS];
+static uint32_t            g_iob_buffers[CONFIG_IOB_NBUFFERS]
+                                        [IOB_BUFWORDS(CONFIG_IOB_BUFSIZE)];
+
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+/* The optional pool of small I/O buffers */
+
+static struct iob_s        g_iob_smallpool[CONFIG_IOB_SMALL_NBUFFERS];
+static uint32_t            g_iob_smallbuffers[CONFIG_IOB_SMALL_NBUFFERS]
+                                    [IOB_BUFWORDS(CONFIG_IOB_SMALL_BUFSIZE)];
+#endif
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+/* The optional pool of large I/O buffers */
+
+static struct iob_s        g_iob_largepool[CONFIG_IOB_LARGE_NBUFFERS];
+static uint32_t            g_iob_largebuffers[CONFIG_IOB_LARGE_NBUFFERS]
+                                    [IOB_BUFWORDS(CONFIG_IOB_LARGE_BUFSIZE)];
+#endif
+
 #if CONFIG_IOB_NCHAINS > 0
 static struct iob_qentry_s g_iob_qpool[CONFIG_IOB_NCHAINS];
 #endif
@@ -69,6 +95,10 @@ static struct iob_qentry_s g_iob_qpool[CONFIG_IOB_NCHAINS];
  * Public Data
  ****************************************************************************/
 
+/* The I/O buffer size classes */
+
+struct iob_pool_s g_iob_pools[IOB_NPOOLS];
+
 /* A list of all free, unallocated I/O buffers */
 
 FAR struct iob_s *g_iob_freelist;
@@ -97,6 +127,45 @@ sem_t g_throttle_sem;       /* Counts available I/O buffers when throttled */
 sem_t g_qentry_sem;         /* Counts free I/O buffer queue containers */
 #endif
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_initpool
+ *
+ * Description:
+ *   Bind each I/O buffer of a size class to its payload buffer and add it
+ *   to the free list of the class.
+ *
+ ****************************************************************************/
+
+static void iob_initpool(int pool, FAR struct iob_s *iobs,
+                         FAR uint32_t *buffers, uint16_t bufsize,
+                         uint16_t nbuffers, FAR struct iob_s **freelist)
+{
+  FAR struct iob_pool_s *iobpool = &g_iob_pools[pool];
+  int i;
+
+  for (i = 0; i < nbuffers; i++)
+    {
+      FAR struct iob_s *iob = &iobs[i];
+
+      iob->io_data    = (FAR uint8_t *)&buffers[i * IOB_BUFWORDS(bufsize)];
+      iob->io_bufsize = bufsize;
+      iob->io_pool    = pool;
+
+      /* Add the pre-allocate I/O buffer to the head of the free list */
+
+      iob->io_flink   = *freelist;
+      *freelist       = iob;
+    }
+
+  iobpool->ip_bufsize  = bufsize;
+  iobpool->ip_nbuffers = nbuffers;
+  iobpool->ip_nfree    = nbuffers;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -112,23 +181,33 @@ sem_t g_qentry_sem;         /* Counts free I/O buffer queue containers */
 void iob_initialize(void)
 {
   static bool initialized = false;
+#if CONFIG_IOB_NCHAINS > 0
   int i;
+#endif
 
   /* Perform one-time initialization */
 
   if (!initialized)
     {
-      /* Add each I/O buffer to the free list */
+      /* Add each I/O buffer to the free list of its size class */
 
-      for (i = 0; i < CONFIG_IOB_NBUFFERS; i++)
-        {
-          FAR struct iob_s *iob = &g_iob_pool[i];
+      iob_initpool(IOB_DEFAULT_POOL, g_iob_pool, &g_iob_buffers[0][0],
+                   CONFIG_IOB_BUFSIZE, CONFIG_IOB_NBUFFERS,
+                   &g_iob_freelist);
 
-          /* Add the pre-allocate I/O buffer to the head of the free list */
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+      iob_initpool(IOB_SMALL_POOL, g_iob_smallpool,
+                   &g_iob_smallbuffers[0][0], CONFIG_IOB_SMALL_BUFSIZE,
+                   CONFIG_IOB_SMALL_NBUFFERS,
+                   &g_iob_pools[IOB_SMALL_POOL].ip_freelist);
+#endif
 
-          iob->io_flink  = g_iob_freelist;
-          g_iob_freelist = iob;
-        }
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+      iob_initpool(IOB_LARGE_POOL, g_iob_largepool,
+                   &g_iob_largebuffers[0][0], CONFIG_IOB_LARGE_BUFSIZE,
+                   CONFIG_IOB_LARGE_NBUFFERS,
+                   &g_iob_pools[IOB_LARGE_POOL].ip_freelist);
+#endif
 
       g_iob_committed = NULL;
 
@@ -0,0 +1,318 @@
+/****************************************************************************
+ * mm/iob/iob_pool.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Buffers move between a per-CPU cache and the shared free list in batches
+ * of this many buffers.  A cache is drained when it holds more than two
+ * batches.  Without a cache, every buffer goes to and from the shared list
+ * by itself.
+ */
+
+#if CONFIG_IOB_CACHE_SIZE > 0
+#  define IOB_CACHE_BATCH CONFIG_IOB_CACHE_SIZE
+#else
+#  define IOB_CACHE_BATCH 1
+#endif
+
+#define IOB_CACHE_LIMIT   (2 * CONFIG_IOB_CACHE_SIZE)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#if IOB_NPOOLS > 1
+
+/****************************************************************************
+ * Name: iob_pool_refill
+ *
+ * Description:
+ *   Move a batch of buffers from the shared free list of the size class to
+ *   the cache of this CPU.  Local interrupts must be disabled.
+ *
+ ****************************************************************************/
+
+static void iob_pool_refill(FAR struct iob_pool_s *pool,
+                            FAR struct iob_cache_s *cache)
+{
+  FAR struct iob_s *iob;
+  int n;
+
+#ifdef CONFIG_SMP
+  spin_lock(&pool->ip_lock);
+#endif
+
+  for (n = 0; n < IOB_CACHE_BATCH && pool->ip_freelist != NULL; n++)
+    {
+      iob               = pool->ip_freelist;
+      pool->ip_freelist = iob->io_flink;
+      pool->ip_nfree--;
+
+      iob->io_flink     = cache->ic_head;
+      cache->ic_head    = iob;
+      cache->ic_count++;
+    }
+
+#ifdef CONFIG_SMP
+  spin_unlock(&pool->ip_lock);
+#endif
+}
+
+/****************************************************************************
+ * Name: iob_pool_drain
+ *
+ * Description:
+ *   Move a batch of buffers from the cache of this CPU back to the shared
+ *   free list of the size class.  Local interrupts must be disabled.
+ *
+ ****************************************************************************/
+
+static void iob_pool_drain(FAR struct iob_pool_s *pool,
+                           FAR struct iob_cache_s *cache)
+{
+  FAR struct iob_s *iob;
+  int n;
+
+#ifdef CONFIG_SMP
+  spin_lock(&pool->ip_lock);
+#endif
+
+  for (n = 0; n < IOB_CACHE_BATCH && cache->ic_head != NULL; n++)
+    {
+      iob               = cache->ic_head;
+      cache->ic_head    = iob->io_flink;
+      cache->ic_count--;
+
+      iob->io_flink     = pool->ip_freelist;
+      pool->ip_freelist = iob;
+      pool->ip_nfree++;
+    }
+
+#ifdef CONFIG_SMP
+  spin_unlock(&pool->ip_lock);
+#endif
+}
+
+#endif /* IOB_NPOOLS > 1 */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#if IOB_NPOOLS > 1
+
+/****************************************************************************
+ * Name: iob_pool_tryalloc
+ *
+ * Description:
+ *   Try to allocate a buffer from one of the optional small or large size
+ *   classes.  Buffers are taken from the per-CPU cache, which is refilled
+ *   from the shared free list of the class when it is empty.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_pool_tryalloc(int pool, enum iob_user_e consumerid)
+{
+  FAR struct iob_pool_s *iobpool;
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+  DEBUGASSERT(pool >= 0 && pool < IOB_NPOOLS && pool != IOB_DEFAULT_POOL);
+  iobpool = &g_iob_pools[pool];
+
+  /* Only this CPU uses its cache, so disabling local interrupts is all that
+   * is needed to protect it.
+   */
+
+  flags = up_irq_save();
+  cache = &iobpool->ip_cache[up_cpu_index()];
+
+  if (cache->ic_head == NULL)
+    {
+      iob_pool_refill(iobpool, cache);
+    }
+
+  iob = cache->ic_head;
+  if (iob != NULL)
+    {
+      cache->ic_head = iob->io_flink;
+      cache->ic_count--;
+      cache->ic_nalloc++;
+    }
+  else
+    {
+      cache->ic_nfail++;
+    }
+
+  up_irq_restore(flags);
+
+  if (iob != NULL)
+    {
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+      /* The user statistics are shared by all CPUs and pools.  Update them
+       * in a critical section, as the default pool does.
+       */
+
+      flags = enter_critical_section();
+      iob_stats_onalloc(consumerid);
+      leave_critical_section(flags);
+#endif
+
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+    }
+
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_pool_free
+ *
+ * Description:
+ *   Return a buffer of one of the optional small or large size classes to
+ *   the per-CPU cache.  When the cache grows too large, a batch of buffers
+ *   is returned to the shared free list of the class.
+ *
+ ****************************************************************************/
+
+void iob_pool_free(FAR struct iob_s *iob, enum iob_user_e producerid)
+{
+  FAR struct iob_pool_s *iobpool;
+  FAR struct iob_cache_s *cache;
+  irqstate_t flags;
+
+  DEBUGASSERT(iob->io_pool < IOB_NPOOLS &&
+              iob->io_pool != IOB_DEFAULT_POOL);
+  iobpool = &g_iob_pools[iob->io_pool];
+
+  flags = up_irq_save();
+  cache = &iobpool->ip_cache[up_cpu_index()];
+
+  iob->io_flink  = cache->ic_head;
+  cache->ic_head = iob;
+  cache->ic_count++;
+
+  if (cache->ic_count > IOB_CACHE_LIMIT)
+    {
+      iob_pool_drain(iobpool, cache);
+    }
+
+  up_irq_restore(flags);
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+  /* The user statistics are shared by all CPUs and pools */
+
+  flags = enter_critical_section();
+  iob_stats_onfree(producerid);
+  leave_critical_section(flags);
+#endif
+}
+
+#endif /* IOB_NPOOLS > 1 */
+
+/****************************************************************************
+ * Name: iob_getpoolstats
+ *
+ * Description:
+ *   Return the statistics of one I/O buffer size class.
+ *
+ * Input Parameters:
+ *   pool  - The size class, 0 through IOB_NPOOLS - 1
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void iob_getpoolstats(int pool, FAR struct iob_poolstats_s *stats)
+{
+  FAR struct iob_pool_s *iobpool;
+  int cpu;
+
+  DEBUGASSERT(pool >= 0 && pool < IOB_NPOOLS && stats != NULL);
+  iobpool = &g_iob_pools[pool];
+
+  stats->bufsize  = iobpool->ip_bufsize;
+  stats->nbuffers = iobpool->ip_nbuffers;
+  stats->ncached  = 0;
+  stats->nalloc   = 0;
+  stats->nfail    = 0;
+
+  /* The per-CPU values are sampled without any locking, so the sums are
+   * only a snapshot.
+   */
+
+  for (cpu = 0; cpu < IOB_NCPUS; cpu++)
+    {
+      stats->ncached += iobpool->ip_cache[cpu].ic_count;
+      stats->nalloc  += iobpool->ip_cache[cpu].ic_nalloc;
+      stats->nfail   += iobpool->ip_cache[cpu].ic_nfail;
+    }
+
+  if (pool == IOB_DEFAULT_POOL)
+    {
+      stats->nfree = iob_navail(false);
+    }
+  else
+    {
+      stats->nfree = iobpool->ip_nfree + stats->ncached;
+    }
+}
@@ -0,0 +1,336 @@
+/****************************************************************************
+ * mm/mm_heap/mm_cache.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Chunk sizes are always a non-zero multiple of MM_MIN_CHUNK */
+
+#define MM_CACHE_NDX(s)   (((s) >> MM_MIN_SHIFT) - 1)
+#define MM_CACHE_SIZE(n)  ((size_t)((n) + 1) << MM_MIN_SHIFT)
+
+/* Cached chunks are linked through the first word of their payload */
+
+#define MM_CACHE_NEXT(m)  (*(FAR void **)(m))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cache_lock
+ *
+ * Description:
+ *   Get exclusive access to one cache.  Disabling local interrupts is
+ *   sufficient to keep other tasks on this CPU out of the cache;  the
+ *   spinlock in the SMP case is contended only while mm_cache_flush()
+ *   drains the cache of some other CPU.
+ *
+ ****************************************************************************/
+
+static inline irqstate_t mm_cache_lock(FAR struct mm_cache_s *cache)
+{
+  irqstate_t flags = up_irq_save();
+
+#ifdef CONFIG_SMP
+  spin_lock(&cache->mc_lock);
+#endif
+  return flags;
+}
+
+/****************************************************************************
+ * Name: mm_cache_local
+ *
+ * Description:
+ *   Get exclusive access to the cache of the current CPU.  The CPU index
+ *   cannot change while local interrupts are disabled.
+ *
+ ****************************************************************************/
+
+static inline FAR struct mm_cache_s *
+mm_cache_local(FAR struct mm_heap_s *heap, FAR irqstate_t *flags)
+{
+  FAR struct mm_cache_s *cache;
+
+  *flags = up_irq_save();
+  cache  = &heap->mm_cache[up_cpu_index()];
+
+#ifdef CONFIG_SMP
+  spin_lock(&cache->mc_lock);
+#endif
+  return cache;
+}
+
+/****************************************************************************
+ * Name: mm_cache_unlock
+ ****************************************************************************/
+
+static inline void mm_cache_unlock(FAR struct mm_cache_s *cache,
+                                   irqstate_t flags)
+{
+#ifdef CONFIG_SMP
+  spin_unlock(&cache->mc_lock);
+#endif
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cache_initialize
+ *
+ * Description:
+ *   Initialize the (empty) small-object caches of a heap.
+ *
+ ****************************************************************************/
+
+void mm_cache_initialize(FAR struct mm_heap_s *heap)
+{
+#ifdef CONFIG_SMP
+  int i;
+#endif
+
+  memset(heap->mm_cache, 0, sizeof(heap->mm_cache));
+
+#ifdef CONFIG_SMP
+  for (i = 0; i < MM_CACHE_NCACHES; i++)
+    {
+      spin_initialize(&heap->mm_cache[i].mc_lock, SP_UNLOCKED);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: mm_cache_alloc
+ *
+ * Description:
+ *   Try to satisfy an allocation from the cache of the current CPU.
+ *
+ * Input Parameters:
+ *   heap      - The selected heap
+ *   alignsize - The chunk size needed, including the chunk header.
+ *
+ * Returned Value:
+ *   The allocated memory or NULL if there is no cached chunk of exactly
+ *   this size.
+ *
+ ****************************************************************************/
+
+FAR void *mm_cache_alloc(FAR struct mm_heap_s *heap, size_t alignsize)
+{
+  FAR struct mm_cache_s *cache;
+  FAR void *ret;
+  irqstate_t flags;
+  int ndx;
+
+  if (alignsize > CONFIG_MM_CACHE_MAXSIZE)
+    {
+      return NULL;
+    }
+
+  ndx   = MM_CACHE_NDX(alignsize);
+  cache = mm_cache_local(heap, &flags);
+
+  ret = cache->mc_free[ndx];
+  if (ret != NULL)
+    {
+      cache->mc_free[ndx] = MM_CACHE_NEXT(ret);
+      cache->mc_nfree[ndx]--;
+      cache->mc_hits++;
+    }
+  else
+    {
+      cache->mc_misses++;
+    }
+
+  mm_cache_unlock(cache, flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_cache_free
+ *
+ * Description:
+ *   Try to place a chunk being freed into the cache of the current CPU.
+ *   The chunk stays marked as allocated in the heap.
+ *
+ * Input Parameters:
+ *   heap - The selected heap
+ *   mem  - The memory being freed
+ *
+ * Returned Value:
+ *   True if the chunk was cached;  false if it is too large or if the
+ *   cache for this size is full.  In the latter case the caller must
+ *   return the chunk to the heap.
+ *
+ ****************************************************************************/
+
+bool mm_cache_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct mm_allocnode_s *node;
+  FAR struct mm_cache_s *cache;
+  irqstate_t flags;
+  bool cached = false;
+  int ndx;
+
+  /* The size of the chunk cannot change while we own it */
+
+  node = (FAR struct mm_allocnode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+  DEBUGASSERT((node->preceding & MM_ALLOC_BIT) != 0);
+
+  if (node->size > CONFIG_MM_CACHE_MAXSIZE)
+    {
+      return false;
+    }
+
+  ndx   = MM_CACHE_NDX(node->size);
+  cache = mm_cache_local(heap, &flags);
+
+  if (cache->mc_nfree[ndx] < CONFIG_MM_CACHE_DEPTH)
+    {
+      MM_CACHE_NEXT(mem)  = cache->mc_free[ndx];
+      cache->mc_free[ndx] = mem;
+      cache->mc_nfree[ndx]++;
+      cached              = true;
+    }
+
+  mm_cache_unlock(cache, flags);
+  return cached;
+}
+
+/****************************************************************************
+ * Name: mm_cache_flush
+ *
+ * Description:
+ *   Return every cached chunk of every CPU to the heap.  This is done when
+ *   an allocation from the heap fails so that cached chunks can be merged
+ *   back into larger free chunks.
+ *
+ *   The caller must not hold the heap semaphore.
+ *
+ * Returned Value:
+ *   The number of chunks returned to the heap.
+ *
+ ****************************************************************************/
+
+int mm_cache_flush(FAR struct mm_heap_s *heap)
+{
+  FAR struct mm_cache_s *cache;
+  FAR void *mem;
+  FAR void *next;
+  irqstate_t flags;
+  int nflushed = 0;
+  int ndx;
+  int i;
+
+  for (i = 0; i < MM_CACHE_NCACHES; i++)
+    {
+      cache = &heap->mm_cache[i];
+      for (ndx = 0; ndx < MM_CACHE_NCLASSES; ndx++)
+        {
+          /* Detach the whole list, then free it without holding the
+           * cache.
+           */
+
+          flags                = mm_cache_lock(cache);
+          mem                  = cache->mc_free[ndx];
+          cache->mc_free[ndx]  = NULL;
+          cache->mc_nfree[ndx] = 0;
+          mm_cache_unlock(cache, flags);
+
+          for (; mem != NULL; mem = next)
+            {
+              next = MM_CACHE_NEXT(mem);
+              mm_uncachedfree(heap, mem);
+              nflushed++;
+            }
+        }
+    }
+
+  return nflushed;
+}
+
+/****************************************************************************
+ * Name: mm_cache_info
+ *
+ * Description:
+ *   Add the cache statistics to the mallinfo structure.  The counters are
+ *   sampled without locking, so the result is only a snapshot.
+ *
+ ****************************************************************************/
+
+void mm_cache_info(FAR struct mm_heap_s *heap, FAR struct mallinfo *info)
+{
+  FAR struct mm_cache_s *cache;
+  int ndx;
+  int i;
+
+  info->cacheblks   = 0;
+  info->cachehits   = 0;
+  info->cachemisses = 0;
+
+  for (i = 0; i < MM_CACHE_NCACHES; i++)
+    {
+      cache = &heap->mm_cache[i];
+      info->cachehits   += cache->mc_hits;
+      info->cachemisses += cache->mc_misses;
+
+      for (ndx = 0; ndx < MM_CACHE_NCLASSES; ndx++)
+        {
+          info->cacheblks += cache->mc_nfree[ndx] * MM_CACHE_SIZE(ndx);
+        }
+    }
+}
+
+#endif /* CONFIG_MM_CACHE */
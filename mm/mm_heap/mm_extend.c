@@ -120,8 +120,8 @@ void mm_extend(FAR struct mm_heap_s *heap, FAR void *mem, size_t size,
   mm_givesemaphore(heap);
 
   /* Finally "free" the new block of memory where the old terminal node was
-   * located.
+   * located.  It must go to the heap, not to the small-object cache.
    */
 
-  mm_free(heap, (FAR void *)mem);
+  mm_uncachedfree(heap, (FAR void *)mem);
 }
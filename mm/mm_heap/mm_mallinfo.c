@@ -126,5 +126,10 @@ int mm_mallinfo(FAR struct mm_heap_s *heap, FAR struct mallinfo *info)
   info->mxordblk = mxordblk;
   info->uordblks = uordblks;
   info->fordblks = fordblks;
+
+#ifdef CONFIG_MM_CACHE
+  mm_cache_info(heap, info);
+#endif
+
   return OK;
 }
@@ -123,6 +123,9 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
     {
       FAR struct mm_allocnode_s *newnode;
       FAR struct mm_allocnode_s *next;
+#ifdef CONFIG_MM_CACHE
+      FAR struct mm_freenode_s *prev;
+#endif
       size_t precedingsize;
 
       /* Get the node the next node after the allocation. */
@@ -178,6 +181,24 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
 
       allocsize = newnode->size - SIZEOF_MM_ALLOCNODE;
 
+#ifdef CONFIG_MM_CACHE
+      /* A chunk taken from the small-object cache may follow a free chunk.
+       * In that case, merge the newly freed node with that free chunk.
+       */
+
+      prev = (FAR struct mm_freenode_s *)((FAR char *)node - node->preceding);
+      if ((prev->preceding & MM_ALLOC_BIT) == 0)
+        {
+          /* Remove the previous node from the free list */
+
+          mm_delfreechunk(heap, prev);
+
+          prev->size        += node->size;
+          newnode->preceding = prev->size | MM_ALLOC_BIT;
+          node               = (FAR struct mm_allocnode_s *)prev;
+        }
+#endif
+
       /* Add the original, newly freed node to the free nodelist */
 
       mm_addfreechunk(heap, (FAR struct mm_freenode_s *)node);
@@ -0,0 +1,295 @@
+/****************************************************************************
+ * mm/mm_heap/mm_tlsf.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <strings.h>
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_TLSF_MANAGER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The last first-level row holds every chunk of MM_MAX_CHUNK or more */
+
+#define MM_FL_HUGE      (MM_FL_COUNT - 1)
+
+/* Chunks smaller than this are kept in exact-size lists in row 0 */
+
+#define MM_FL_MINSIZE   ((size_t)1 << MM_FL_SHIFT)
+
+#define MM_BIT(n)       ((uint32_t)1 << (n))
+#define MM_BITS_FROM(n) (~(uint32_t)0 << (n))
+
+#if MM_SL_COUNT > 32 || MM_FL_COUNT > 32
+#  error The TLSF bitmaps are limited to 32 bits
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tlsf_mapping
+ *
+ * Description:
+ *   Map a chunk size to the first- and second-level index of the list that
+ *   holds chunks of that size.
+ *
+ ****************************************************************************/
+
+static inline void mm_tlsf_mapping(size_t size, FAR int *fl, FAR int *sl)
+{
+  int msb;
+
+  if (size >= MM_MAX_CHUNK)
+    {
+      *fl = MM_FL_HUGE;
+      *sl = 0;
+    }
+  else if (size < MM_FL_MINSIZE)
+    {
+      *fl = 0;
+      *sl = size >> MM_MIN_SHIFT;
+    }
+  else
+    {
+      /* The first level is given by the most significant bit, the second
+       * level by the MM_SL_SHIFT bits that follow it.
+       */
+
+      msb = fls((int)size) - 1;
+      *fl = msb - MM_FL_SHIFT + 1;
+      *sl = (size >> (msb - MM_SL_SHIFT)) & (MM_SL_COUNT - 1);
+    }
+}
+
+/****************************************************************************
+ * Name: mm_tlsf_firstfit
+ *
+ * Description:
+ *   Return the first chunk of at least 'size' bytes in one list.
+ *
+ ****************************************************************************/
+
+static FAR struct mm_freenode_s *
+mm_tlsf_firstfit(FAR struct mm_heap_s *heap, int fl, int sl, size_t size)
+{
+  FAR struct mm_freenode_s *node;
+
+  for (node = heap->mm_freelist[fl][sl];
+       node && node->size < size;
+       node = node->flink);
+
+  return node;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tlsf_initialize
+ *
+ * Description:
+ *   Initialize the (empty) free lists of the heap.
+ *
+ ****************************************************************************/
+
+void mm_tlsf_initialize(FAR struct mm_heap_s *heap)
+{
+  heap->mm_flbitmap = 0;
+  memset(heap->mm_slbitmap, 0, sizeof(heap->mm_slbitmap));
+  memset(heap->mm_freelist, 0, sizeof(heap->mm_freelist));
+}
+
+/****************************************************************************
+ * Name: mm_addfreechunk
+ *
+ * Description:
+ *   Add a free chunk to the head of the list for its size class.  It is
+ *   assumed that the caller holds the mm semaphore
+ *
+ ****************************************************************************/
+
+void mm_addfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node)
+{
+  FAR struct mm_freenode_s *head;
+  int fl;
+  int sl;
+
+  mm_tlsf_mapping(node->size, &fl, &sl);
+
+  head        = heap->mm_freelist[fl][sl];
+  node->flink = head;
+  node->blink = NULL;
+
+  if (head)
+    {
+      head->blink = node;
+    }
+
+  heap->mm_freelist[fl][sl] = node;
+  heap->mm_slbitmap[fl]    |= MM_BIT(sl);
+  heap->mm_flbitmap        |= MM_BIT(fl);
+}
+
+/****************************************************************************
+ * Name: mm_delfreechunk
+ *
+ * Description:
+ *   Remove a free chunk from the list for its size class.  It is assumed
+ *   that the caller holds the mm semaphore
+ *
+ ****************************************************************************/
+
+void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node)
+{
+  int fl;
+  int sl;
+
+  if (node->flink)
+    {
+      node->flink->blink = node->blink;
+    }
+
+  if (node->blink)
+    {
+      node->blink->flink = node->flink;
+    }
+  else
+    {
+      /* This is the head of the list.  Clear the bitmaps if the list
+       * becomes empty.
+       */
+
+      mm_tlsf_mapping(node->size, &fl, &sl);
+      DEBUGASSERT(heap->mm_freelist[fl][sl] == node);
+
+      heap->mm_freelist[fl][sl] = node->flink;
+      if (node->flink == NULL)
+        {
+          heap->mm_slbitmap[fl] &= ~MM_BIT(sl);
+          if (heap->mm_slbitmap[fl] == 0)
+            {
+              heap->mm_flbitmap &= ~MM_BIT(fl);
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mm_findfreechunk
+ *
+ * Description:
+ *   Find a free chunk of at least 'size' bytes.  The chunk is not removed
+ *   from its list.  It is assumed that the caller holds the mm semaphore
+ *
+ *   The size is first rounded up to the next size class so that any chunk
+ *   in a list of that class or above is large enough:  The search is then
+ *   just two bitmap lookups.  Only when that fails (i.e., when the heap is
+ *   nearly exhausted) is the list that contains 'size' itself searched
+ *   for a chunk that is large enough.
+ *
+ ****************************************************************************/
+
+FAR struct mm_freenode_s *mm_findfreechunk(FAR struct mm_heap_s *heap,
+                                           size_t size)
+{
+  FAR struct mm_freenode_s *node;
+  size_t rounded = size;
+  uint32_t map;
+  int fl;
+  int sl;
+
+  if (size >= MM_FL_MINSIZE && size < MM_MAX_CHUNK)
+    {
+      rounded += ((size_t)1 << (fls((int)size) - 1 - MM_SL_SHIFT)) - 1;
+    }
+
+  mm_tlsf_mapping(rounded, &fl, &sl);
+
+  if (fl < MM_FL_HUGE)
+    {
+      /* Look for a non-empty list in this row first, then in the
+       * following rows.
+       */
+
+      map = heap->mm_slbitmap[fl] & MM_BITS_FROM(sl);
+      if (map == 0)
+        {
+          map = heap->mm_flbitmap & MM_BITS_FROM(fl + 1);
+          if (map != 0)
+            {
+              fl  = ffs((int)map) - 1;
+              map = heap->mm_slbitmap[fl];
+            }
+        }
+
+      if (map != 0 && fl < MM_FL_HUGE)
+        {
+          sl = ffs((int)map) - 1;
+          return heap->mm_freelist[fl][sl];
+        }
+    }
+
+  /* Very large chunks are kept in one unordered list */
+
+  node = mm_tlsf_firstfit(heap, MM_FL_HUGE, 0, size);
+  if (node == NULL && rounded != size)
+    {
+      /* Last resort:  The list that holds chunks of the requested size may
+       * still contain one that is large enough.
+       */
+
+      mm_tlsf_mapping(size, &fl, &sl);
+      node = mm_tlsf_firstfit(heap, fl, sl, size);
+    }
+
+  return node;
+}
+
+#endif /* CONFIG_MM_TLSF_MANAGER */
@@ -263,6 +263,12 @@ void arp_out(FAR struct net_driver_s *dev)
 
       arp_format(dev, ipaddr);
       arp_dump(ARPBUF);
+
+#ifdef CONFIG_NETDEV_TSO
+      /* The ARP request does not carry the TCP payload */
+
+      dev->d_sgiob = NULL;
+#endif
       return;
     }
 
@@ -481,6 +481,26 @@ void devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *buf,
                     unsigned int len, unsigned int offset);
 #endif
 
+/****************************************************************************
+ * Name: devif_iob_sgsend
+ *
+ * Description:
+ *   Like devif_iob_send() but, rather than copying the data into the
+ *   device buffer, leave it in the I/O buffer chain for a device that
+ *   advertises scatter-gather transmit.  If the device also supports TCP
+ *   segmentation offload, len may exceed mss.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_TSO
+void devif_iob_sgsend(FAR struct net_driver_s *dev, FAR struct iob_s *buf,
+                      unsigned int len, unsigned int offset,
+                      unsigned int mss);
+#endif
+
 /****************************************************************************
  * Name: devif_pkt_send
  *
@@ -0,0 +1,223 @@
+/****************************************************************************
+ * net/devif/devif_batch.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/net/netdev.h>
+
+#ifdef CONFIG_NETDEV_POLL_BATCH
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devif_batch_flush
+ *
+ * Description:
+ *   Pass the queued packets to the driver and start a new batch.
+ *
+ ****************************************************************************/
+
+static int devif_batch_flush(FAR struct net_driver_s *dev,
+                             FAR struct devif_txbatch_s *batch)
+{
+  int ret;
+
+  NETDEV_TXBATCHES(dev);
+  ret = batch->tb_flush(dev, batch);
+
+  batch->tb_count = 0;
+  dev->d_buf      = batch->tb_desc[0].td_buf;
+  dev->d_len      = 0;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: devif_batch_enqueue
+ *
+ * Description:
+ *   Queue the packet in d_buf, which is the next free transmit buffer, and
+ *   move d_buf to the following transmit buffer.  Flush the batch if there
+ *   is none.
+ *
+ ****************************************************************************/
+
+static int devif_batch_enqueue(FAR struct net_driver_s *dev)
+{
+  FAR struct devif_txbatch_s *batch = dev->d_txbatch;
+
+  DEBUGASSERT(dev->d_buf == batch->tb_desc[batch->tb_count].td_buf);
+
+  batch->tb_desc[batch->tb_count].td_len = dev->d_len;
+  if (++batch->tb_count >= batch->tb_ndesc)
+    {
+      return devif_batch_flush(dev, batch);
+    }
+
+  dev->d_buf = batch->tb_desc[batch->tb_count].td_buf;
+  dev->d_len = 0;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: devif_batch_txpoll
+ *
+ * Description:
+ *   The devif_poll() callback used for batched polling.
+ *
+ ****************************************************************************/
+
+static int devif_batch_txpoll(FAR struct net_driver_s *dev)
+{
+  FAR struct devif_txbatch_s *batch = dev->d_txbatch;
+
+  if (dev->d_len > 0 && batch->tb_prepare != NULL)
+    {
+      (void)batch->tb_prepare(dev);
+    }
+
+  if (dev->d_len > 0)
+    {
+#ifdef CONFIG_NETDEV_TSO
+      return devif_segment(dev, devif_batch_enqueue);
+#else
+      return devif_batch_enqueue(dev);
+#endif
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: devif_batch_poll
+ *
+ * Description:
+ *   Common logic of devif_poll_batch() and devif_timer_batch().
+ *
+ ****************************************************************************/
+
+static int devif_batch_poll(FAR struct net_driver_s *dev,
+                            FAR struct devif_txbatch_s *batch, bool timer)
+{
+  FAR uint8_t *buf = dev->d_buf;
+  int bstop;
+  int ret;
+
+  DEBUGASSERT(dev != NULL && batch != NULL && batch->tb_flush != NULL &&
+              batch->tb_desc != NULL && batch->tb_ndesc > 0);
+  DEBUGASSERT(dev->d_txbatch == NULL);
+
+  /* Build the first packet in the first transmit buffer */
+
+  batch->tb_count = 0;
+  dev->d_txbatch  = batch;
+  dev->d_buf      = batch->tb_desc[0].td_buf;
+
+  if (timer)
+    {
+      bstop = devif_timer(dev, devif_batch_txpoll);
+    }
+  else
+    {
+      bstop = devif_poll(dev, devif_batch_txpoll);
+    }
+
+  /* Send whatever is left over */
+
+  if (batch->tb_count > 0)
+    {
+      ret = devif_batch_flush(dev, batch);
+      if (!bstop)
+        {
+          bstop = ret;
+        }
+    }
+
+  dev->d_txbatch = NULL;
+  dev->d_buf     = buf;
+  dev->d_len     = 0;
+  return bstop;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devif_poll_batch
+ *
+ * Description:
+ *   Batched version of devif_poll().  See include/nuttx/net/netdev.h.
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver with the network
+ *   locked.
+ *
+ ****************************************************************************/
+
+int devif_poll_batch(FAR struct net_driver_s *dev,
+                     FAR struct devif_txbatch_s *batch)
+{
+  return devif_batch_poll(dev, batch, false);
+}
+
+/****************************************************************************
+ * Name: devif_timer_batch
+ *
+ * Description:
+ *   Batched version of devif_timer().  See include/nuttx/net/netdev.h.
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver with the network
+ *   locked.
+ *
+ ****************************************************************************/
+
+int devif_timer_batch(FAR struct net_driver_s *dev,
+                      FAR struct devif_txbatch_s *batch)
+{
+  return devif_batch_poll(dev, batch, true);
+}
+
+#endif /* CONFIG_NETDEV_POLL_BATCH */
@@ -84,5 +84,43 @@ void devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
 #endif
 }
 
+/****************************************************************************
+ * Name: devif_iob_sgsend
+ *
+ * Description:
+ *   Like devif_iob_send() but, rather than copying the data into the
+ *   device buffer, leave it in the I/O buffer chain for a device that
+ *   advertises scatter-gather transmit.  If the device also supports TCP
+ *   segmentation offload, len may exceed mss.
+ *
+ *   The I/O buffer chain must remain valid until the driver has sent the
+ *   packet.  That is true of the TCP write buffers, which are not released
+ *   before the data is acknowledged.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_TSO
+void devif_iob_sgsend(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
+                      unsigned int len, unsigned int offset,
+                      unsigned int mss)
+{
+  DEBUGASSERT(dev && iob && len > 0 && mss > 0);
+  DEBUGASSERT((dev->d_txcaps & NETDEV_TXCAP_SG) != 0);
+  DEBUGASSERT(len <= mss || (dev->d_txcaps & NETDEV_TXCAP_TSO) != 0);
+
+  /* Only describe the payload.  The driver gathers it from the I/O buffer
+   * chain when the packet is sent.
+   */
+
+  dev->d_sgiob    = iob;
+  dev->d_sgoffset = offset;
+  dev->d_sgmss    = mss;
+  dev->d_sndlen   = len;
+}
+#endif
+
 #endif /* CONFIG_MM_IOB */
 
@@ -0,0 +1,259 @@
+/****************************************************************************
+ * net/devif/devif_segment.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/tcp.h>
+
+#include "inet/inet.h"
+#include "tcp/tcp.h"
+#include "utils/utils.h"
+
+#ifdef CONFIG_NETDEV_TSO
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Room for the link layer header, the largest IP header and a TCP header
+ * with options.
+ */
+
+#define SEG_MAXHDRLEN  (32 + 60 + TCP_MAX_HDRLEN)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devif_segment
+ *
+ * Description:
+ *   Software scatter-gather and TCP segmentation for drivers that
+ *   advertise NETDEV_TXCAP_SG or NETDEV_TXCAP_TSO but cannot gather or
+ *   segment in hardware.  Call this from the poll callback after arp_out()
+ *   or neighbor_out() in place of sending the packet directly.
+ *
+ *   If d_sgiob is NULL, the packet in d_buf is passed to the callback as
+ *   is.  Otherwise, the payload in d_sgiob is copied into d_buf one
+ *   segment at a time behind a copy of the headers.  The sequence number,
+ *   lengths, IP ID, flags and checksums are updated for each segment
+ *   before the callback is invoked to send it.
+ *
+ * Input Parameters:
+ *   dev      - The network device holding the outgoing packet
+ *   callback - Sends the packet currently in d_buf
+ *
+ * Returned Value:
+ *   The value returned by the last invocation of the callback.  If the
+ *   callback returns a non-zero value, the remaining segments are dropped
+ *   and will be retransmitted by TCP.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+int devif_segment(FAR struct net_driver_s *dev,
+                  devif_poll_callback_t callback)
+{
+  uint8_t hdr[SEG_MAXHDRLEN];
+  FAR struct iob_s *iob;
+  FAR uint8_t *iphdr;
+  FAR struct tcp_hdr_s *tcp;
+  unsigned int llhdrlen;
+  unsigned int iphdrlen;
+  unsigned int hdrlen;
+  uint16_t paylen;
+  uint16_t offset;
+  uint16_t mss;
+  uint16_t seglen;
+  uint16_t pos;
+  uint32_t seqno;
+  uint8_t flags;
+  bool ipv4;
+  int ret = 0;
+
+  DEBUGASSERT(dev != NULL && callback != NULL);
+
+  iob = dev->d_sgiob;
+  if (iob == NULL)
+    {
+      /* The payload, if any, is already in d_buf */
+
+      return callback(dev);
+    }
+
+  /* Take the payload description from the device.  The callback may
+   * perform input processing (e.g. devif_loopback()) that prepares another
+   * packet in d_buf.
+   */
+
+  paylen       = dev->d_sndlen;
+  offset       = dev->d_sgoffset;
+  mss          = dev->d_sgmss;
+  dev->d_sgiob = NULL;
+
+  llhdrlen     = NET_LL_HDRLEN(dev);
+  iphdr        = &dev->d_buf[llhdrlen];
+  hdrlen       = dev->d_len - paylen;
+
+  DEBUGASSERT(paylen > 0 && mss > 0 && dev->d_len > paylen);
+  DEBUGASSERT(hdrlen + mss <= NETDEV_PKTSIZE(dev));
+
+  if (hdrlen > SEG_MAXHDRLEN)
+    {
+      nerr("ERROR: Header too large: %u\n", hdrlen);
+      dev->d_len = 0;
+      return 0;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  ipv4 = (iphdr[0] & IP_VERSION_MASK) == IPv4_VERSION;
+  if (ipv4)
+    {
+      iphdrlen = (iphdr[0] & IPv4_HLMASK) << 2;
+    }
+#else
+  ipv4 = false;
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (!ipv4)
+    {
+      iphdrlen = IPv6_HDRLEN;
+    }
+#endif
+
+  /* Save the header template */
+
+  memcpy(hdr, dev->d_buf, hdrlen);
+
+  tcp   = (FAR struct tcp_hdr_s *)&hdr[llhdrlen + iphdrlen];
+  seqno = tcp_getsequence(tcp->seqno);
+  flags = tcp->flags;
+
+  for (pos = 0; pos < paylen; pos += seglen)
+    {
+      seglen = paylen - pos;
+      if (seglen > mss)
+        {
+          seglen = mss;
+        }
+
+      /* Restore the headers and add this segment's payload.  The callback
+       * may have consumed the previous segment in place or moved d_buf to
+       * another buffer.
+       */
+
+      memcpy(dev->d_buf, hdr, hdrlen);
+      iphdr = &dev->d_buf[llhdrlen];
+      tcp   = (FAR struct tcp_hdr_s *)&iphdr[iphdrlen];
+      iob_copyout(&dev->d_buf[hdrlen], iob, seglen, offset + pos);
+
+      dev->d_len    = hdrlen + seglen;
+      dev->d_sndlen = seglen;
+
+      /* PSH and FIN only belong to the last segment */
+
+      tcp_setsequence(tcp->seqno, seqno + pos);
+      if (pos + seglen < paylen)
+        {
+          tcp->flags = flags & ~(TCP_PSH | TCP_FIN);
+        }
+
+      tcp->tcpchksum = 0;
+
+#ifdef CONFIG_NET_IPv4
+      if (ipv4)
+        {
+          FAR struct ipv4_hdr_s *ip = (FAR struct ipv4_hdr_s *)iphdr;
+          uint16_t iplen = dev->d_len - llhdrlen;
+
+          ip->len[0] = iplen >> 8;
+          ip->len[1] = iplen & 0xff;
+
+          /* The first segment keeps the IP ID assigned by tcp_send() */
+
+          if (pos > 0)
+            {
+              ++g_ipid;
+              ip->ipid[0] = g_ipid >> 8;
+              ip->ipid[1] = g_ipid & 0xff;
+            }
+
+          ip->ipchksum   = 0;
+          ip->ipchksum   = ~ipv4_chksum(dev);
+          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+        }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+      if (!ipv4)
+        {
+          FAR struct ipv6_hdr_s *ip = (FAR struct ipv6_hdr_s *)iphdr;
+          uint16_t iplen = dev->d_len - llhdrlen - IPv6_HDRLEN;
+
+          ip->len[0] = iplen >> 8;
+          ip->len[1] = iplen & 0xff;
+
+          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+        }
+#endif
+
+      ret = callback(dev);
+      if (ret != 0)
+        {
+          break;
+        }
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_NETDEV_TSO */
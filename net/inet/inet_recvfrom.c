@@ -230,9 +230,9 @@ static inline void inet_tcp_newdata(FAR struct net_driver_s *dev,
 #ifdef CONFIG_DEBUG_NET
       uint16_t nsaved;
 
-      nsaved = tcp_datahandler(conn, buffer, buflen);
+      nsaved = tcp_datahandler(dev, conn, buffer, buflen);
 #else
-      (void)tcp_datahandler(conn, buffer, buflen);
+      (void)tcp_datahandler(dev, conn, buffer, buflen);
 #endif
 
       /* There are complicated buffering issues that are not addressed fully
@@ -308,7 +308,7 @@ static inline void inet_udp_newdata(FAR struct net_driver_s *dev,
  *   None
  *
  * Assumptions:
- *   The network is locked.
+ *   The connection is locked.  The network need not be locked.
  *
  ****************************************************************************/
 
@@ -1200,17 +1200,17 @@ static ssize_t inet_udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
 
   /* Perform the UDP recvfrom() operation */
 
-  /* Initialize the state structure.  This is done with the network locked
-   * because we don't want anything to happen until we are ready.
-   */
-
-  net_lock();
   inet_recvfrom_initialize(psock, buf, len, from, fromlen, &state);
 
 #ifdef CONFIG_NET_UDP_READAHEAD
-  /* Copy the read-ahead data from the packet */
+  /* Copy the read-ahead data from the packet.  Only the connection lock is
+   * needed for this, so a datagram that is already buffered is received
+   * without locking the network.
+   */
 
+  udp_conn_lock(conn);
   inet_udp_readahead(&state);
+  udp_conn_unlock(conn);
 
   /* The default return value is the number of bytes that we just copied
    * into the user buffer.  We will return this if the socket has become
@@ -1255,43 +1255,67 @@ static ssize_t inet_udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
   else if (state.ir_recvlen <= 0)
 #endif
     {
-      /* Get the device that will handle the packet transfers.  This may be
-       * NULL if the UDP socket is bound to INADDR_ANY.  In that case, no
-       * NETDEV_DOWN notifications will be received.
+      /* Lock the network because we don't want anything to happen until we
+       * are ready.
        */
 
-      dev = udp_find_laddr_device(conn);
+      net_lock();
 
-      /* Set up the callback in the connection */
+#ifdef CONFIG_NET_UDP_READAHEAD
+      /* A datagram may have been buffered after the read-ahead queue was
+       * checked and before the network was locked.
+       */
 
-      state.ir_cb = udp_callback_alloc(dev, conn);
-      if (state.ir_cb)
+      if (state.ir_recvlen < 0)
+        {
+          udp_conn_lock(conn);
+          inet_udp_readahead(&state);
+          udp_conn_unlock(conn);
+          ret = state.ir_recvlen;
+        }
+
+      if (state.ir_recvlen <= 0)
+#endif
         {
+          /* Get the device that will handle the packet transfers.  This may
+           * be NULL if the UDP socket is bound to INADDR_ANY.  In that case,
+           * no NETDEV_DOWN notifications will be received.
+           */
+
+          dev = udp_find_laddr_device(conn);
+
           /* Set up the callback in the connection */
 
-          state.ir_cb->flags   = (UDP_NEWDATA | NETDEV_DOWN);
-          state.ir_cb->priv    = (FAR void *)&state;
-          state.ir_cb->event   = inet_udp_eventhandler;
+          state.ir_cb = udp_callback_alloc(dev, conn);
+          if (state.ir_cb)
+            {
+              /* Set up the callback in the connection */
 
-          /* Wait for either the receive to complete or for an error/timeout
-           * to occur.  net_lockedwait will also terminate if a signal is
-           * received.
-           */
+              state.ir_cb->flags   = (UDP_NEWDATA | NETDEV_DOWN);
+              state.ir_cb->priv    = (FAR void *)&state;
+              state.ir_cb->event   = inet_udp_eventhandler;
 
-          ret = net_lockedwait(&state. ir_sem);
+              /* Wait for either the receive to complete or for an
+               * error/timeout to occur.  net_lockedwait will also terminate
+               * if a signal is received.
+               */
 
-          /* Make sure that no further events are processed */
+              ret = net_lockedwait(&state. ir_sem);
 
-          udp_callback_free(dev, conn, state.ir_cb);
-          ret = inet_recvfrom_result(ret, &state);
-        }
-      else
-        {
-          ret = -EBUSY;
+              /* Make sure that no further events are processed */
+
+              udp_callback_free(dev, conn, state.ir_cb);
+              ret = inet_recvfrom_result(ret, &state);
+            }
+          else
+            {
+              ret = -EBUSY;
+            }
         }
+
+      net_unlock();
     }
 
-  net_unlock();
   inet_recvfrom_uninitialize(&state);
   return ret;
 }
@@ -1321,23 +1345,50 @@ static ssize_t inet_udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
 static ssize_t inet_tcp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
                                  FAR struct sockaddr *from, FAR socklen_t *fromlen)
 {
+  FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)psock->s_conn;
   struct inet_recvfrom_s state;
   int               ret;
 
-  /* Initialize the state structure.  This is done with the network locked
-   * because we don't want anything to happen until we are ready.
+  inet_recvfrom_initialize(psock, buf, len, from, fromlen, &state);
+
+#ifdef CONFIG_NET_TCP_READAHEAD
+  /* Handle any TCP data already buffered in a read-ahead buffer.  Only the
+   * connection lock is needed for this.  If the buffered data is all that
+   * will be returned, the network is not locked at all.
+   */
+
+  tcp_conn_lock(conn);
+  inet_tcp_readahead(&state);
+  tcp_conn_unlock(conn);
+
+#if CONFIG_NET_TCP_RECVDELAY == 0
+  if (state.ir_recvlen > 0)
+#else
+  if (state.ir_recvlen > 0 &&
+      (state.ir_buflen == 0 || _SS_ISNONBLOCK(psock->s_flags)))
+#endif
+    {
+      ret = state.ir_recvlen;
+      inet_recvfrom_uninitialize(&state);
+      return (ssize_t)ret;
+    }
+#endif
+
+  /* Lock the network because we don't want anything to happen until we are
+   * ready.
    */
 
   net_lock();
-  inet_recvfrom_initialize(psock, buf, len, from, fromlen, &state);
 
-  /* Handle any any TCP data already buffered in a read-ahead buffer.  NOTE
-   * that there may be read-ahead data to be retrieved even after the
+  /* Handle any TCP data that was buffered before the network was locked.
+   * NOTE that there may be read-ahead data to be retrieved even after the
    * socket has been disconnected.
    */
 
 #ifdef CONFIG_NET_TCP_READAHEAD
+  tcp_conn_lock(conn);
   inet_tcp_readahead(&state);
+  tcp_conn_unlock(conn);
 
   /* The default return value is the number of bytes that we just copied
    * into the user buffer.  We will return this if the socket has become
@@ -1435,8 +1486,6 @@ static ssize_t inet_tcp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
   if (state.ir_buflen > 0)
 #endif
     {
-      FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)psock->s_conn;
-
       /* Set up the callback in the connection */
 
       state.ir_cb = tcp_callback_alloc(conn);
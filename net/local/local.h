@@ -62,6 +62,7 @@
 
 #define HAVE_LOCAL_POLL 1
 #define LOCAL_ACCEPT_NPOLLWAITERS 2
+#define LOCAL_DIRECT_NPOLLWAITERS 2
 
 /* Packet format in FIFO:
  *
@@ -128,13 +129,60 @@ enum local_state_s
 
 struct devif_callback_s;       /* Forward reference */
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+/* One direction of a direct connection.  This is a single-
+ * producer, single-consumer ring:  Only the sending side modifies lr_head
+ * and only the receiving side modifies lr_tail.  Several threads may send
+ * or receive on the same socket, so lr_sndsem and lr_rcvsem make each side
+ * a single producer or consumer.  Both indices are free-running counters so
+ * that the ring can use all CONFIG_NET_LOCAL_DIRECT_BUFSIZE bytes.  The
+ * lr_rdsem and lr_wrsem semaphores and the poll lists are only used when a
+ * side must wait and are protected by a critical section.
+ */
+
+struct local_ring_s
+{
+  volatile uint32_t lr_head;   /* Incremented by the producer */
+  volatile uint32_t lr_tail;   /* Incremented by the consumer */
+  sem_t lr_sndsem;             /* Serializes the sending threads */
+  sem_t lr_rcvsem;             /* Serializes the receiving threads */
+  sem_t lr_rdsem;              /* Consumer waits here for data */
+  sem_t lr_wrsem;              /* Producer waits here for space */
+
+  /* Threads polling for POLLIN (consumer) and POLLOUT (producer) */
+
+  FAR struct pollfd *lr_infds[LOCAL_DIRECT_NPOLLWAITERS];
+  FAR struct pollfd *lr_outfds[LOCAL_DIRECT_NPOLLWAITERS];
+
+  uint8_t lr_buffer[CONFIG_NET_LOCAL_DIRECT_BUFSIZE];
+};
+
+/* The in-kernel connection object shared by two connected SOCK_STREAM
+ * peers.  It replaces the pair of named FIFOs.  ld_ring[0] carries data
+ * to the client, ld_ring[1] carries data to the server.
+ *
+ * A bound SOCK_DGRAM socket owns an object with only ld_ring[0], which
+ * holds the datagrams sent to it, each preceded by its 16-bit length.
+ * Senders hold a reference only for the duration of one sendto().
+ */
+
+struct local_direct_s
+{
+  uint16_t ld_crefs;           /* Number of peers or senders attached */
+  volatile bool ld_closed;     /* One of the peers has been released */
+  bool ld_dgram;               /* Datagram receiver (ld_ring[0] only) */
+  struct local_ring_s ld_ring[2];
+};
+#endif
+
 struct local_conn_s
 {
   /* Common prologue of all connection structures. */
 
   /* lc_node supports a doubly linked list: Listening SOCK_STREAM servers
    * will be linked into a list of listeners; SOCK_STREAM clients will be
-   * linked to the lc_waiters and lc_conn lists.
+   * linked to the lc_waiters and lc_conn lists; bound SOCK_DGRAM sockets
+   * with a direct receive ring will be linked into g_local_dgrams.
    */
 
   dq_entry_t lc_node;          /* Supports a doubly linked list */
@@ -151,6 +199,16 @@ struct local_conn_s
 
   /* Fields common to SOCK_STREAM and SOCK_DGRAM */
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  /* Direct connection object and the index of the ring that carries data
+   * to this socket.  For SOCK_STREAM, the object is shared with the peer;
+   * for SOCK_DGRAM, it is allocated by bind().
+   */
+
+  FAR struct local_direct_s *lc_direct;
+  uint8_t lc_rxndx;
+#endif
+
   uint8_t lc_crefs;            /* Reference counts on this instance */
   uint8_t lc_proto;            /* SOCK_STREAM or SOCK_DGRAM */
   uint8_t lc_type;             /* See enum local_type_e */
@@ -229,6 +287,12 @@ EXTERN const struct sock_intf_s g_local_sockif;
 EXTERN dq_queue_t g_local_listeners;
 #endif
 
+#if defined(CONFIG_NET_LOCAL_DGRAM) && defined(CONFIG_NET_LOCAL_DIRECT)
+/* A list of all bound SOCK_DGRAM connections with a direct receive ring */
+
+EXTERN dq_queue_t g_local_dgrams;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -662,6 +726,147 @@ int local_open_sender(FAR struct local_conn_s *conn, FAR const char *path,
                       bool nonblock);
 #endif
 
+/****************************************************************************
+ * Name: local_direct_alloc
+ *
+ * Description:
+ *   Allocate the direct connection object for a connecting SOCK_STREAM
+ *   client.  The accepting server attaches to it with local_direct_attach().
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DIRECT
+int local_direct_alloc(FAR struct local_conn_s *client);
+#endif
+
+/****************************************************************************
+ * Name: local_direct_attach
+ *
+ * Description:
+ *   Attach the new, accepted server-side peer to the direct connection
+ *   object allocated by the client.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DIRECT
+void local_direct_attach(FAR struct local_conn_s *conn,
+                         FAR struct local_conn_s *client);
+#endif
+
+/****************************************************************************
+ * Name: local_direct_release
+ *
+ * Description:
+ *   Detach a peer from its direct connection object.  The peer is woken up
+ *   and sees end-of-file (or EPIPE on send) once the ring is drained.  The
+ *   object is freed when the last peer detaches.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DIRECT
+void local_direct_release(FAR struct local_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: local_direct_send
+ *
+ * Description:
+ *   Copy data directly into the peer's receive ring.
+ *
+ * Returned Value:
+ *   The number of bytes sent (which may be less than 'len' only for a
+ *   non-blocking socket) or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DIRECT
+ssize_t local_direct_send(FAR struct local_conn_s *conn,
+                          FAR const void *buf, size_t len, bool nonblock);
+#endif
+
+/****************************************************************************
+ * Name: local_direct_recv
+ *
+ * Description:
+ *   Copy data out of the receive ring.
+ *
+ * Returned Value:
+ *   The number of bytes received, zero if the peer has been released and
+ *   the ring is empty, or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DIRECT
+ssize_t local_direct_recv(FAR struct local_conn_s *conn, FAR void *buf,
+                          size_t len, bool nonblock);
+#endif
+
+/****************************************************************************
+ * Name: local_direct_bind
+ *
+ * Description:
+ *   Allocate the direct receive ring of a SOCK_DGRAM socket that has just
+ *   been bound to a path and make it visible to local_direct_sendto().
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_LOCAL_DGRAM) && defined(CONFIG_NET_LOCAL_DIRECT)
+int local_direct_bind(FAR struct local_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: local_direct_sendto
+ *
+ * Description:
+ *   Copy one datagram directly into the receive ring of the SOCK_DGRAM
+ *   socket bound to 'path'.
+ *
+ * Returned Value:
+ *   The number of bytes sent or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_LOCAL_DGRAM) && defined(CONFIG_NET_LOCAL_DIRECT)
+ssize_t local_direct_sendto(FAR const char *path, FAR const void *buf,
+                            size_t len, bool nonblock);
+#endif
+
+/****************************************************************************
+ * Name: local_direct_recvfrom
+ *
+ * Description:
+ *   Copy one datagram out of the receive ring.  The part of the datagram
+ *   that does not fit into 'buf' is discarded.
+ *
+ * Returned Value:
+ *   The number of bytes received or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_LOCAL_DGRAM) && defined(CONFIG_NET_LOCAL_DIRECT)
+ssize_t local_direct_recvfrom(FAR struct local_conn_s *conn, FAR void *buf,
+                              size_t len, bool nonblock);
+#endif
+
+/****************************************************************************
+ * Name: local_direct_pollsetup
+ *
+ * Description:
+ *   Setup or teardown monitoring of events on a direct connection.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_LOCAL_DIRECT) && defined(HAVE_LOCAL_POLL)
+int local_direct_pollsetup(FAR struct local_conn_s *conn,
+                           FAR struct pollfd *fds, bool setup);
+#endif
+
 /****************************************************************************
  * Name: local_accept_pollnotify
  ****************************************************************************/
@@ -184,6 +184,12 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
               conn->lc_path[UNIX_PATH_MAX - 1] = '\0';
               conn->lc_instance_id = client->lc_instance_id;
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+              /* Attach to the connection object allocated by the client */
+
+              local_direct_attach(conn, client);
+              ret = OK;
+#else
               /* Open the server-side write-only FIFO.  This should not
                * block.
                */
@@ -195,8 +201,10 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
                    nerr("ERROR: Failed to open write-only FIFOs for %s: %d\n",
                         conn->lc_path, ret);
                 }
+#endif
             }
 
+#ifndef CONFIG_NET_LOCAL_DIRECT
           /* Do we have a connection?  Is the write-side FIFO opened? */
 
           if (ret == OK)
@@ -222,7 +230,11 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
           if (ret == OK)
             {
               DEBUGASSERT(conn->lc_infile.f_inode != NULL);
+            }
+#endif
 
+          if (ret == OK)
+            {
               /* Return the address family */
 
               if (addr != NULL)
@@ -42,6 +42,7 @@
 
 #include <sys/socket.h>
 #include <string.h>
+#include <errno.h>
 #include <assert.h>
 
 #include <nuttx/net/net.h>
@@ -75,6 +76,15 @@ int psock_local_bind(FAR struct socket *psock,
 
   conn = (FAR struct local_conn_s *)psock->s_conn;
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  /* The socket must not already be bound or connected */
+
+  if (conn->lc_direct != NULL)
+    {
+      return -EINVAL;
+    }
+#endif
+
   /* Save the address family */
 
   conn->lc_proto = psock->s_type;
@@ -113,6 +123,19 @@ int psock_local_bind(FAR struct socket *psock,
         }
     }
 
+#if defined(CONFIG_NET_LOCAL_DGRAM) && defined(CONFIG_NET_LOCAL_DIRECT)
+  /* Datagrams sent to the path are copied directly into a receive ring */
+
+  if (conn->lc_proto == SOCK_DGRAM && conn->lc_type == LOCAL_TYPE_PATHNAME)
+    {
+      int ret = local_direct_bind(conn);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+#endif
+
   conn->lc_state = LOCAL_STATE_BOUND;
   return OK;
 }
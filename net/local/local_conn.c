@@ -70,6 +70,9 @@ void local_initialize(void)
 #ifdef CONFIG_NET_LOCAL_STREAM
   dq_init(&g_local_listeners);
 #endif
+#if defined(CONFIG_NET_LOCAL_DGRAM) && defined(CONFIG_NET_LOCAL_DIRECT)
+  dq_init(&g_local_dgrams);
+#endif
 }
 
 /****************************************************************************
@@ -136,10 +139,24 @@ void local_free(FAR struct local_conn_s *conn)
       conn->lc_outfile.f_inode = NULL;
     }
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  /* Detach from the direct connection object.  No FIFOs were created. */
+
+  if (conn->lc_direct != NULL)
+    {
+      local_direct_release(conn);
+    }
+  else
+#endif
+    {
 #ifdef CONFIG_NET_LOCAL_STREAM
-  /* Destroy all FIFOs associted with the connection */
+      /* Destroy all FIFOs associted with the connection */
 
-  local_release_fifos(conn);
+      local_release_fifos(conn);
+#endif
+    }
+
+#ifdef CONFIG_NET_LOCAL_STREAM
   nxsem_destroy(&conn->lc_waitsem);
 #endif
 
@@ -156,6 +156,17 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
   server->u.server.lc_pending++;
   DEBUGASSERT(server->u.server.lc_pending != 0);
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  /* Allocate the connection object that will be shared with the server */
+
+  ret = local_direct_alloc(client);
+  if (ret < 0)
+    {
+      server->u.server.lc_pending--;
+      net_unlock();
+      return ret;
+    }
+#else
   /* Create the FIFOs needed for the connection */
 
   ret = local_create_fifos(client);
@@ -183,6 +194,7 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
     }
 
   DEBUGASSERT(client->lc_outfile.f_inode != NULL);
+#endif
 
   /* Set the busy "result" before giving the semaphore. */
 
@@ -215,9 +227,16 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
   if (ret < 0)
     {
       nerr("ERROR: Failed to connect: %d\n", ret);
+#ifdef CONFIG_NET_LOCAL_DIRECT
+      local_direct_release(client);
+      client->lc_state = LOCAL_STATE_BOUND;
+      return ret;
+#else
       goto errout_with_outfd;
+#endif
     }
 
+#ifndef CONFIG_NET_LOCAL_DIRECT
   /* Yes.. open the read-only FIFO */
 
   ret = local_open_client_rx(client, nonblock);
@@ -229,9 +248,13 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
     }
 
   DEBUGASSERT(client->lc_infile.f_inode != NULL);
+#endif
+
   client->lc_state = LOCAL_STATE_CONNECTED;
   return OK;
 
+#ifndef CONFIG_NET_LOCAL_DIRECT
+
 errout_with_outfd:
   (void)file_close(&client->lc_outfile);
   client->lc_outfile.f_inode = NULL;
@@ -240,6 +263,7 @@ errout_with_fifos:
   (void)local_release_fifos(client);
   client->lc_state = LOCAL_STATE_BOUND;
   return ret;
+#endif
 }
 
 /****************************************************************************
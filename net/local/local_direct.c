@@ -0,0 +1,1034 @@
+/****************************************************************************
+ * net/local/local_direct.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_LOCAL_DIRECT)
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <semaphore.h>
+#include <poll.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/net/net.h>
+
+#include "local/local.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LOCAL_RING_SIZE CONFIG_NET_LOCAL_DIRECT_BUFSIZE
+#define LOCAL_RING_MASK (LOCAL_RING_SIZE - 1)
+
+#if LOCAL_RING_SIZE <= 0 || (LOCAL_RING_SIZE & LOCAL_RING_MASK) != 0
+#  error CONFIG_NET_LOCAL_DIRECT_BUFSIZE must be a power of two
+#endif
+
+#ifndef MIN
+#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
+/* Rings used for reception and transmission by a peer */
+
+#define LOCAL_RXRING(c) (&(c)->lc_direct->ld_ring[(c)->lc_rxndx])
+#define LOCAL_TXRING(c) (&(c)->lc_direct->ld_ring[(c)->lc_rxndx ^ 1])
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+/* A list of all bound SOCK_DGRAM connections with a direct receive ring */
+
+dq_queue_t g_local_dgrams;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_notify
+ *
+ * Description:
+ *   Wake up all threads waiting on 'sem' and report 'eventset' to the
+ *   threads polling in 'fds'.  Must be called from within a critical
+ *   section.
+ *
+ ****************************************************************************/
+
+static void local_ring_notify(FAR sem_t *sem, FAR struct pollfd **fds,
+                              pollevent_t eventset)
+{
+  int sval;
+  int i;
+
+  while (nxsem_getvalue(sem, &sval) == 0 && sval < 0)
+    {
+      nxsem_post(sem);
+    }
+
+#ifdef HAVE_LOCAL_POLL
+  for (i = 0; i < LOCAL_DIRECT_NPOLLWAITERS; i++)
+    {
+      if (fds[i] != NULL)
+        {
+          fds[i]->revents |= (fds[i]->events & eventset) |
+                             (eventset & POLLHUP);
+          if (fds[i]->revents != 0)
+            {
+              ninfo("Report events: %02x\n", fds[i]->revents);
+              poll_notify(fds[i]);
+            }
+        }
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: local_ring_init
+ ****************************************************************************/
+
+static void local_ring_init(FAR struct local_ring_s *ring)
+{
+  /* lr_sndsem and lr_rcvsem are mutexes.  The other semaphores are used
+   * for signaling and, hence, should not have priority inheritance enabled.
+   */
+
+  nxsem_init(&ring->lr_sndsem, 0, 1);
+  nxsem_init(&ring->lr_rcvsem, 0, 1);
+  nxsem_init(&ring->lr_rdsem, 0, 0);
+  nxsem_setprotocol(&ring->lr_rdsem, SEM_PRIO_NONE);
+  nxsem_init(&ring->lr_wrsem, 0, 0);
+  nxsem_setprotocol(&ring->lr_wrsem, SEM_PRIO_NONE);
+}
+
+/****************************************************************************
+ * Name: local_ring_destroy
+ ****************************************************************************/
+
+static void local_ring_destroy(FAR struct local_ring_s *ring)
+{
+  nxsem_destroy(&ring->lr_sndsem);
+  nxsem_destroy(&ring->lr_rcvsem);
+  nxsem_destroy(&ring->lr_rdsem);
+  nxsem_destroy(&ring->lr_wrsem);
+}
+
+/****************************************************************************
+ * Name: local_ring_hangup
+ *
+ * Description:
+ *   Wake up everything waiting on a ring after one of the peers has been
+ *   released.  Must be called from within a critical section.
+ *
+ ****************************************************************************/
+
+static void local_ring_hangup(FAR struct local_ring_s *ring)
+{
+  local_ring_notify(&ring->lr_rdsem, ring->lr_infds, POLLIN | POLLHUP);
+  local_ring_notify(&ring->lr_wrsem, ring->lr_outfds, POLLOUT | POLLHUP);
+}
+
+/****************************************************************************
+ * Name: local_ring_copyin
+ *
+ * Description:
+ *   Copy 'len' bytes into the ring at the free-running index 'head' in at
+ *   most two pieces:  to the end of the buffer, then from its beginning.
+ *   The caller must hold lr_sndsem and have checked for space.
+ *
+ ****************************************************************************/
+
+static void local_ring_copyin(FAR struct local_ring_s *ring, uint32_t head,
+                              FAR const uint8_t *src, size_t len)
+{
+  size_t off = head & LOCAL_RING_MASK;
+
+  if (len > LOCAL_RING_SIZE - off)
+    {
+      memcpy(&ring->lr_buffer[off], src, LOCAL_RING_SIZE - off);
+      memcpy(ring->lr_buffer, &src[LOCAL_RING_SIZE - off],
+             len - (LOCAL_RING_SIZE - off));
+    }
+  else
+    {
+      memcpy(&ring->lr_buffer[off], src, len);
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_copyout
+ *
+ * Description:
+ *   Copy 'len' bytes out of the ring at the free-running index 'tail'.
+ *   The caller must hold lr_rcvsem and have checked for data.
+ *
+ ****************************************************************************/
+
+static void local_ring_copyout(FAR struct local_ring_s *ring, uint32_t tail,
+                               FAR uint8_t *dest, size_t len)
+{
+  size_t off = tail & LOCAL_RING_MASK;
+
+  if (len > LOCAL_RING_SIZE - off)
+    {
+      memcpy(dest, &ring->lr_buffer[off], LOCAL_RING_SIZE - off);
+      memcpy(&dest[LOCAL_RING_SIZE - off], ring->lr_buffer,
+             len - (LOCAL_RING_SIZE - off));
+    }
+  else
+    {
+      memcpy(dest, &ring->lr_buffer[off], len);
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_waitspace
+ *
+ * Description:
+ *   Wait until at least 'len' bytes are free in the ring or the direct
+ *   connection is closed.  The check is repeated inside the critical
+ *   section so that the wake-up cannot be lost.
+ *
+ ****************************************************************************/
+
+static int local_ring_waitspace(FAR struct local_direct_s *direct,
+                                FAR struct local_ring_s *ring, size_t len)
+{
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = enter_critical_section();
+  if (LOCAL_RING_SIZE - (ring->lr_head - ring->lr_tail) < len &&
+      !direct->ld_closed)
+    {
+      ret = nxsem_wait(&ring->lr_wrsem);
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_waitdata
+ *
+ * Description:
+ *   Wait until the ring is not empty or the direct connection is closed.
+ *
+ ****************************************************************************/
+
+static int local_ring_waitdata(FAR struct local_direct_s *direct,
+                               FAR struct local_ring_s *ring)
+{
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = enter_critical_section();
+  if (ring->lr_head == ring->lr_tail && !direct->ld_closed)
+    {
+      ret = nxsem_wait(&ring->lr_rdsem);
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_direct_free
+ *
+ * Description:
+ *   Drop one reference to a direct connection object and free it when the
+ *   last reference is gone.
+ *
+ ****************************************************************************/
+
+static void local_direct_free(FAR struct local_direct_s *direct)
+{
+  irqstate_t flags;
+  uint16_t crefs;
+
+  DEBUGASSERT(direct->ld_crefs > 0);
+
+  flags = enter_critical_section();
+  crefs = --direct->ld_crefs;
+  leave_critical_section(flags);
+
+  if (crefs == 0)
+    {
+      local_ring_destroy(&direct->ld_ring[0]);
+      if (!direct->ld_dgram)
+        {
+          local_ring_destroy(&direct->ld_ring[1]);
+        }
+
+      kmm_free(direct);
+    }
+}
+
+/****************************************************************************
+ * Name: local_stream_send
+ *
+ * Description:
+ *   Copy stream data into the ring.  The caller holds lr_sndsem, so this
+ *   thread is the only producer.
+ *
+ ****************************************************************************/
+
+static ssize_t local_stream_send(FAR struct local_direct_s *direct,
+                                 FAR struct local_ring_s *ring,
+                                 FAR const uint8_t *src, size_t len,
+                                 bool nonblock)
+{
+  irqstate_t flags;
+  uint32_t head;
+  uint32_t tail;
+  size_t nsent = 0;
+  size_t ncopy;
+  int ret;
+
+  while (nsent < len)
+    {
+      if (direct->ld_closed)
+        {
+          return nsent > 0 ? (ssize_t)nsent : -EPIPE;
+        }
+
+      /* Only the holder of lr_sndsem modifies lr_head.  Read lr_tail
+       * before touching the freed space.
+       */
+
+      head = ring->lr_head;
+      tail = ring->lr_tail;
+      SP_DMB();
+
+      ncopy = MIN(len - nsent, LOCAL_RING_SIZE - (head - tail));
+      if (ncopy > 0)
+        {
+          local_ring_copyin(ring, head, &src[nsent], ncopy);
+
+          /* Publish the data before the new head */
+
+          SP_DMB();
+          ring->lr_head = head + ncopy;
+          nsent += ncopy;
+
+          flags = enter_critical_section();
+          local_ring_notify(&ring->lr_rdsem, ring->lr_infds, POLLIN);
+          leave_critical_section(flags);
+          continue;
+        }
+
+      /* The ring is full */
+
+      if (nonblock)
+        {
+          return nsent > 0 ? (ssize_t)nsent : -EAGAIN;
+        }
+
+      ret = local_ring_waitspace(direct, ring, 1);
+      if (ret < 0)
+        {
+          return nsent > 0 ? (ssize_t)nsent : ret;
+        }
+    }
+
+  return nsent;
+}
+
+/****************************************************************************
+ * Name: local_stream_recv
+ *
+ * Description:
+ *   Copy stream data out of the ring.  The caller holds lr_rcvsem, so this
+ *   thread is the only consumer.
+ *
+ ****************************************************************************/
+
+static ssize_t local_stream_recv(FAR struct local_direct_s *direct,
+                                 FAR struct local_ring_s *ring,
+                                 FAR uint8_t *dest, size_t len,
+                                 bool nonblock)
+{
+  irqstate_t flags;
+  uint32_t head;
+  uint32_t tail;
+  size_t ncopy;
+  int ret;
+
+  for (; ; )
+    {
+      /* Only the holder of lr_rcvsem modifies lr_tail.  Read lr_head
+       * before reading the data that it covers.
+       */
+
+      tail = ring->lr_tail;
+      head = ring->lr_head;
+      SP_DMB();
+
+      if (head != tail)
+        {
+          break;
+        }
+
+      /* The ring is empty.  Return end-of-file if the peer is gone. */
+
+      if (direct->ld_closed)
+        {
+          return 0;
+        }
+
+      if (nonblock)
+        {
+          return -EAGAIN;
+        }
+
+      ret = local_ring_waitdata(direct, ring);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  ncopy = MIN(len, head - tail);
+  local_ring_copyout(ring, tail, dest, ncopy);
+
+  /* Release the space only after the data has been read */
+
+  SP_DMB();
+  ring->lr_tail = tail + ncopy;
+
+  flags = enter_critical_section();
+  local_ring_notify(&ring->lr_wrsem, ring->lr_outfds, POLLOUT);
+  leave_critical_section(flags);
+
+  return ncopy;
+}
+
+/****************************************************************************
+ * Name: local_dgram_find
+ *
+ * Description:
+ *   Find the SOCK_DGRAM socket bound to 'path' and take a reference to its
+ *   direct receive ring.  Must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+static FAR struct local_direct_s *local_dgram_find(FAR const char *path)
+{
+  FAR struct local_conn_s *conn;
+  FAR struct local_direct_s *direct;
+  irqstate_t flags;
+
+  for (conn = (FAR struct local_conn_s *)g_local_dgrams.head;
+       conn != NULL;
+       conn = (FAR struct local_conn_s *)dq_next(&conn->lc_node))
+    {
+      if (strncmp(conn->lc_path, path, UNIX_PATH_MAX - 1) == 0)
+        {
+          direct = conn->lc_direct;
+
+          flags = enter_critical_section();
+          direct->ld_crefs++;
+          leave_critical_section(flags);
+
+          return direct;
+        }
+    }
+
+  return NULL;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_direct_alloc
+ *
+ * Description:
+ *   Allocate the direct connection object for a connecting SOCK_STREAM
+ *   client.  The accepting server attaches to it with local_direct_attach().
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int local_direct_alloc(FAR struct local_conn_s *client)
+{
+  FAR struct local_direct_s *direct;
+
+  DEBUGASSERT(client != NULL && client->lc_direct == NULL);
+
+  direct = (FAR struct local_direct_s *)
+    kmm_zalloc(sizeof(struct local_direct_s));
+
+  if (direct == NULL)
+    {
+      nerr("ERROR: Failed to allocate direct connection\n");
+      return -ENOMEM;
+    }
+
+  local_ring_init(&direct->ld_ring[0]);
+  local_ring_init(&direct->ld_ring[1]);
+
+  direct->ld_crefs  = 1;
+  client->lc_direct = direct;
+  client->lc_rxndx  = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: local_direct_attach
+ *
+ * Description:
+ *   Attach the new, accepted server-side peer to the direct connection
+ *   object allocated by the client.
+ *
+ ****************************************************************************/
+
+void local_direct_attach(FAR struct local_conn_s *conn,
+                         FAR struct local_conn_s *client)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(conn != NULL && client != NULL && client->lc_direct != NULL);
+
+  flags = enter_critical_section();
+  client->lc_direct->ld_crefs++;
+  leave_critical_section(flags);
+
+  conn->lc_direct = client->lc_direct;
+  conn->lc_rxndx  = 1;
+}
+
+/****************************************************************************
+ * Name: local_direct_release
+ *
+ * Description:
+ *   Detach a peer from its direct connection object.  The peer is woken up
+ *   and sees end-of-file (or EPIPE on send) once the ring is drained.  The
+ *   object is freed when the last peer detaches.
+ *
+ ****************************************************************************/
+
+void local_direct_release(FAR struct local_conn_s *conn)
+{
+  FAR struct local_direct_s *direct = conn->lc_direct;
+  irqstate_t flags;
+
+  DEBUGASSERT(direct != NULL && direct->ld_crefs > 0);
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+  /* Make a datagram receiver invisible to new senders */
+
+  if (direct->ld_dgram)
+    {
+      net_lock();
+      dq_rem(&conn->lc_node, &g_local_dgrams);
+      net_unlock();
+    }
+#endif
+
+  flags = enter_critical_section();
+  direct->ld_closed = true;
+
+  local_ring_hangup(&direct->ld_ring[0]);
+  if (!direct->ld_dgram)
+    {
+      local_ring_hangup(&direct->ld_ring[1]);
+    }
+
+  leave_critical_section(flags);
+
+  conn->lc_direct = NULL;
+  local_direct_free(direct);
+}
+
+/****************************************************************************
+ * Name: local_direct_send
+ *
+ * Description:
+ *   Copy data directly into the peer's receive ring.
+ *
+ * Returned Value:
+ *   The number of bytes sent (which may be less than 'len' only for a
+ *   non-blocking socket) or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t local_direct_send(FAR struct local_conn_s *conn,
+                          FAR const void *buf, size_t len, bool nonblock)
+{
+  FAR struct local_ring_s *ring = LOCAL_TXRING(conn);
+  ssize_t ret;
+
+  /* Serialize the threads sending on this socket so that the ring has a
+   * single producer and data from concurrent send() calls is not
+   * interleaved.
+   */
+
+  ret = nxsem_wait(&ring->lr_sndsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = local_stream_send(conn->lc_direct, ring,
+                          (FAR const uint8_t *)buf, len, nonblock);
+
+  nxsem_post(&ring->lr_sndsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_direct_recv
+ *
+ * Description:
+ *   Copy data out of the receive ring.
+ *
+ * Returned Value:
+ *   The number of bytes received, zero if the peer has been released and
+ *   the ring is empty, or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t local_direct_recv(FAR struct local_conn_s *conn, FAR void *buf,
+                          size_t len, bool nonblock)
+{
+  FAR struct local_ring_s *ring = LOCAL_RXRING(conn);
+  ssize_t ret;
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  /* Serialize the threads receiving on this socket so that the ring has a
+   * single consumer.
+   */
+
+  ret = nxsem_wait(&ring->lr_rcvsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = local_stream_recv(conn->lc_direct, ring, (FAR uint8_t *)buf, len,
+                          nonblock);
+
+  nxsem_post(&ring->lr_rcvsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_direct_bind
+ *
+ * Description:
+ *   Allocate the direct receive ring of a SOCK_DGRAM socket that has just
+ *   been bound to a path and make it visible to local_direct_sendto().
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+int local_direct_bind(FAR struct local_conn_s *conn)
+{
+  FAR struct local_direct_s *direct;
+  FAR struct local_conn_s *other;
+  int ret = OK;
+
+  DEBUGASSERT(conn != NULL && conn->lc_direct == NULL);
+
+  /* Only ld_ring[0] is used */
+
+  direct = (FAR struct local_direct_s *)
+    kmm_zalloc(sizeof(struct local_direct_s) - sizeof(struct local_ring_s));
+
+  if (direct == NULL)
+    {
+      nerr("ERROR: Failed to allocate direct receive ring\n");
+      return -ENOMEM;
+    }
+
+  local_ring_init(&direct->ld_ring[0]);
+  direct->ld_crefs = 1;
+  direct->ld_dgram = true;
+
+  /* The path may be bound by only one receiver */
+
+  net_lock();
+  for (other = (FAR struct local_conn_s *)g_local_dgrams.head;
+       other != NULL;
+       other = (FAR struct local_conn_s *)dq_next(&other->lc_node))
+    {
+      if (strncmp(other->lc_path, conn->lc_path, UNIX_PATH_MAX - 1) == 0)
+        {
+          ret = -EADDRINUSE;
+          break;
+        }
+    }
+
+  if (ret == OK)
+    {
+      conn->lc_direct = direct;
+      conn->lc_rxndx  = 0;
+      dq_addlast(&conn->lc_node, &g_local_dgrams);
+    }
+
+  net_unlock();
+
+  if (ret < 0)
+    {
+      local_ring_destroy(&direct->ld_ring[0]);
+      kmm_free(direct);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_direct_sendto
+ *
+ * Description:
+ *   Copy one datagram directly into the receive ring of the SOCK_DGRAM
+ *   socket bound to 'path'.
+ *
+ * Returned Value:
+ *   The number of bytes sent or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t local_direct_sendto(FAR const char *path, FAR const void *buf,
+                            size_t len, bool nonblock)
+{
+  FAR struct local_direct_s *direct;
+  FAR struct local_ring_s *ring;
+  irqstate_t flags;
+  uint16_t pktlen = (uint16_t)len;
+  uint32_t head;
+  uint32_t tail;
+  ssize_t ret;
+
+  /* The datagram and its length must fit into the ring as a whole */
+
+  if (len > UINT16_MAX || len + sizeof(pktlen) > LOCAL_RING_SIZE)
+    {
+      return -EMSGSIZE;
+    }
+
+  net_lock();
+  direct = local_dgram_find(path);
+  net_unlock();
+
+  if (direct == NULL)
+    {
+      return -ECONNREFUSED;
+    }
+
+  /* Serialize the senders so that datagrams are not interleaved */
+
+  ring = &direct->ld_ring[0];
+  ret  = nxsem_wait(&ring->lr_sndsem);
+  if (ret < 0)
+    {
+      goto errout_with_ref;
+    }
+
+  for (; ; )
+    {
+      if (direct->ld_closed)
+        {
+          ret = -ECONNREFUSED;
+          goto errout_with_lock;
+        }
+
+      head = ring->lr_head;
+      tail = ring->lr_tail;
+      SP_DMB();
+
+      if (LOCAL_RING_SIZE - (head - tail) >= len + sizeof(pktlen))
+        {
+          break;
+        }
+
+      if (nonblock)
+        {
+          ret = -EAGAIN;
+          goto errout_with_lock;
+        }
+
+      ret = local_ring_waitspace(direct, ring, len + sizeof(pktlen));
+      if (ret < 0)
+        {
+          goto errout_with_lock;
+        }
+    }
+
+  /* Copy the length and the data, then publish them together */
+
+  local_ring_copyin(ring, head, (FAR const uint8_t *)&pktlen,
+                    sizeof(pktlen));
+  local_ring_copyin(ring, head + sizeof(pktlen),
+                    (FAR const uint8_t *)buf, len);
+
+  SP_DMB();
+  ring->lr_head = head + sizeof(pktlen) + len;
+  ret = len;
+
+  flags = enter_critical_section();
+  local_ring_notify(&ring->lr_rdsem, ring->lr_infds, POLLIN);
+  leave_critical_section(flags);
+
+errout_with_lock:
+  nxsem_post(&ring->lr_sndsem);
+
+errout_with_ref:
+  local_direct_free(direct);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_direct_recvfrom
+ *
+ * Description:
+ *   Copy one datagram out of the receive ring.  The part of the datagram
+ *   that does not fit into 'buf' is discarded.
+ *
+ * Returned Value:
+ *   The number of bytes received or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t local_direct_recvfrom(FAR struct local_conn_s *conn, FAR void *buf,
+                              size_t len, bool nonblock)
+{
+  FAR struct local_direct_s *direct = conn->lc_direct;
+  FAR struct local_ring_s *ring = LOCAL_RXRING(conn);
+  irqstate_t flags;
+  uint16_t pktlen;
+  uint32_t head;
+  uint32_t tail;
+  size_t ncopy;
+  ssize_t ret;
+
+  ret = nxsem_wait(&ring->lr_rcvsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (; ; )
+    {
+      tail = ring->lr_tail;
+      head = ring->lr_head;
+      SP_DMB();
+
+      if (head != tail)
+        {
+          break;
+        }
+
+      if (nonblock)
+        {
+          ret = -EAGAIN;
+          goto errout_with_lock;
+        }
+
+      ret = local_ring_waitdata(direct, ring);
+      if (ret < 0)
+        {
+          goto errout_with_lock;
+        }
+    }
+
+  /* Senders publish the length and the data together */
+
+  local_ring_copyout(ring, tail, (FAR uint8_t *)&pktlen, sizeof(pktlen));
+  DEBUGASSERT(head - tail >= sizeof(pktlen) + pktlen);
+
+  ncopy = MIN(len, pktlen);
+  local_ring_copyout(ring, tail + sizeof(pktlen), (FAR uint8_t *)buf,
+                     ncopy);
+
+  SP_DMB();
+  ring->lr_tail = tail + sizeof(pktlen) + pktlen;
+  ret = ncopy;
+
+  flags = enter_critical_section();
+  local_ring_notify(&ring->lr_wrsem, ring->lr_outfds, POLLOUT);
+  leave_critical_section(flags);
+
+errout_with_lock:
+  nxsem_post(&ring->lr_rcvsem);
+  return ret;
+}
+#endif /* CONFIG_NET_LOCAL_DGRAM */
+
+/****************************************************************************
+ * Name: local_direct_pollsetup
+ *
+ * Description:
+ *   Setup or teardown monitoring of events on a direct connection.  A
+ *   SOCK_DGRAM socket has only a receive ring and is always writable.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_LOCAL_POLL
+int local_direct_pollsetup(FAR struct local_conn_s *conn,
+                           FAR struct pollfd *fds, bool setup)
+{
+  FAR struct local_ring_s *rxring = LOCAL_RXRING(conn);
+  FAR struct local_ring_s *txring = NULL;
+  FAR struct pollfd **inslot = NULL;
+  FAR struct pollfd **outslot = NULL;
+  pollevent_t eventset;
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  if (!conn->lc_direct->ld_dgram)
+    {
+      txring = LOCAL_TXRING(conn);
+    }
+
+  flags = enter_critical_section();
+
+  if (!setup)
+    {
+      /* Remove all memory of the poll setup */
+
+      for (i = 0; i < LOCAL_DIRECT_NPOLLWAITERS; i++)
+        {
+          if (rxring->lr_infds[i] == fds)
+            {
+              rxring->lr_infds[i] = NULL;
+            }
+
+          if (txring != NULL && txring->lr_outfds[i] == fds)
+            {
+              txring->lr_outfds[i] = NULL;
+            }
+        }
+
+      fds->priv = NULL;
+      goto errout;
+    }
+
+  /* Find available slots for the poll structure reference */
+
+  for (i = 0; i < LOCAL_DIRECT_NPOLLWAITERS; i++)
+    {
+      if (inslot == NULL && rxring->lr_infds[i] == NULL)
+        {
+          inslot = &rxring->lr_infds[i];
+        }
+
+      if (outslot == NULL && txring != NULL &&
+          txring->lr_outfds[i] == NULL)
+        {
+          outslot = &txring->lr_outfds[i];
+        }
+    }
+
+  if (((fds->events & POLLIN) != 0 && inslot == NULL) ||
+      ((fds->events & POLLOUT) != 0 && outslot == NULL && txring != NULL))
+    {
+      fds->priv = NULL;
+      ret = -EBUSY;
+      goto errout;
+    }
+
+  if ((fds->events & POLLIN) != 0)
+    {
+      *inslot = fds;
+    }
+
+  if ((fds->events & POLLOUT) != 0 && outslot != NULL)
+    {
+      *outslot = fds;
+    }
+
+  fds->priv = conn;
+
+  /* Report the events that are already pending */
+
+  eventset = 0;
+  if (rxring->lr_head != rxring->lr_tail)
+    {
+      eventset |= POLLIN;
+    }
+
+  if (txring == NULL || txring->lr_head - txring->lr_tail < LOCAL_RING_SIZE)
+    {
+      eventset |= POLLOUT;
+    }
+
+  if (conn->lc_direct->ld_closed)
+    {
+      eventset |= POLLIN | POLLHUP;
+    }
+
+  fds->revents |= (fds->events & eventset) | (eventset & POLLHUP);
+  if (fds->revents != 0)
+    {
+      poll_notify(fds);
+    }
+
+errout:
+  leave_critical_section(flags);
+  return ret;
+}
+#endif /* HAVE_LOCAL_POLL */
+
+#endif /* CONFIG_NET && CONFIG_NET_LOCAL_DIRECT */
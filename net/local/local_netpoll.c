@@ -152,7 +152,7 @@ void local_accept_pollnotify(FAR struct local_conn_s *conn,
           if (fds->revents != 0)
             {
               ninfo("Report events: %02x\n", fds->revents);
-              nxsem_post(fds->sem);
+              poll_notify(fds);
             }
         }
     }
@@ -184,6 +184,15 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
 
   if (conn->lc_proto == SOCK_DGRAM)
     {
+#ifdef CONFIG_NET_LOCAL_DIRECT
+      /* A bound datagram socket with a direct receive ring */
+
+      if (conn->lc_direct != NULL)
+        {
+          return local_direct_pollsetup(conn, fds, true);
+        }
+#endif
+
       return ret;
     }
 
@@ -194,6 +203,13 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
       return local_accept_pollsetup(conn, fds, true);
     }
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  if (conn->lc_direct != NULL)
+    {
+      return local_direct_pollsetup(conn, fds, true);
+    }
+#endif
+
   if (conn->lc_state == LOCAL_STATE_DISCONNECTED)
     {
       fds->priv = NULL;
@@ -295,7 +311,7 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
 
 pollerr:
   fds->revents |= POLLERR;
-  nxsem_post(fds->sem);
+  poll_notify(fds);
   return OK;
 }
 
@@ -325,6 +341,15 @@ int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
 
   if (conn->lc_proto == SOCK_DGRAM)
     {
+#ifdef CONFIG_NET_LOCAL_DIRECT
+      /* A bound datagram socket with a direct receive ring */
+
+      if (conn->lc_direct != NULL)
+        {
+          return local_direct_pollsetup(conn, fds, false);
+        }
+#endif
+
       return ret;
     }
 
@@ -335,6 +360,13 @@ int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
       return local_accept_pollsetup(conn, fds, false);
     }
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  if (conn->lc_direct != NULL)
+    {
+      return local_direct_pollsetup(conn, fds, false);
+    }
+#endif
+
   if (conn->lc_state == LOCAL_STATE_DISCONNECTED)
     {
       return OK;
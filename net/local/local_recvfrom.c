@@ -159,6 +159,28 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
       return -ENOTCONN;
     }
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  /* Copy directly from the receive ring.  There is no packet framing. */
+
+  if (conn->lc_direct != NULL)
+    {
+      ssize_t nrecv;
+
+      nrecv = local_direct_recv(conn, buf, len,
+                                _SS_ISNONBLOCK(psock->s_flags));
+      if (nrecv >= 0 && from != NULL)
+        {
+          ret = local_getaddr(conn, from, fromlen);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      return nrecv;
+    }
+#endif
+
   /* The incoming FIFO should be open */
 
   DEBUGASSERT(conn->lc_infile.f_inode != NULL);
@@ -263,6 +285,28 @@ psock_dgram_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
       return -EISCONN;
     }
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  /* Copy one datagram directly from the receive ring */
+
+  if (conn->lc_direct != NULL)
+    {
+      ssize_t nrecv;
+
+      nrecv = local_direct_recvfrom(conn, buf, len,
+                                    _SS_ISNONBLOCK(psock->s_flags));
+      if (nrecv >= 0 && from != NULL)
+        {
+          ret = local_getaddr(conn, from, fromlen);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      return nrecv;
+    }
+#endif
+
   /* The incoming FIFO should not be open */
 
   DEBUGASSERT(conn->lc_infile.f_inode == NULL);
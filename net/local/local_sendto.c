@@ -87,8 +87,10 @@ ssize_t psock_local_sendto(FAR struct socket *psock, FAR const void *buf,
 {
   FAR struct local_conn_s *conn = (FAR struct local_conn_s *)psock->s_conn;
   FAR struct sockaddr_un *unaddr = (FAR struct sockaddr_un *)to;
+#ifndef CONFIG_NET_LOCAL_DIRECT
   ssize_t nsent;
   int ret;
+#endif
 
   /* We keep packet sizes in a uint16_t, so there is a upper limit to the
    * 'len' that can be supported.
@@ -123,6 +125,14 @@ ssize_t psock_local_sendto(FAR struct socket *psock, FAR const void *buf,
       return -EFAULT;
     }
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  /* Copy the datagram directly into the receive ring of the socket bound
+   * to the path.  No FIFO is created.
+   */
+
+  return local_direct_sendto(unaddr->sun_path, buf, len,
+                             _SS_ISNONBLOCK(psock->s_flags));
+#else
   /* Make sure that half duplex FIFO has been created.
    * REVISIT:  Or should be just make sure that it already exists?
    */
@@ -173,6 +183,7 @@ errout_with_halfduplex:
 
   (void)local_release_halfduplex(conn);
   return nsent;
+#endif
 }
 
 #endif /* CONFIG_NET && CONFIG_NET_LOCAL_DGRAM */
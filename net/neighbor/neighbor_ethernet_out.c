@@ -186,6 +186,12 @@ void neighbor_ethernet_out(FAR struct net_driver_s *dev)
            */
 
           icmpv6_solicit(dev, ipaddr);
+
+#ifdef CONFIG_NETDEV_TSO
+          /* The solicitation does not carry the TCP payload */
+
+          dev->d_sgiob = NULL;
+#endif
         }
     }
 
@@ -0,0 +1,240 @@
+/****************************************************************************
+ * net/netdev/netdev_iob.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+
+#ifdef CONFIG_NETDEV_IOB_RECEIVE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The size of I/O buffer needed to receive a full packet */
+
+#define NETDEV_IOBSIZE(d) (NETDEV_PKTSIZE(d) + CONFIG_NET_GUARDSIZE)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_iob_alloc
+ *
+ * Description:
+ *   Allocate an I/O buffer that can hold a full packet of the device.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *netdev_iob_alloc(FAR struct net_driver_s *dev)
+{
+  FAR struct iob_s *iob;
+
+  iob = iob_tryalloc_size(NETDEV_IOBSIZE(dev), false, IOBUSER_NET_NETDEV);
+  if (iob != NULL && IOB_BUFSIZE(iob) < NETDEV_IOBSIZE(dev))
+    {
+      /* Only a smaller buffer was available */
+
+      (void)iob_free(iob, IOBUSER_NET_NETDEV);
+      iob = NULL;
+    }
+
+  return iob;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_iob_prepare
+ *
+ * Description:
+ *   Let the driver receive packets directly into an I/O buffer.  An I/O
+ *   buffer large enough for a full packet is allocated and d_buf is set to
+ *   point to its payload.  The driver then receives into d_buf as usual.
+ *
+ * Input Parameters:
+ *   dev - The device driver structure
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  -ENOMEM is returned if no sufficiently large
+ *   I/O buffer is available; d_buf is left unchanged in that case.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int netdev_iob_prepare(FAR struct net_driver_s *dev)
+{
+  FAR struct iob_s *iob;
+
+  if (dev->d_iob == NULL)
+    {
+      iob = netdev_iob_alloc(dev);
+      if (iob == NULL)
+        {
+          nwarn("WARNING: No I/O buffer for %d byte packets\n",
+                NETDEV_IOBSIZE(dev));
+          return -ENOMEM;
+        }
+
+      dev->d_iob = iob;
+      dev->d_buf = iob->io_data;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netdev_iob_release
+ *
+ * Description:
+ *   Stop receiving into I/O buffers.  The I/O buffer in d_iob is freed and
+ *   d_buf is set to 'buf', the packet buffer of the driver.
+ *
+ * Input Parameters:
+ *   dev - The device driver structure
+ *   buf - The packet buffer to use from now on
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void netdev_iob_release(FAR struct net_driver_s *dev, FAR uint8_t *buf)
+{
+  if (dev->d_iob != NULL)
+    {
+      (void)iob_free(dev->d_iob, IOBUSER_NET_NETDEV);
+      dev->d_iob = NULL;
+    }
+
+  dev->d_buf = buf;
+}
+
+/****************************************************************************
+ * Name: netdev_iob_detach
+ *
+ * Description:
+ *   Take the I/O buffer holding the packet being received, trimmed to the
+ *   'buflen' bytes at 'buffer', so that it can be queued without copying
+ *   the data.  The device is given a new I/O buffer holding a copy of
+ *   everything in front of 'buffer' (the link layer and protocol headers)
+ *   so that the network can still build its response in d_buf.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure
+ *   buffer - The start of the data to take, within d_buf
+ *   buflen - The number of bytes of data to take
+ *
+ * Returned Value:
+ *   The detached I/O buffer, or NULL if the device is not receiving into
+ *   I/O buffers or no replacement I/O buffer is available.  In the latter
+ *   case, the caller must copy the data.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *netdev_iob_detach(FAR struct net_driver_s *dev,
+                                    FAR uint8_t *buffer, uint16_t buflen)
+{
+  FAR struct iob_s *iob = dev->d_iob;
+  FAR struct iob_s *newiob;
+  unsigned int offset;
+
+  /* The packet must be in the I/O buffer.  It is not, for example, if it
+   * was reassembled from fragments in a separate buffer.
+   */
+
+  if (iob == NULL || dev->d_buf != iob->io_data ||
+      buffer < iob->io_data ||
+      buffer + buflen > iob->io_data + IOB_BUFSIZE(iob))
+    {
+      return NULL;
+    }
+
+  newiob = netdev_iob_alloc(dev);
+  if (newiob == NULL)
+    {
+      return NULL;
+    }
+
+  /* The headers are still needed to build the response */
+
+  offset = buffer - iob->io_data;
+  memcpy(newiob->io_data, iob->io_data, offset);
+
+  dev->d_appdata = newiob->io_data + (dev->d_appdata - iob->io_data);
+#ifdef CONFIG_NET_TCPURGDATA
+  if (dev->d_urgdata != NULL)
+    {
+      dev->d_urgdata = newiob->io_data + (dev->d_urgdata - iob->io_data);
+    }
+#endif
+
+  dev->d_buf     = newiob->io_data;
+  dev->d_iob     = newiob;
+
+  /* Leave only the requested data in the detached I/O buffer */
+
+  iob->io_offset = offset;
+  iob->io_len    = buflen;
+  iob->io_pktlen = buflen;
+  return iob;
+}
+
+#endif /* CONFIG_NETDEV_IOB_RECEIVE */
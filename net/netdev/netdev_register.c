@@ -343,6 +343,10 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
       dev->d_conncb = NULL;
       dev->d_devcb = NULL;
 
+      /* Initialize the lock that serializes the driver work */
+
+      net_rmutex_initialize(&dev->d_lock);
+
       /* We need exclusive access for the following operations */
 
       net_lock();
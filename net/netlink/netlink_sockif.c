@@ -49,6 +49,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/wqueue.h>
@@ -605,7 +606,7 @@ static int netlink_poll(FAR struct socket *psock, FAR struct pollfd *fds,
       if (revents != 0)
         {
           fds->revents = revents;
-          nxsem_post(fds->sem);
+          poll_notify(fds);
           net_unlock();
           return OK;
         }
@@ -664,7 +665,7 @@ static int netlink_poll(FAR struct socket *psock, FAR struct pollfd *fds,
                   conn->pollsem   = NULL;
                   conn->pollevent = NULL;
                   fds->revents    = POLLIN;
-                  nxsem_post(fds->sem);
+                  poll_notify(fds);
                 }
               else
                 {
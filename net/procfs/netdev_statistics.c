@@ -496,8 +496,14 @@ static int netprocfs_txstatistics_header(FAR struct netprocfs_file_s *netfile)
 {
   DEBUGASSERT(netfile != NULL);
 
+#ifdef CONFIG_NETDEV_POLL_BATCH
+  return snprintf(netfile->line, NET_LINELEN,
+                  "\tTX: %-8s %-8s %-8s %-8s %-8s\n",
+                  "Queued", "Sent", "Errors", "Timeouts", "Batches");
+#else
   return snprintf(netfile->line, NET_LINELEN, "\tTX: %-8s %-8s %-8s %-8s\n",
                  "Queued", "Sent", "Errors", "Timeouts");
+#endif
 }
 #endif /* CONFIG_NETDEV_STATISTICS */
 
@@ -515,11 +521,21 @@ static int netprocfs_txstatistics(FAR struct netprocfs_file_s *netfile)
   dev = netfile->dev;
   stats = &dev->d_statistics;
 
+#ifdef CONFIG_NETDEV_POLL_BATCH
+  return snprintf(netfile->line, NET_LINELEN,
+                  "\t    %08lx %08lx %08lx %08lx %08lx\n",
+                  (unsigned long)stats->tx_packets,
+                  (unsigned long)stats->tx_done,
+                  (unsigned long)stats->tx_errors,
+                  (unsigned long)stats->tx_timeouts,
+                  (unsigned long)stats->tx_batches);
+#else
   return snprintf(netfile->line, NET_LINELEN, "\t    %08lx %08lx %08lx %08lx\n",
                   (unsigned long)stats->tx_packets,
                   (unsigned long)stats->tx_done,
                   (unsigned long)stats->tx_errors,
                   (unsigned long)stats->tx_timeouts);
+#endif
 }
 #endif /* CONFIG_NETDEV_STATISTICS */
 
@@ -47,6 +47,7 @@
 #include <debug.h>
 #include <assert.h>
 
+#include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 
 #include "socket/socket.h"
@@ -93,6 +94,13 @@ int psock_close(FAR struct socket *psock)
    * waiting in accept.
    */
 
+  if (psock->s_crefs <= 1)
+    {
+      /* Remove the socket from any epoll interest list */
+
+      epoll_detach(psock);
+    }
+
   if (psock->s_crefs <= 1 && psock->s_conn != NULL)
     {
       /* Let the address family's close() method handle the operation */
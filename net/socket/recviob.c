@@ -0,0 +1,134 @@
+/****************************************************************************
+ * net/socket/recviob.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+#include "tcp/tcp.h"
+#include "usrsock/usrsock.h"
+
+#if defined(NET_TCP_HAVE_STACK) && defined(CONFIG_NET_TCP_READAHEAD)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_recviob
+ *
+ * Description:
+ *   Lend the oldest buffered data of a TCP socket to the caller without
+ *   copying it.  The I/O buffer chain at the head of the read-ahead queue
+ *   of the socket is removed from the queue and returned.  The caller owns
+ *   the chain and must free it with iob_free_chain() when done with it.
+ *
+ *   This never waits for data.  Use poll() to wait until data is
+ *   available.
+ *
+ * Input Parameters:
+ *   psock - A pointer to a NuttX-specific, internal socket structure
+ *   iob   - The location to return the I/O buffer chain
+ *
+ * Returned Value:
+ *   The number of bytes in the returned I/O buffer chain on success.  Zero
+ *   is returned if no data is buffered and the peer has performed an
+ *   orderly shutdown.  Otherwise a negated errno value is returned:
+ *
+ *   EAGAIN     - No data is buffered
+ *   EBADF      - psock is not a valid socket
+ *   EOPNOTSUPP - The socket is not a TCP socket
+ *
+ ****************************************************************************/
+
+ssize_t psock_recviob(FAR struct socket *psock, FAR struct iob_s **iob)
+{
+  FAR struct tcp_conn_s *conn;
+  FAR struct iob_s *chain;
+
+  DEBUGASSERT(iob != NULL);
+
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      nerr("ERROR: Invalid socket\n");
+      return -EBADF;
+    }
+
+#ifdef CONFIG_NET_USRSOCK
+  if (psock->s_sockif == &g_usrsock_sockif)
+    {
+      return -EOPNOTSUPP;
+    }
+#endif
+
+  if ((psock->s_domain != PF_INET && psock->s_domain != PF_INET6) ||
+      psock->s_type != SOCK_STREAM)
+    {
+      return -EOPNOTSUPP;
+    }
+
+  conn = (FAR struct tcp_conn_s *)psock->s_conn;
+  DEBUGASSERT(conn != NULL);
+
+  tcp_conn_lock(conn);
+  chain = iob_remove_queue(&conn->readahead);
+  tcp_conn_unlock(conn);
+
+  if (chain != NULL)
+    {
+      *iob = chain;
+      return chain->io_pktlen;
+    }
+
+  /* No buffered data.  Report end-of-file if the peer has closed the
+   * connection.
+   */
+
+  return _SS_ISCLOSED(psock->s_flags) ? 0 : -EAGAIN;
+}
+
+#endif /* NET_TCP_HAVE_STACK && CONFIG_NET_TCP_READAHEAD */
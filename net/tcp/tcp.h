@@ -48,6 +48,7 @@
 #include <nuttx/clock.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/net/net.h>
 
 #ifdef CONFIG_TCP_NOTIFIER
 #  include <nuttx/wqueue.h>
@@ -78,6 +79,13 @@
 #define tcp_callback_free(conn,cb) \
   devif_conn_callback_free((conn)->dev, (cb), &(conn)->list)
 
+/* Take and release the lock of one TCP connection.  See struct tcp_conn_s. */
+
+#ifdef CONFIG_NET_TCP_READAHEAD
+#  define tcp_conn_lock(conn)   net_rmutex_lock(&(conn)->lock)
+#  define tcp_conn_unlock(conn) net_rmutex_unlock(&(conn)->lock)
+#endif
+
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
 /* TCP write buffer access macros */
 
@@ -202,9 +210,15 @@ struct tcp_conn_s
    *
    *   readahead - A singly linked list of type struct iob_qentry_s
    *               where the TCP/IP read-ahead data is retained.
+   *   lock      - Protects readahead.  The network adds data with the
+   *               network locked; recvfrom() and psock_recviob() take it
+   *               with only this lock held, so that buffered data is
+   *               received without the network lock.  Nothing may wait
+   *               and no other lock may be taken while this lock is held.
    */
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
+  struct net_rmutex_s lock;       /* Protects readahead */
 #endif
 
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
@@ -274,6 +288,18 @@ struct tcp_conn_s
 
   FAR void *accept_private;
   int (*accept)(FAR struct tcp_conn_s *listener, FAR struct tcp_conn_s *conn);
+
+  /* Connection hash table support (see tcp_conn.c):
+   *
+   *   hnext - The next active connection in the same chain of the hash
+   *           table indexed by ports and remote address.
+   *   pnext - The next connection in the same chain of the hash table
+   *           indexed by local port.  A connection is in that table while
+   *           it has a local port assigned.
+   */
+
+  FAR struct tcp_conn_s *hnext;
+  FAR struct tcp_conn_s *pnext;
 };
 
 /* This structure supports TCP write buffering */
@@ -1081,6 +1107,7 @@ uint16_t tcp_callback(FAR struct net_driver_s *dev,
  *   receive the data.
  *
  * Input Parameters:
+ *   dev - The device driver structure that received the data
  *   conn - A pointer to the TCP connection structure
  *   buffer - A pointer to the buffer to be copied to the read-ahead
  *     buffers
@@ -1098,7 +1125,8 @@ uint16_t tcp_callback(FAR struct net_driver_s *dev,
  ****************************************************************************/
 
 #ifdef CONFIG_NET_TCP_READAHEAD
-uint16_t tcp_datahandler(FAR struct tcp_conn_s *conn, FAR uint8_t *buffer,
+uint16_t tcp_datahandler(FAR struct net_driver_s *dev,
+                         FAR struct tcp_conn_s *conn, FAR uint8_t *buffer,
                          uint16_t nbytes);
 #endif
 
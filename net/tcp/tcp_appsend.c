@@ -180,6 +180,9 @@ void tcp_appsend(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
        */
 
       dev->d_sndlen = 0;
+#ifdef CONFIG_NETDEV_TSO
+      dev->d_sgiob  = NULL;
+#endif
       conn->tcpstateflags = TCP_CLOSED;
       ninfo("TCP state: NETDEV_DOWN\n");
     }
@@ -189,6 +192,9 @@ void tcp_appsend(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
   else if ((result & TCP_ABORT) != 0)
     {
       dev->d_sndlen = 0;
+#ifdef CONFIG_NETDEV_TSO
+      dev->d_sgiob  = NULL;
+#endif
       conn->tcpstateflags = TCP_CLOSED;
       ninfo("TCP state: TCP_CLOSED\n");
 
@@ -208,6 +214,9 @@ void tcp_appsend(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
       ninfo("TCP state: TCP_FIN_WAIT_1\n");
 
       dev->d_sndlen       = 0;
+#ifdef CONFIG_NETDEV_TSO
+      dev->d_sgiob        = NULL;
+#endif
       tcp_send(dev, conn, TCP_FIN | TCP_ACK, hdrlen);
     }
 
@@ -215,7 +224,11 @@ void tcp_appsend(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
   else
     {
-#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+#if defined(CONFIG_NETDEV_TSO)
+      /* With segmentation offload, the driver splits larger payloads */
+
+      DEBUGASSERT(dev->d_sndlen <= conn->mss || dev->d_sgiob != NULL);
+#elif defined(CONFIG_NET_TCP_WRITE_BUFFERS)
       DEBUGASSERT(dev->d_sndlen <= conn->mss);
 #else
       /* If d_sndlen > 0, the application has data to be sent. */
@@ -298,6 +311,15 @@ void tcp_rexmit(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
     }
 #endif /* CONFIG_NET_IPv6 */
 
+#ifdef CONFIG_NETDEV_TSO
+  /* Forget any I/O buffer chain payload if no payload is sent */
+
+  if (dev->d_sndlen == 0)
+    {
+      dev->d_sgiob = NULL;
+    }
+#endif
+
   /* If the application has data to be sent, or if the incoming packet had
    * new data in it, we must send out a packet.
    */
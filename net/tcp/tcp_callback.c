@@ -102,7 +102,7 @@ tcp_data_event(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
        * partial packets will not be buffered.
        */
 
-      recvlen = tcp_datahandler(conn, buffer, buflen);
+      recvlen = tcp_datahandler(dev, conn, buffer, buflen);
       if (recvlen < buflen)
 #endif
         {
@@ -225,6 +225,7 @@ uint16_t tcp_callback(FAR struct net_driver_s *dev,
  *   receive the data.
  *
  * Input Parameters:
+ *   dev - The device driver structure that received the data
  *   conn - A pointer to the TCP connection structure
  *   buffer - A pointer to the buffer to be copied to the read-ahead
  *     buffers
@@ -242,44 +243,59 @@ uint16_t tcp_callback(FAR struct net_driver_s *dev,
  ****************************************************************************/
 
 #ifdef CONFIG_NET_TCP_READAHEAD
-uint16_t tcp_datahandler(FAR struct tcp_conn_s *conn, FAR uint8_t *buffer,
+uint16_t tcp_datahandler(FAR struct net_driver_s *dev,
+                         FAR struct tcp_conn_s *conn, FAR uint8_t *buffer,
                          uint16_t buflen)
 {
   FAR struct iob_s *iob;
   int ret;
 
-  /* Try to allocate on I/O buffer to start the chain without waiting (and
-   * throttling as necessary).  If we would have to wait, then drop the
-   * packet.
+#ifdef CONFIG_NETDEV_IOB_RECEIVE
+  /* If the driver received the packet into an I/O buffer, then just take
+   * that I/O buffer instead of copying the data.
    */
 
-  iob = iob_tryalloc(true, IOBUSER_NET_TCP_READAHEAD);
+  iob = netdev_iob_detach(dev, buffer, buflen);
   if (iob == NULL)
+#endif
     {
-      nerr("ERROR: Failed to create new I/O buffer chain\n");
-      return 0;
-    }
+      /* Try to allocate on I/O buffer to start the chain without waiting
+       * (and throttling as necessary).  If we would have to wait, then
+       * drop the packet.
+       */
 
-  /* Copy the new appdata into the I/O buffer chain (without waiting) */
+      iob = iob_tryalloc_size(buflen, true, IOBUSER_NET_TCP_READAHEAD);
+      if (iob == NULL)
+        {
+          nerr("ERROR: Failed to create new I/O buffer chain\n");
+          return 0;
+        }
 
-  ret = iob_trycopyin(iob, buffer, buflen, 0, true,
-                      IOBUSER_NET_TCP_READAHEAD);
-  if (ret < 0)
-    {
-      /* On a failure, iob_copyin return a negated error value but does
-       * not free any I/O buffers.
-       */
+      /* Copy the new appdata into the I/O buffer chain (without waiting) */
 
-      nerr("ERROR: Failed to add data to the I/O buffer chain: %d\n", ret);
-      (void)iob_free_chain(iob, IOBUSER_NET_TCP_READAHEAD);
-      return 0;
+      ret = iob_trycopyin(iob, buffer, buflen, 0, true,
+                          IOBUSER_NET_TCP_READAHEAD);
+      if (ret < 0)
+        {
+          /* On a failure, iob_copyin return a negated error value but does
+           * not free any I/O buffers.
+           */
+
+          nerr("ERROR: Failed to add data to the I/O buffer chain: %d\n",
+               ret);
+          (void)iob_free_chain(iob, IOBUSER_NET_TCP_READAHEAD);
+          return 0;
+        }
     }
 
   /* Add the new I/O buffer chain to the tail of the read-ahead queue (again
    * without waiting).
    */
 
+  tcp_conn_lock(conn);
   ret = iob_tryadd_queue(iob, &conn->readahead);
+  tcp_conn_unlock(conn);
+
   if (ret < 0)
     {
       nerr("ERROR: Failed to queue the I/O buffer chain: %d\n", ret);
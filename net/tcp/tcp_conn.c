@@ -72,6 +72,11 @@
 #define IPv4BUF ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+/* Index into the local port hash table (port in network byte order) */
+
+#define TCP_PORTHASH(p) \
+  ((unsigned int)((p) ^ ((p) >> 8)) % CONFIG_NET_TCP_HASHSIZE)
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -88,6 +93,22 @@ static dq_queue_t g_free_tcp_connections;
 
 static dq_queue_t g_active_tcp_connections;
 
+/* Hash tables used to find connections in expected constant time:
+ *
+ *   g_tcp_connhash - All connections in g_active_tcp_connections, indexed
+ *                    by local port, remote port and remote address and
+ *                    chained through hnext.
+ *   g_tcp_porthash - All connections with a local port assigned, indexed
+ *                    by local port and chained through pnext.
+ *
+ * Connections are added at the tail of each chain so that lookups find
+ * the oldest matching connection first, just as a search of the lists
+ * would.
+ */
+
+static FAR struct tcp_conn_s *g_tcp_connhash[CONFIG_NET_TCP_HASHSIZE];
+static FAR struct tcp_conn_s *g_tcp_porthash[CONFIG_NET_TCP_HASHSIZE];
+
 /* Last port used by a TCP connection connection. */
 
 static uint16_t g_last_tcp_port;
@@ -96,6 +117,162 @@ static uint16_t g_last_tcp_port;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_hash
+ *
+ * Description:
+ *   Return the index into g_tcp_connhash[] for the given local port,
+ *   remote port and (folded) remote address.
+ *
+ ****************************************************************************/
+
+static unsigned int tcp_hash(uint16_t lport, uint16_t rport, uint32_t raddr)
+{
+  uint32_t hash = raddr ^ ((uint32_t)lport << 16 | rport);
+
+  /* Mix the bits so that all of them affect the table index */
+
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3b;
+  hash ^= hash >> 16;
+
+  return hash % CONFIG_NET_TCP_HASHSIZE;
+}
+
+/****************************************************************************
+ * Name: tcp_ipv6_fold
+ *
+ * Description:
+ *   Fold a 128-bit IPv6 address into 32-bits for tcp_hash().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+static inline uint32_t tcp_ipv6_fold(FAR const uint16_t *addr)
+{
+  return ((uint32_t)addr[0] << 16 | addr[1]) ^
+         ((uint32_t)addr[2] << 16 | addr[3]) ^
+         ((uint32_t)addr[4] << 16 | addr[5]) ^
+         ((uint32_t)addr[6] << 16 | addr[7]);
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_connhash_ndx
+ *
+ * Description:
+ *   Return the index into g_tcp_connhash[] for a connection.
+ *
+ ****************************************************************************/
+
+static unsigned int tcp_connhash_ndx(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return tcp_hash(conn->lport, conn->rport, conn->u.ipv4.raddr);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return tcp_hash(conn->lport, conn->rport,
+                      tcp_ipv6_fold(conn->u.ipv6.raddr));
+    }
+#endif /* CONFIG_NET_IPv6 */
+}
+
+/****************************************************************************
+ * Name: tcp_connhash_add and tcp_connhash_remove
+ *
+ * Description:
+ *   Add or remove a connection from g_tcp_connhash[].  These are called
+ *   whenever a connection is added to or removed from the list of active
+ *   connections.  The ports and remote address must not change in between.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+static void tcp_connhash_add(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s **link = &g_tcp_connhash[tcp_connhash_ndx(conn)];
+
+  while (*link != NULL)
+    {
+      link = &(*link)->hnext;
+    }
+
+  conn->hnext = NULL;
+  *link       = conn;
+}
+
+static void tcp_connhash_remove(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s **link = &g_tcp_connhash[tcp_connhash_ndx(conn)];
+
+  while (*link != NULL)
+    {
+      if (*link == conn)
+        {
+          *link       = conn->hnext;
+          conn->hnext = NULL;
+          break;
+        }
+
+      link = &(*link)->hnext;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_porthash_add and tcp_porthash_remove
+ *
+ * Description:
+ *   Add or remove a connection from g_tcp_porthash[].  A connection is in
+ *   this table from the time that a local port is assigned until it is
+ *   freed or the local port is cleared.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+static void tcp_porthash_add(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s **link = &g_tcp_porthash[TCP_PORTHASH(conn->lport)];
+
+  while (*link != NULL)
+    {
+      link = &(*link)->pnext;
+    }
+
+  conn->pnext = NULL;
+  *link       = conn;
+}
+
+static void tcp_porthash_remove(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s **link = &g_tcp_porthash[TCP_PORTHASH(conn->lport)];
+
+  while (*link != NULL)
+    {
+      if (*link == conn)
+        {
+          *link       = conn->pnext;
+          conn->pnext = NULL;
+          break;
+        }
+
+      link = &(*link)->pnext;
+    }
+}
+
 /****************************************************************************
  * Name: tcp_ipv4_listener
  *
@@ -113,14 +290,16 @@ static inline FAR struct tcp_conn_s *tcp_ipv4_listener(in_addr_t ipaddr,
                                                        uint16_t portno)
 {
   FAR struct tcp_conn_s *conn;
-  int i;
 
-  /* Check if this port number is in use by any active UIP TCP connection */
+  /* Check if this port number is in use by any active UIP TCP connection.
+   * Only connections with a local port assigned can match and those are
+   * all in the port hash table.
+   */
 
-  for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
+  for (conn = g_tcp_porthash[TCP_PORTHASH(portno)];
+       conn != NULL;
+       conn = conn->pnext)
     {
-      conn = &g_tcp_connections[i];
-
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
        */
@@ -164,14 +343,16 @@ static inline FAR struct tcp_conn_s *
 tcp_ipv6_listener(const net_ipv6addr_t ipaddr, uint16_t portno)
 {
   FAR struct tcp_conn_s *conn;
-  int i;
 
-  /* Check if this port number is in use by any active UIP TCP connection */
+  /* Check if this port number is in use by any active UIP TCP connection.
+   * Only connections with a local port assigned can match and those are
+   * all in the port hash table.
+   */
 
-  for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
+  for (conn = g_tcp_porthash[TCP_PORTHASH(portno)];
+       conn != NULL;
+       conn = conn->pnext)
     {
-      conn = &g_tcp_connections[i];
-
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
        */
@@ -327,10 +508,13 @@ static inline FAR struct tcp_conn_s *
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
 
+  /* Only the connections in the matching hash chain need to be examined */
+
+  conn = g_tcp_connhash[tcp_hash(tcp->destport, tcp->srcport, srcipaddr)];
+
   while (conn)
     {
       /* Find an open connection matching the TCP input. The following
@@ -364,9 +548,9 @@ static inline FAR struct tcp_conn_s *
           break;
         }
 
-      /* Look at the next active connection */
+      /* Look at the next connection in the hash chain */
 
-      conn = (FAR struct tcp_conn_s *)conn->node.flink;
+      conn = conn->hnext;
     }
 
   return conn;
@@ -394,10 +578,14 @@ static inline FAR struct tcp_conn_s *
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
 
+  /* Only the connections in the matching hash chain need to be examined */
+
+  conn = g_tcp_connhash[tcp_hash(tcp->destport, tcp->srcport,
+                                 tcp_ipv6_fold(ip->srcipaddr))];
+
   while (conn)
     {
       /* Find an open connection matching the TCP input. The following
@@ -431,9 +619,9 @@ static inline FAR struct tcp_conn_s *
           break;
         }
 
-      /* Look at the next active connection */
+      /* Look at the next connection in the hash chain */
 
-      conn = (FAR struct tcp_conn_s *)conn->node.flink;
+      conn = conn->hnext;
     }
 
   return conn;
@@ -474,12 +662,19 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
   if (port < 0)
     {
       nerr("ERROR: tcp_selectport failed: %d\n", port);
+      net_unlock();
       return port;
     }
 
   /* Save the local address in the connection structure (network byte order). */
 
+  if (conn->lport != 0)
+    {
+      tcp_porthash_remove(conn);
+    }
+
   conn->lport = htons(port);
+  tcp_porthash_add(conn);
   net_ipv4addr_copy(conn->u.ipv4.laddr, addr->sin_addr.s_addr);
 
   /* Find the device that can receive packets on the network associated with
@@ -495,8 +690,10 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
 
       /* Back out the local address setting */
 
+      tcp_porthash_remove(conn);
       conn->lport = 0;
       net_ipv4addr_copy(conn->u.ipv4.laddr, INADDR_ANY);
+      net_unlock();
       return ret;
     }
 
@@ -541,12 +738,19 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
   if (port < 0)
     {
       nerr("ERROR: tcp_selectport failed: %d\n", port);
+      net_unlock();
       return port;
     }
 
   /* Save the local address in the connection structure (network byte order). */
 
+  if (conn->lport != 0)
+    {
+      tcp_porthash_remove(conn);
+    }
+
   conn->lport = htons(port);
+  tcp_porthash_add(conn);
   net_ipv6addr_copy(conn->u.ipv6.laddr, addr->sin6_addr.in6_u.u6_addr16);
 
   /* Find the device that can receive packets on the network
@@ -562,8 +766,10 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
       /* Back out the local address setting */
 
+      tcp_porthash_remove(conn);
       conn->lport = 0;
       net_ipv6addr_copy(conn->u.ipv6.laddr, g_ipv6_unspecaddr);
+      net_unlock();
       return ret;
     }
 
@@ -594,6 +800,12 @@ void tcp_initialize(void)
   dq_init(&g_free_tcp_connections);
   dq_init(&g_active_tcp_connections);
 
+  for (i = 0; i < CONFIG_NET_TCP_HASHSIZE; i++)
+    {
+      g_tcp_connhash[i] = NULL;
+      g_tcp_porthash[i] = NULL;
+    }
+
   /* Now initialize each connection structure */
 
   for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
@@ -714,6 +926,9 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
   if (conn)
     {
       memset(conn, 0, sizeof(struct tcp_conn_s));
+#ifdef CONFIG_NET_TCP_READAHEAD
+      net_rmutex_initialize(&conn->lock);
+#endif
       conn->tcpstateflags = TCP_ALLOCATED;
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
       conn->domain        = domain;
@@ -773,12 +988,24 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       /* Remove the connection from the active list */
 
       dq_rem(&conn->node, &g_active_tcp_connections);
+      tcp_connhash_remove(conn);
+    }
+
+  /* Release the local port */
+
+  if (conn->lport != 0)
+    {
+      tcp_porthash_remove(conn);
     }
 
 #ifdef CONFIG_NET_TCP_READAHEAD
-  /* Release any read-ahead buffers attached to the connection */
+  /* Release any read-ahead buffers attached to the connection.  Taking
+   * the connection lock waits for a reader that is still copying from them.
+   */
 
+  tcp_conn_lock(conn);
   iob_free_queue(&conn->readahead, IOBUSER_NET_TCP_READAHEAD);
+  tcp_conn_unlock(conn);
 #endif
 
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
@@ -1033,11 +1260,14 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
       sq_init(&conn->unacked_q);
 #endif
 
-      /* And, finally, put the connection structure into the active list.
-       * Interrupts should already be disabled in this context.
+      /* And, finally, put the connection structure into the active list
+       * and the hash tables.  Interrupts should already be disabled in this
+       * context.
        */
 
       dq_addlast(&conn->node, &g_active_tcp_connections);
+      tcp_connhash_add(conn);
+      tcp_porthash_add(conn);
     }
 
   return conn;
@@ -1249,7 +1479,14 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   conn->rto        = TCP_RTO;
   conn->sa         = 0;
   conn->sv         = 16;   /* Initial value of the RTT variance. */
+
+  if (conn->lport != 0)
+    {
+      tcp_porthash_remove(conn);
+    }
+
   conn->lport      = htons((uint16_t)port);
+  tcp_porthash_add(conn);
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   conn->expired    = 0;
   conn->isn        = 0;
@@ -1270,9 +1507,12 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   sq_init(&conn->unacked_q);
 #endif
 
-  /* And, finally, put the connection structure into the active list. */
+  /* And, finally, put the connection structure into the active list and
+   * the hash tables.
+   */
 
   dq_addlast(&conn->node, &g_active_tcp_connections);
+  tcp_connhash_add(conn);
   ret = OK;
 
 errout_with_lock:
@@ -54,11 +54,25 @@
 #include "devif/devif.h"
 #include "tcp/tcp.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The slot in tcp_listenports[] where the search for a port starts */
+
+#define TCP_LISTENHASH(p) \
+  ((unsigned int)((p) ^ ((p) >> 8)) % CONFIG_NET_MAX_LISTENPORTS)
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-/* The tcp_listenports list all currently listening ports. */
+/* The tcp_listenports list all currently listening ports.  This is an open
+ * addressed hash table indexed by local port:  A listener is kept in the
+ * first free slot at or after TCP_LISTENHASH(lport), wrapping around, and
+ * no empty slot is left between that slot and the listener.  A search may
+ * then stop at the first empty slot.
+ */
 
 static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
 
@@ -83,27 +97,35 @@ FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno, uint8_t domain)
 FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno)
 #endif
 {
-  int ndx;
+  unsigned int ndx = TCP_LISTENHASH(portno);
+  int i;
 
-  /* Examine each connection structure in each slot of the listener list */
+  /* Examine the slots starting at the hashed slot for this port */
 
-  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+  for (i = 0; i < CONFIG_NET_MAX_LISTENPORTS; i++)
     {
-      /* Is this slot assigned?  If so, does the connection have the same
-       * local port number?
+      /* Is this slot assigned?  If not, there is no listener on this port.
+       * If so, does the connection have the same local port number?
        */
 
       FAR struct tcp_conn_s *conn = tcp_listenports[ndx];
+      if (conn == NULL)
+        {
+          break;
+        }
+
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-      if (conn && conn->lport == portno && conn->domain == domain)
+      if (conn->lport == portno && conn->domain == domain)
 #else
-      if (conn && conn->lport == portno)
+      if (conn->lport == portno)
 #endif
         {
           /* Yes.. we found a listener on this port */
 
           return conn;
         }
+
+      ndx = (ndx + 1) % CONFIG_NET_MAX_LISTENPORTS;
     }
 
   /* No listener for this port */
@@ -149,18 +171,60 @@ void tcp_listen_initialize(void)
 
 int tcp_unlisten(FAR struct tcp_conn_s *conn)
 {
-  int ndx;
+  FAR struct tcp_conn_s *next;
+  unsigned int ndx = TCP_LISTENHASH(conn->lport);
+  unsigned int hole;
+  unsigned int home;
   int ret = -EINVAL;
+  int i;
 
   net_lock();
-  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+
+  /* Find the slot holding the connection */
+
+  for (i = 0; i < CONFIG_NET_MAX_LISTENPORTS; i++)
     {
-      if (tcp_listenports[ndx] == conn)
+      if (tcp_listenports[ndx] == NULL || tcp_listenports[ndx] == conn)
         {
-          tcp_listenports[ndx] = NULL;
-          ret = OK;
           break;
         }
+
+      ndx = (ndx + 1) % CONFIG_NET_MAX_LISTENPORTS;
+    }
+
+  if (i < CONFIG_NET_MAX_LISTENPORTS && tcp_listenports[ndx] == conn)
+    {
+      /* Free the slot.  Then move back any following listener that would
+       * no longer be found because of the new empty slot.
+       */
+
+      tcp_listenports[ndx] = NULL;
+      hole = ndx;
+
+      for (i = 1; i < CONFIG_NET_MAX_LISTENPORTS; i++)
+        {
+          ndx  = (ndx + 1) % CONFIG_NET_MAX_LISTENPORTS;
+          next = tcp_listenports[ndx];
+          if (next == NULL)
+            {
+              break;
+            }
+
+          /* The listener may move into the hole only if the hole does not
+           * lie before its home slot on the (circular) search path.
+           */
+
+          home = TCP_LISTENHASH(next->lport);
+          if ((ndx > hole && (home <= hole || home > ndx)) ||
+              (ndx < hole && (home <= hole && home > ndx)))
+            {
+              tcp_listenports[hole] = next;
+              tcp_listenports[ndx]  = NULL;
+              hole                  = ndx;
+            }
+        }
+
+      ret = OK;
     }
 
   net_unlock();
@@ -180,8 +244,9 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
 
 int tcp_listen(FAR struct tcp_conn_s *conn)
 {
-  int ndx;
+  unsigned int ndx;
   int ret;
+  int i;
 
   /* This must be done with network locked because the listener table
    * is accessed from event processing logic as well.
@@ -209,9 +274,12 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 
       ret = -ENOBUFS; /* Assume failure */
 
-      /* Search all slots until an available slot is found */
+      /* Search the slots, starting at the hashed slot for this port, until
+       * an available slot is found.
+       */
 
-      for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+      ndx = TCP_LISTENHASH(conn->lport);
+      for (i = 0; i < CONFIG_NET_MAX_LISTENPORTS; i++)
         {
           /* Is the next slot available? */
 
@@ -223,6 +291,8 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
               ret = OK;
               break;
             }
+
+          ndx = (ndx + 1) % CONFIG_NET_MAX_LISTENPORTS;
         }
     }
 
@@ -44,6 +44,7 @@
 #include <poll.h>
 #include <debug.h>
 
+#include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/mm/iob.h>
@@ -68,6 +69,7 @@ struct tcp_poll_s
   FAR struct socket *psock;        /* Needed to handle loss of connection */
   struct pollfd *fds;              /* Needed to handle poll events */
   FAR struct devif_callback_s *cb; /* Needed to teardown the poll */
+  bool writable;                   /* POLLOUT reported and still in effect */
 #if defined(CONFIG_NET_TCP_WRITE_BUFFERS) && defined(CONFIG_IOB_NOTIFIER)
   int16_t key;                     /* Needed to cancel pending notification */
 #endif
@@ -130,25 +132,43 @@ static uint16_t tcp_poll_eventhandler(FAR struct net_driver_s *dev,
           eventset |= (POLLERR | POLLHUP);
         }
 
-      /* A poll is a sign that we are free to send data. */
+      /* A poll is a sign that we are free to send data.  The device polls
+       * the connection continually, so POLLOUT is only reported when the
+       * socket becomes writable.  An edge-triggered epoll registration
+       * would otherwise see a new event on every poll.
+       */
 
-      else if ((flags & TCP_POLL) != 0 && psock_tcp_cansend(info->psock) >= 0)
+      else if ((flags & TCP_POLL) != 0)
         {
-          eventset |= (POLLOUT & info->fds->events);
+          if (psock_tcp_cansend(info->psock) < 0)
+            {
+              info->writable = false;
+            }
+          else if (!info->writable)
+            {
+              info->writable = true;
+              eventset |= (POLLOUT & info->fds->events);
+            }
         }
 
       /* Awaken the caller of poll() if requested event occurred. */
 
       if (eventset != 0)
         {
-          /* Stop further callbacks */
+          /* Stop further callbacks once the connection is lost.  Otherwise
+           * keep reporting events until the poll is torn down:  An epoll
+           * registration stays in place across many events.
+           */
 
-          info->cb->flags   = 0;
-          info->cb->priv    = NULL;
-          info->cb->event   = NULL;
+          if ((eventset & POLLHUP) != 0)
+            {
+              info->cb->flags   = 0;
+              info->cb->priv    = NULL;
+              info->cb->event   = NULL;
+            }
 
           info->fds->revents |= eventset;
-          nxsem_post(info->fds->sem);
+          poll_notify(info->fds);
         }
     }
 
@@ -204,7 +224,7 @@ static inline void tcp_iob_work(FAR void *arg)
            */
 
           fds->revents |= (POLLERR | POLLHUP);
-          nxsem_post(fds->sem);
+          poll_notify(fds);
         }
     }
 
@@ -221,8 +241,9 @@ static inline void tcp_iob_work(FAR void *arg)
         {
           /* Yes.. then signal the poll logic */
 
+          pinfo->writable = true;
           fds->revents |= POLLWRNORM;
-          nxsem_post(fds->sem);
+          poll_notify(fds);
         }
       else
         {
@@ -299,11 +320,12 @@ int tcp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
 
   /* Initialize the poll info container */
 
-  info->psock  = psock;
-  info->fds    = fds;
-  info->cb     = cb;
+  info->psock    = psock;
+  info->fds      = fds;
+  info->cb       = cb;
+  info->writable = false;
 #if defined(CONFIG_NET_TCP_WRITE_BUFFERS) && defined(CONFIG_IOB_NOTIFIER)
-  info->key    = 0;
+  info->key      = 0;
 #endif
 
   /* Initialize the callback structure.  Save the reference to the info
@@ -397,6 +419,7 @@ int tcp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
     }
   else if (_SS_ISCONNECTED(psock->s_flags) && psock_tcp_cansend(psock) >= 0)
     {
+      info->writable = true;
       fds->revents |= (POLLWRNORM & fds->events);
     }
 
@@ -406,7 +429,7 @@ int tcp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
     {
       /* Yes.. then signal the poll logic */
 
-      nxsem_post(fds->sem);
+      poll_notify(fds);
     }
 
 #if defined(CONFIG_NET_TCP_WRITE_BUFFERS) && defined(CONFIG_IOB_NOTIFIER)
@@ -153,7 +153,17 @@ static inline void tcp_ipv4_sendcomplete(FAR struct net_driver_s *dev,
   tcp->urgp[1]      = 0;
 
   tcp->tcpchksum    = 0;
-  tcp->tcpchksum    = ~tcp_ipv4_chksum(dev);
+
+#ifdef CONFIG_NETDEV_TSO
+  /* The payload is not in d_buf.  The driver computes the checksum of each
+   * segment that it sends.
+   */
+
+  if (dev->d_sgiob == NULL)
+#endif
+    {
+      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+    }
 
   /* Finish initializing the IP header and calculate the IP checksum */
 
@@ -225,7 +235,17 @@ static inline void tcp_ipv6_sendcomplete(FAR struct net_driver_s *dev,
   tcp->urgp[1]     = 0;
 
   tcp->tcpchksum   = 0;
-  tcp->tcpchksum   = ~tcp_ipv6_chksum(dev);
+
+#ifdef CONFIG_NETDEV_TSO
+  /* The payload is not in d_buf.  The driver computes the checksum of each
+   * segment that it sends.
+   */
+
+  if (dev->d_sgiob == NULL)
+#endif
+    {
+      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+    }
 
   /* Finish initializing the IP header (no IPv6 checksum) */
 
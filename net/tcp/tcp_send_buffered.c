@@ -291,6 +291,81 @@ static inline void send_ipselect(FAR struct net_driver_s *dev,
 }
 #endif
 
+/****************************************************************************
+ * Name: send_sgmax
+ *
+ * Description:
+ *   Return the largest payload that may be passed to the device in an I/O
+ *   buffer chain, or zero if the payload must be copied into d_buf.
+ *
+ * Input Parameters:
+ *   dev  - The structure of the network driver that caused the event
+ *   conn - The connection structure associated with the socket
+ *
+ * Returned Value:
+ *   The maximum payload size in bytes.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_TSO
+static uint16_t send_sgmax(FAR struct net_driver_s *dev,
+                           FAR struct tcp_conn_s *conn)
+{
+  unsigned int maxlen;
+
+  if ((dev->d_txcaps & (NETDEV_TXCAP_SG | NETDEV_TXCAP_TSO)) == 0)
+    {
+      return 0;
+    }
+
+  /* Packets to ourself are looped back through the input path, which
+   * needs the payload in d_buf.
+   */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      if (net_ipv4addr_cmp(conn->u.ipv4.raddr, dev->d_ipaddr))
+        {
+          return 0;
+        }
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      if (net_ipv6addr_cmp(conn->u.ipv6.raddr, dev->d_ipv6addr))
+        {
+          return 0;
+        }
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+  if ((dev->d_txcaps & NETDEV_TXCAP_TSO) == 0)
+    {
+      return conn->mss;
+    }
+
+  /* The whole frame length must still fit in d_len and the IP length */
+
+  maxlen = UINT16_MAX - NET_LL_HDRLEN(dev) - __IPv6_HDRLEN - TCP_HDRLEN;
+  if (dev->d_tsomax < maxlen)
+    {
+      maxlen = dev->d_tsomax;
+    }
+
+  return maxlen > conn->mss ? maxlen : conn->mss;
+}
+#endif
+
 /****************************************************************************
  * Name: psock_send_eventhandler
  *
@@ -694,7 +769,11 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
     {
       FAR struct tcp_wrbuffer_s *wrb;
       uint32_t predicted_seqno;
+      size_t maxlen;
       size_t sndlen;
+#ifdef CONFIG_NETDEV_TSO
+      uint16_t sgmax;
+#endif
 
       /* Peek at the head of the write queue (but don't remove anything
        * from the write queue yet).  We know from the above test that
@@ -707,13 +786,23 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       /* Get the amount of data that we can send in the next packet.
        * We will send either the remaining data in the buffer I/O
        * buffer chain, or as much as will fit given the MSS and current
-       * window size.
+       * window size.  If the device segments TCP packets itself, the MSS
+       * limit is replaced by the device limit.
        */
 
+      maxlen = conn->mss;
+#ifdef CONFIG_NETDEV_TSO
+      sgmax  = send_sgmax(dev, conn);
+      if (sgmax > maxlen)
+        {
+          maxlen = sgmax;
+        }
+#endif
+
       sndlen = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
-      if (sndlen > conn->mss)
+      if (sndlen > maxlen)
         {
-          sndlen = conn->mss;
+          sndlen = maxlen;
         }
 
       if (sndlen > conn->winsize)
@@ -759,7 +848,19 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
        * won't actually happen until the polling cycle completes).
        */
 
-      devif_iob_send(dev, TCP_WBIOB(wrb), sndlen, TCP_WBSENT(wrb));
+#ifdef CONFIG_NETDEV_TSO
+      if (sgmax > 0)
+        {
+          /* Let the device gather (and segment) the payload itself */
+
+          devif_iob_sgsend(dev, TCP_WBIOB(wrb), sndlen, TCP_WBSENT(wrb),
+                           conn->mss);
+        }
+      else
+#endif
+        {
+          devif_iob_send(dev, TCP_WBIOB(wrb), sndlen, TCP_WBSENT(wrb));
+        }
 
       /* Remember how much data we send out now so that we know
        * when everything has been acknowledged.  Just increment
@@ -1054,9 +1155,13 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
       TCP_WBNRTX(wrb)  = 0;
 
       /* Copy the user data into the write buffer.  We cannot wait for
-       * buffer space if the socket was opened non-blocking.
+       * buffer space if the socket was opened non-blocking.  The write
+       * buffer belongs to this thread until it is queued, so the data is
+       * copied with the network unlocked.
        */
 
+      net_unlock();
+
       if (_SS_ISNONBLOCK(psock->s_flags))
         {
           /* The return value from TCP_WBTRYCOPYIN is either OK or
@@ -1079,6 +1184,7 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
                 {
                   nerr("ERROR: Failed to add data to the I/O buffer chain\n");
                   ret = -EWOULDBLOCK;
+                  net_lock();
                   goto errout_with_wrb;
                 }
             }
@@ -1105,6 +1211,8 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
             }
         }
 
+      net_lock();
+
       /* Dump I/O buffer chain */
 
       TCP_WBDUMP("I/O buffer chain", wrb, TCP_WBPKTLEN(wrb), 0);
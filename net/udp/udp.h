@@ -51,6 +51,7 @@
 
 #ifdef CONFIG_NET_UDP_READAHEAD
 #  include <nuttx/mm/iob.h>
+#  include <nuttx/net/net.h>
 #endif
 
 #ifdef CONFIG_UDP_NOTIFIER
@@ -89,6 +90,13 @@
 #define udp_callback_free(dev,conn,cb) \
   devif_conn_callback_free((dev), (cb), &(conn)->list)
 
+/* Take and release the lock of one UDP connection.  See struct udp_conn_s. */
+
+#ifdef CONFIG_NET_UDP_READAHEAD
+#  define udp_conn_lock(conn)   net_rmutex_lock(&(conn)->lock)
+#  define udp_conn_unlock(conn) net_rmutex_unlock(&(conn)->lock)
+#endif
+
 /* Definitions for the UDP connection struct flag field */
 
 #define _UDP_FLAG_CONNECTMODE (1 << 0) /* Bit 0:  UDP connection-mode */
@@ -136,9 +144,15 @@ struct udp_conn_s
    *
    *   readahead - A singly linked list of type struct iob_qentry_s
    *               where the UDP/IP read-ahead data is retained.
+   *   lock      - Protects readahead.  The network adds datagrams with the
+   *               network locked; recvfrom() takes them with only this
+   *               lock held, so that buffered data is received without
+   *               the network lock.  Nothing may wait and no other lock
+   *               may be taken while this lock is held.
    */
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
+  struct net_rmutex_s lock;       /* Protects readahead */
 #endif
 
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
@@ -226,7 +226,10 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
 
   /* Add the new I/O buffer chain to the tail of the read-ahead queue */
 
+  udp_conn_lock(conn);
   ret = iob_tryadd_queue(iob, &conn->readahead);
+  udp_conn_unlock(conn);
+
   if (ret < 0)
     {
       nerr("ERROR: Failed to queue the I/O buffer chain: %d\n", ret);
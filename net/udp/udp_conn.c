@@ -553,6 +553,9 @@ void udp_initialize(void)
       /* Mark the connection closed and move it to the free list */
 
       g_udp_connections[i].lport = 0;
+#ifdef CONFIG_NET_UDP_READAHEAD
+      net_rmutex_initialize(&g_udp_connections[i].lock);
+#endif
       dq_addlast(&g_udp_connections[i].node, &g_free_udp_connections);
     }
 
@@ -633,7 +636,9 @@ void udp_free(FAR struct udp_conn_s *conn)
 #ifdef CONFIG_NET_UDP_READAHEAD
   /* Release any read-ahead buffers attached to the connection */
 
+  udp_conn_lock(conn);
   iob_free_queue(&conn->readahead, IOBUSER_NET_UDP_READAHEAD);
+  udp_conn_unlock(conn);
 #endif
 
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
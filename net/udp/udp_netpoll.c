@@ -41,9 +41,11 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <poll.h>
 #include <debug.h>
 
+#include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/mm/iob.h>
@@ -68,6 +70,7 @@ struct udp_poll_s
   FAR struct net_driver_s *dev;    /* Needed to free the callback structure */
   struct pollfd *fds;              /* Needed to handle poll events */
   FAR struct devif_callback_s *cb; /* Needed to teardown the poll */
+  bool writable;                   /* POLLOUT reported and still in effect */
 #if defined(CONFIG_NET_UDP_WRITE_BUFFERS) && defined(CONFIG_IOB_NOTIFIER)
   int16_t key;                     /* Needed to cancel pending notification */
 #endif
@@ -127,11 +130,23 @@ static uint16_t udp_poll_eventhandler(FAR struct net_driver_s *dev,
           eventset |= (POLLHUP | POLLERR);
         }
 
-      /* A poll is a sign that we are free to send data. */
+      /* A poll is a sign that we are free to send data.  As for TCP,
+       * POLLOUT is only reported when the socket becomes writable so that
+       * an edge-triggered epoll registration does not see an event on every
+       * poll.
+       */
 
-      else if ((flags & UDP_POLL) != 0 && psock_udp_cansend(info->psock) >= 0)
+      else if ((flags & UDP_POLL) != 0)
         {
-          eventset |= (POLLOUT & info->fds->events);
+          if (psock_udp_cansend(info->psock) < 0)
+            {
+              info->writable = false;
+            }
+          else if (!info->writable)
+            {
+              info->writable = true;
+              eventset |= (POLLOUT & info->fds->events);
+            }
         }
 
       /* Awaken the caller of poll() is requested event occurred. */
@@ -139,7 +154,7 @@ static uint16_t udp_poll_eventhandler(FAR struct net_driver_s *dev,
       if (eventset)
         {
           info->fds->revents |= eventset;
-          nxsem_post(info->fds->sem);
+          poll_notify(info->fds);
         }
     }
 
@@ -194,8 +209,9 @@ static inline void udp_iob_work(FAR void *arg)
         {
           /* Yes.. then signal the poll logic */
 
+          pinfo->writable = true;
           fds->revents |= POLLWRNORM;
-          nxsem_post(fds->sem);
+          poll_notify(fds);
         }
       else
         {
@@ -279,11 +295,12 @@ int udp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
 
   /* Initialize the poll info container */
 
-  info->psock  = psock;
-  info->fds    = fds;
-  info->cb     = cb;
+  info->psock    = psock;
+  info->fds      = fds;
+  info->cb       = cb;
+  info->writable = false;
 #if defined(CONFIG_NET_UDP_WRITE_BUFFERS) && defined(CONFIG_IOB_NOTIFIER)
-  info->key    = 0;
+  info->key      = 0;
 #endif
 
   /* Initialize the callback structure.  Save the reference to the info
@@ -324,6 +341,7 @@ int udp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
     {
       /* Normal data may be sent without blocking (at least one byte). */
 
+      info->writable = true;
       fds->revents |= (POLLWRNORM & fds->events);
     }
 
@@ -333,7 +351,7 @@ int udp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
     {
       /* Yes.. then signal the poll logic */
 
-      nxsem_post(fds->sem);
+      poll_notify(fds);
     }
 
 #if defined(CONFIG_NET_UDP_WRITE_BUFFERS) && defined(CONFIG_IOB_NOTIFIER)
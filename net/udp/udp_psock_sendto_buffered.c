@@ -765,9 +765,13 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
 #endif
 
       /* Copy the user data into the write buffer.  We cannot wait for
-       * buffer space if the socket was opened non-blocking.
+       * buffer space if the socket was opened non-blocking.  The write
+       * buffer belongs to this thread until it is queued, so the data is
+       * copied with the network unlocked.
        */
 
+      net_unlock();
+
       if (_SS_ISNONBLOCK(psock->s_flags))
         {
           ret = iob_trycopyin(wrb->wb_iob, (FAR uint8_t *)buf, len, 0, false,
@@ -779,6 +783,7 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
                            IOBUSER_NET_SOCK_UDP);
         }
 
+      net_lock();
       if (ret < 0)
         {
           goto errout_with_wrb;
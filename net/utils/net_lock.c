@@ -63,16 +63,14 @@
  * Private Data
  ****************************************************************************/
 
-static sem_t        g_netlock;
-static pid_t        g_holder  = NO_HOLDER;
-static unsigned int g_count   = 0;
+static struct net_rmutex_s g_netlock;
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: _net_takesem
+ * Name: net_rmutex_takesem
  *
  * Description:
  *   Take the semaphore, waiting indefinitely.
@@ -80,7 +78,7 @@ static unsigned int g_count   = 0;
  *
  ****************************************************************************/
 
-static int _net_takesem(void)
+static int net_rmutex_takesem(FAR struct net_rmutex_s *rmutex)
 {
   int ret;
 
@@ -88,7 +86,7 @@ static int _net_takesem(void)
     {
       /* Take the semaphore (perhaps waiting) */
 
-      ret = nxsem_wait(&g_netlock);
+      ret = nxsem_wait(&rmutex->rm_sem);
 
       /* The only case that an error should occur here is if the wait was
        * awakened by a signal.
@@ -101,31 +99,68 @@ static int _net_takesem(void)
   return ret;
 }
 
+/****************************************************************************
+ * Name: net_rmutex_self
+ *
+ * Description:
+ *   Return the PID of the calling thread.  In SMP, getpid() looks up the
+ *   task running on the current CPU; local interrupts are disabled so that
+ *   the thread cannot be moved to another CPU between finding the CPU and
+ *   reading its running task.  This does not serialize the CPUs the way
+ *   that enter_critical_section() would.
+ *
+ ****************************************************************************/
+
+static pid_t net_rmutex_self(void)
+{
+#ifdef CONFIG_SMP
+  irqstate_t flags;
+  pid_t me;
+
+  flags = up_irq_save();
+  me    = getpid();
+  up_irq_restore(flags);
+  return me;
+#else
+  return getpid();
+#endif
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: net_lockinitialize
+ * Name: net_rmutex_initialize
  *
  * Description:
- *   Initialize the locking facility
+ *   Initialize a re-entrant mutex
  *
  ****************************************************************************/
 
-void net_lockinitialize(void)
+void net_rmutex_initialize(FAR struct net_rmutex_s *rmutex)
 {
-  nxsem_init(&g_netlock, 0, 1);
+  nxsem_init(&rmutex->rm_sem, 0, 1);
+  rmutex->rm_holder = NO_HOLDER;
+  rmutex->rm_count  = 0;
 }
 
 /****************************************************************************
- * Name: net_lock
+ * Name: net_rmutex_lock
  *
  * Description:
- *   Take the network lock
+ *   Take a re-entrant mutex.
+ *
+ *   No critical section is needed to test the holder:  Only the holding
+ *   thread ever sets rm_holder to its own PID, so a thread that finds its
+ *   own PID there really does hold the mutex.  Any other value, even one
+ *   that is being changed by another CPU, means that it does not.  This
+ *   matters in SMP where enter_critical_section() would serialize all CPUs
+ *   on every network operation.  The PID itself is obtained with
+ *   net_rmutex_self() so that it is right even if the thread migrates.
  *
  * Input Parameters:
- *   None
+ *   rmutex - The re-entrant mutex
  *
  * Returned Value:
  *   Zero (OK) is returned on success; a negated errno value is returned on
@@ -133,83 +168,123 @@ void net_lockinitialize(void)
  *
  ****************************************************************************/
 
-int net_lock(void)
+int net_rmutex_lock(FAR struct net_rmutex_s *rmutex)
 {
-#ifdef CONFIG_SMP
-  irqstate_t flags = enter_critical_section();
-#endif
-  pid_t me = getpid();
+  pid_t me = net_rmutex_self();
   int ret = OK;
 
   /* Does this thread already hold the semaphore? */
 
-  if (g_holder == me)
+  if (rmutex->rm_holder == me)
     {
       /* Yes.. just increment the reference count */
 
-      g_count++;
+      rmutex->rm_count++;
     }
   else
     {
       /* No.. take the semaphore (perhaps waiting) */
 
-      ret = _net_takesem();
+      ret = net_rmutex_takesem(rmutex);
       if (ret >= 0)
         {
           /* Now this thread holds the semaphore */
 
-          g_holder = me;
-          g_count  = 1;
+          rmutex->rm_holder = me;
+          rmutex->rm_count  = 1;
         }
     }
 
-#ifdef CONFIG_SMP
-  leave_critical_section(flags);
-#endif
   return ret;
 }
 
 /****************************************************************************
- * Name: net_unlock
+ * Name: net_rmutex_unlock
  *
  * Description:
- *   Release the network lock.
+ *   Release a re-entrant mutex.
  *
  * Input Parameters:
- *   None
+ *   rmutex - The re-entrant mutex
  *
  * Returned Value:
  *   None
  *
  ****************************************************************************/
 
-void net_unlock(void)
+void net_rmutex_unlock(FAR struct net_rmutex_s *rmutex)
 {
-#ifdef CONFIG_SMP
-  irqstate_t flags = enter_critical_section();
-#endif
-  DEBUGASSERT(g_holder == getpid() && g_count > 0);
+  DEBUGASSERT(rmutex->rm_holder == net_rmutex_self() &&
+              rmutex->rm_count > 0);
 
   /* If the count would go to zero, then release the semaphore */
 
-  if (g_count == 1)
+  if (rmutex->rm_count == 1)
     {
       /* We no longer hold the semaphore */
 
-      g_holder = NO_HOLDER;
-      g_count  = 0;
-      nxsem_post(&g_netlock);
+      rmutex->rm_holder = NO_HOLDER;
+      rmutex->rm_count  = 0;
+      nxsem_post(&rmutex->rm_sem);
     }
   else
     {
       /* We still hold the semaphore. Just decrement the count */
 
-      g_count--;
+      rmutex->rm_count--;
     }
+}
 
-#ifdef CONFIG_SMP
-  leave_critical_section(flags);
-#endif
+/****************************************************************************
+ * Name: net_lockinitialize
+ *
+ * Description:
+ *   Initialize the locking facility
+ *
+ ****************************************************************************/
+
+void net_lockinitialize(void)
+{
+  net_rmutex_initialize(&g_netlock);
+}
+
+/****************************************************************************
+ * Name: net_lock
+ *
+ * Description:
+ *   Take the network lock
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failured (probably -ECANCELED).
+ *
+ ****************************************************************************/
+
+int net_lock(void)
+{
+  return net_rmutex_lock(&g_netlock);
+}
+
+/****************************************************************************
+ * Name: net_unlock
+ *
+ * Description:
+ *   Release the network lock.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void net_unlock(void)
+{
+  net_rmutex_unlock(&g_netlock);
 }
 
 /****************************************************************************
@@ -223,29 +298,26 @@ void net_unlock(void)
 
 int net_breaklock(FAR unsigned int *count)
 {
-  irqstate_t flags;
-  pid_t me = getpid();
+  pid_t me = net_rmutex_self();
   int ret = -EPERM;
 
   DEBUGASSERT(count != NULL);
 
-  flags = enter_critical_section(); /* No interrupts */
-  if (g_holder == me)
+  if (g_netlock.rm_holder == me)
     {
       /* Return the lock setting */
 
-      *count   = g_count;
+      *count = g_netlock.rm_count;
 
       /* Release the network lock  */
 
-      g_holder = NO_HOLDER;
-      g_count  = 0;
+      g_netlock.rm_holder = NO_HOLDER;
+      g_netlock.rm_count  = 0;
 
-      (void)nxsem_post(&g_netlock);
-      ret      = OK;
+      (void)nxsem_post(&g_netlock.rm_sem);
+      ret = OK;
     }
 
-  leave_critical_section(flags);
   return ret;
 }
 
@@ -263,18 +335,18 @@ int net_breaklock(FAR unsigned int *count)
 
 int net_restorelock(unsigned int count)
 {
-  pid_t me = getpid();
+  pid_t me = net_rmutex_self();
   int ret;
 
-  DEBUGASSERT(g_holder != me);
+  DEBUGASSERT(g_netlock.rm_holder != me);
 
   /* Recover the network lock at the proper count */
 
-  ret = _net_takesem();
+  ret = net_rmutex_takesem(&g_netlock);
   if (ret >= 0)
     {
-      g_holder = me;
-      g_count  = count;
+      g_netlock.rm_holder = me;
+      g_netlock.rm_count  = count;
     }
 
   return ret;
@@ -136,6 +136,14 @@ extern volatile cpu_set_t g_cpu_irqset SP_SECTION;
 /* Handles nested calls to enter_critical section from interrupt handlers */
 
 extern volatile uint8_t g_cpu_nestcount[CONFIG_SMP_NCPUS];
+
+#ifdef CONFIG_SMP_CSECTION_STATS
+/* Contention statistics of g_cpu_irqlock for each CPU */
+
+extern volatile uint32_t g_csection_nlocks[CONFIG_SMP_NCPUS];
+extern volatile uint32_t g_csection_ncontended[CONFIG_SMP_NCPUS];
+extern volatile uint32_t g_csection_nspins[CONFIG_SMP_NCPUS];
+#endif
 #endif
 
 /****************************************************************************
@@ -51,6 +51,21 @@
 
 #ifdef CONFIG_IRQCOUNT
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_CSECTION_FAIR
+/* Round-robin arbitration of g_cpu_irqlock.  g_csection_waiting[cpu] is set
+ * while the CPU spins in irq_waitlock() and is only written by that CPU.
+ * g_csection_turn is the CPU that is first in the round-robin order and is
+ * only written by the CPU that has just taken g_cpu_irqlock.
+ */
+
+static volatile bool g_csection_waiting[CONFIG_SMP_NCPUS];
+static volatile uint8_t g_csection_turn;
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -70,12 +85,60 @@ volatile cpu_set_t g_cpu_irqset SP_SECTION;
 /* Handles nested calls to enter_critical section from interrupt handlers */
 
 volatile uint8_t g_cpu_nestcount[CONFIG_SMP_NCPUS];
+
+#ifdef CONFIG_SMP_CSECTION_STATS
+/* Contention statistics of g_cpu_irqlock for each CPU:  The number of
+ * times that the CPU took the lock, the number of those times that the
+ * lock was held by another CPU, and the number of failed attempts.  Each
+ * entry is only written by its own CPU.
+ */
+
+volatile uint32_t g_csection_nlocks[CONFIG_SMP_NCPUS];
+volatile uint32_t g_csection_ncontended[CONFIG_SMP_NCPUS];
+volatile uint32_t g_csection_nspins[CONFIG_SMP_NCPUS];
+#endif
 #endif
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: irq_trylock
+ *
+ * Description:
+ *   Try once to take g_cpu_irqlock.  With CONFIG_SMP_CSECTION_FAIR, the
+ *   attempt is only made if no CPU ahead of this one in the round-robin
+ *   order is also waiting.  That order is only a hint; the test-and-set
+ *   still decides which CPU gets the lock.
+ *
+ * Input Parameters:
+ *   cpu - The index of CPU that is trying to enter the critical section.
+ *
+ * Returned Value:
+ *   True if g_cpu_irqlock has been taken.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+static inline bool irq_trylock(int cpu)
+{
+#ifdef CONFIG_SMP_CSECTION_FAIR
+  int i;
+
+  for (i = g_csection_turn; i != cpu; i = (i + 1) % CONFIG_SMP_NCPUS)
+    {
+      if (g_csection_waiting[i])
+        {
+          return false;
+        }
+    }
+#endif
+
+  return spin_trylock_wo_note(&g_cpu_irqlock) == SP_UNLOCKED;
+}
+#endif
+
 /****************************************************************************
  * Name: irq_waitlock
  *
@@ -122,6 +185,9 @@ volatile uint8_t g_cpu_nestcount[CONFIG_SMP_NCPUS];
 #ifdef CONFIG_SMP
 static inline bool irq_waitlock(int cpu)
 {
+#ifdef CONFIG_SMP_CSECTION_STATS
+  bool contended = false;
+#endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
   FAR struct tcb_s *tcb = current_task(cpu);
 
@@ -130,12 +196,31 @@ static inline bool irq_waitlock(int cpu)
   sched_note_spinlock(tcb, &g_cpu_irqlock);
 #endif
 
+#ifdef CONFIG_SMP_CSECTION_FAIR
+  /* Let the other CPUs know that this CPU is waiting */
+
+  g_csection_waiting[cpu] = true;
+  SP_DMB();
+#endif
+
   /* Duplicate the spin_lock() logic from spinlock.c, but adding the check
    * for the deadlock condition.
    */
 
-  while (spin_trylock_wo_note(&g_cpu_irqlock) == SP_LOCKED)
+  while (!irq_trylock(cpu))
     {
+#ifdef CONFIG_SMP_CSECTION_STATS
+      /* Count the first failure as one contended acquisition */
+
+      if (!contended)
+        {
+          g_csection_ncontended[cpu]++;
+          contended = true;
+        }
+
+      g_csection_nspins[cpu]++;
+#endif
+
       /* Is a pause request pending? */
 
       if (up_cpu_pausereq(cpu))
@@ -144,6 +229,10 @@ static inline bool irq_waitlock(int cpu)
            * Abort the wait and return false.
            */
 
+#ifdef CONFIG_SMP_CSECTION_FAIR
+          g_csection_waiting[cpu] = false;
+#endif
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
           /* Notify that we are waiting for a spinlock */
 
@@ -156,6 +245,17 @@ static inline bool irq_waitlock(int cpu)
 
   /* We have g_cpu_irqlock! */
 
+#ifdef CONFIG_SMP_CSECTION_FAIR
+  /* This CPU is now last in the round-robin order */
+
+  g_csection_waiting[cpu] = false;
+  g_csection_turn         = (cpu + 1) % CONFIG_SMP_NCPUS;
+#endif
+
+#ifdef CONFIG_SMP_CSECTION_STATS
+  g_csection_nlocks[cpu]++;
+#endif
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
   /* Notify that we have the spinlock */
 
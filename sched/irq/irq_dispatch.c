@@ -173,9 +173,17 @@ void irq_dispatch(int irq, FAR void *context)
 
   /* Then dispatch to the interrupt handler */
 
+#ifdef CONFIG_SCHED_SCHEDSTAT
+  sched_schedstat_irqenter();
+#endif
+
   CALL_VECTOR(ndx, vector, irq, context, arg);
   UNUSED(ndx);
 
+#ifdef CONFIG_SCHED_SCHEDSTAT
+  sched_schedstat_irqleave();
+#endif
+
   /* Record the new "running" task.  g_running_tasks[] is only used by
    * assertion logic for reporting crashes.
    */
@@ -0,0 +1,130 @@
+/****************************************************************************
+ * sched/mqueue/mq_bufalloc.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/mqueue.h>
+
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_ZEROCOPY
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Zero-copy message buffers are allocated from their own heap so that a
+ * backlog of large messages cannot exhaust the kernel heap.
+ */
+
+static struct mm_heap_s g_mqbufheap;
+static uint8_t g_mqbufpool[CONFIG_MQ_ZEROCOPY_POOLSIZE];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_initialize_buffers
+ *
+ * Description:
+ *   Initialize the pool of zero-copy message buffers.  Called by
+ *   nxmq_initialize().
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxmq_initialize_buffers(void)
+{
+  mm_initialize(&g_mqbufheap, g_mqbufpool, CONFIG_MQ_ZEROCOPY_POOLSIZE);
+}
+
+/****************************************************************************
+ * Name: nxmq_alloc_buffer
+ *
+ * Description:
+ *   Allocate a buffer for a zero-copy message from the dedicated message
+ *   buffer pool.
+ *
+ * Input Parameters:
+ *   size - The size of the buffer in bytes
+ *
+ * Returned Value:
+ *   The allocated buffer or NULL if the pool is exhausted.
+ *
+ ****************************************************************************/
+
+FAR void *nxmq_alloc_buffer(size_t size)
+{
+  DEBUGASSERT(!up_interrupt_context());
+  return mm_malloc(&g_mqbufheap, size > 0 ? size : 1);
+}
+
+/****************************************************************************
+ * Name: nxmq_free_buffer
+ *
+ * Description:
+ *   Return a buffer obtained from nxmq_alloc_buffer() or from
+ *   nxmq_receive_buffer() to the message buffer pool.
+ *
+ * Input Parameters:
+ *   buffer - The buffer to be freed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxmq_free_buffer(FAR void *buffer)
+{
+  DEBUGASSERT(!up_interrupt_context());
+  mm_free(&g_mqbufheap, buffer);
+}
+
+#endif /* CONFIG_MQ_ZEROCOPY */
@@ -0,0 +1,161 @@
+/****************************************************************************
+ * sched/mqueue/mq_bufreceive.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <fcntl.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <mqueue.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/mqueue.h>
+
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_ZEROCOPY
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_receive_buffer
+ *
+ * Description:
+ *   This function receives the oldest of the highest priority messages
+ *   from the message queue specified by "mqdes" without copying it:  The
+ *   caller takes ownership of the buffer holding the message and must
+ *   release it with nxmq_free_buffer().  Otherwise, it behaves like
+ *   nxmq_receive().
+ *
+ *   A message that was sent with mq_send() is copied into a new buffer.
+ *
+ * Input Parameters:
+ *   mqdes  - Message Queue Descriptor
+ *   buffer - The location to return the buffer holding the message
+ *   prio   - If not NULL, the location to store message priority.
+ *
+ * Returned Value:
+ *   The length of the message is returned on success.  A negated errno
+ *   value is returned on failure (see mq_receive() for the list of valid
+ *   return values).  ENOMEM is returned if a message sent with mq_send()
+ *   could not be copied into a buffer; that message is lost.
+ *
+ ****************************************************************************/
+
+ssize_t nxmq_receive_buffer(mqd_t mqdes, FAR void **buffer,
+                            FAR unsigned int *prio)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  ssize_t ret;
+
+  DEBUGASSERT(up_interrupt_context() == false);
+
+  /* Verify the input parameters.  No receive buffer is needed, so the
+   * message size does not matter.
+   */
+
+  if (buffer == NULL || mqdes == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if ((mqdes->oflags & O_RDOK) == 0)
+    {
+      return -EPERM;
+    }
+
+  *buffer = NULL;
+
+  /* Get the next message from the message queue with pre-emption and,
+   * because messages can be sent from interrupt level, interrupts disabled
+   * (see nxmq_receive()).
+   */
+
+  sched_lock();
+  flags = enter_critical_section();
+  ret   = nxmq_wait_receive(mqdes, &mqmsg);
+  leave_critical_section(flags);
+
+  if (ret >= 0)
+    {
+      DEBUGASSERT(mqmsg != NULL);
+
+      if (mqmsg->buffer != NULL)
+        {
+          /* Take the buffer from the message */
+
+          *buffer       = mqmsg->buffer;
+          mqmsg->buffer = NULL;
+        }
+      else
+        {
+          /* The message was copied into the message structure by
+           * mq_send().  Copy it into a buffer of its own.
+           */
+
+          *buffer = nxmq_alloc_buffer(mqmsg->msglen);
+          if (*buffer != NULL)
+            {
+              memcpy(*buffer, (FAR const void *)mqmsg->mail, mqmsg->msglen);
+            }
+        }
+
+      /* Let nxmq_do_receive() release the message structure and wake up
+       * any senders waiting for space in the message queue.
+       */
+
+      ret = nxmq_do_receive(mqdes, mqmsg, NULL, prio);
+      if (*buffer == NULL)
+        {
+          ret = -ENOMEM;
+        }
+    }
+
+  sched_unlock();
+  return ret;
+}
+
+#endif /* CONFIG_MQ_ZEROCOPY */
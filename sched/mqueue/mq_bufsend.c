@@ -0,0 +1,151 @@
+/****************************************************************************
+ * sched/mqueue/mq_bufsend.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/mqueue.h>
+
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_ZEROCOPY
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_send_buffer
+ *
+ * Description:
+ *   This function adds a message to the message queue (mqdes) without
+ *   copying it:  The message queue takes ownership of the buffer, which
+ *   must have been allocated with nxmq_alloc_buffer().  Otherwise, it
+ *   behaves like nxmq_send().  It may be called from an interrupt handler
+ *   with a buffer that was allocated beforehand.
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor
+ *   buffer - The buffer holding the message
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned on
+ *   failure (see mq_send() for the list of valid return values).  The
+ *   caller still owns the buffer if the message was not sent.
+ *
+ ****************************************************************************/
+
+int nxmq_send_buffer(mqd_t mqdes, FAR void *buffer, size_t msglen,
+                     unsigned int prio)
+{
+  FAR struct mqueue_inode_s *msgq;
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  int ret;
+
+  /* Verify the input parameters.  Unlike with nxmq_send(), the message may
+   * be larger than MQ_MAX_BYTES.
+   */
+
+  if (buffer == NULL || mqdes == NULL || prio > MQ_PRIO_MAX)
+    {
+      return -EINVAL;
+    }
+
+  if ((mqdes->oflags & O_WROK) == 0)
+    {
+      return -EPERM;
+    }
+
+  if (msglen > mqdes->msgq->maxmsgsize)
+    {
+      return -EMSGSIZE;
+    }
+
+  /* Get a pointer to the message queue */
+
+  sched_lock();
+  msgq = mqdes->msgq;
+
+  /* Wait for space in the message queue unless we are called from an
+   * interrupt handler.  This would fail with EAGAIN or EINTR.
+   */
+
+  mqmsg = NULL;
+  flags = enter_critical_section();
+  ret   = OK;
+
+  if (!up_interrupt_context() && msgq->nmsgs >= msgq->maxmsgs)
+    {
+      ret = nxmq_wait_send(mqdes);
+    }
+
+  leave_critical_section(flags);
+  if (ret >= 0)
+    {
+      /* Now allocate the message structure that will carry the buffer */
+
+      mqmsg = nxmq_alloc_msg();
+      ret   = (mqmsg == NULL) ? -ENOMEM : OK;
+    }
+
+  if (mqmsg != NULL)
+    {
+      /* Hand the buffer over to the message queue.  nxmq_do_send() does not
+       * copy the message data if the message structure carries a buffer.
+       */
+
+      mqmsg->buffer = buffer;
+      ret = nxmq_do_send(mqdes, mqmsg, buffer, msglen, prio);
+    }
+
+  sched_unlock();
+  return ret;
+}
+
+#endif /* CONFIG_MQ_ZEROCOPY */
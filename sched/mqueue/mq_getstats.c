@@ -0,0 +1,118 @@
+/****************************************************************************
+ * sched/mqueue/mq_getstats.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <mqueue.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/mqueue.h>
+
+#ifdef CONFIG_MQ_STATISTICS
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mq_perf2nsec
+ *
+ * Description:
+ *   Convert a number of up_perf_gettime() counts to nanoseconds without
+ *   overflowing the intermediate product.
+ *
+ ****************************************************************************/
+
+static uint64_t mq_perf2nsec(uint64_t count)
+{
+  uint32_t freq = up_perf_getfreq();
+
+  return (count / freq) * NSEC_PER_SEC +
+         (count % freq) * NSEC_PER_SEC / freq;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_get_stats
+ *
+ * Description:
+ *   Return the statistics of a message queue.  The latencies are returned
+ *   in nanoseconds.  The latency of a message is the time from its
+ *   insertion into the message queue until its removal by a receiver.
+ *
+ * Input Parameters:
+ *   mqdes - Message queue descriptor
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -EINVAL is returned if 'mqdes' or
+ *   'stats' is NULL.
+ *
+ ****************************************************************************/
+
+int nxmq_get_stats(mqd_t mqdes, FAR struct mqueue_stats_s *stats)
+{
+  irqstate_t flags;
+
+  if (mqdes == NULL || stats == NULL)
+    {
+      return -EINVAL;
+    }
+
+  /* Take a consistent snapshot.  Messages may be sent from interrupt
+   * handlers.
+   */
+
+  flags  = enter_critical_section();
+  *stats = mqdes->msgq->stats;
+  leave_critical_section(flags);
+
+  stats->maxlatency = mq_perf2nsec(stats->maxlatency);
+  stats->totlatency = mq_perf2nsec(stats->totlatency);
+  return OK;
+}
+
+#endif /* CONFIG_MQ_STATISTICS */
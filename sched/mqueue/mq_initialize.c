@@ -189,6 +189,12 @@ void nxmq_initialize(void)
   /* Allocate a block of message queue descriptors */
 
   nxmq_alloc_desblock();
+
+#ifdef CONFIG_MQ_ZEROCOPY
+  /* Initialize the pool of zero-copy message buffers */
+
+  nxmq_initialize_buffers();
+#endif
 }
 
 /****************************************************************************
@@ -71,6 +71,16 @@ void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg)
 {
   irqstate_t flags;
 
+#ifdef CONFIG_MQ_ZEROCOPY
+  /* Release the zero-copy message data if nobody has taken it */
+
+  if (mqmsg->buffer != NULL)
+    {
+      nxmq_free_buffer(mqmsg->buffer);
+      mqmsg->buffer = NULL;
+    }
+#endif
+
   /* If this is a generally available pre-allocated message,
    * then just put it back in the free list.
    */
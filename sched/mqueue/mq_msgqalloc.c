@@ -64,7 +64,9 @@
  *   mode   - mode_t value is ignored
  *   attr   - The mq_maxmsg attribute is used at the time that the message
  *            queue is created to determine the maximum number of
- *            messages that may be placed in the message queue.
+ *            messages that may be placed in the message queue.  If
+ *            MQ_ZEROCOPY is set in mq_flags, mq_msgsize may exceed
+ *            MQ_MAX_BYTES.
  *
  * Returned Value:
  *   The allocated and initialized message queue structure or NULL in the
@@ -81,8 +83,13 @@ FAR struct mqueue_inode_s *nxmq_alloc_msgq(mode_t mode,
    * larger than the configured maximum message size.
    */
 
+#ifdef CONFIG_MQ_ZEROCOPY
+  if (attr && attr->mq_msgsize > MQ_MAX_BYTES &&
+      (attr->mq_flags & MQ_ZEROCOPY) == 0)
+#else
   DEBUGASSERT(!attr || attr->mq_msgsize <= MQ_MAX_BYTES);
   if (attr && attr->mq_msgsize > MQ_MAX_BYTES)
+#endif
     {
       return NULL;
     }
@@ -100,7 +107,7 @@ FAR struct mqueue_inode_s *nxmq_alloc_msgq(mode_t mode,
       if (attr)
         {
           msgq->maxmsgs    = (int16_t)attr->mq_maxmsg;
-          msgq->maxmsgsize = (int16_t)attr->mq_msgsize;
+          msgq->maxmsgsize = attr->mq_msgsize;
         }
       else
         {
@@ -138,6 +138,9 @@ int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg)
   FAR struct tcb_s *rtcb;
   FAR struct mqueue_inode_s *msgq;
   FAR struct mqueue_msg_s *newmsg;
+#ifdef CONFIG_MQ_STATISTICS
+  uint32_t latency;
+#endif
   int ret;
 
   DEBUGASSERT(rcvmsg != NULL);
@@ -225,6 +228,21 @@ int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg)
   if (newmsg)
     {
       msgq->nmsgs--;
+
+#ifdef CONFIG_MQ_STATISTICS
+      /* Account for the time that the message spent in the queue */
+
+      latency = up_perf_gettime() - newmsg->sendtime;
+
+      msgq->nbytes -= newmsg->msglen;
+      msgq->stats.nreceived++;
+      msgq->stats.totlatency += latency;
+
+      if (latency > msgq->stats.maxlatency)
+        {
+          msgq->stats.maxlatency = latency;
+        }
+#endif
     }
 
   *rcvmsg = newmsg;
@@ -245,6 +263,7 @@ int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg)
  *   mqdes - Message queue descriptor
  *   mqmsg   - The message obtained by mq_waitmsg()
  *   ubuffer - The address of the user provided buffer to receive the message
+ *             or NULL if the caller has already taken the message data.
  *   prio    - The user-provided location to return the message priority.
  *
  * Returned Value:
@@ -273,7 +292,20 @@ ssize_t nxmq_do_receive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
 
   /* Copy the message into the caller's buffer */
 
-  memcpy(ubuffer, (FAR const void *)mqmsg->mail, rcvmsglen);
+#ifdef CONFIG_MQ_ZEROCOPY
+  if (ubuffer == NULL)
+    {
+      /* The caller has taken the message data */
+    }
+  else if (mqmsg->buffer != NULL)
+    {
+      memcpy(ubuffer, (FAR const void *)mqmsg->buffer, rcvmsglen);
+    }
+  else
+#endif
+    {
+      memcpy(ubuffer, (FAR const void *)mqmsg->mail, rcvmsglen);
+    }
 
   /* Copy the message priority as well (if a buffer is provided) */
 
@@ -82,7 +82,8 @@
  *     EINVAL   Either msg or mqdes is NULL or the value of prio is invalid.
  *     EPERM    Message queue opened not opened for writing.
  *     EMSGSIZE 'msglen' was greater than the maxmsgsize attribute of the
- *               message queue.
+ *               message queue (or than MQ_MAX_BYTES, which may be smaller
+ *               for a zero-copy message queue).
  *
  ****************************************************************************/
 
@@ -106,6 +107,15 @@ int nxmq_verify_send(mqd_t mqdes, FAR const char *msg, size_t msglen,
       return -EMSGSIZE;
     }
 
+#ifdef CONFIG_MQ_ZEROCOPY
+  /* Only zero-copy messages may be larger than the message structure */
+
+  if (msglen > MQ_MAX_BYTES)
+    {
+      return -EMSGSIZE;
+    }
+#endif
+
   return OK;
 }
 
@@ -191,6 +201,15 @@ FAR struct mqueue_msg_s *nxmq_alloc_msg(void)
         }
     }
 
+#ifdef CONFIG_MQ_ZEROCOPY
+  /* The message data is in mail[] unless the sender provides a buffer */
+
+  if (mqmsg != NULL)
+    {
+      mqmsg->buffer = NULL;
+    }
+#endif
+
   return mqmsg;
 }
 
@@ -329,6 +348,8 @@ int nxmq_wait_send(mqd_t mqdes)
  *
  * Input Parameters:
  *   mqdes  - Message queue descriptor
+ *   mqmsg  - The message structure.  If mqmsg->buffer is set, that buffer
+ *            holds the message (zero-copy) and msg is not copied.
  *   msg    - Message to send
  *   msglen - The length of the message in bytes
  *   prio   - The priority of the message
@@ -359,7 +380,12 @@ int nxmq_do_send(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
 
   /* Copy the message data into the message */
 
-  memcpy((FAR void *)mqmsg->mail, (FAR const void *)msg, msglen);
+#ifdef CONFIG_MQ_ZEROCOPY
+  if (mqmsg->buffer == NULL)
+#endif
+    {
+      memcpy((FAR void *)mqmsg->mail, (FAR const void *)msg, msglen);
+    }
 
   /* Insert the new message in the message queue */
 
@@ -388,6 +414,26 @@ int nxmq_do_send(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
   /* Increment the count of messages in the queue */
 
   msgq->nmsgs++;
+
+#ifdef CONFIG_MQ_STATISTICS
+  /* Update the statistics and remember when the message was queued */
+
+  msgq->nbytes += msglen;
+  msgq->stats.nsent++;
+
+  if (msgq->nmsgs > msgq->stats.maxmsgs)
+    {
+      msgq->stats.maxmsgs = msgq->nmsgs;
+    }
+
+  if (msgq->nbytes > msgq->stats.maxbytes)
+    {
+      msgq->stats.maxbytes = msgq->nbytes;
+    }
+
+  mqmsg->sendtime = up_perf_gettime();
+#endif
+
   leave_critical_section(flags);
 
   /* Check if we need to notify any tasks that are attached to the
@@ -92,10 +92,18 @@ struct mqueue_msg_s
   FAR struct mqueue_msg_s *next;  /* Forward link to next message */
   uint8_t type;                   /* (Used to manage allocations) */
   uint8_t priority;               /* priority of message */
-#if MQ_MAX_BYTES < 256
+#if defined(CONFIG_MQ_ZEROCOPY)
+  size_t msglen;                  /* Message data length */
+#elif MQ_MAX_BYTES < 256
   uint8_t msglen;                 /* Message data length */
 #else
   uint16_t msglen;                /* Message data length */
+#endif
+#ifdef CONFIG_MQ_ZEROCOPY
+  FAR void *buffer;               /* Zero-copy message data (NULL: in mail[]) */
+#endif
+#ifdef CONFIG_MQ_STATISTICS
+  uint32_t sendtime;              /* Time when the message was queued */
 #endif
   char mail[MQ_MAX_BYTES];        /* Message data */
 };
@@ -144,6 +152,12 @@ void weak_function nxmq_initialize(void);
 void nxmq_alloc_desblock(void);
 void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg);
 
+/* mq_bufalloc.c ***********************************************************/
+
+#ifdef CONFIG_MQ_ZEROCOPY
+void nxmq_initialize_buffers(void);
+#endif
+
 /* mq_waitirq.c ************************************************************/
 
 void nxmq_wait_irq(FAR struct tcb_s *wtcb, int errcode);
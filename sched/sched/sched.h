@@ -119,6 +119,14 @@
 #  define TLIST_BLOCKED(s)       __TLIST_HEAD(s)
 #endif
 
+/* Values of tcb_s::stat_state:  What the time since tcb_s::stat_start is
+ * charged to.
+ */
+
+#define SCHEDSTAT_BLOCKED        0 /* Nothing, the thread is blocked */
+#define SCHEDSTAT_WAITING        1 /* tcb_s::wait_time */
+#define SCHEDSTAT_RUNNING        2 /* tcb_s::run_time */
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -504,6 +512,16 @@ void sched_critmon_resume(FAR struct tcb_s *tcb);
 void sched_critmon_suspend(FAR struct tcb_s *tcb);
 #endif
 
+/* Scheduler statistics */
+
+#ifdef CONFIG_SCHED_SCHEDSTAT
+void sched_schedstat_ready(FAR struct tcb_s *tcb);
+void sched_schedstat_resume(FAR struct tcb_s *tcb);
+void sched_schedstat_suspend(FAR struct tcb_s *tcb);
+void sched_schedstat_irqenter(void);
+void sched_schedstat_irqleave(void);
+#endif
+
 /* TCB operations */
 
 bool sched_verifytcb(FAR struct tcb_s *tcb);
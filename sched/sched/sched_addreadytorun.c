@@ -85,6 +85,12 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
   FAR struct tcb_s *rtcb = this_task();
   bool ret;
 
+#ifdef CONFIG_SCHED_SCHEDSTAT
+  /* The task starts waiting to run now */
+
+  sched_schedstat_ready(btcb);
+#endif
+
   /* Check if pre-emption is disabled for the current running task and if
    * the new ready-to-run task would cause the current running task to be
    * pre-empted.  NOTE that IRQs disabled implies that pre-emption is
@@ -178,6 +184,12 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
 
   irqstate_t lock = sched_tasklist_lock();
 
+#ifdef CONFIG_SCHED_SCHEDSTAT
+  /* The task starts waiting to run now */
+
+  sched_schedstat_ready(btcb);
+#endif
+
   /* Check if the blocked TCB is locked to this CPU */
 
   if ((btcb->flags & TCB_FLAG_CPU_LOCKED) != 0)
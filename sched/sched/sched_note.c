@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stddef.h>
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
@@ -57,14 +58,32 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* There is one note buffer for each CPU */
+
+#ifdef CONFIG_SMP
+#  define NOTE_NCPUS CONFIG_SMP_NCPUS
+#else
+#  define NOTE_NCPUS 1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* Each CPU adds its notes to its own circular buffer.  Only that CPU ever
+ * moves ni_head (with its local interrupts disabled) and, if notes can be
+ * retrieved with sched_note_get(), only the reader ever moves ni_tail.  So
+ * no lock is needed to add a note.
+ */
+
 struct note_info_s
 {
-  volatile unsigned int ni_head;
-  volatile unsigned int ni_tail;
+  volatile unsigned int ni_head;     /* Index of the next byte to write */
+  volatile unsigned int ni_tail;     /* Index of the oldest note */
+  volatile uint32_t ni_overflow;     /* Total number of notes lost */
+#ifdef CONFIG_SCHED_NOTE_GET
+  uint32_t ni_dropped;               /* Notes lost since the last report */
+#endif
   uint8_t ni_buffer[CONFIG_SCHED_NOTE_BUFSIZE];
 };
 
@@ -92,11 +111,7 @@ static void note_add(FAR const uint8_t *note, uint8_t notelen);
  * Private Data
  ****************************************************************************/
 
-static struct note_info_s g_note_info;
-
-#ifdef CONFIG_SMP
-static volatile spinlock_t g_note_lock;
-#endif
+static struct note_info_s g_note_info[NOTE_NCPUS];
 
 /****************************************************************************
  * Private Functions
@@ -206,10 +221,10 @@ void note_spincommon(FAR struct tcb_s *tcb, FAR volatile spinlock_t *spinlock,
  * Name: note_length
  *
  * Description:
- *   Length of data currently in circular buffer.
+ *   Length of data currently in a circular buffer.
  *
  * Input Parameters:
- *   None
+ *   ni - The note buffer of one CPU
  *
  * Returned Value:
  *   Length of data currently in circular buffer.
@@ -217,10 +232,10 @@ void note_spincommon(FAR struct tcb_s *tcb, FAR volatile spinlock_t *spinlock,
  ****************************************************************************/
 
 #if defined(CONFIG_SCHED_NOTE_GET) || defined(CONFIG_DEBUG_ASSERTIONS)
-static unsigned int note_length(void)
+static unsigned int note_length(FAR struct note_info_s *ni)
 {
-  unsigned int head = g_note_info.ni_head;
-  unsigned int tail = g_note_info.ni_tail;
+  unsigned int head = ni->ni_head;
+  unsigned int tail = ni->ni_tail;
 
   if (tail > head)
     {
@@ -235,20 +250,21 @@ static unsigned int note_length(void)
  * Name: note_remove
  *
  * Description:
- *   Remove the variable length note from the tail of the circular buffer
+ *   Remove the variable length note from the tail of a circular buffer
  *
  * Input Parameters:
- *   None
+ *   ni - The note buffer of one CPU
  *
  * Returned Value:
  *   None
  *
  * Assumptions:
- *   We are within a critical section.
+ *   Called only by the CPU that owns the buffer when there is no reader,
+ *   or by the reader within a critical section.
  *
  ****************************************************************************/
 
-static void note_remove(void)
+static void note_remove(FAR struct note_info_s *ni)
 {
   FAR struct note_common_s *note;
   unsigned int tail;
@@ -256,97 +272,247 @@ static void note_remove(void)
 
   /* Get the tail index of the circular buffer */
 
-  tail = g_note_info.ni_tail;
+  tail = ni->ni_tail;
   DEBUGASSERT(tail < CONFIG_SCHED_NOTE_BUFSIZE);
 
   /* Get the length of the note at the tail index */
 
-  note   = (FAR struct note_common_s *)&g_note_info.ni_buffer[tail];
+  note   = (FAR struct note_common_s *)&ni->ni_buffer[tail];
   length = note->nc_length;
-  DEBUGASSERT(length <= note_length());
+  DEBUGASSERT(length <= note_length(ni));
 
   /* Increment the tail index to remove the entire note from the circular
    * buffer.
    */
 
-  g_note_info.ni_tail = note_next(tail, length);
+  ni->ni_tail = note_next(tail, length);
 }
 
 /****************************************************************************
- * Name: note_add
+ * Name: note_copy
  *
  * Description:
- *   Add the variable length note to the head of the circular buffer
+ *   Copy a variable length note to the head of a circular buffer.
+ *
+ *   If notes are retrieved with sched_note_get(), the caller must already
+ *   have verified that there is space for the note.  Otherwise, older
+ *   notes are overwritten by newer notes.
  *
  * Input Parameters:
- *   None
+ *   ni      - The note buffer of the current CPU
+ *   note    - The note to add
+ *   notelen - The length of the note
  *
  * Returned Value:
  *   None
  *
- * Assumptions:
- *   We are within a critical section.
- *
  ****************************************************************************/
 
-static void note_add(FAR const uint8_t *note, uint8_t notelen)
+static void note_copy(FAR struct note_info_s *ni, FAR const uint8_t *note,
+                      uint8_t notelen)
 {
   unsigned int head;
+#ifndef CONFIG_SCHED_NOTE_GET
   unsigned int next;
-
-#ifdef CONFIG_SMP
-  /* Ignore notes that are not in the set of monitored CPUs */
-
-  if ((CONFIG_SCHED_INSTRUMENTATION_CPUSET & (1 << this_cpu())) == 0)
-    {
-      /* Not in the set of monitored CPUs.  Do not log the note. */
-
-      return;
-    }
-#endif
-
-#ifdef CONFIG_SMP
-  irqstate_t flags = up_irq_save();
-  spin_lock_wo_note(&g_note_lock);
 #endif
 
   /* Get the index to the head of the circular buffer */
 
-  DEBUGASSERT(note != NULL && notelen < CONFIG_SCHED_NOTE_BUFSIZE);
-  head = g_note_info.ni_head;
+  head = ni->ni_head;
 
   /* Loop until all bytes have been transferred to the circular buffer */
 
   while (notelen > 0)
     {
+#ifndef CONFIG_SCHED_NOTE_GET
       /* Get the next head index.  Would it collide with the current tail
        * index?
        */
 
       next = note_next(head, 1);
-      if (next == g_note_info.ni_tail)
+      if (next == ni->ni_tail)
         {
           /* Yes, then remove the note at the tail index */
 
-          note_remove();
+          note_remove(ni);
+          ni->ni_overflow++;
         }
+#endif
 
       /* Save the next byte at the head index */
 
-      g_note_info.ni_buffer[head] = *note++;
+      ni->ni_buffer[head] = *note++;
 
-      head = next;
+      head = note_next(head, 1);
       notelen--;
     }
 
-  g_note_info.ni_head = head;
+  /* The note must be complete before the reader can see it */
+
+  SP_DMB();
+  ni->ni_head = head;
+}
+
+/****************************************************************************
+ * Name: note_add
+ *
+ * Description:
+ *   Add the variable length note to the head of the circular buffer of the
+ *   current CPU.
+ *
+ *   If notes are retrieved with sched_note_get() and the buffer is full,
+ *   the new note is dropped instead and counted.  The count of dropped
+ *   notes is reported in a NOTE_OVERFLOW note that precedes the next note
+ *   that fits in the buffer.
+ *
+ * Input Parameters:
+ *   note    - The note to add
+ *   notelen - The length of the note
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void note_add(FAR const uint8_t *note, uint8_t notelen)
+{
+  FAR struct note_info_s *ni;
+  irqstate_t flags;
+#ifdef CONFIG_SCHED_NOTE_GET
+  struct note_overflow_s overflow;
+  unsigned int space;
+#endif
+  int cpu;
+
+  DEBUGASSERT(note != NULL && notelen < CONFIG_SCHED_NOTE_BUFSIZE);
+
+  /* Disabling local interrupts keeps us on this CPU and keeps interrupt
+   * handlers on this CPU from adding notes at the same time.  No other CPU
+   * ever adds notes to this CPU's buffer.
+   */
+
+  flags = up_irq_save();
+  cpu   = this_cpu();
 
 #ifdef CONFIG_SMP
-  spin_unlock_wo_note(&g_note_lock);
-  up_irq_restore(flags);
+  /* Ignore notes that are not in the set of monitored CPUs */
+
+  if ((CONFIG_SCHED_INSTRUMENTATION_CPUSET & (1 << cpu)) == 0)
+    {
+      /* Not in the set of monitored CPUs.  Do not log the note. */
+
+      up_irq_restore(flags);
+      return;
+    }
+#endif
+
+  ni = &g_note_info[cpu];
+
+#ifdef CONFIG_SCHED_NOTE_GET
+  /* Do not overwrite notes that have not yet been read.  Reserve space
+   * for the report of any notes that were dropped before this one.
+   */
+
+  space = CONFIG_SCHED_NOTE_BUFSIZE - 1 - note_length(ni);
+  if (notelen + (ni->ni_dropped > 0 ? sizeof(overflow) : 0) > space)
+    {
+      ni->ni_dropped++;
+      ni->ni_overflow++;
+      up_irq_restore(flags);
+      return;
+    }
+
+  if (ni->ni_dropped > 0)
+    {
+      /* The report takes the common fields of the note that follows */
+
+      memcpy(&overflow.nov_cmn, note, sizeof(struct note_common_s));
+      overflow.nov_cmn.nc_length = sizeof(struct note_overflow_s);
+      overflow.nov_cmn.nc_type   = NOTE_OVERFLOW;
+      overflow.nov_count[0]      = (uint8_t)( ni->ni_dropped        & 0xff);
+      overflow.nov_count[1]      = (uint8_t)((ni->ni_dropped >> 8)  & 0xff);
+      overflow.nov_count[2]      = (uint8_t)((ni->ni_dropped >> 16) & 0xff);
+      overflow.nov_count[3]      = (uint8_t)((ni->ni_dropped >> 24) & 0xff);
+
+      note_copy(ni, (FAR const uint8_t *)&overflow,
+                sizeof(struct note_overflow_s));
+      ni->ni_dropped = 0;
+    }
 #endif
+
+  note_copy(ni, note, notelen);
+  up_irq_restore(flags);
 }
 
+/****************************************************************************
+ * Name: note_systime
+ *
+ * Description:
+ *   Return the time stamp of the note at the tail of a circular buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_NOTE_GET
+static uint32_t note_systime(FAR struct note_info_s *ni)
+{
+  unsigned int ndx;
+  uint32_t systime = 0;
+  int i;
+
+  ndx = note_next(ni->ni_tail, offsetof(struct note_common_s, nc_systime));
+  for (i = 3; i >= 0; i--)
+    {
+      systime = (systime << 8) | ni->ni_buffer[note_next(ndx, i)];
+    }
+
+  return systime;
+}
+
+/****************************************************************************
+ * Name: note_select
+ *
+ * Description:
+ *   Select the circular buffer holding the oldest note.  The notes of all
+ *   CPUs are so merged into one stream ordered by time stamp.
+ *
+ * Returned Value:
+ *   The selected buffer or NULL if all buffers are empty.
+ *
+ * Assumptions:
+ *   We are within a critical section.
+ *
+ ****************************************************************************/
+
+static FAR struct note_info_s *note_select(void)
+{
+  FAR struct note_info_s *select = NULL;
+  FAR struct note_info_s *ni;
+  uint32_t oldest = 0;
+  uint32_t systime;
+  int cpu;
+
+  for (cpu = 0; cpu < NOTE_NCPUS; cpu++)
+    {
+      ni = &g_note_info[cpu];
+      if (note_length(ni) > 0)
+        {
+          /* The head index is read before the note itself */
+
+          SP_DMB();
+
+          systime = note_systime(ni);
+          if (select == NULL || (int32_t)(systime - oldest) < 0)
+            {
+              select = ni;
+              oldest = systime;
+            }
+        }
+    }
+
+  return select;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -388,7 +554,7 @@ void sched_note_start(FAR struct tcb_s *tcb)
 
   length = SIZEOF_NOTE_START(namelen + 1);
 #else
-  length = SIZEOF_NOTE_START(0)
+  length = SIZEOF_NOTE_START(0);
 #endif
 
   /* Finish formatting the note */
@@ -595,6 +761,8 @@ void sched_note_spinabort(FAR struct tcb_s *tcb, FAR volatile void *spinlock)
  * Description:
  *   Remove the next note from the tail of the circular buffer.  The note
  *   is also removed from the circular buffer to make room for further notes.
+ *   In SMP configurations, each CPU has its own circular buffer and the
+ *   oldest note of all CPUs is returned.
  *
  * Input Parameters:
  *   buffer - Location to return the next note
@@ -610,20 +778,20 @@ void sched_note_spinabort(FAR struct tcb_s *tcb, FAR volatile void *spinlock)
 #ifdef CONFIG_SCHED_NOTE_GET
 ssize_t sched_note_get(FAR uint8_t *buffer, size_t buflen)
 {
+  FAR struct note_info_s *ni;
   FAR struct note_common_s *note;
   irqstate_t flags;
   unsigned int remaining;
   unsigned int tail;
   ssize_t notelen;
-  size_t circlen;
 
   DEBUGASSERT(buffer != NULL);
   flags = enter_critical_section();
 
-  /* Verify that the circular buffer is not empty */
+  /* Select the buffer with the oldest note.  Are all buffers empty? */
 
-  circlen = note_length();
-  if (circlen <= 0)
+  ni = note_select();
+  if (ni == NULL)
     {
       notelen = 0;
       goto errout_with_csection;
@@ -631,14 +799,14 @@ ssize_t sched_note_get(FAR uint8_t *buffer, size_t buflen)
 
   /* Get the index to the tail of the circular buffer */
 
-  tail    = g_note_info.ni_tail;
+  tail    = ni->ni_tail;
   DEBUGASSERT(tail < CONFIG_SCHED_NOTE_BUFSIZE);
 
   /* Get the length of the note at the tail index */
 
-  note    = (FAR struct note_common_s *)&g_note_info.ni_buffer[tail];
+  note    = (FAR struct note_common_s *)&ni->ni_buffer[tail];
   notelen = note->nc_length;
-  DEBUGASSERT(notelen <= circlen);
+  DEBUGASSERT(notelen <= note_length(ni));
 
   /* Is the user buffer large enough to hold the note? */
 
@@ -646,7 +814,7 @@ ssize_t sched_note_get(FAR uint8_t *buffer, size_t buflen)
     {
       /* Remove the large note so that we do not get constipated. */
 
-      note_remove();
+      note_remove(ni);
 
       /* and return an error */
 
@@ -661,7 +829,7 @@ ssize_t sched_note_get(FAR uint8_t *buffer, size_t buflen)
     {
       /* Copy the next byte at the tail index */
 
-      *buffer++ = g_note_info.ni_buffer[tail];
+      *buffer++ = ni->ni_buffer[tail];
 
       /* Adjust indices and counts */
 
@@ -669,7 +837,12 @@ ssize_t sched_note_get(FAR uint8_t *buffer, size_t buflen)
       remaining--;
     }
 
-  g_note_info.ni_tail = tail;
+  /* The note must be copied before its space is given back to the CPU
+   * that adds the notes.
+   */
+
+  SP_DMB();
+  ni->ni_tail = tail;
 
 errout_with_csection:
   leave_critical_section(flags);
@@ -695,33 +868,28 @@ errout_with_csection:
 #ifdef CONFIG_SCHED_NOTE_GET
 ssize_t sched_note_size(void)
 {
+  FAR struct note_info_s *ni;
   FAR struct note_common_s *note;
   irqstate_t flags;
-  unsigned int tail;
   ssize_t notelen;
-  size_t circlen;
 
   flags = enter_critical_section();
 
-  /* Verify that the circular buffer is not empty */
+  /* Select the buffer with the oldest note.  Are all buffers empty? */
 
-  circlen = note_length();
-  if (circlen <= 0)
+  ni = note_select();
+  if (ni == NULL)
     {
       notelen = 0;
       goto errout_with_csection;
     }
 
-  /* Get the index to the tail of the circular buffer */
-
-  tail = g_note_info.ni_tail;
-  DEBUGASSERT(tail < CONFIG_SCHED_NOTE_BUFSIZE);
-
   /* Get the length of the note at the tail index */
 
-  note    = (FAR struct note_common_s *)&g_note_info.ni_buffer[tail];
+  DEBUGASSERT(ni->ni_tail < CONFIG_SCHED_NOTE_BUFSIZE);
+  note    = (FAR struct note_common_s *)&ni->ni_buffer[ni->ni_tail];
   notelen = note->nc_length;
-  DEBUGASSERT(notelen <= circlen);
+  DEBUGASSERT(notelen <= note_length(ni));
 
 errout_with_csection:
   leave_critical_section(flags);
@@ -729,4 +897,32 @@ errout_with_csection:
 }
 #endif
 
+/****************************************************************************
+ * Name: sched_note_overflow
+ *
+ * Description:
+ *   Return the total number of notes that were lost on all CPUs because
+ *   the circular buffers were full.
+ *
+ * Input Parameters:
+ *   None.
+ *
+ * Returned Value:
+ *   The number of lost notes.
+ *
+ ****************************************************************************/
+
+uint32_t sched_note_overflow(void)
+{
+  uint32_t total = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < NOTE_NCPUS; cpu++)
+    {
+      total += g_note_info[cpu].ni_overflow;
+    }
+
+  return total;
+}
+
 #endif /* CONFIG_SCHED_INSTRUMENTATION_BUFFER */
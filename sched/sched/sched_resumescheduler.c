@@ -100,6 +100,9 @@ void sched_resume_scheduler(FAR struct tcb_s *tcb)
 #ifdef CONFIG_SCHED_CRITMONITOR
   sched_critmon_resume(tcb);
 #endif
+#ifdef CONFIG_SCHED_SCHEDSTAT
+  sched_schedstat_resume(tcb);
+#endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   sched_note_resume(tcb);
 #endif
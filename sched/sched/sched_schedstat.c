@@ -0,0 +1,390 @@
+/****************************************************************************
+ * sched/sched/sched_schedstat.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <sched.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_SCHEDSTAT
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Interrupt accounting for each CPU:  The time of the entry into the
+ * outermost interrupt handler, the interrupt nesting level and the total
+ * time spent in interrupt handlers.  Each entry is only modified by its
+ * own CPU.
+ */
+
+#ifdef CONFIG_SMP
+static uint32_t g_irq_start[CONFIG_SMP_NCPUS];
+static uint8_t  g_irq_nest[CONFIG_SMP_NCPUS];
+static uint64_t g_irq_time[CONFIG_SMP_NCPUS];
+#else
+static uint32_t g_irq_start[1];
+static uint8_t  g_irq_nest[1];
+static uint64_t g_irq_time[1];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: schedstat_now
+ *
+ * Description:
+ *   Return the time up to which threads are charged.  Inside of an
+ *   interrupt handler, that is the time when the interrupt was entered:
+ *   The rest is interrupt time.
+ *
+ ****************************************************************************/
+
+static inline uint32_t schedstat_now(void)
+{
+  int cpu = this_cpu();
+
+  if (g_irq_nest[cpu] > 0)
+    {
+      return g_irq_start[cpu];
+    }
+
+  return up_perf_gettime();
+}
+
+/****************************************************************************
+ * Name: schedstat_update
+ *
+ * Description:
+ *   Charge the time since the last accounting of the thread to its
+ *   current state and restart the accounting at 'now'.
+ *
+ ****************************************************************************/
+
+static void schedstat_update(FAR struct tcb_s *tcb, uint32_t now)
+{
+  int32_t elapsed = (int32_t)(now - tcb->stat_start);
+
+  /* The thread may have last been accounted on a CPU whose interrupt
+   * handler started later than the one that is running here.
+   */
+
+  if (elapsed > 0)
+    {
+      if (tcb->stat_state == SCHEDSTAT_RUNNING)
+        {
+          tcb->run_time += elapsed;
+        }
+      else if (tcb->stat_state == SCHEDSTAT_WAITING)
+        {
+          tcb->wait_time += elapsed;
+        }
+    }
+
+  tcb->stat_start = now;
+}
+
+/****************************************************************************
+ * Name: schedstat_nsec
+ *
+ * Description:
+ *   Convert a number of up_perf_gettime() counts to nanoseconds without
+ *   overflowing the intermediate product.
+ *
+ ****************************************************************************/
+
+static uint64_t schedstat_nsec(uint64_t count)
+{
+  uint32_t freq = up_perf_getfreq();
+
+  return (count / freq) * NSEC_PER_SEC +
+         (count % freq) * NSEC_PER_SEC / freq;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_schedstat_ready
+ *
+ * Description:
+ *   Called when a thread is added to the ready-to-run list.  If it was
+ *   blocked, it starts waiting to run.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_schedstat_ready(FAR struct tcb_s *tcb)
+{
+  if (tcb->stat_state == SCHEDSTAT_BLOCKED)
+    {
+      tcb->stat_start = schedstat_now();
+      tcb->stat_state = SCHEDSTAT_WAITING;
+    }
+}
+
+/****************************************************************************
+ * Name: sched_schedstat_resume
+ *
+ * Description:
+ *   Called when a thread starts running on this CPU.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread that is starting to run.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_schedstat_resume(FAR struct tcb_s *tcb)
+{
+  schedstat_update(tcb, schedstat_now());
+  tcb->stat_state = SCHEDSTAT_RUNNING;
+}
+
+/****************************************************************************
+ * Name: sched_schedstat_suspend
+ *
+ * Description:
+ *   Called when a thread stops running on this CPU.  The switch is
+ *   involuntary if the thread is still ready to run (or pending), i.e.,
+ *   if it was preempted.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread that is being suspended.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_schedstat_suspend(FAR struct tcb_s *tcb)
+{
+  schedstat_update(tcb, schedstat_now());
+
+  if (tcb->task_state >= TSTATE_TASK_PENDING &&
+      tcb->task_state <= LAST_READY_TO_RUN_STATE)
+    {
+      tcb->nivcsw++;
+      tcb->stat_state = SCHEDSTAT_WAITING;
+    }
+  else
+    {
+      tcb->nvcsw++;
+      tcb->stat_state = SCHEDSTAT_BLOCKED;
+    }
+}
+
+/****************************************************************************
+ * Name: sched_schedstat_irqenter and sched_schedstat_irqleave
+ *
+ * Description:
+ *   Called by irq_dispatch() before and after the interrupt handler.  The
+ *   time spent in the outermost handler is added to the interrupt time of
+ *   this CPU and is not charged to the thread that runs on this CPU when
+ *   the handler returns.  A thread resumed by the handler is accounted
+ *   from the entry into the handler (see schedstat_now()), so it is not
+ *   charged either.
+ *
+ ****************************************************************************/
+
+void sched_schedstat_irqenter(void)
+{
+  int cpu = this_cpu();
+
+  if (g_irq_nest[cpu]++ == 0)
+    {
+      g_irq_start[cpu] = up_perf_gettime();
+    }
+}
+
+void sched_schedstat_irqleave(void)
+{
+  FAR struct tcb_s *tcb;
+  uint32_t elapsed;
+  int cpu = this_cpu();
+
+  DEBUGASSERT(g_irq_nest[cpu] > 0);
+  if (--g_irq_nest[cpu] == 0)
+    {
+      elapsed          = up_perf_gettime() - g_irq_start[cpu];
+      g_irq_time[cpu] += elapsed;
+
+      tcb = current_task(cpu);
+      if (tcb->stat_state == SCHEDSTAT_RUNNING)
+        {
+          tcb->stat_start += elapsed;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: clock_schedstat
+ *
+ * Description:
+ *   Return the scheduler statistics of the selected PID.
+ *
+ * Input Parameters:
+ *   pid  - The task ID of the thread of interest.
+ *   stat - The location to return the statistics
+ *
+ * Returned Value:
+ *   OK (0) on success; -ESRCH if 'pid' does not refer to a valid thread.
+ *
+ ****************************************************************************/
+
+int clock_schedstat(int pid, FAR struct schedstat_s *stat)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  uint64_t run;
+  uint64_t wait;
+  int32_t elapsed;
+  int ret = -ESRCH;
+
+  DEBUGASSERT(stat != NULL);
+
+  /* The TCB must stay valid and the counts consistent while they are
+   * read.
+   */
+
+  flags = enter_critical_section();
+
+  tcb = sched_gettcb((pid_t)pid);
+  if (tcb != NULL)
+    {
+      /* Include the time in the current state */
+
+      run     = tcb->run_time;
+      wait    = tcb->wait_time;
+      elapsed = (int32_t)(up_perf_gettime() - tcb->stat_start);
+
+      if (elapsed > 0)
+        {
+          if (tcb->stat_state == SCHEDSTAT_RUNNING)
+            {
+              run += elapsed;
+            }
+          else if (tcb->stat_state == SCHEDSTAT_WAITING)
+            {
+              wait += elapsed;
+            }
+        }
+
+      stat->nvcsw  = tcb->nvcsw;
+      stat->nivcsw = tcb->nivcsw;
+      ret          = OK;
+    }
+
+  leave_critical_section(flags);
+
+  if (ret == OK)
+    {
+      stat->run  = schedstat_nsec(run);
+      stat->wait = schedstat_nsec(wait);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: clock_cpustat
+ *
+ * Description:
+ *   Return the time that the selected CPU has spent in its IDLE thread and
+ *   in interrupt handlers.
+ *
+ * Input Parameters:
+ *   cpu  - The index of the CPU of interest.
+ *   stat - The location to return the statistics
+ *
+ * Returned Value:
+ *   OK (0) on success; -EINVAL if 'cpu' is not a valid CPU index.
+ *
+ ****************************************************************************/
+
+int clock_cpustat(int cpu, FAR struct cpustat_s *stat)
+{
+  struct schedstat_s idle;
+  irqstate_t flags;
+  uint64_t irq;
+
+  DEBUGASSERT(stat != NULL);
+
+#ifdef CONFIG_SMP
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS)
+#else
+  if (cpu != 0)
+#endif
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  irq   = g_irq_time[cpu];
+  leave_critical_section(flags);
+
+  /* The PID of the IDLE thread of each CPU is the index of the CPU */
+
+  DEBUGVERIFY(clock_schedstat(cpu, &idle));
+
+  stat->idle = idle.run;
+  stat->irq  = schedstat_nsec(irq);
+  return OK;
+}
+
+#endif /* CONFIG_SCHED_SCHEDSTAT */
@@ -87,13 +87,33 @@
 int nxsem_post(FAR sem_t *sem)
 {
   FAR struct tcb_s *stcb = NULL;
+  irqstate_t lflags;
   irqstate_t flags;
+  int16_t semcount;
   int ret = -EINVAL;
 
   /* Make sure we were supplied with a valid semaphore. */
 
   if (sem != NULL)
     {
+      /* If no thread is waiting and there are no holders to track, just
+       * increment the count without entering the critical section.
+       */
+
+      if (NXSEM_FASTPATH(sem))
+        {
+          lflags = nxsem_lock(sem);
+          if (sem->semcount >= 0)
+            {
+              DEBUGASSERT(sem->semcount < SEM_VALUE_MAX);
+              sem->semcount++;
+              nxsem_unlock(sem, lflags);
+              return OK;
+            }
+
+          nxsem_unlock(sem, lflags);
+        }
+
       /* The following operations must be performed with interrupts
        * disabled because sem_post() may be called from an interrupt
        * handler.
@@ -118,9 +138,12 @@ int nxsem_post(FAR sem_t *sem)
        * initialized if the semaphore is to used for signaling purposes.
        */
 
-      DEBUGASSERT(sem->semcount < SEM_VALUE_MAX);
       nxsem_releaseholder(sem);
-      sem->semcount++;
+
+      lflags = nxsem_lock(sem);
+      DEBUGASSERT(sem->semcount < SEM_VALUE_MAX);
+      semcount = ++sem->semcount;
+      nxsem_unlock(sem, lflags);
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
       /* Don't let any unblocked tasks run until we complete any priority
@@ -137,7 +160,7 @@ int nxsem_post(FAR sem_t *sem)
        * there must be some task waiting for the semaphore.
        */
 
-      if (sem->semcount <= 0)
+      if (semcount <= 0)
         {
           /* Check if there are any tasks in the waiting for semaphore
            * task list that are waiting for this semaphore. This is a
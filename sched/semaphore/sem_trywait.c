@@ -81,7 +81,9 @@
 int nxsem_trywait(FAR sem_t *sem)
 {
   FAR struct tcb_s *rtcb = this_task();
+  irqstate_t cflags = 0;
   irqstate_t flags;
+  bool fast;
   int ret;
 
   /* This API should not be called from interrupt handlers */
@@ -90,11 +92,19 @@ int nxsem_trywait(FAR sem_t *sem)
 
   if (sem != NULL)
     {
-      /* The following operations must be performed with interrupts disabled
-       * because sem_post() may be called from an interrupt handler.
+      /* The count is changed under the semaphore lock because sem_post()
+       * may be called from an interrupt handler or from another CPU.
+       * Semaphores with priority inheritance are still changed only in the
+       * critical section as well.
        */
 
-      flags = enter_critical_section();
+      fast = NXSEM_FASTPATH(sem);
+      if (!fast)
+        {
+          cflags = enter_critical_section();
+        }
+
+      flags = nxsem_lock(sem);
 
       /* If the semaphore is available, give it to the requesting task */
 
@@ -115,7 +125,11 @@ int nxsem_trywait(FAR sem_t *sem)
 
       /* Interrupts may now be enabled. */
 
-      leave_critical_section(flags);
+      nxsem_unlock(sem, flags);
+      if (!fast)
+        {
+          leave_critical_section(cflags);
+        }
     }
   else
     {
@@ -86,6 +86,7 @@
 int nxsem_wait(FAR sem_t *sem)
 {
   FAR struct tcb_s *rtcb = this_task();
+  irqstate_t lflags;
   irqstate_t flags;
   int ret = -EINVAL;
 
@@ -93,6 +94,25 @@ int nxsem_wait(FAR sem_t *sem)
 
   DEBUGASSERT(sem != NULL && up_interrupt_context() == false);
 
+  /* If a count is available and there are no holders to track, take it
+   * without entering the critical section.
+   */
+
+  if (sem != NULL && NXSEM_FASTPATH(sem))
+    {
+      lflags = nxsem_lock(sem);
+      if (sem->semcount > 0)
+        {
+          sem->semcount--;
+          nxsem_unlock(sem, lflags);
+
+          rtcb->waitsem = NULL;
+          return OK;
+        }
+
+      nxsem_unlock(sem, lflags);
+    }
+
   /* The following operations must be performed with interrupts
    * disabled because nxsem_post() may be called from an interrupt
    * handler.
@@ -106,11 +126,14 @@ int nxsem_wait(FAR sem_t *sem)
     {
       /* Check if the lock is available */
 
+      lflags = nxsem_lock(sem);
       if (sem->semcount > 0)
         {
           /* It is, let the task take the semaphore. */
 
           sem->semcount--;
+          nxsem_unlock(sem, lflags);
+
           nxsem_addholder(sem);
           rtcb->waitsem = NULL;
           ret = OK;
@@ -130,9 +153,14 @@ int nxsem_wait(FAR sem_t *sem)
 
           DEBUGASSERT(rtcb->waitsem == NULL);
 
-          /* Handle the POSIX semaphore (but don't set the owner yet) */
+          /* Handle the POSIX semaphore (but don't set the owner yet).
+           * A thread that posts the semaphore now will find the count
+           * negative and will wait for the critical section, i.e., until
+           * this thread is blocked.
+           */
 
           sem->semcount--;
+          nxsem_unlock(sem, lflags);
 
           /* Save the waited on semaphore in the TCB */
 
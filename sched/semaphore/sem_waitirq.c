@@ -79,6 +79,7 @@
 
 void nxsem_wait_irq(FAR struct tcb_s *wtcb, int errcode)
 {
+  irqstate_t lflags;
   irqstate_t flags;
 
   /* Disable interrupts.  This is necessary (unfortunately) because an
@@ -109,7 +110,9 @@ void nxsem_wait_irq(FAR struct tcb_s *wtcb, int errcode)
        * place.
        */
 
+      lflags = nxsem_lock(sem);
       sem->semcount++;
+      nxsem_unlock(sem, lflags);
 
       /* Indicate that the semaphore wait is over. */
 
@@ -49,8 +49,44 @@
 #include <sched.h>
 #include <queue.h>
 
+#include <nuttx/spinlock.h>
+
 /****************************************************************************
- * Public Function Prototypes
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Semaphore counts are changed under one of SEM_NLOCKS spinlocks, selected
+ * by the address of the semaphore.  This lets nxsem_trywait(), and
+ * nxsem_wait() and nxsem_post() when they neither block nor wake up a
+ * thread, run without the critical section.  Blocking and waking up still
+ * need the critical section, which is always entered before the semaphore
+ * lock is taken.
+ */
+
+#ifdef CONFIG_SMP
+#  define SEM_NLOCKS           16
+#  define SEM_LOCK(s) \
+     (&g_semlock[((uintptr_t)(s) >> 3) & (SEM_NLOCKS - 1)])
+#  define nxsem_lock(s)        spin_lock_save(SEM_LOCK(s))
+#  define nxsem_unlock(s,f)    spin_unlock_restore(SEM_LOCK(s), (f))
+#else
+#  define nxsem_lock(s)        up_irq_save()
+#  define nxsem_unlock(s,f)    up_irq_restore(f)
+#endif
+
+/* The holder lists of semaphores with priority inheritance are protected
+ * by the critical section, so only semaphores without it may use the
+ * paths that skip the critical section.
+ */
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+#  define NXSEM_FASTPATH(s)    (((s)->flags & PRIOINHERIT_FLAGS_DISABLE) != 0)
+#else
+#  define NXSEM_FASTPATH(s)    true
+#endif
+
+/****************************************************************************
+ * Public Data
  ****************************************************************************/
 
 #ifdef __cplusplus
@@ -61,6 +97,16 @@ extern "C"
 #define EXTERN extern
 #endif
 
+#ifdef CONFIG_SMP
+/* The spinlocks that protect the semaphore counts */
+
+extern volatile spinlock_t g_semlock[SEM_NLOCKS];
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
 /* Common semaphore logic */
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
@@ -43,6 +43,7 @@
 #include <sched.h>
 #include <assert.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/sched_note.h>
 #include <arch/irq.h>
@@ -51,6 +52,21 @@
 
 #ifdef CONFIG_SPINLOCK
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_STATS
+/* The list of named ticket locks, in the order in which they were named.
+ * Locks are only ever added at the tail so that the list may be walked
+ * without holding g_spinstats_lock.
+ */
+
+static FAR struct spinlock_stats_s *g_spinstats_head;
+static FAR struct spinlock_stats_s *g_spinstats_tail;
+static volatile spinlock_t g_spinstats_lock SP_SECTION;
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -99,6 +115,230 @@ void spin_lock(FAR volatile spinlock_t *lock)
   SP_DMB();
 }
 
+/****************************************************************************
+ * Name: spin_lock_save
+ *
+ * Description:
+ *   Disable local interrupts and take the spinlock 'lock'.
+ *
+ * Input Parameters:
+ *   lock - A reference to the spinlock object to lock.
+ *
+ * Returned Value:
+ *   The state of the interrupts prior to the call.
+ *
+ ****************************************************************************/
+
+irqstate_t spin_lock_save(FAR volatile spinlock_t *lock)
+{
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  spin_lock(lock);
+  return flags;
+}
+
+/****************************************************************************
+ * Name: spin_unlock_restore
+ *
+ * Description:
+ *   Release the spinlock taken by spin_lock_save() and restore the
+ *   interrupt state.
+ *
+ * Input Parameters:
+ *   lock  - A reference to the spinlock object to unlock.
+ *   flags - The value returned by spin_lock_save().
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void spin_unlock_restore(FAR volatile spinlock_t *lock, irqstate_t flags)
+{
+  spin_unlock(lock);
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: spin_ticket_register
+ *
+ * Description:
+ *   Give a ticket lock a name and add it to the list shown in
+ *   /proc/spinlock.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket lock.
+ *   name - The name of the lock.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_STATS
+void spin_ticket_register(FAR struct spin_ticket_s *lock,
+                          FAR const char *name)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(lock != NULL && name != NULL && lock->stats.name == NULL);
+
+  /* Name the entry before it becomes visible */
+
+  lock->stats.name  = name;
+  lock->stats.flink = NULL;
+  SP_DMB();
+
+  flags = spin_lock_save(&g_spinstats_lock);
+  if (g_spinstats_tail == NULL)
+    {
+      g_spinstats_head = &lock->stats;
+    }
+  else
+    {
+      g_spinstats_tail->flink = &lock->stats;
+    }
+
+  g_spinstats_tail = &lock->stats;
+  spin_unlock_restore(&g_spinstats_lock, flags);
+}
+#endif
+
+/****************************************************************************
+ * Name: spin_ticket_lock_save
+ *
+ * Description:
+ *   Disable local interrupts, draw a ticket and wait until it is served.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket lock to lock.
+ *
+ * Returned Value:
+ *   The state of the interrupts prior to the call.
+ *
+ ****************************************************************************/
+
+irqstate_t spin_ticket_lock_save(FAR struct spin_ticket_s *lock)
+{
+#ifdef CONFIG_SPINLOCK_STATS
+  uint32_t nspins = 0;
+#endif
+  irqstate_t flags;
+  uint16_t ticket;
+
+  flags = up_irq_save();
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
+  /* Notify that we are waiting for a spinlock */
+
+  sched_note_spinlock(this_task(), &lock->guard);
+#endif
+
+  /* Draw a ticket.  The guard is only held for the increment. */
+
+  spin_lock_wo_note(&lock->guard);
+  ticket = lock->next++;
+  spin_unlock_wo_note(&lock->guard);
+
+  /* Then wait until the holders of all earlier tickets are done */
+
+  while (lock->owner != ticket)
+    {
+#ifdef CONFIG_SPINLOCK_STATS
+      nspins++;
+#endif
+      SP_DSB();
+    }
+
+  SP_DMB();
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
+  /* Notify that we have the spinlock */
+
+  sched_note_spinlocked(this_task(), &lock->guard);
+#endif
+
+#ifdef CONFIG_SPINLOCK_STATS
+  lock->stats.nlocks++;
+  if (nspins > 0)
+    {
+      lock->stats.ncontended++;
+      lock->stats.nspins += nspins;
+    }
+
+#ifdef CONFIG_ARCH_HAVE_PERF_EVENTS
+  lock->stats.start = up_perf_gettime();
+#endif
+#endif
+
+  return flags;
+}
+
+/****************************************************************************
+ * Name: spin_ticket_unlock_restore
+ *
+ * Description:
+ *   Serve the next ticket and restore the interrupt state.
+ *
+ * Input Parameters:
+ *   lock  - A reference to the ticket lock to unlock.
+ *   flags - The value returned by spin_ticket_lock_save().
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void spin_ticket_unlock_restore(FAR struct spin_ticket_s *lock,
+                                irqstate_t flags)
+{
+#if defined(CONFIG_SPINLOCK_STATS) && defined(CONFIG_ARCH_HAVE_PERF_EVENTS)
+  uint32_t elapsed = up_perf_gettime() - lock->stats.start;
+
+  if (elapsed > lock->stats.maxhold)
+    {
+      lock->stats.maxhold = elapsed;
+    }
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
+  /* Notify that we are unlocking the spinlock */
+
+  sched_note_spinunlock(this_task(), &lock->guard);
+#endif
+
+  /* Only the holder writes 'owner', so no atomic operation is needed */
+
+  SP_DMB();
+  lock->owner++;
+  SP_DSB();
+
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: spin_stats_next
+ *
+ * Description:
+ *   Walk the list of named ticket locks.
+ *
+ * Input Parameters:
+ *   stats - The statistics returned by the previous call, or NULL.
+ *
+ * Returned Value:
+ *   The statistics of the next named lock, or NULL if there are no more.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_STATS
+FAR struct spinlock_stats_s *
+  spin_stats_next(FAR struct spinlock_stats_s *stats)
+{
+  return stats == NULL ? g_spinstats_head : stats->flink;
+}
+#endif
+
 /****************************************************************************
  * Name: spin_lock_wo_note
  *
@@ -46,6 +46,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/wdog.h>
 #include <nuttx/kmalloc.h>
 
@@ -82,14 +83,11 @@ int wd_delete(WDOG_ID wdog)
 
   DEBUGASSERT(wdog != NULL);
 
-  /* The following steps are atomic... the watchdog must not be active when
-   * it is being deallocated.
+  /* The watchdog must not be active when it is being deallocated.
+   * wd_cancel() re-checks this in the critical section in case the
+   * watchdog expires first.
    */
 
-  flags = enter_critical_section();
-
-  /* Check if the watchdog has been started. */
-
   if (WDOG_ISACTIVE(wdog))
     {
       /* Yes.. stop it */
@@ -111,7 +109,6 @@ int wd_delete(WDOG_ID wdog)
        * We don't need interrupts disabled to do this.
        */
 
-      leave_critical_section(flags);
       sched_kfree(wdog);
     }
 
@@ -123,20 +120,16 @@ int wd_delete(WDOG_ID wdog)
        * timers, all with interrupts disabled.
        */
 
+      flags = spin_lock_save(&g_wdfreelock);
       sq_addlast((FAR sq_entry_t *)wdog, &g_wdfreelist);
       g_wdnfree++;
       DEBUGASSERT(g_wdnfree <= CONFIG_PREALLOC_WDOGS);
-      leave_critical_section(flags);
+      spin_unlock_restore(&g_wdfreelock, flags);
     }
 
-  /* This function should not be called for statically allocated timers. */
-
-  else
-    {
-      leave_critical_section(flags);
-    }
-
-  /* Return success */
+  /* This function should not be called for statically allocated timers.
+   * Return success.
+   */
 
   return OK;
 }
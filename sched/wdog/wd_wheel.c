@@ -0,0 +1,541 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <strings.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/wdog.h>
+
+#include "sched/sched.h"
+#include "wdog/wdog.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Each level of the wheel has WHEEL_SLOTS slots.  A slot in level 0 holds
+ * the watchdogs that expire on one tick; a slot in level n holds the
+ * watchdogs that expire within a block of 32^n ticks.  When time reaches
+ * the start of such a block, the slot is emptied and its watchdogs are
+ * re-inserted at the lower levels ("cascaded").
+ */
+
+#define WHEEL_BITS        5
+#define WHEEL_SLOTS       (1 << WHEEL_BITS)
+#define WHEEL_MASK        (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS      CONFIG_WDOG_TIMER_WHEEL_LEVELS
+#define WHEEL_SHIFT(l)    ((l) * WHEEL_BITS)
+#define WHEEL_SPAN        ((clock_t)1 << WHEEL_SHIFT(WHEEL_LEVELS))
+
+#define WHEEL_SLOT(l,t)   \
+  (((l) << WHEEL_BITS) + (int)(((t) >> WHEEL_SHIFT(l)) & WHEEL_MASK))
+
+/* In the tickless mode, the wheel position is the watchdog tickbase.
+ * Otherwise it simply counts the timer interrupts.
+ */
+
+#ifdef CONFIG_SCHED_TICKLESS
+#  define g_wdbase        g_wdtickbase
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The slots of the wheel.  Each slot is a circular, doubly linked list of
+ * watchdogs in the order that they were added.
+ */
+
+static FAR struct wdog_s *g_wdwheel[WHEEL_LEVELS * WHEEL_SLOTS];
+
+/* One bit per non-empty slot, for each level of the wheel */
+
+static uint32_t g_wdslotmap[WHEEL_LEVELS];
+
+/* The number of watchdogs in the wheel */
+
+static unsigned int g_wdactive;
+
+/* The current position of the wheel in ticks */
+
+#ifndef CONFIG_SCHED_TICKLESS
+static clock_t g_wdbase;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_link
+ *
+ * Description:
+ *   Add a watchdog to the tail of the slot that corresponds to its
+ *   expiration time, relative to the current position of the wheel.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_link(FAR struct wdog_s *wdog)
+{
+  FAR struct wdog_s **head;
+  clock_t when = wdog->expire;
+  clock_t diff = when - g_wdbase;
+  int level = 0;
+
+  /* Find the lowest level that covers the delay */
+
+  while (level < WHEEL_LEVELS - 1 &&
+         diff >= ((clock_t)1 << WHEEL_SHIFT(level + 1)))
+    {
+      level++;
+    }
+
+  /* Watchdogs beyond the span of the wheel are parked in the furthest slot
+   * of the top level.  They are re-inserted when that slot is reached.
+   */
+
+  if (diff >= WHEEL_SPAN)
+    {
+      when = g_wdbase + WHEEL_SPAN - 1;
+    }
+
+  wdog->slot = WHEEL_SLOT(level, when);
+  head       = &g_wdwheel[wdog->slot];
+
+  if (*head == NULL)
+    {
+      wdog->next = wdog;
+      wdog->prev = wdog;
+      *head      = wdog;
+
+      g_wdslotmap[level] |= (uint32_t)1 << (wdog->slot & WHEEL_MASK);
+    }
+  else
+    {
+      wdog->next       = *head;
+      wdog->prev       = (*head)->prev;
+      wdog->prev->next = wdog;
+      (*head)->prev    = wdog;
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_unlink
+ *
+ * Description:
+ *   Remove a watchdog from its slot.  Returns true if the slot became
+ *   empty.
+ *
+ ****************************************************************************/
+
+static bool wd_wheel_unlink(FAR struct wdog_s *wdog)
+{
+  FAR struct wdog_s **head = &g_wdwheel[wdog->slot];
+  bool empty = false;
+
+  if (wdog->next == wdog)
+    {
+      *head = NULL;
+      g_wdslotmap[wdog->slot >> WHEEL_BITS] &=
+        ~((uint32_t)1 << (wdog->slot & WHEEL_MASK));
+      empty = true;
+    }
+  else
+    {
+      wdog->prev->next = wdog->next;
+      wdog->next->prev = wdog->prev;
+
+      if (*head == wdog)
+        {
+          *head = wdog->next;
+        }
+    }
+
+  wdog->next = NULL;
+  wdog->prev = NULL;
+  return empty;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Empty the current slot of an upper level and re-insert its watchdogs
+ *   into the lower levels.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_cascade(int level)
+{
+  FAR struct wdog_s *wdog;
+  FAR struct wdog_s *next;
+  int slot = WHEEL_SLOT(level, g_wdbase);
+
+  wdog = g_wdwheel[slot];
+  if (wdog != NULL)
+    {
+      /* Detach the whole list, breaking the ring at its tail */
+
+      g_wdwheel[slot]     = NULL;
+      g_wdslotmap[level] &= ~((uint32_t)1 << (slot & WHEEL_MASK));
+      wdog->prev->next    = NULL;
+
+      do
+        {
+          next = wdog->next;
+          wd_wheel_link(wdog);
+          wdog = next;
+        }
+      while (wdog != NULL);
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_step
+ *
+ * Description:
+ *   Advance the wheel by one tick, cascade the upper levels as needed and
+ *   run all of the watchdogs that expire on the new tick.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_step(void)
+{
+  FAR struct wdog_s *wdog;
+  int level;
+  int slot;
+
+  g_wdbase++;
+
+  /* Cascade each level at which a new block begins */
+
+  for (level = 1;
+       level < WHEEL_LEVELS &&
+       (g_wdbase & (((clock_t)1 << WHEEL_SHIFT(level)) - 1)) == 0;
+       level++)
+    {
+      wd_wheel_cascade(level);
+    }
+
+  /* Run the watchdogs in the current slot of level 0.  The functions may
+   * start or cancel other watchdogs, so always take the new head.
+   */
+
+  slot = WHEEL_SLOT(0, g_wdbase);
+  while ((wdog = g_wdwheel[slot]) != NULL)
+    {
+      wd_wheel_unlink(wdog);
+      g_wdactive--;
+
+      wd_dispatch(wdog);
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Return the number of ticks until the next non-empty slot is reached,
+ *   or zero if the wheel is empty.  For the upper levels, this is the time
+ *   at which that slot is cascaded, which may be earlier than the
+ *   expiration of any of its watchdogs.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS
+static clock_t wd_wheel_next(void)
+{
+  clock_t delay = 0;
+  clock_t pos;
+  clock_t tmp;
+  uint32_t map;
+  int level;
+  int cur;
+
+  for (level = 0; level < WHEEL_LEVELS; level++)
+    {
+      map = g_wdslotmap[level];
+      if (map == 0)
+        {
+          continue;
+        }
+
+      /* Rotate the map so that bit 0 is the slot after the current one.
+       * The current slot itself then comes last, a full turn away.
+       */
+
+      pos = g_wdbase >> WHEEL_SHIFT(level);
+      cur = (int)(pos & WHEEL_MASK);
+
+      if (cur < WHEEL_MASK)
+        {
+          map = (map >> (cur + 1)) | (map << (WHEEL_MASK - cur));
+        }
+
+      tmp = ((pos + ffs((int)map)) << WHEEL_SHIFT(level)) - g_wdbase;
+      if (delay == 0 || tmp < delay)
+        {
+          delay = tmp;
+        }
+    }
+
+  return delay;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_initialize
+ *
+ * Description:
+ *   Initialize the watchdog timing wheel.  Called from wd_initialize().
+ *
+ ****************************************************************************/
+
+void wd_wheel_initialize(void)
+{
+  int i;
+
+  for (i = 0; i < WHEEL_LEVELS * WHEEL_SLOTS; i++)
+    {
+      g_wdwheel[i] = NULL;
+    }
+
+  for (i = 0; i < WHEEL_LEVELS; i++)
+    {
+      g_wdslotmap[i] = 0;
+    }
+
+  g_wdactive = 0;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_add
+ *
+ * Description:
+ *   Add a watchdog to the timing wheel so that it expires after 'delay'
+ *   ticks.  This is an O(1) operation.
+ *
+ * Input Parameters:
+ *   wdog  - The watchdog to add.  It must not already be active.
+ *   delay - The delay in ticks (must be greater than zero).
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called in a critical section.
+ *
+ ****************************************************************************/
+
+void wd_wheel_add(FAR struct wdog_s *wdog, int32_t delay)
+{
+#ifdef CONFIG_SCHED_TICKLESS
+  if (g_wdactive == 0)
+    {
+      /* Update clock tickbase */
+
+      g_wdtickbase = clock_systimer();
+    }
+#endif
+
+  wdog->expire = g_wdbase + (clock_t)delay;
+  wd_wheel_link(wdog);
+  g_wdactive++;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove an active watchdog from the timing wheel.  This is an O(1)
+ *   operation.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog to remove.
+ *
+ * Returned Value:
+ *   True is returned if the removal may have changed the time of the next
+ *   expiration event, i.e., if the interval timer should be reassessed.
+ *
+ * Assumptions:
+ *   Called in a critical section.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+  g_wdactive--;
+
+  /* The next event can only move if a slot became empty */
+
+  return wd_wheel_unlink(wdog);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remaining
+ *
+ * Description:
+ *   Return the number of ticks remaining before an active watchdog
+ *   expires.
+ *
+ * Assumptions:
+ *   Called in a critical section.
+ *
+ ****************************************************************************/
+
+int wd_wheel_remaining(FAR struct wdog_s *wdog)
+{
+  return (int)(wdog->expire - g_wdbase - wd_elapse());
+}
+
+/****************************************************************************
+ * Name: wd_timer
+ *
+ * Description:
+ *   This function is called from the timer interrupt handler to determine
+ *   if it is time to execute a watchdog function.  If so, the watchdog
+ *   function will be executed in the context of the timer interrupt
+ *   handler.
+ *
+ * Input Parameters:
+ *   ticks - If CONFIG_SCHED_TICKLESS is defined then the number of ticks
+ *     in the interval that just expired is provided.  Otherwise,
+ *     this function is called on each timer interrupt and a value of one
+ *     is implicit.
+ *
+ * Returned Value:
+ *   If CONFIG_SCHED_TICKLESS is defined then the number of ticks for the
+ *   next delay is provided (zero if no delay).  Otherwise, this function
+ *   has no returned value.
+ *
+ * Assumptions:
+ *   Called from interrupt handler logic with interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS
+unsigned int wd_timer(int ticks)
+{
+#ifdef CONFIG_SMP
+  irqstate_t flags;
+#endif
+  clock_t next;
+
+#ifdef CONFIG_SMP
+  /* We are in an interrupt handler as, as a consequence, interrupts are
+   * disabled.  But in the SMP case, interrupts MAY be disabled only on
+   * the local CPU since most architectures do not permit disabling
+   * interrupts on other CPUS.
+   *
+   * Hence, we must follow rules for critical sections even here in the
+   * SMP case.
+   */
+
+  flags = enter_critical_section();
+#endif
+
+  /* Skip directly over the ticks in which nothing happens */
+
+  while (ticks > 0)
+    {
+      next = wd_wheel_next();
+      if (next == 0 || next > (clock_t)ticks)
+        {
+          g_wdbase += ticks;
+          break;
+        }
+
+      g_wdbase += next - 1;
+      ticks    -= (int)next;
+      wd_wheel_step();
+    }
+
+  /* Return the delay for the next watchdog to expire */
+
+  next = wd_wheel_next();
+
+#ifdef CONFIG_SMP
+  leave_critical_section(flags);
+#endif
+
+  return (unsigned int)next;
+}
+
+#else
+void wd_timer(void)
+{
+#ifdef CONFIG_SMP
+  irqstate_t flags;
+
+  /* We are in an interrupt handler as, as a consequence, interrupts are
+   * disabled.  But in the SMP case, interrupts MAY be disabled only on
+   * the local CPU since most architectures do not permit disabling
+   * interrupts on other CPUS.
+   *
+   * Hence, we must follow rules for critical sections even here in the
+   * SMP case.
+   */
+
+  flags = enter_critical_section();
+#endif
+
+  if (g_wdactive > 0)
+    {
+      wd_wheel_step();
+    }
+  else
+    {
+      g_wdbase++;
+    }
+
+#ifdef CONFIG_SMP
+  leave_critical_section(flags);
+#endif
+}
+#endif /* CONFIG_SCHED_TICKLESS */
@@ -46,7 +46,9 @@
 #include <stdbool.h>
 
 #include <nuttx/compiler.h>
+#include <nuttx/arch.h>
 #include <nuttx/clock.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/wdog.h>
 
 /****************************************************************************
@@ -88,12 +90,14 @@ extern "C"
 
 extern sq_queue_t g_wdfreelist;
 
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 extern sq_queue_t g_wdactivelist;
+#endif
 
 /* This is the number of free, pre-allocated watchdog structures in the
  * g_wdfreelist.  This value is used to enforce a reserve for interrupt
@@ -102,6 +106,14 @@ extern sq_queue_t g_wdactivelist;
 
 extern uint16_t g_wdnfree;
 
+#ifdef CONFIG_SPINLOCK
+/* This spinlock protects g_wdfreelist and g_wdnfree.  The active watchdogs
+ * are still protected by the critical section.
+ */
+
+extern volatile spinlock_t g_wdfreelock;
+#endif
+
 /* This is wdog tickbase, for wd_gettime() may called many times
  * between 2 times of wd_timer(), we use it to update wd_gettime().
  */
@@ -110,6 +122,58 @@ extern uint16_t g_wdnfree;
 extern clock_t g_wdtickbase;
 #endif
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_dispatch
+ *
+ * Description:
+ *   Execute the function of a watchdog that has expired and has already
+ *   been removed from the set of active watchdogs.
+ *
+ * Input Parameters:
+ *   wdog - The expired watchdog
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from the timer interrupt handler in a critical section.
+ *
+ ****************************************************************************/
+
+static inline void wd_dispatch(FAR struct wdog_s *wdog)
+{
+  /* Indicate that the watchdog is no longer active. */
+
+  WDOG_CLRACTIVE(wdog);
+
+  /* Execute the watchdog function */
+
+  up_setpicbase(wdog->picbase);
+
+#if CONFIG_MAX_WDOGPARMS == 0
+  wdog->func(0);
+#elif CONFIG_MAX_WDOGPARMS == 1
+  wdog->func((int)wdog->argc,
+             wdog->parm[0]);
+#elif CONFIG_MAX_WDOGPARMS == 2
+  wdog->func((int)wdog->argc,
+             wdog->parm[0], wdog->parm[1]);
+#elif CONFIG_MAX_WDOGPARMS == 3
+  wdog->func((int)wdog->argc,
+             wdog->parm[0], wdog->parm[1], wdog->parm[2]);
+#elif CONFIG_MAX_WDOGPARMS == 4
+  wdog->func((int)wdog->argc,
+             wdog->parm[0], wdog->parm[1], wdog->parm[2],
+             wdog->parm[3]);
+#else
+#  error Missing support
+#endif
+}
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -188,6 +252,74 @@ void wd_timer(void);
 struct tcb_s;
 void wd_recover(FAR struct tcb_s *tcb);
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+/****************************************************************************
+ * Name: wd_wheel_initialize
+ *
+ * Description:
+ *   Initialize the watchdog timing wheel.  Called from wd_initialize().
+ *
+ ****************************************************************************/
+
+void wd_wheel_initialize(void);
+
+/****************************************************************************
+ * Name: wd_wheel_add
+ *
+ * Description:
+ *   Add a watchdog to the timing wheel so that it expires after 'delay'
+ *   ticks.  This is an O(1) operation.
+ *
+ * Input Parameters:
+ *   wdog  - The watchdog to add.  It must not already be active.
+ *   delay - The delay in ticks (must be greater than zero).
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called in a critical section.
+ *
+ ****************************************************************************/
+
+void wd_wheel_add(FAR struct wdog_s *wdog, int32_t delay);
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove an active watchdog from the timing wheel.  This is an O(1)
+ *   operation.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog to remove.
+ *
+ * Returned Value:
+ *   True is returned if the removal may have changed the time of the next
+ *   expiration event, i.e., if the interval timer should be reassessed.
+ *
+ * Assumptions:
+ *   Called in a critical section.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_remove(FAR struct wdog_s *wdog);
+
+/****************************************************************************
+ * Name: wd_wheel_remaining
+ *
+ * Description:
+ *   Return the number of ticks remaining before an active watchdog
+ *   expires.
+ *
+ * Assumptions:
+ *   Called in a critical section.
+ *
+ ****************************************************************************/
+
+int wd_wheel_remaining(FAR struct wdog_s *wdog);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -144,7 +144,11 @@ int work_cancel(int qid, FAR struct work_s *work)
     {
       /* Cancel high priority work */
 
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+      return work_cpucancel(work);
+#else
       return work_qcancel((FAR struct kwork_wqueue_s *)&g_hpwork, work);
+#endif
     }
   else
 #endif
@@ -53,7 +53,7 @@
 
 #include "wqueue/wqueue.h"
 
-#ifdef CONFIG_SCHED_HPWORK
+#if defined(CONFIG_SCHED_HPWORK) && !defined(CONFIG_SCHED_HPWORK_PERCPU)
 
 /****************************************************************************
  * Public Data
@@ -216,4 +216,4 @@ int work_hpstart(void)
   return g_hpwork.worker[0].pid;
 }
 
-#endif /* CONFIG_SCHED_HPWORK */
+#endif /* CONFIG_SCHED_HPWORK && !CONFIG_SCHED_HPWORK_PERCPU */
@@ -0,0 +1,710 @@
+/****************************************************************************
+ * sched/wqueue/kwork_percpu.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sched.h>
+#include <signal.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/sched.h>
+#include <nuttx/signal.h>
+#include <nuttx/kthread.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+
+#include "wqueue/wqueue.h"
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSTEM_TIME64
+#  define WORK_DELAY_MAX UINT64_MAX
+#else
+#  define WORK_DELAY_MAX UINT32_MAX
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The state of the kernel mode, high priority work queue of each CPU.  The
+ * all-zero initial state is an empty queue with an unlocked lock so that
+ * work may be queued before the worker threads are started.
+ */
+
+struct hp_cpuqueue_s g_hpcpuwork[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_cpuaccount
+ *
+ * Description:
+ *   Update the statistics of a queue for work that is about to run.  The
+ *   queue must be locked.
+ *
+ ****************************************************************************/
+
+static void work_cpuaccount(FAR struct hp_cpuqueue_s *cq, clock_t latency,
+                            bool stolen)
+{
+  cq->nrun++;
+  cq->totlatency += latency;
+
+  if (latency > cq->maxlatency)
+    {
+      cq->maxlatency = latency;
+    }
+
+  if (stolen)
+    {
+      cq->nstolen++;
+    }
+}
+
+/****************************************************************************
+ * Name: work_cpusteal
+ *
+ * Description:
+ *   Called by the worker of CPU 'cpu' when it has no ready work of its own.
+ *   Take one ready work item from the queue of another CPU whose worker is
+ *   busy and run it.
+ *
+ * Returned Value:
+ *   true if work was run.
+ *
+ ****************************************************************************/
+
+static bool work_cpusteal(int cpu)
+{
+  FAR struct hp_cpuqueue_s *cq = &g_hpcpuwork[cpu];
+  FAR struct hp_cpuqueue_s *vq;
+  FAR struct work_s *work;
+  irqstate_t flags;
+  worker_t worker;
+  FAR void *arg;
+  clock_t elapsed;
+  clock_t ctick;
+  int i;
+
+  for (i = 1; i < CONFIG_SMP_NCPUS; i++)
+    {
+      /* Only busy peers are robbed; an idle peer will run its own work.
+       * The unlocked tests only skip obviously uninteresting queues.
+       */
+
+      vq = &g_hpcpuwork[(cpu + i) % CONFIG_SMP_NCPUS];
+      if (!vq->worker.busy || vq->q.head == NULL)
+        {
+          continue;
+        }
+
+      flags = spin_ticket_lock_save(&vq->lock);
+      ctick = clock_systimer();
+
+      for (work = (FAR struct work_s *)vq->q.head;
+           work != NULL;
+           work = (FAR struct work_s *)work->dq.flink)
+        {
+          elapsed = ctick - work->qtime;
+          if (elapsed >= work->delay && work->worker != NULL)
+            {
+              break;
+            }
+        }
+
+      if (work == NULL)
+        {
+          spin_ticket_unlock_restore(&vq->lock, flags);
+          continue;
+        }
+
+      /* Take the work from the peer's queue */
+
+      dq_rem((FAR dq_entry_t *)work, &vq->q);
+      vq->depth--;
+
+      worker       = work->worker;
+      arg          = work->arg;
+      elapsed     -= work->delay;
+      work->worker = NULL;
+      spin_ticket_unlock_restore(&vq->lock, flags);
+
+      flags = spin_ticket_lock_save(&cq->lock);
+      work_cpuaccount(cq, elapsed, true);
+      spin_ticket_unlock_restore(&cq->lock, flags);
+
+      /* And run it here */
+
+      worker(arg);
+      return true;
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: work_cpuprocess
+ *
+ * Description:
+ *   Perform the ready work of one CPU's queue, then ready work of busy
+ *   peers, then wait until more work is queued or until the next delayed
+ *   work becomes ready.  This is the per-CPU counterpart of work_process().
+ *
+ ****************************************************************************/
+
+static void work_cpuprocess(int cpu)
+{
+  FAR struct hp_cpuqueue_s *cq = &g_hpcpuwork[cpu];
+  FAR struct work_s *work;
+  worker_t  worker;
+  irqstate_t flags;
+  FAR void *arg;
+  uint32_t nqueued;
+  clock_t elapsed;
+  clock_t remaining;
+  clock_t stick;
+  clock_t ctick;
+  clock_t next;
+
+  next  = WORK_DELAY_MAX;
+  flags = spin_ticket_lock_save(&cq->lock);
+  stick = clock_systimer();
+
+  work = (FAR struct work_s *)cq->q.head;
+  while (work != NULL)
+    {
+      ctick   = clock_systimer();
+      elapsed = ctick - work->qtime;
+      if (elapsed >= work->delay)
+        {
+          /* Remove the ready-to-execute work from the list */
+
+          dq_rem((FAR dq_entry_t *)work, &cq->q);
+          cq->depth--;
+
+          worker = work->worker;
+          if (worker != NULL)
+            {
+              arg          = work->arg;
+              work->worker = NULL;
+              work_cpuaccount(cq, elapsed - work->delay, false);
+
+              /* Do the work with the queue unlocked, then start over at
+               * the head of the queue.
+               */
+
+              spin_ticket_unlock_restore(&cq->lock, flags);
+              worker(arg);
+
+              flags = spin_ticket_lock_save(&cq->lock);
+              work  = (FAR struct work_s *)cq->q.head;
+            }
+          else
+            {
+              work = (FAR struct work_s *)work->dq.flink;
+            }
+        }
+      else /* elapsed < work->delay */
+        {
+          /* This one is not ready.  Will it be ready before the next
+           * scheduled wakeup interval?
+           */
+
+          elapsed += (ctick - stick);
+          if (elapsed > work->delay)
+            {
+              elapsed = work->delay;
+            }
+
+          remaining = work->delay - elapsed;
+          if (remaining < next)
+            {
+              next = remaining;
+            }
+
+          work = (FAR struct work_s *)work->dq.flink;
+        }
+    }
+
+  nqueued = cq->nqueued;
+  spin_ticket_unlock_restore(&cq->lock, flags);
+
+  /* Nothing is ready here.  Help busy peers before going to sleep. */
+
+  if (work_cpusteal(cpu))
+    {
+      return;
+    }
+
+  /* Wait until signalled or until the next delayed work is ready.  As in
+   * work_process(), the critical section assures that a signal sent after
+   * 'busy' is cleared is not delivered before we actually wait.  Work that
+   * was queued before 'busy' was cleared is caught by the test of nqueued.
+   */
+
+  flags = enter_critical_section();
+  cq->worker.busy = false;
+  SP_DMB();
+
+  if (cq->nqueued == nqueued)
+    {
+      if (next == WORK_DELAY_MAX)
+        {
+          sigset_t set;
+
+          sigemptyset(&set);
+          sigaddset(&set, SIGWORK);
+          DEBUGVERIFY(nxsig_waitinfo(&set, NULL));
+        }
+      else
+        {
+          nxsig_usleep(next * USEC_PER_TICK);
+        }
+    }
+
+  cq->worker.busy = true;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: work_cputhread
+ *
+ * Description:
+ *   The per-CPU, high-priority worker threads.  The worker of CPU 0 also
+ *   performs garbage collection unless there is a low-priority worker.
+ *
+ ****************************************************************************/
+
+static int work_cputhread(int argc, char *argv[])
+{
+  pid_t me = getpid();
+  int cpu;
+
+  /* Find our CPU by searching for our PID */
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (g_hpcpuwork[cpu].worker.pid == me)
+        {
+          break;
+        }
+    }
+
+  DEBUGASSERT(cpu < CONFIG_SMP_NCPUS);
+
+  for (; ; )
+    {
+#ifndef CONFIG_SCHED_LPWORK
+      if (cpu == 0)
+        {
+          sched_garbage_collection();
+        }
+#endif
+
+      work_cpuprocess(cpu);
+    }
+
+  return OK; /* To keep some compilers happy */
+}
+
+/****************************************************************************
+ * Name: work_cpuremove
+ *
+ * Description:
+ *   Remove work from the queue that holds it, if any.
+ *
+ ****************************************************************************/
+
+static int work_cpuremove(FAR struct work_s *work)
+{
+  FAR struct hp_cpuqueue_s *cq;
+  irqstate_t flags;
+  int cpu;
+
+  for (; ; )
+    {
+      /* work->cpu and work->worker only change with the queue named by
+       * work->cpu locked, so both are stable once that queue is locked and
+       * still named by work->cpu.
+       */
+
+      cpu = work->cpu;
+      if (cpu >= CONFIG_SMP_NCPUS)
+        {
+          return -ENOENT;
+        }
+
+      cq    = &g_hpcpuwork[cpu];
+      flags = spin_ticket_lock_save(&cq->lock);
+
+      if (work->cpu != cpu)
+        {
+          spin_ticket_unlock_restore(&cq->lock, flags);
+          continue;
+        }
+
+      if (work->worker == NULL)
+        {
+          spin_ticket_unlock_restore(&cq->lock, flags);
+          return -ENOENT;
+        }
+
+      dq_rem((FAR dq_entry_t *)work, &cq->q);
+      cq->depth--;
+      work->worker = NULL;
+      spin_ticket_unlock_restore(&cq->lock, flags);
+      return OK;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_cpuqueue
+ *
+ * Description:
+ *   Queue high-priority work on the queue of one CPU.
+ *
+ ****************************************************************************/
+
+int work_cpuqueue(int cpu, FAR struct work_s *work, worker_t worker,
+                  FAR void *arg, clock_t delay)
+{
+  FAR struct hp_cpuqueue_s *cq;
+  FAR struct hp_cpuqueue_s *oq;
+  irqstate_t flags;
+  irqstate_t oflags;
+  int old;
+  int i;
+
+  DEBUGASSERT(work != NULL && worker != NULL);
+
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  /* Lock the queue named by work->cpu and the new queue, in CPU order so
+   * that two callers cannot deadlock.  With both locked, removing pending
+   * work from its old queue and adding it to the new one is atomic, so a
+   * concurrent work_cpuqueue() of the same work cannot link it twice.  The
+   * work was zeroed by the caller, so work->cpu is valid even if the work
+   * was never queued.
+   */
+
+  cq = &g_hpcpuwork[cpu];
+
+  for (; ; )
+    {
+      old = work->cpu;
+      DEBUGASSERT(old < CONFIG_SMP_NCPUS);
+
+      oq = &g_hpcpuwork[old];
+      if (old < cpu)
+        {
+          oflags = spin_ticket_lock_save(&oq->lock);
+          flags  = spin_ticket_lock_save(&cq->lock);
+        }
+      else
+        {
+          flags  = spin_ticket_lock_save(&cq->lock);
+          oflags = old != cpu ? spin_ticket_lock_save(&oq->lock) : 0;
+        }
+
+      if (work->cpu == old)
+        {
+          break;
+        }
+
+      /* Moved to another queue while we waited for the locks */
+
+      if (old != cpu)
+        {
+          spin_ticket_unlock_restore(&oq->lock, oflags);
+        }
+
+      spin_ticket_unlock_restore(&cq->lock, flags);
+    }
+
+  /* If the work is already pending, it is re-queued at the end of the new
+   * queue.
+   */
+
+  if (work->worker != NULL)
+    {
+      dq_rem((FAR dq_entry_t *)work, &oq->q);
+      oq->depth--;
+    }
+
+  work->cpu    = cpu;
+  work->worker = worker;           /* Work callback. non-NULL means queued */
+  work->arg    = arg;              /* Callback argument */
+  work->delay  = delay;            /* Delay until work performed */
+  work->qtime  = clock_systimer(); /* Time work queued */
+
+  dq_addlast((FAR dq_entry_t *)work, &cq->q);
+
+  cq->nqueued++;
+  if (++cq->depth > cq->maxdepth)
+    {
+      cq->maxdepth = cq->depth;
+    }
+
+  /* Release the locks in the reverse order of taking them */
+
+  if (old < cpu)
+    {
+      spin_ticket_unlock_restore(&cq->lock, flags);
+      spin_ticket_unlock_restore(&oq->lock, oflags);
+    }
+  else
+    {
+      if (old != cpu)
+        {
+          spin_ticket_unlock_restore(&oq->lock, oflags);
+        }
+
+      spin_ticket_unlock_restore(&cq->lock, flags);
+    }
+
+  /* Wake up the worker of this CPU.  If it is busy and the work is ready
+   * now, wake up an idle peer instead so that it can take the work.
+   *
+   * The worker clears 'busy' and then re-reads nqueued, so nqueued must be
+   * published before 'busy' is read here.  With the full barrier, either
+   * the worker sees the new nqueued and does not wait, or 'busy' is seen
+   * to be false and the worker is signalled.
+   */
+
+  SP_DMB();
+
+  if (!cq->worker.busy || delay > 0)
+    {
+      return work_cpusignal(cpu);
+    }
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      if (!g_hpcpuwork[i].worker.busy)
+        {
+          return work_cpusignal(i);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: work_cpucancel
+ *
+ * Description:
+ *   Cancel high-priority work queued on any CPU.
+ *
+ ****************************************************************************/
+
+int work_cpucancel(FAR struct work_s *work)
+{
+  DEBUGASSERT(work != NULL);
+  return work_cpuremove(work);
+}
+
+/****************************************************************************
+ * Name: work_cpusignal
+ *
+ * Description:
+ *   Wake up the high-priority worker thread of one CPU, or of all CPUs if
+ *   'cpu' is negative, if it is waiting.
+ *
+ ****************************************************************************/
+
+int work_cpusignal(int cpu)
+{
+  FAR struct kworker_s *worker;
+  int ret = OK;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      if (cpu >= 0 && i != cpu)
+        {
+          continue;
+        }
+
+      worker = &g_hpcpuwork[i].worker;
+      if (!worker->busy && worker->pid > 0)
+        {
+          ret = nxsig_kill(worker->pid, SIGWORK);
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: work_cpustats
+ *
+ * Description:
+ *   Return the statistics of the high-priority work queue of one CPU.
+ *
+ ****************************************************************************/
+
+int work_cpustats(int cpu, FAR struct work_cpustats_s *stats)
+{
+  FAR struct hp_cpuqueue_s *cq;
+  irqstate_t flags;
+
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS || stats == NULL)
+    {
+      return -EINVAL;
+    }
+
+  cq    = &g_hpcpuwork[cpu];
+  flags = spin_ticket_lock_save(&cq->lock);
+
+  stats->ws_queued     = cq->nqueued;
+  stats->ws_run        = cq->nrun;
+  stats->ws_stolen     = cq->nstolen;
+  stats->ws_depth      = cq->depth;
+  stats->ws_maxdepth   = cq->maxdepth;
+  stats->ws_maxlatency = cq->maxlatency;
+  stats->ws_avglatency = cq->nrun > 0 ?
+                         (clock_t)(cq->totlatency / cq->nrun) : 0;
+
+  spin_ticket_unlock_restore(&cq->lock, flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: work_hpstart
+ *
+ * Description:
+ *   Start the per-CPU, high-priority, kernel-mode worker threads.  Each
+ *   thread is bound to its CPU.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The task ID of the worker thread of CPU 0 is returned on success.  A
+ *   negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+int work_hpstart(void)
+{
+  cpu_set_t cpuset;
+  pid_t pid;
+  int cpu;
+  int ret;
+
+  /* Don't permit any of the threads to run until we have fully initialized
+   * g_hpcpuwork.
+   */
+
+  sched_lock();
+
+  sinfo("Starting per-CPU high-priority kernel worker threads\n");
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      pid = kthread_create(HPWORKNAME, CONFIG_SCHED_HPWORKPRIORITY,
+                           CONFIG_SCHED_HPWORKSTACKSIZE,
+                           (main_t)work_cputhread,
+                           (FAR char * const *)NULL);
+
+      DEBUGASSERT(pid > 0);
+      if (pid < 0)
+        {
+          serr("ERROR: kthread_create %d failed: %d\n", cpu, (int)pid);
+          sched_unlock();
+          return (int)pid;
+        }
+
+      CPU_ZERO(&cpuset);
+      CPU_SET(cpu, &cpuset);
+
+      ret = nxsched_setaffinity(pid, sizeof(cpu_set_t), &cpuset);
+      if (ret < 0)
+        {
+          serr("ERROR: nxsched_setaffinity %d failed: %d\n", cpu, ret);
+          sched_unlock();
+          return ret;
+        }
+
+      g_hpcpuwork[cpu].worker.pid  = pid;
+      g_hpcpuwork[cpu].worker.busy = true;
+
+#ifdef CONFIG_SPINLOCK_STATS
+      snprintf(g_hpcpuwork[cpu].lockname,
+               sizeof(g_hpcpuwork[cpu].lockname), "hpwork%d", cpu);
+      spin_ticket_register(&g_hpcpuwork[cpu].lock,
+                           g_hpcpuwork[cpu].lockname);
+#endif
+    }
+
+  sched_unlock();
+  return g_hpcpuwork[0].worker.pid;
+}
+
+#endif /* CONFIG_SCHED_HPWORK_PERCPU */
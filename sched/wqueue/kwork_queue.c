@@ -169,8 +169,12 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
     {
       /* Queue high priority work */
 
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+      return work_cpuqueue(up_cpu_index(), work, worker, arg, delay);
+#else
       work_qqueue((FAR struct kwork_wqueue_s *)&g_hpwork, work, worker, arg, delay);
       return work_signal(HPWORK);
+#endif
     }
   else
 #endif
@@ -189,4 +193,44 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
     }
 }
 
+/****************************************************************************
+ * Name: work_queue_cpu
+ *
+ * Description:
+ *   Queue kernel-mode work like work_queue() with a hint of the CPU that
+ *   should perform it.  The hint is used only for the per-CPU HPWORK
+ *   queues.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (index)
+ *   cpu    - The preferred CPU, or -1 for the current CPU
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.
+ *   arg    - The argument that will be passed to the workder callback
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+int work_queue_cpu(int qid, int cpu, FAR struct work_s *work,
+                   worker_t worker, FAR void *arg, clock_t delay)
+{
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  if (qid == HPWORK)
+    {
+      if (cpu < 0)
+        {
+          cpu = up_cpu_index();
+        }
+
+      return work_cpuqueue(cpu, work, worker, arg, delay);
+    }
+#endif
+
+  return work_queue(qid, work, worker, arg, delay);
+}
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
@@ -80,8 +80,12 @@ int work_signal(int qid)
 #ifdef CONFIG_SCHED_HPWORK
   if (qid == HPWORK)
     {
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+      return work_cpusignal(-1);
+#else
       work = (FAR struct kwork_wqueue_s *)&g_hpwork;
       threads = CONFIG_SCHED_HPNTHREADS;
+#endif
     }
   else
 #endif
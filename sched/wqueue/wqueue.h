@@ -47,6 +47,7 @@
 #include <queue.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/spinlock.h>
 
 #ifdef CONFIG_SCHED_WORKQUEUE
 
@@ -83,7 +84,7 @@ struct kwork_wqueue_s
  * structure must be cast-compatible with kwork_wqueue_s.
  */
 
-#ifdef CONFIG_SCHED_HPWORK
+#if defined(CONFIG_SCHED_HPWORK) && !defined(CONFIG_SCHED_HPWORK_PERCPU)
 struct hp_wqueue_s
 {
   struct dq_queue_s q;         /* The queue of pending work */
@@ -94,6 +95,34 @@ struct hp_wqueue_s
 };
 #endif
 
+/* This structure defines the state of the high-priority work queue of one
+ * CPU.  The queue is protected by its own ticket lock rather than by the
+ * critical section so that a worker stealing work cannot starve the CPUs
+ * that queue it.
+ */
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+struct hp_cpuqueue_s
+{
+  struct dq_queue_s q;         /* The queue of pending work */
+  struct kworker_s  worker;    /* The worker thread bound to this CPU */
+  struct spin_ticket_s lock;   /* Protects q and the statistics */
+#ifdef CONFIG_SPINLOCK_STATS
+  char lockname[12];           /* Name of the lock in /proc/spinlock */
+#endif
+
+  /* Statistics */
+
+  uint32_t nqueued;            /* Number of work items queued */
+  uint32_t nrun;               /* Number of work items run */
+  uint32_t nstolen;            /* Number run from other CPUs' queues */
+  uint16_t depth;              /* Number of work items in q */
+  uint16_t maxdepth;           /* Maximum value of depth */
+  clock_t  maxlatency;         /* Longest time from ready to run */
+  uint64_t totlatency;         /* Sum of the times from ready to run */
+};
+#endif
+
 /* This structure defines the state of one low-priority work queue.  This
  * structure must be cast compatible with kwork_wqueue_s
  */
@@ -113,12 +142,18 @@ struct lp_wqueue_s
  * Public Data
  ****************************************************************************/
 
-#ifdef CONFIG_SCHED_HPWORK
+#if defined(CONFIG_SCHED_HPWORK) && !defined(CONFIG_SCHED_HPWORK_PERCPU)
 /* The state of the kernel mode, high priority work queue. */
 
 extern struct hp_wqueue_s g_hpwork;
 #endif
 
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+/* The state of the kernel mode, high priority work queue of each CPU. */
+
+extern struct hp_cpuqueue_s g_hpcpuwork[CONFIG_SMP_NCPUS];
+#endif
+
 #ifdef CONFIG_SCHED_LPWORK
 /* The state of the kernel mode, low priority work queue(s). */
 
@@ -187,6 +222,59 @@ int work_lpstart(void);
 
 void work_process(FAR struct kwork_wqueue_s *wqueue, int wndx);
 
+/****************************************************************************
+ * Name: work_cpuqueue
+ *
+ * Description:
+ *   Queue high-priority work on the queue of one CPU.  This is the
+ *   implementation of work_queue(HPWORK, ...) when CONFIG_SCHED_HPWORK_PERCPU
+ *   is selected.
+ *
+ * Input Parameters:
+ *   cpu    - The CPU whose queue receives the work
+ *   work, worker, arg, delay - As for work_queue()
+ *
+ * Returned Value:
+ *   Zero (OK) on success, a negated errno value on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+int work_cpuqueue(int cpu, FAR struct work_s *work, worker_t worker,
+                  FAR void *arg, clock_t delay);
+#endif
+
+/****************************************************************************
+ * Name: work_cpucancel
+ *
+ * Description:
+ *   Cancel high-priority work queued on any CPU.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if the work is not queued.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+int work_cpucancel(FAR struct work_s *work);
+#endif
+
+/****************************************************************************
+ * Name: work_cpusignal
+ *
+ * Description:
+ *   Wake up the high-priority worker thread of one CPU, or of all CPUs if
+ *   'cpu' is negative, if it is waiting.
+ *
+ * Returned Value:
+ *   Zero (OK) on success, a negated errno value on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+int work_cpusignal(int cpu);
+#endif
+
 /****************************************************************************
  * Name: work_notifier_initialize
  *
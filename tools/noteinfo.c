@@ -1,15 +1,24 @@
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
 /****************************************************************************
  * The following is autogenerated and comes from:
  *
- *   (gdb) p &g_note_info.ni_buffer
+ *   (gdb) p &g_note_info[0].ni_buffer
  *   $3 = (uint8_t (*)[2048]) 0x10831004
  *   (gdb) dump binary memory noteinfo.bin 0x10831004 0x10831804
  *
  *   $ xxd -g 1 -i noteinfo.bin >noteinfo.h
  *
+ * In SMP configurations, there is one such buffer for each CPU.
+ *
+ * Alternatively, the notes may be read from /dev/note in the streaming
+ * mode (see NOTEIOC_STREAM) and saved to a file.  Such a file is decoded
+ * with:
+ *
+ *   $ noteinfo <file>
+ *
  ****************************************************************************/
 
 unsigned char noteinfo_bin[] = {
@@ -702,7 +711,7 @@ unsigned int noteinfo_bin_len = 8192;
 /****************************************************************************
  * This comes from:
  *
- *   (gdb) p g_note_info
+ *   (gdb) p g_note_info[0]
  *   $1 = {ni_head = 915, ni_tail = 925,
  *   ni_buffer = ...
  *
@@ -728,7 +737,7 @@ struct note_common_s
   uint8_t nc_systime[4];       /* Time when note buffered */
 };
 
-#define NTYPES 18
+#define NTYPES 19
 static char *noteid[NTYPES] =
 {
   "NOTE_START",           /* type = 0 */
@@ -752,7 +761,9 @@ static char *noteid[NTYPES] =
   "NOTE_SPINLOCK_LOCK",   /* type = 14 */
   "NOTE_SPINLOCK_LOCKED", /* type = 15 */
   "NOTE_SPINLOCK_UNLOCK", /* type = 16 */
-  "NOTE_SPINLOCK_ABORT"   /* type = 17 */
+  "NOTE_SPINLOCK_ABORT",  /* type = 17 */
+
+  "NOTE_OVERFLOW"         /* type = 18 */
 };
 
 static unsigned int next_ndx(unsigned int ndx)
@@ -765,16 +776,181 @@ static unsigned int next_ndx(unsigned int ndx)
   return ndx;
 }
 
-int main(int argc, char **argv)
+static void print_note(char *buffer, unsigned int size)
 {
   struct note_common_s *note;
-  unsigned int size;
-  unsigned int notndx;
   unsigned int bufndx;
   unsigned int remainder;
   unsigned int value;
+
+  note = (struct note_common_s *)buffer;
+  printf("CPU%1u PID%-3uprio=%-3u: %-20s time=%08lx",
+         note->nc_cpu,
+         (unsigned int) note->nc_pid[1] << 8 |
+         (unsigned int) note->nc_pid[0],
+         note->nc_priority,
+         note->nc_type < NTYPES ? noteid[note->nc_type] : "Unrecognized",
+         (unsigned long)note->nc_systime[3] << 24 |
+         (unsigned long)note->nc_systime[2] << 16 |
+         (unsigned long)note->nc_systime[1] << 8 |
+         (unsigned long)note->nc_systime[0]);
+
+  bufndx    = sizeof(struct note_common_s);
+  remainder = size - bufndx;
+  if (remainder > 0)
+    {
+      switch(note->nc_type)
+      {
+        /* Followed by a varible length, NULL terminated name */
+
+        case 0: /* NOTE_START */
+          buffer[size - 1] = '\0';
+          printf(" Name: %s", &buffer[bufndx]);
+          bufndx    = size;
+          remainder = 0;
+          break;
+
+        /* Followed by an 8-bit task state */
+
+        case 2: /* NOTE_SUSPEND */
+          printf(" State=%u", (unsigned int)buffer[bufndx]);
+          bufndx++;
+          remainder--;
+          break;
+
+        /* Followed by an 8-bit target CPU number */
+
+        case 4: /* NOTE_CPU_START */
+        case 6: /* NOTE_CPU_PAUSE */
+        case 8: /* NOTE_CPU_RESUME */
+          printf(" Target CPU%u", (unsigned int)buffer[bufndx]);
+          bufndx++;
+          remainder--;
+          break;
+
+        /* Followed by a 16-bit count */
+
+        case 10: /* NOTE_PREEMPT_LOCK */
+        case 11: /* NOTE_PREEMPT_UNLOCK */
+        case 12: /* NOTE_CSECTION_ENTER */
+        case 13: /* NOTE_CSECTION_LEAVE */
+          if (remainder >= 2)
+            {
+              value = (unsigned int)(uint8_t)buffer[bufndx + 1] << 8 |
+                      (unsigned int)(uint8_t)buffer[bufndx];
+              printf(" Count=%u", value);
+              bufndx += 2;
+              remainder -= 2;
+            }
+          break;
+
+        /* Followed by an 8-bit spinlock value */
+
+        case 14: /* NOTE_SPINLOCK_LOCK */
+        case 15: /* NOTE_SPINLOCK_LOCKED */
+        case 16: /* NOTE_SPINLOCK_UNLOCK */
+        case 17: /* NOTE_SPINLOCK_ABORT */
+          printf(" Spinlock=%u", (unsigned int)buffer[bufndx]);
+          bufndx++;
+          remainder--;
+          break;
+
+        /* Followed by a 32-bit count of lost notes */
+
+        case 18: /* NOTE_OVERFLOW */
+          if (remainder >= 4)
+            {
+              value = (unsigned int)(uint8_t)buffer[bufndx + 3] << 24 |
+                      (unsigned int)(uint8_t)buffer[bufndx + 2] << 16 |
+                      (unsigned int)(uint8_t)buffer[bufndx + 1] << 8 |
+                      (unsigned int)(uint8_t)buffer[bufndx];
+              printf(" Lost=%u", value);
+              bufndx += 4;
+              remainder -= 4;
+            }
+          break;
+
+        /* Nothing addition shold follow these types */
+
+        case 1: /* NOTE_STOP */
+        case 3: /* NOTE_RESUME */
+        case 5: /* NOTE_CPU_STARTED */
+        case 7: /* NOTE_CPU_PAUSED */
+        case 9: /* NOTE_CPU_RESUMED */
+        default:
+          break;
+      }
+    }
+
+  for (; bufndx < size; bufndx++)
+    {
+      printf(" %02x", (unsigned int)(uint8_t)buffer[bufndx]);
+    }
+
+  printf("\n");
+}
+
+static int print_stream(const char *path)
+{
+  FILE *stream;
+  unsigned long offset;
+  unsigned int size;
+  int ch;
+  char buffer[256];
+
+  stream = fopen(path, "rb");
+  if (stream == NULL)
+    {
+      fprintf(stderr, "ERROR: Failed to open %s\n", path);
+      return 1;
+    }
+
+  /* The stream is a sequence of notes, each beginning with its length */
+
+  offset = 0;
+  while ((ch = fgetc(stream)) != EOF)
+    {
+      size = (unsigned int)ch;
+      if (size < sizeof(struct note_common_s))
+        {
+          printf("ERROR: Bad note size at offset %lu: %u\n", offset, size);
+          fclose(stream);
+          return 1;
+        }
+
+      buffer[0] = (char)size;
+      if (fread(&buffer[1], 1, size - 1, stream) != size - 1)
+        {
+          printf("Incomplete record\n");
+          fclose(stream);
+          return 1;
+        }
+
+      printf("%5lu: ", offset);
+      print_note(buffer, size);
+      offset += size;
+    }
+
+  fclose(stream);
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  unsigned int size;
+  unsigned int notndx;
+  unsigned int bufndx;
   char buffer[64];
 
+  /* Decode a binary stream captured from /dev/note */
+
+  if (argc > 1)
+    {
+      return print_stream(argv[1]);
+    }
+
+  /* Otherwise, decode the circular buffer dumped above */
+
   notndx = ni_tail;
   while (notndx != ni_head)
     {
@@ -803,94 +979,8 @@ int main(int argc, char **argv)
             }
         }
 
-      note = (struct note_common_s *)buffer;
-      printf("CPU%1u PID%-3uprio=%-3u: %-20s time=%08lx",
-             note->nc_cpu,
-             (unsigned int) note->nc_pid[1] << 8 |
-             (unsigned int) note->nc_pid[0],
-             note->nc_priority,
-             note->nc_type < NTYPES ? noteid[note->nc_type] : "Unrecognized",
-             (unsigned long)note->nc_systime[3] << 24 |
-             (unsigned long)note->nc_systime[2] << 16 |
-             (unsigned long)note->nc_systime[1] << 8 |
-             (unsigned long)note->nc_systime[0]);
-
-      bufndx    = sizeof(struct note_common_s);
-      remainder = size - bufndx;
-      if (remainder > 0)
-        {
-          switch(note->nc_type)
-          {
-            /* Followed by a varible length, NULL terminated name */
-
-            case 0: /* NOTE_START */
-              buffer[size - 1] = '\0';
-              printf(" Name: %s", &buffer[bufndx]);
-              bufndx    = size;
-              remainder = 0;
-              break;
-
-            /* Followed by an 8-bit task state */
-
-            case 2: /* NOTE_SUSPEND */
-              printf(" State=%u", (unsigned int)buffer[bufndx]);
-              bufndx++;
-              remainder--;
-              break;
-
-            /* Followed by an 8-bit target CPU number */
-
-            case 4: /* NOTE_CPU_START */
-            case 6: /* NOTE_CPU_PAUSE */
-            case 8: /* NOTE_CPU_RESUME */
-              printf(" Target CPU%u", (unsigned int)buffer[bufndx]);
-              bufndx++;
-              remainder--;
-              break;
-
-            /* Followed by a 16-bit count */
-
-            case 10: /* NOTE_PREEMPT_LOCK */
-            case 11: /* NOTE_PREEMPT_UNLOCK */
-            case 12: /* NOTE_CSECTION_ENTER */
-            case 13: /* NOTE_CSECTION_LEAVE */
-              if (remainder >= 2)
-                {
-                  value = (unsigned int)buffer[bufndx] << 8 |
-                          (unsigned int)buffer[bufndx+1];
-                  bufndx += 2;
-                  remainder -= 2;
-                  break;
-                }
-
-            /* Followed by an 8-bit spinlock value */
-
-            case 14: /* NOTE_SPINLOCK_LOCK */
-            case 15: /* NOTE_SPINLOCK_LOCKED */
-            case 16: /* NOTE_SPINLOCK_UNLOCK */
-            case 17: /* NOTE_SPINLOCK_ABORT */
-              printf(" Spinlock=%u", (unsigned int)buffer[bufndx]);
-              bufndx++;
-              remainder--;
-              break;
-
-            /* Nothing addition shold follow these types */
-
-            case 1: /* NOTE_STOP */
-            case 3: /* NOTE_RESUME */
-            case 5: /* NOTE_CPU_STARTED */
-            case 7: /* NOTE_CPU_PAUSED */
-            case 9: /* NOTE_CPU_RESUMED */
-            default:
-              break;
-          }
-        }
-
-      for (; bufndx < size; bufndx++)
-        {
-          printf(" %02x", buffer[bufndx]);
-        }
-
-      printf("\n");
+      print_note(buffer, size);
     }
+
+  return 0;
 }